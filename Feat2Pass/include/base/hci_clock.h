@@ -0,0 +1,69 @@
+/* ====================================================================
+ * Copyright (c) 2007 HCI LAB.
+ * ALL RIGHTS RESERVED.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are prohibited provided that permissions by HCI LAB
+ * are not given.
+ *
+ * ====================================================================
+ *
+ */
+
+/**
+ *	@file	hci_clock.h
+ *	@ingroup common_base_src
+ *	@brief	Monotonic clock for the per-stage timing of the hot path.
+ *
+ *   ; HCI_STAGE_START / HCI_STAGE_TIME compile to nothing when TRG_NO_STATS is defined.
+ */
+
+
+#ifndef __HCILAB_CLOCK_H__
+#define __HCILAB_CLOCK_H__
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *	monotonic time in ns, only differences are meaningful
+ */
+static __inline unsigned long long
+hci_clock_ns(void)
+{
+#if defined(_WIN32)
+	static LARGE_INTEGER freq;
+	LARGE_INTEGER now;
+	if (0 == freq.QuadPart)	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&now);
+	return (unsigned long long)(now.QuadPart / freq.QuadPart) * 1000000000ULL
+		+ (unsigned long long)(now.QuadPart % freq.QuadPart) * 1000000000ULL / freq.QuadPart;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec;
+#endif
+}
+
+#ifndef TRG_NO_STATS
+/// t = now
+#define HCI_STAGE_START(t)		((t) = hci_clock_ns())
+/// acc += now - t, t = now (start of the next stage)
+#define HCI_STAGE_TIME(acc, t)	do { const unsigned long long t_now_ = hci_clock_ns(); (acc) += t_now_ - (t); (t) = t_now_; } while (0)
+#else
+#define HCI_STAGE_START(t)		((void)(t))
+#define HCI_STAGE_TIME(acc, t)	((void)(t))
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	// __HCILAB_CLOCK_H__
@@ -134,6 +134,15 @@ hci_free_2d(void **ptr);
 HCILAB_PUBLIC HCI_BASE_API void
 hci_free_3d(void ***ptr);
 
+/**
+ * Allocation accounting : hook called with the size of every allocation of the functions above
+ * (NULL : off, the default), see CAllocStats
+ */
+typedef void (*hci_alloc_hook)(size_t size);
+
+HCILAB_PUBLIC HCI_BASE_API void
+hci_set_alloc_hook(hci_alloc_hook hook);
+
 /**
  * Macros to simplify the use of above functions.
  * One should use these, rather than target functions directly.
@@ -84,6 +84,29 @@ HCILAB_PUBLIC HCI_BASICOP_API hci_int16*
 PowerASR_BasicOP_getLogAdditionTableForStateLL(PowerASR_BasicOP *pThis
 );
 
+/**
+ *	return the image of the basic operator set-up, to be saved in a snapshot.
+ *	the image is the inner data struct as it is, valid only for the same build.
+ *
+ *	@return return the image size in bytes, otherwise return -1.
+ */
+HCILAB_PUBLIC HCI_BASICOP_API hci_int32
+PowerASR_BasicOP_getImage(PowerASR_BasicOP *pThis,							///< (i) pointer to the basic operator
+						  const void **ppImage								///< (o) image of the basic operator
+);
+
+/**
+ *	set-up the basic operator from an image returned by PowerASR_BasicOP_getImage,
+ *	instead of making the log-addition tables.
+ *
+ *	@return return 0 if the image is set-up correctly, otherwise return -1.
+ */
+HCILAB_PUBLIC HCI_BASICOP_API hci_int32
+PowerASR_BasicOP_setImage(PowerASR_BasicOP *pThis,							///< (i/o) pointer to the basic operator
+						  const void *pImage,								///< (i) image saved by PowerASR_BasicOP_getImage
+						  const hci_int32 nSize								///< (i) image size in bytes
+);
+
 /**
  *	Performs the addition (var1+var2) with overflow control and saturation.
  *	the 16 bit result is set at +32767 when overflow occurs or at -32768 when underflow occurs.
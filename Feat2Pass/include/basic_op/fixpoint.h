@@ -72,6 +72,9 @@ typedef hci_int16 hci_fixed16;
 /** Convert fixed point to floating point. */
 #define FIX2FLOAT_ANY(x,radix) ((hci_float32)(x)/(1<<(radix)))
 #define FIX2FLOAT(x) FIX2FLOAT_ANY(x,DEFAULT_RADIX)
+/** Q15 value of a config parameter: fractions (0.97) are converted, integers (31785) are already Q15. */
+#define CONFIG2Q15(x) \
+	((((x) < 1.0) && ((x) > -1.0)) ? FLOAT2FIX16_ANY(x,15) : (hci_fixed16)(x))
 
 
 #define HCI_ROUND16(a)      ((hci_int16)( ((a) >= 0) ? ((hci_int16)((a) + 0.5)) : ((hci_int16)((a) - 0.5))))
@@ -236,6 +236,10 @@ typedef struct {
     ARData *st;                                 ///< DNN EPD
 	float *refSilFeat;
 	int nSampleRate;
+
+	unsigned long long nTimeNR;			///< ns in noise reduction (base/hci_clock.h), 0 with TRG_NO_STATS
+	unsigned long long nTimeMfcc;		///< ns in wave-to-MFCC conversion
+	unsigned long long nTimeFeat;		///< ns in end-point detection and MFCC-to-feature conversion
 } FrontEnd_UserData;
 
 /**
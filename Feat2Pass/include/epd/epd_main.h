@@ -74,7 +74,7 @@ EPD_detectSpeechBoundary(EPD_UserData *pEpdData,		///< (i/o) : pointer to EPD da
 						 EpdParameters *pEpdVar,		///< (i) : EPD config. variables
 						 hci_epd32 specEntropy,			///< (i) : spectral entropy (Q15.32)
 						 hci_epd32 frameLogEnergy,		///< (i) : log frame energy (Q15.32)
-						 hci_epd32 frameLogPower,		///< (i) : log frame power (Q0.16)
+						 hci_epd16 frameLogPower,		///< (i) : log frame power (Q0.16)
 						 hci_int32 flagNRVad,			///< (i) : VAD output in noise-reduction module
 						 hci_int32 bSpeechFound			///< (i) flag to speech found
 );
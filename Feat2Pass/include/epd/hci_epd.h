@@ -85,6 +85,29 @@ HCILAB_PUBLIC HCI_EPD_API hci_int32
 PowerASR_EPD_closeEPDetector(PowerASR_EPD *pThis		///< (i/o) pointer to the end-point detector
 );
 
+/**
+ *	return the image of the end-point detector set-up, to be saved in a snapshot.
+ *	the image is the inner data struct as it is, valid only for the same build.
+ *
+ *	@return return the image size in bytes, otherwise return -1.
+ */
+HCILAB_PUBLIC HCI_EPD_API hci_int32
+PowerASR_EPD_getImage(PowerASR_EPD *pThis,									///< (i) pointer to the end-point detector
+					  const void **ppImage									///< (o) image of the end-point detector
+);
+
+/**
+ *	set-up environments for end-point detector from an image returned by PowerASR_EPD_getImage,
+ *	instead of the configuration file.
+ *
+ *	@return return 0 if the image is set-up correctly, otherwise return -1.
+ */
+HCILAB_PUBLIC HCI_EPD_API hci_int32
+PowerASR_EPD_openEPDetectorFromImage(PowerASR_EPD *pThis,					///< (i/o) pointer to the end-point detector
+									 const void *pImage,					///< (i) image saved by PowerASR_EPD_getImage
+									 const hci_int32 nSize					///< (i) image size in bytes
+);
+
 /**
  *	initialize data buffers for end-point detector.
  *
@@ -88,6 +88,29 @@ HCILAB_PUBLIC HCI_MFCC2FEAT_API hci_int32
 PowerASR_FX_Mfcc2Feat_closeMfcc2FeatConverter(PowerASR_FX_Mfcc2Feat *pThis	///< (i/o) pointer to the mfcc-to-feature converter
 );
 
+/**
+ *	return the image of the mfcc-to-feature converter set-up, to be saved in a snapshot.
+ *	the image is the inner data struct as it is, valid only for the same build.
+ *
+ *	@return return the image size in bytes, otherwise return -1.
+ */
+HCILAB_PUBLIC HCI_MFCC2FEAT_API hci_int32
+PowerASR_FX_Mfcc2Feat_getImage(PowerASR_FX_Mfcc2Feat *pThis,				///< (i) pointer to the mfcc-to-feature converter
+							   const void **ppImage							///< (o) image of the mfcc-to-feature converter
+);
+
+/**
+ *	set-up environments for mfcc-to-feature converter from an image returned by PowerASR_FX_Mfcc2Feat_getImage,
+ *	instead of the configuration file.
+ *
+ *	@return return 0 if the image is set-up correctly, otherwise return -1.
+ */
+HCILAB_PUBLIC HCI_MFCC2FEAT_API hci_int32
+PowerASR_FX_Mfcc2Feat_openMfcc2FeatConverterFromImage(PowerASR_FX_Mfcc2Feat *pThis,	///< (i/o) pointer to the mfcc-to-feature converter
+													  const void *pImage,	///< (i) image saved by PowerASR_FX_Mfcc2Feat_getImage
+													  const hci_int32 nSize	///< (i) image size in bytes
+);
+
 /**
  *	initialize data buffers for mfcc-to-feature converter.
  *
@@ -0,0 +1,53 @@
+/*
+   pffft_cache : process-wide pffft setups and per-thread work buffers
+
+   A PFFFT_Setup only holds twiddles and factors, it is never written by
+   pffft_transform*(), so one setup per (size, transform type) is shared
+   by every front-end engine and channel. The transform direction is an
+   argument of pffft_transform*(), not part of the setup.
+*/
+
+#ifndef PFFFT_CACHE_H
+#define PFFFT_CACHE_H
+
+#include "pffft.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  /* largest work buffer handed out by pffft_cache_work(), in floats */
+#define PFFFT_CACHE_MAX_WORK 2048
+
+  /*
+     get the shared setup of an N-point transform, creating it on first
+     use. Each successful call must be paired with pffft_cache_release().
+     Returns NULL if N is not supported by pffft.
+  */
+  PFFFT_Setup *pffft_cache_setup(int N, pffft_transform_t transform);
+
+  /* drop a reference taken by pffft_cache_setup(), the last one destroys the setup */
+  void pffft_cache_release(PFFFT_Setup *setup);
+
+  /*
+     aligned work buffer of the calling thread for the 'work' argument of
+     pffft_transform*() on an N-point transform. Valid until the thread
+     exits, not re-entrant within one thread. Returns NULL (pffft then
+     uses its stack buffer) if the transform needs more than
+     PFFFT_CACHE_MAX_WORK floats.
+  */
+  float *pffft_cache_work(int N, pffft_transform_t transform);
+
+  /*
+     z-domain order of the unordered forward transform:
+     ordered[k] == unordered[zorder[k]] for k in [0, N) (2N for complex),
+     i.e. what pffft_zreorder(PFFFT_FORWARD) would do. Computed once per
+     shared setup.
+  */
+  const int *pffft_cache_zorder(PFFFT_Setup *setup);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PFFFT_CACHE_H
@@ -68,6 +68,8 @@ typedef struct {
 	hci_mfcc16 lowerWeight[NB_FFT_SIZE];	///< lower weight of filter banks (Q15.16)
 	hci_int16 lowerChan[NB_FFT_SIZE];		///< lower bin mapping value
 	hci_mfcc16 dctCosTable[DIM_CEPSTRUM*NUM_FILTERBANK];	///< cosine table for DCT
+	hci_mfcc16 dctCosTableT[NUM_FILTERBANK*DIM_CEPSTRUM];	///< transposed cosine table for DCT ([filter][cepstrum], float only)
+	hci_int16 melBinFirst[NUM_FILTERBANK+2];	///< first bin of each lower channel (-1 ~ nNumFilters), float HTK only
 	hci_mfcc16 sineFilter[WIDTH_SINE_FILTER];	///< sine filter in PDPS-based MFCC
 	hci_mfcc16 phs_tbl[BB_FFT_SIZE];		///< phase table for fast FFT computation 
 	hci_mfcc32 weightChannel[NUM_FILTERBANK];	///< weights per channel (Q15.32)
@@ -166,6 +166,7 @@ typedef struct _MFCC_UserData{
 	hci_mfcc_t avgNoisePower;				///< average noise power value (Q15.32)
 	hci_mfcc16 frameEn;						///< log frame power (Q0.16)
 	hci_mfcc16 nPriorSample;				///< prior sample value for pre-emphasis
+	hci_int16 idxPrevBuf;					///< half of prevBuf holding the oldest samples (float HTK only)
 	hci_int16  biasEntropy;					///< bias constant term in entropy computation
 	float averLogEnergy;
 	int cnt_EstiFrames;
@@ -100,6 +100,30 @@ HCILAB_PUBLIC HCI_WAVE2MFCC_API hci_int32
 PowerASR_FX_Wave2Mfcc_closeWave2MfccConverter(PowerASR_FX_Wave2Mfcc *pThis	///< (i/o) pointer to the wave-to-mfcc converter
 );
 
+/**
+ *	return the image of the wave-to-mfcc converter set-up, to be saved in a snapshot.
+ *	the image is the inner data struct as it is, valid only for the same build.
+ *
+ *	@return return the image size in bytes, otherwise return -1.
+ */
+HCILAB_PUBLIC HCI_WAVE2MFCC_API hci_int32
+PowerASR_FX_Wave2Mfcc_getImage(PowerASR_FX_Wave2Mfcc *pThis,				///< (i) pointer to the wave-to-mfcc converter
+							   const void **ppImage							///< (o) image of the wave-to-mfcc converter
+);
+
+/**
+ *	set-up environments for wave-to-mfcc converter from an image returned by PowerASR_FX_Wave2Mfcc_getImage,
+ *	instead of the configuration file.
+ *
+ *	@return return 0 if the image is set-up correctly, otherwise return -1.
+ */
+HCILAB_PUBLIC HCI_WAVE2MFCC_API hci_int32
+PowerASR_FX_Wave2Mfcc_openWave2MfccConverterFromImage(PowerASR_FX_Wave2Mfcc *pThis,	///< (i/o) pointer to the wave-to-mfcc converter
+													  const void *pImage,	///< (i) image saved by PowerASR_FX_Wave2Mfcc_getImage
+													  const hci_int32 nSize,	///< (i) image size in bytes
+													  hci_logadd_t *pLogAddTbl	///< (i) pointer to log-addition table
+);
+
 /**
  *	initialize data buffers for wave-to-mfcc converter.
  *
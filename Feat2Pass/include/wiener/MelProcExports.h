@@ -18,31 +18,54 @@
 
 #define WF_MEL_ORDER        25
 
-// Structure for FFT window (one triangle in the chained list)
-struct MelFB_Window
+#define MELFB_MAX_CHANNELS  32                    // >= WF_MEL_ORDER, NUM_CHANNELS
+#define MELFB_MAX_BINS      (FFT_LENGTH / 2 + 1)  // spectrum bins covered by a filter bank
+#define MELFB_ALIGN         4                     // coefficient rows are padded to 4 floats (16 bytes)
+#define MELFB_ROUNDUP(n)    (((n) + MELFB_ALIGN - 1) / MELFB_ALIGN * MELFB_ALIGN)
+
+#define WF_MEL_IDCT_STRIDE  MELFB_ROUNDUP(WF_MEL_ORDER)   // row length of the mel IDCT basis
+
+// Mel filter bank (all triangles) in one aligned coefficient block.
+// Coefficients of channel i are Data[Offset[i]] .. Data[Offset[i] + Length[i] - 1],
+// applied to FFT bins from StartingPoint[i]; rows are zero padded to MELFB_ALIGN.
+struct MelFB_Bank
 {
-  int StartingPoint;
-  int Length;
+  int NumChannels;
+  int NumBins;                              // last bin used + 1
+  int StartingPoint [MELFB_MAX_CHANNELS];
+  int Length [MELFB_MAX_CHANNELS];
+  int Offset [MELFB_MAX_CHANNELS];
   float *Data;
-  struct MelFB_Window *Next;
-};                                        
+#ifdef FIXED_POINT_FE
+  int *DataFx;                              // Q15 copy of Data (InitMelFBFx), NULL if not made
+#endif
+};
 
 
-MelFB_Window *CMelFBAlloc ();
+MelFB_Bank *CMelFBAlloc ();
 
-void InitMelFBwindows (MelFB_Window * FirstWin, float StFreq, float SmplFreq, int FFTLength, int NumChannels, ETSI_BOOL normalize);
-void InitFFTWindows (MelFB_Window *FirstWin,
+void InitMelFBwindows (MelFB_Bank *Bank, float StFreq, float SmplFreq, int FFTLength, int NumChannels, ETSI_BOOL normalize);
+void InitFFTWindows (MelFB_Bank *Bank,
 					 float StFreq,
 					 float SmplFreq,
 					 int FFTLength,
 					 int NumChannels);
-void ComputeTriangle (MelFB_Window * FirstWin);
+void ComputeTriangle (MelFB_Bank *Bank);
 
-void DoMelFB (float *SigFFT, MelFB_Window * FirstWin);
+void DoMelFB (float *SigFFT, const MelFB_Bank *Bank);
 
-void ReleaseMelFBwindows (MelFB_Window *FirstWin);
+void ReleaseMelFBwindows (MelFB_Bank *Bank);
 
-void DoMelIDCT (float *inData, float **melIDCTbasis, int melOrder, int timeLength);
-void InitMelIDCTbasis (float **melIDCTbasis, MelFB_Window *FirstWin, short melorder, int sampFreq, int FFTLength);
+// melIDCTbasis: aligned [melOrder][MELFB_ROUNDUP(timeLength)] block, stored frequency-major
+void DoMelIDCT (float *inData, const float *melIDCTbasis, int melOrder, int timeLength);
+void InitMelIDCTbasis (float *melIDCTbasis, const MelFB_Bank *Bank, short melorder, int sampFreq, int FFTLength);
+
+#ifdef FIXED_POINT_FE
+// fixed-point variants : Q15 coefficients, Q15 input and output
+void InitMelFBFx (MelFB_Bank *Bank);
+void DoMelFBFx (int *SigFFT, const MelFB_Bank *Bank);
+void InitMelIDCTbasisFx (int *melIDCTbasisFx, const float *melIDCTbasis, int melOrder, int timeLength);
+void DoMelIDCTFx (int *inData, const int *melIDCTbasisFx, int melOrder, int timeLength);
+#endif
 
 #endif
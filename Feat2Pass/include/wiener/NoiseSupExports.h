@@ -20,7 +20,7 @@
 
 extern NoiseSupStructX *DoNoiseSupAlloc (void) ;
 extern void             DoNoiseSupInit (FEParamsX *This) ;
-extern ETSI_BOOL        DoNoiseSup (const X_FLOAT32 *InData, X_FLOAT32 *OutData, FEParamsX *This);
+extern ETSI_BOOL        DoNoiseSup (const NS_SAMPLE *InData, NS_SAMPLE *OutData, FEParamsX *This);
 extern void             DoNoiseSupDelete (NoiseSupStructX *NSX) ;
 
 #endif
@@ -51,6 +51,16 @@
 
 #define PIx2               6.28318530717958647692
 
+/*------------------------------------------------------
+ * Samples in and out of the noise suppression : Q0
+ * integers in the fixed-point build (FIXED_POINT_FE)
+ *------------------------------------------------------*/
+#ifdef FIXED_POINT_FE
+typedef X_INT32   NS_SAMPLE;
+#else	// !FIXED_POINT_FE
+typedef X_FLOAT32 NS_SAMPLE;
+#endif	// #ifdef FIXED_POINT_FE
+
 #ifndef _defined_AFE_VAD
 
 #define		NUM_VAD_CHAN		23
@@ -110,7 +120,7 @@ typedef struct {
  * SNR waveform processing, cepstrum calculation, ...)
  *------------------------------------------------------*/
 typedef struct NoiseSupStructX NoiseSupStructX;
-typedef struct MelFB_Window    MelFB_Window;
+typedef struct MelFB_Bank      MelFB_Bank;
 
 /*------------------------------------------------------
  * FEParamsX must (only) contains:
@@ -128,7 +138,6 @@ typedef struct MelFB_Window    MelFB_Window;
  *------------------------------------------------------*/
 
 typedef struct FEParamsX FEParamsX;
-typedef struct PFFFT_Setup PFFFT_Setup;
 
 struct FEParamsX
 {
@@ -157,9 +166,9 @@ struct FEParamsX
   long ZeroFrameCounter;	//
 
   BufferIn *denoisedBuf;	//
-  X_FLOAT32 *CurFrame;	    //
+  NS_SAMPLE *CurFrame;	    //
 
-  MelFB_Window *FirstWindow;       //
+  MelFB_Bank *FirstWindow;         //
 
   AFE_VAD_DATA dataVAD;
 
@@ -178,8 +187,8 @@ struct FEParamsX
    *-----------------------*/
   NoiseSupStructX* (*DoNoiseSupAlloc) (void);
   void (*DoNoiseSupInit) (FEParamsX *this);
-  ETSI_BOOL (*DoNoiseSup) (X_FLOAT32 *InData,
-						   X_FLOAT32 *outData,
+  ETSI_BOOL (*DoNoiseSup) (const NS_SAMPLE *InData,
+						   NS_SAMPLE *outData,
 						   FEParamsX *this);
   void (*DoNoiseSupDelete) (NoiseSupStructX*);
 
@@ -206,10 +215,13 @@ struct FEParamsX
    * For GSM high-pass filtering to remove low-frequency noise components, e.g., car noises
    */
   
+#ifdef FIXED_POINT_FE
+  X_INT32 GSM_HPF_A_Buf[3];		// output history, Q8
+  X_INT32 GSM_HPF_B_Buf[3];		// input history, Q0
+#else	// !FIXED_POINT_FE
   X_FLOAT32 GSM_HPF_A_Buf[3];
   X_FLOAT32 GSM_HPF_B_Buf[3];
-  
-  PFFFT_Setup* fft_setup;
+#endif	// #ifdef FIXED_POINT_FE
 };
 
 #define _defined_FEParamsX
@@ -90,6 +90,29 @@ HCILAB_PUBLIC HCI_WIENER_API hci_int32
 PowerASR_NR_Wiener_closeWienerNR(PowerASR_NR_Wiener *pThis		///< (i/o) pointer to the Wiener noise reducer
 );
 
+/**
+ *	return the image of the Wiener noise reducer set-up, to be saved in a snapshot.
+ *	the image is the inner data struct as it is, valid only for the same build.
+ *
+ *	@return return the image size in bytes, otherwise return -1.
+ */
+HCILAB_PUBLIC HCI_WIENER_API hci_int32
+PowerASR_NR_Wiener_getImage(PowerASR_NR_Wiener *pThis,						///< (i) pointer to the Wiener noise reducer
+							const void **ppImage							///< (o) image of the Wiener noise reducer
+);
+
+/**
+ *	set-up environments for Wiener noise reducer from an image returned by PowerASR_NR_Wiener_getImage,
+ *	instead of the configuration file.
+ *
+ *	@return return 0 if the image is set-up correctly, otherwise return -1.
+ */
+HCILAB_PUBLIC HCI_WIENER_API hci_int32
+PowerASR_NR_Wiener_openWienerNRFromImage(PowerASR_NR_Wiener *pThis,			///< (i/o) pointer to the Wiener noise reducer
+										 const void *pImage,				///< (i) image saved by PowerASR_NR_Wiener_getImage
+										 const hci_int32 nSize				///< (i) image size in bytes
+);
+
 /**
  *	initialize data buffers for Wiener noise reducer.
  *
@@ -110,6 +133,19 @@ PowerASR_NR_Wiener_releaseWienerNR(PowerASR_NR_Wiener *pThis,		///< (i) pointer
 								   Wiener_UserData *pUserData		///< (o) channel-specific Wiener data
 );
 
+/**
+ *	select the noise reduction mode of a channel.
+ *	the Wiener filter states are re-initialized when noise reduction is switched on or
+ *	between single/two-stage, so a few frames of NR latency are re-introduced.
+ *
+ *	@return Return 0 if the mode is set, otherwise return -1.
+ */
+HCILAB_PUBLIC HCI_WIENER_API hci_int32
+PowerASR_NR_Wiener_setNRMode(PowerASR_NR_Wiener *pThis,		///< (i) pointer to the Wiener noise reducer
+							 Wiener_UserData *pUserData,	///< (i/o) channel-specific Wiener data
+							 const hci_int32 nNRMode		///< (i) noise reduction mode (NR_Mode)
+);
+
 /**
  *	produce noise-reduced samples from a noisy input frame buffer.
  *
@@ -32,6 +32,13 @@ typedef	double		hci_wie64;
 #define	hci_wie16_defined
 #endif	// #ifndef hci_wie16_defined
 
+/** noise reduction mode of a channel */
+typedef enum {
+	NR_MODE_OFF = 0,				///< bypass, input frame is passed through unchanged
+	NR_MODE_SINGLE_STAGE,			///< 1st-stage Wiener filter only
+	NR_MODE_TWO_STAGE				///< ETSI two-stage Wiener filter (default)
+} NR_Mode;
+
 /** Wiener data struct for each user/channel */
 typedef struct _Wiener_UserData
 {
@@ -39,6 +46,8 @@ typedef struct _Wiener_UserData
 	hci_int32 flagVAD;				///< VAD flag (0 == silence, 1 = unvoiced, 2 = mixed, 3 = voiced)
 	hci_int32 bSpeechFound;			///< flag to speech found
 	hci_float32 specEntropy;		///< mel spectral entropy
+	hci_int32 nNRMode;				///< noise reduction mode (NR_Mode)
+	hci_int32 bSpeechVAD;			///< energy VAD of the noise suppressor (1 == speech, always 1 when NR is off)
 } Wiener_UserData;
 
 #endif // #ifndef __WIENER_COMMON_H__
@@ -31,6 +31,9 @@
 #include "base/hci_msg.h"
 
 
+static hci_alloc_hook alloc_hook = 0;
+
+
 /**
  * The following functions are similar to the malloc family, except that they have
  * two additional parameters, caller_file and caller_line, for error reporting.
@@ -45,6 +48,7 @@ __hci_calloc__(size_t n_elem,
 {
     void *mem = 0;
 
+	if (alloc_hook)	alloc_hook(n_elem * elem_size);
     if ((mem = calloc(n_elem, elem_size)) == NULL) {
         HCIMSG_ERROR("calloc(%d,%d) failed from %s(%d)\n", n_elem,
                 elem_size, caller_file, caller_line);
@@ -60,6 +64,7 @@ __hci_malloc__(size_t size,
 {
     void *mem = 0;
 
+	if (alloc_hook)	alloc_hook(size);
     if ((mem = malloc(size)) == NULL) {
         HCIMSG_ERROR("malloc(%d) failed from %s(%d)\n", size,
                 caller_file, caller_line);
@@ -76,6 +81,7 @@ __hci_realloc__(void *ptr,
 {
     void *mem = 0;
 
+	if (alloc_hook)	alloc_hook(new_size);
     if ((mem = realloc(ptr, new_size)) == NULL) {
         HCIMSG_ERROR("realloc(%d) failed from %s(%d)\n", new_size,
                 caller_file, caller_line);
@@ -276,4 +282,14 @@ hci_free_3d(void ***ptr)
 }
 
 
+/**
+ * Allocation accounting hook, NULL to switch it off
+ */
+HCILAB_PUBLIC HCI_BASE_API void
+hci_set_alloc_hook(hci_alloc_hook hook)
+{
+	alloc_hook = hook;
+}
+
+
 // end of file
\ No newline at end of file
@@ -140,6 +140,56 @@ PowerASR_EPD_closeEPDetector(PowerASR_EPD *pThis)		///< (i/o) pointer to the end
 }
 
 
+/**
+ *	return the image of the end-point detector set-up, to be saved in a snapshot.
+ *	the image is the inner data struct as it is, valid only for the same build.
+ *
+ *	@return return the image size in bytes, otherwise return -1.
+ */
+HCILAB_PUBLIC HCI_EPD_API hci_int32
+PowerASR_EPD_getImage(PowerASR_EPD *pThis,									///< (i) pointer to the end-point detector
+					  const void **ppImage)									///< (o) image of the end-point detector
+{
+	if (0 == pThis || 0 == ppImage) {
+		return -1;
+	}
+
+	*ppImage = pThis->pInner;
+
+	return (hci_int32)sizeof(EPD_Inner);
+}
+
+
+/**
+ *	set-up environments for end-point detector from an image returned by PowerASR_EPD_getImage,
+ *	instead of the configuration file.
+ *
+ *	@return return 0 if the image is set-up correctly, otherwise return -1.
+ */
+HCILAB_PUBLIC HCI_EPD_API hci_int32
+PowerASR_EPD_openEPDetectorFromImage(PowerASR_EPD *pThis,					///< (i/o) pointer to the end-point detector
+									 const void *pImage,					///< (i) image saved by PowerASR_EPD_getImage
+									 const hci_int32 nSize)					///< (i) image size in bytes
+{
+	EPD_Inner *pInner = 0;
+
+	if (0 == pThis || 0 == pImage) {
+		return -1;
+	}
+
+	if (nSize != (hci_int32)sizeof(EPD_Inner)) {
+		HCIMSG_ERROR("image size mismatch (%d, %d).\n", nSize, (hci_int32)sizeof(EPD_Inner));
+		return -1;
+	}
+
+	pInner = (EPD_Inner *) pThis->pInner;
+
+	memcpy(pInner, pImage, sizeof(EPD_Inner));
+
+	return 0;
+}
+
+
 /**
  *	initialize data buffers for end-point detector.
  *
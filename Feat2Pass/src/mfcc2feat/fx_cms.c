@@ -35,6 +35,29 @@
 #define CMN_WIN_FULL	(hci_int16)(2*CMN_WIN)		///< window length to update feature normalization vectors in VAD-dependent mode
 #define CMN_UPDATE_COUNT	(hci_int16)3000			///< maximum window length for updating feature normalization vectors to prevent overflows !!!
 
+// local functions
+#ifdef __cplusplus
+extern "C" {
+#endif 
+
+/**
+ *	read feature normalization vectors from a binary file (float values in both builds)
+ */
+HCILAB_PRIVATE hci_int32
+_FX_CMS_readFeatNormalizer(FEAT_Normalizer *pFeatNorm,		///< (o) feature normalizer
+						   FILE *fpCMV);					///< (i) feature normalization data file
+
+/**
+ *	write feature normalization vectors to a binary file (float values in both builds)
+ */
+HCILAB_PRIVATE hci_int32
+_FX_CMS_writeFeatNormalizer(FEAT_Normalizer *pFeatNorm,		///< (i) feature normalizer
+							FILE *fpCMV);					///< (o) feature normalization data file
+
+#ifdef __cplusplus
+}
+#endif
+
 /**
  *	load seed cepstral mean vector & max log-energy
  */
@@ -177,8 +200,7 @@ FX_CMS_loadCmsProfileList(
 				return -1;
 			}
 
-			size_t ret = fread(&pSeedFeatNorm_ForCmsProfileType[n], sizeof(FEAT_Normalizer), 1, fpCMV);
-			if (1 != ret) {
+			if (_FX_CMS_readFeatNormalizer(&pSeedFeatNorm_ForCmsProfileType[n], fpCMV) != 0) {
 				HCIMSG_ERROR("failed to load feature normalization vectors.\n");
 				fclose(fpCMV);
 				return -1;
@@ -295,7 +317,7 @@ FX_CMS_loadSeedCepstralMeanVector(FEAT_Normalizer *pSeedFeatNorm,	///< (o) featu
 		return -1;
 	}
 
-	if (fread(pSeedFeatNorm, sizeof(FEAT_Normalizer), 1, fpCMV) != 1) {
+	if (_FX_CMS_readFeatNormalizer(pSeedFeatNorm, fpCMV) != 0) {
 		HCIMSG_ERROR("failed to load feature normalization vectors.\n");
 		fclose(fpCMV);
 		return -1;
@@ -368,7 +390,7 @@ FX_CMS_saveCepstralMeanVector(FEAT_Normalizer *pFeatNorm,			///< (i) feature nor
 		return -1;
 	}
 
-	fwrite(pFeatNorm, sizeof(FEAT_Normalizer), 1, fpCMV);
+	_FX_CMS_writeFeatNormalizer(pFeatNorm, fpCMV);
 	
 	fclose(fpCMV);
 
@@ -1766,25 +1788,52 @@ FX_CMS_updateCepstralMeanVector(MFCC_Stream *pMfccStream, 		///< (i/o) pointer t
 
 
 /* end of file */
+/**
+ *	read feature normalization vectors from a binary file
+ *	- the file holds float values, the fixed-point build converts them to Q15.32
+ */
+HCILAB_PRIVATE hci_int32
+_FX_CMS_readFeatNormalizer(FEAT_Normalizer *pFeatNorm,		///< (o) feature normalizer
+						   FILE *fpCMV)						///< (i) feature normalization data file
+{
+#ifdef FIXED_POINT_FE
+	hci_float32 val[sizeof(FEAT_Normalizer)/sizeof(hci_mfcc_t)];
+	hci_mfcc_t *pOut = (hci_mfcc_t *)pFeatNorm;
+	size_t i = 0;
 
+	if (fread(val, sizeof(val), 1, fpCMV) != 1) {
+		return -1;
+	}
+	for (i = 0; i < sizeof(val)/sizeof(val[0]); i++) {
+		pOut[i] = (hci_mfcc_t)floor(val[i] * 32768.0 + 0.5);		// Q15.32
+	}
 
+	return 0;
+#else	// !FIXED_POINT_FE
+	return (fread(pFeatNorm, sizeof(FEAT_Normalizer), 1, fpCMV) == 1) ? 0 : -1;
+#endif	// #ifdef FIXED_POINT_FE
+}
 
 
+/**
+ *	write feature normalization vectors to a binary file
+ *	- the file holds float values, the fixed-point build converts them from Q15.32
+ */
+HCILAB_PRIVATE hci_int32
+_FX_CMS_writeFeatNormalizer(FEAT_Normalizer *pFeatNorm,		///< (i) feature normalizer
+							FILE *fpCMV)					///< (o) feature normalization data file
+{
+#ifdef FIXED_POINT_FE
+	hci_float32 val[sizeof(FEAT_Normalizer)/sizeof(hci_mfcc_t)];
+	const hci_mfcc_t *pIn = (const hci_mfcc_t *)pFeatNorm;
+	size_t i = 0;
 
+	for (i = 0; i < sizeof(val)/sizeof(val[0]); i++) {
+		val[i] = (hci_float32)pIn[i] / 32768.0f;
+	}
 
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
+	return (fwrite(val, sizeof(val), 1, fpCMV) == 1) ? 0 : -1;
+#else	// !FIXED_POINT_FE
+	return (fwrite(pFeatNorm, sizeof(FEAT_Normalizer), 1, fpCMV) == 1) ? 0 : -1;
+#endif	// #ifdef FIXED_POINT_FE
+}
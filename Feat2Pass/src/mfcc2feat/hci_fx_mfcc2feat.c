@@ -171,6 +171,56 @@ PowerASR_FX_Mfcc2Feat_closeMfcc2FeatConverter(PowerASR_FX_Mfcc2Feat *pThis)	///<
 }
 
 
+/**
+ *	return the image of the mfcc-to-feature converter set-up, to be saved in a snapshot.
+ *	the image is the inner data struct as it is, valid only for the same build.
+ *
+ *	@return return the image size in bytes, otherwise return -1.
+ */
+HCILAB_PUBLIC HCI_MFCC2FEAT_API hci_int32
+PowerASR_FX_Mfcc2Feat_getImage(PowerASR_FX_Mfcc2Feat *pThis,				///< (i) pointer to the mfcc-to-feature converter
+							   const void **ppImage)						///< (o) image of the mfcc-to-feature converter
+{
+	if (0 == pThis || 0 == ppImage) {
+		return -1;
+	}
+
+	*ppImage = pThis->pInner;
+
+	return (hci_int32)sizeof(FX_Mfcc2Feat_Inner);
+}
+
+
+/**
+ *	set-up environments for mfcc-to-feature converter from an image returned by PowerASR_FX_Mfcc2Feat_getImage,
+ *	instead of the configuration file.
+ *
+ *	@return return 0 if the image is set-up correctly, otherwise return -1.
+ */
+HCILAB_PUBLIC HCI_MFCC2FEAT_API hci_int32
+PowerASR_FX_Mfcc2Feat_openMfcc2FeatConverterFromImage(PowerASR_FX_Mfcc2Feat *pThis,	///< (i/o) pointer to the mfcc-to-feature converter
+													  const void *pImage,	///< (i) image saved by PowerASR_FX_Mfcc2Feat_getImage
+													  const hci_int32 nSize)	///< (i) image size in bytes
+{
+	FX_Mfcc2Feat_Inner *pInner = 0;
+
+	if (0 == pThis || 0 == pImage) {
+		return -1;
+	}
+
+	if (nSize != (hci_int32)sizeof(FX_Mfcc2Feat_Inner)) {
+		HCIMSG_ERROR("image size mismatch (%d, %d).\n", nSize, (hci_int32)sizeof(FX_Mfcc2Feat_Inner));
+		return -1;
+	}
+
+	pInner = (FX_Mfcc2Feat_Inner *) pThis->pInner;
+
+	memcpy(pInner, pImage, sizeof(FX_Mfcc2Feat_Inner));
+
+	return 0;
+}
+
+
 /**
  *	initialize data buffers for mfcc-to-feature converter.
  *
@@ -1181,7 +1231,7 @@ _FX_Mfcc2Feat_loadConfigurations(PowerASR_FX_Mfcc2Feat *pThis,
 		pszValue = PowerASR_Base_getArgumentValue("FORGET_FACTOR_VOICE");
 		if (pszValue) {
 #ifdef FIXED_POINT_FE
-			pFXVar->forgetF_Voice = (hci_mfcc16)atoi(pszValue);
+			pFXVar->forgetF_Voice = (hci_mfcc16)CONFIG2Q15(atof(pszValue));
 #else	// !FIXED_POINT_FE
 			pFXVar->forgetF_Voice = (hci_mfcc16)atof(pszValue);
 #endif	// #ifdef FIXED_POINT_FE
@@ -1195,7 +1245,7 @@ _FX_Mfcc2Feat_loadConfigurations(PowerASR_FX_Mfcc2Feat *pThis,
 		pszValue = PowerASR_Base_getArgumentValue("FORGET_FACTOR_UNVOICE");
 		if (pszValue) {
 #ifdef FIXED_POINT_FE
-			pFXVar->forgetF_Unvoice = (hci_mfcc16)atoi(pszValue);
+			pFXVar->forgetF_Unvoice = (hci_mfcc16)CONFIG2Q15(atof(pszValue));
 #else	// !FIXED_POINT_FE
 			pFXVar->forgetF_Unvoice = (hci_mfcc16)atof(pszValue);
 #endif	// #ifdef FIXED_POINT_FE
@@ -0,0 +1,131 @@
+/*
+   pffft_cache : process-wide pffft setups and per-thread work buffers
+*/
+
+#include <stdlib.h>
+#include <assert.h>
+
+#include "pffft_cache.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+static SRWLOCK g_cache_lock = SRWLOCK_INIT;
+#define CACHE_LOCK() AcquireSRWLockExclusive(&g_cache_lock)
+#define CACHE_UNLOCK() ReleaseSRWLockExclusive(&g_cache_lock)
+#else
+#include <pthread.h>
+static pthread_mutex_t g_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+#define CACHE_LOCK() pthread_mutex_lock(&g_cache_lock)
+#define CACHE_UNLOCK() pthread_mutex_unlock(&g_cache_lock)
+#endif
+
+#if defined(_MSC_VER)
+#define THREAD_LOCAL_ALIGNED_(x) __declspec(thread) __declspec(align(x))
+#else
+#define THREAD_LOCAL_ALIGNED_(x) __thread __attribute__ ((aligned(x)))
+#endif
+
+/* the front end uses a couple of sizes (NR 256, MFCC 256/512) */
+#define PFFFT_CACHE_ENTRIES 8
+
+typedef struct {
+  int N;
+  pffft_transform_t transform;
+  int refs;
+  PFFFT_Setup *setup;
+  int *zorder;
+} pffft_cache_entry;
+
+static pffft_cache_entry g_cache[PFFFT_CACHE_ENTRIES];
+
+static THREAD_LOCAL_ALIGNED_(64) float g_work[PFFFT_CACHE_MAX_WORK];
+
+
+PFFFT_Setup *pffft_cache_setup(int N, pffft_transform_t transform) {
+  PFFFT_Setup *setup = 0;
+  int i, slot = -1;
+
+  CACHE_LOCK();
+  for (i = 0; i < PFFFT_CACHE_ENTRIES; ++i) {
+    if (g_cache[i].refs > 0 && g_cache[i].N == N && g_cache[i].transform == transform) {
+      g_cache[i].refs++;
+      setup = g_cache[i].setup;
+      break;
+    }
+    if (g_cache[i].refs == 0 && slot < 0) slot = i;
+  }
+  if (!setup) {
+    setup = pffft_new_setup(N, transform);
+    if (setup && slot >= 0) {
+      g_cache[slot].N = N;
+      g_cache[slot].transform = transform;
+      g_cache[slot].refs = 1;
+      g_cache[slot].setup = setup;
+      g_cache[slot].zorder = 0;
+    }
+    /* cache full: a private setup, pffft_cache_release() destroys it */
+  }
+  CACHE_UNLOCK();
+
+  return setup;
+}
+
+void pffft_cache_release(PFFFT_Setup *setup) {
+  int i;
+
+  if (!setup) return;
+
+  CACHE_LOCK();
+  for (i = 0; i < PFFFT_CACHE_ENTRIES; ++i) {
+    if (g_cache[i].refs > 0 && g_cache[i].setup == setup) {
+      if (--g_cache[i].refs == 0) {
+        pffft_destroy_setup(g_cache[i].setup);
+        free(g_cache[i].zorder);
+        g_cache[i].setup = 0;
+        g_cache[i].zorder = 0;
+      }
+      break;
+    }
+  }
+  if (i == PFFFT_CACHE_ENTRIES) pffft_destroy_setup(setup);
+  CACHE_UNLOCK();
+}
+
+float *pffft_cache_work(int N, pffft_transform_t transform) {
+  int nfloats = (transform == PFFFT_REAL) ? N : 2*N;
+  return (nfloats <= PFFFT_CACHE_MAX_WORK) ? g_work : 0;
+}
+
+const int *pffft_cache_zorder(PFFFT_Setup *setup) {
+  const int *zorder = 0;
+  int i, k;
+
+  CACHE_LOCK();
+  for (i = 0; i < PFFFT_CACHE_ENTRIES; ++i) {
+    pffft_cache_entry *e = &g_cache[i];
+    if (e->refs > 0 && e->setup == setup) {
+      if (!e->zorder) {
+        /* push the index ramp through the reorder step to read off the permutation */
+        int n = (e->transform == PFFFT_REAL) ? e->N : 2*e->N;
+        float *ramp = (float*)pffft_aligned_malloc(n * sizeof(float));
+        float *ordered = (float*)pffft_aligned_malloc(n * sizeof(float));
+        e->zorder = (int*)malloc(n * sizeof(int));
+        if (ramp && ordered && e->zorder) {
+          for (k = 0; k < n; ++k) ramp[k] = (float)k;
+          pffft_zreorder(setup, ramp, ordered, PFFFT_FORWARD);
+          for (k = 0; k < n; ++k) e->zorder[k] = (int)ordered[k];
+        } else {
+          free(e->zorder);
+          e->zorder = 0;
+        }
+        pffft_aligned_free(ramp);
+        pffft_aligned_free(ordered);
+      }
+      zorder = e->zorder;
+      break;
+    }
+  }
+  CACHE_UNLOCK();
+
+  return zorder;
+}
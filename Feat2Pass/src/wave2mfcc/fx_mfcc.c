@@ -24,7 +24,7 @@
 #include <math.h>
 #include <string.h>
 
-#include "pffft.h"
+#include "pffft_cache.h"
 
 #include "base/hci_type.h"
 #include "base/hci_msg.h"
@@ -44,6 +44,56 @@
 #define ALIGNED_(x)
 #endif
 
+// vector macros of the fused float HTK path (same as pffft.c),
+// define FX_MFCC_SIMD_DISABLE to use scalar code
+//#define FX_MFCC_SIMD_DISABLE
+#if !defined(FIXED_POINT_FE) && !defined(FX_MFCC_SIMD_DISABLE) && (defined(__x86_64__) || defined(_M_X64) || defined(i386) || defined(_M_IX86))
+#include <xmmintrin.h>
+typedef __m128 v4sf;
+#  define SIMD_SZ 4
+#  define VZERO() _mm_setzero_ps()
+#  define VADD(a,b) _mm_add_ps(a,b)
+#  define VSUB(a,b) _mm_sub_ps(a,b)
+#  define VMUL(a,b) _mm_mul_ps(a,b)
+#  define VSQRT(a) _mm_sqrt_ps(a)
+#  define LD_PS1(f) _mm_set1_ps(f)
+#  define VLOAD(p) _mm_load_ps(p)
+#  define VLOADU(p) _mm_loadu_ps(p)
+#  define VSTORE(p,v) _mm_store_ps(p,v)
+#  define VSTOREU(p,v) _mm_storeu_ps(p,v)
+#  define VLOAD_CPLX(p,re,im) { v4sf lo_ = _mm_loadu_ps(p), hi_ = _mm_loadu_ps((p)+4); \
+		re = _mm_shuffle_ps(lo_, hi_, _MM_SHUFFLE(2,0,2,0)); im = _mm_shuffle_ps(lo_, hi_, _MM_SHUFFLE(3,1,3,1)); }
+#elif !defined(FIXED_POINT_FE) && !defined(FX_MFCC_SIMD_DISABLE) && defined(__ARM_NEON)
+#include <arm_neon.h>
+typedef float32x4_t v4sf;
+#  define SIMD_SZ 4
+#  define VZERO() vdupq_n_f32(0)
+#  define VADD(a,b) vaddq_f32(a,b)
+#  define VSUB(a,b) vsubq_f32(a,b)
+#  define VMUL(a,b) vmulq_f32(a,b)
+#  define VSQRT(a) vsqrtq_f32(a)
+#  define LD_PS1(f) vdupq_n_f32(f)
+#  define VLOAD(p) vld1q_f32(p)
+#  define VLOADU(p) vld1q_f32(p)
+#  define VSTORE(p,v) vst1q_f32(p,v)
+#  define VSTOREU(p,v) vst1q_f32(p,v)
+#  define VLOAD_CPLX(p,re,im) { float32x4x2_t c_ = vld2q_f32(p); re = c_.val[0]; im = c_.val[1]; }
+#else
+typedef float v4sf;
+#  define SIMD_SZ 1
+#  define VZERO() 0.f
+#  define VADD(a,b) ((a)+(b))
+#  define VSUB(a,b) ((a)-(b))
+#  define VMUL(a,b) ((a)*(b))
+#  define VSQRT(a) ((float)sqrt(a))
+#  define LD_PS1(f) (f)
+#  define VLOAD(p) (*(p))
+#  define VLOADU(p) (*(p))
+#  define VSTORE(p,v) (*(p) = (v))
+#  define VSTOREU(p,v) (*(p) = (v))
+#  define VLOAD_CPLX(p,re,im) { re = (p)[0]; im = (p)[1]; }
+#endif
+
 // local functions
 #ifdef __cplusplus
 extern "C" {
@@ -57,6 +107,49 @@ _FX_Wave2Mfcc_checkAllZeroSamples(hci_int16 *pFrameBuf,		///< In : frame sample
 								  hci_int16 nFrameLen		///< In : frame length in sample count
 );
 
+/**
+ *	Convert one frame of samples to a mel power spectrum (generic path)
+ */
+HCILAB_PRIVATE hci_int32
+_FX_Wave2Mfcc_computeMelSpectrum(MfccParameters *pMfccVar,	///< In : structure for feature-extraction environments
+								 MFCC_UserData *pMfccData,	///< In/Out : temporary/output data of feature extraction
+								 hci_int16 *pFrameBuf,		///< In : a single frame sample buffer
+								 hci_mfcc32 *melSpecPower,	///< Out : mel-frequency spectral power
+								 hci_mfcc32 *pLogPower,		///< Out : log frame power
+								 hci_int16 *pVarShift		///< Out : left shift count of FFT outputs
+);
+
+#ifndef FIXED_POINT_FE
+
+/**
+ *	build tables for the fused float path (mel bin ranges, transposed DCT matrix)
+ */
+HCILAB_PRIVATE void
+_FX_Wave2Mfcc_buildFusedTables(MfccParameters *pMfccVar		///< In/Out : structure for feature-extraction environments
+);
+
+/**
+ *	Convert one frame of samples to a HTK mel power spectrum in fused float kernels
+ */
+HCILAB_PRIVATE hci_int32
+_FX_Wave2Mfcc_fuseFrameToHTKMelSpectrum(MfccParameters *pMfccVar,	///< In : structure for feature-extraction environments
+										MFCC_UserData *pMfccData,	///< In/Out : temporary/output data of feature extraction
+										hci_int16 *pFrameBuf,		///< In : a single frame sample buffer
+										hci_mfcc32 *melSpecPower,	///< Out : mel-frequency spectral power
+										hci_mfcc32 *pLogPower		///< Out : log frame power
+);
+
+/**
+ *	DCT of mel spectrum as a small matrix-vector product over the transposed cosine table
+ */
+HCILAB_PRIVATE void
+_FX_Wave2Mfcc_melSpectrum2MFCC(hci_mfcc_t *pCepVec,			///< Out : cepstrum vector
+							   hci_mfcc32 *melSpecPower,	///< In : mel-freq. spectrum power
+							   MfccParameters *pMfccVar		///< In : structure for feature-extraction environments
+);
+
+#endif	// #ifndef FIXED_POINT_FE
+
 #ifdef __cplusplus
 }
 #endif
@@ -73,7 +166,7 @@ FX_Wave2Mfcc_buildFeatureExtractor(MfccParameters *pMfccVar)		///< (i/o) structu
 #ifdef FIXED_POINT_FE
 	FX_SigProc_createFFTConstants(pMfccVar);
 #else	// !FIXED_POINT_FE
-	pMfccVar->fftSetup = pffft_new_setup(pMfccVar->nFFTSize, PFFFT_REAL);
+	pMfccVar->fftSetup = pffft_cache_setup(pMfccVar->nFFTSize, PFFFT_REAL);	// shared by all channels
 	pMfccVar->fres = (hci_mfcc16)pMfccVar->nSampleRate / (pMfccVar->nFFTSize*700);
 #endif	// #ifdef FIXED_POINT_FE
 
@@ -83,6 +176,10 @@ FX_Wave2Mfcc_buildFeatureExtractor(MfccParameters *pMfccVar)		///< (i/o) structu
 
 	FX_SigProc_createDCTCosineTable(pMfccVar);
 
+#ifndef FIXED_POINT_FE
+	_FX_Wave2Mfcc_buildFusedTables(pMfccVar);
+#endif	// #ifndef FIXED_POINT_FE
+
 	if (pMfccVar->nMFCCType == PDPS_MFCC) {
 		FX_SigProc_createSineFilter(pMfccVar);
 	}
@@ -101,131 +198,26 @@ FX_Wave2Mfcc_convertSingleFrameToMfccVector(MfccParameters *pMfccVar,	///< (i) s
 											hci_int16 *pFrameBuf,		///< (i/o) a single frame sample buffer
 											const hci_int16 flagVAD)	///< (i) VAD flag (0 = unvoiced, 1 = voiced)
 {
-	hci_int16 *pRawBuf = 0;
-	hci_int16 *pLastBuf = 0;
-	hci_mfcc16 *pInBuf = 0;
 	hci_int16 var_shift = 0;
 	hci_int16 idFrame = 0;
 	hci_mfcc32 nLogPower = 0;
 	float minMaxDiffEnergy = 0.0f;
-	hci_mfcc16 inBuf[BB_FRAME_SHIFT];
-	hci_mfcc16 ALIGNED_(MFCC_ALN) xfft_in[BB_FFT_SIZE];			// input of FFT
-	hci_mfcc16 ALIGNED_(MFCC_ALN) xfft_out[BB_FFT_SIZE];		// output of FFT
 	hci_mfcc32 melSpecPower[NUM_FILTERBANK];	// mel-frequency spectral power (Q15.32)
 
 	// check all-zero sample frame.
 	_FX_Wave2Mfcc_checkAllZeroSamples(pFrameBuf, pMfccVar->nFrameShift);
 
-	// frame buffering
-	memset(inBuf, 0, sizeof(inBuf));
-#ifdef FIXED_POINT_FE
-	memcpy(inBuf, pFrameBuf, (size_t)pMfccVar->nFrameShift*sizeof(hci_int16));
-#else	// !FIXED_POINT_FE
-	pRawBuf = pFrameBuf;
-	pLastBuf = pRawBuf + pMfccVar->nFrameShift;
-	pInBuf = inBuf;
-	while (pRawBuf < pLastBuf) {
-		*pInBuf++ = (hci_mfcc16)(*pRawBuf++);
-		*pInBuf++ = (hci_mfcc16)(*pRawBuf++);
-		*pInBuf++ = (hci_mfcc16)(*pRawBuf++);
-		*pInBuf++ = (hci_mfcc16)(*pRawBuf++);
-	}
-#endif	// #ifdef FIXED_POINT_FE
-
-	// pre-emphasis
-	FX_SigProc_preEmphasize(inBuf,
-							&(pMfccData->nPriorSample),
-							pMfccVar->PreEmphasis,
-							pMfccVar->nFrameShift);
-
-	// compute log frame power
-	nLogPower = FX_SigProc_computeLogFramePower(inBuf,
-												pMfccData->blockPower,
-												pMfccData->logPower,
-												&(pMfccData->frameEn),
-												pMfccVar->logAddTbl,
-												pMfccVar->nFrameShift,
-												pMfccData->nInputFrame);
-
-    pMfccData->nInputFrame = PowerASR_BasicOP_add_32_32(pMfccData->nInputFrame, 1); // PowerASR_BasicOP_add_16_16(pMfccData->nInputFrame, 1);
-	pMfccData->frameEn = nLogPower;	////
-
-	//if (0 == nLogPower) {	// for initial 2 frames
-	if (pMfccData->nInputFrame <= 2) {	// for initial 2 frames
-		if (1 == pMfccData->nInputFrame) {
-			memcpy(pMfccData->prevBuf, inBuf, (size_t)pMfccVar->nFrameShift*sizeof(hci_mfcc16));
-		}
-		else {
-			memcpy(pMfccData->prevBuf+pMfccVar->nFrameShift, inBuf, (size_t)pMfccVar->nFrameShift*sizeof(hci_mfcc16));
-		}
-		return -1;
-	}
-
-	memset(xfft_in, 0, sizeof(xfft_in));
-	memcpy(xfft_in, pMfccData->prevBuf, (size_t)(2*pMfccVar->nFrameShift)*sizeof(hci_mfcc16));
-	memcpy(xfft_in+2*pMfccVar->nFrameShift, inBuf, (size_t)pMfccVar->nFrameShift*sizeof(hci_mfcc16));
-
-#ifdef FIXED_POINT_FE
-	//_FX_Wave2Mfcc_checkAllZeroSamples(xfft, pMfccVar->nFrameSize);
-	var_shift = PowerASR_BasicOP_getNormalShiftCountOfVector_16_16(xfft, pMfccVar->nFrameSize, FFTHEAD);
-#endif	// #ifdef FIXED_POINT_FE
-
-	// hamming windowing
-	FX_SigProc_applyHamming(xfft_in,
-							pMfccVar->hamWin,
-							pMfccVar->nFrameSize);
-
-	// update frame buffer for next processing
-	memcpy(pMfccData->prevBuf, pMfccData->prevBuf+pMfccVar->nFrameShift, (size_t)pMfccVar->nFrameShift*sizeof(hci_mfcc16));
-	memcpy(pMfccData->prevBuf+pMfccVar->nFrameShift, inBuf, (size_t)pMfccVar->nFrameShift*sizeof(hci_mfcc16));
-
-
-	// FFT
-#ifdef FIXED_POINT_FE
-	FX_SigProc_realFFT(xfft,
-					   pMfccVar->phs_tbl,
-					   pMfccVar->nFFTSize,
-					   pMfccVar->nHalfFFT,
-					   pMfccVar->nFFTStage);
-#else	// !FIXED_POINT_FE
-	pffft_transform_ordered(pMfccVar->fftSetup, xfft_in, xfft_out, 0, PFFFT_FORWARD);
-#endif	// #ifdef FIXED_POINT_FE
-
-	// kklee 20150924
-	memcpy(pMfccData->xfft, xfft_out, pMfccVar->nFFTSize*sizeof(xfft_out[0]));
-	pMfccData->xfft_len = pMfccVar->nFFTSize;
-
-#ifdef FIXED_POINT_FE
-	var_shift += PowerASR_BasicOP_getNormalShiftCountOfVector_16_16(xfft, pMfccVar->nFFTSize, 0);
-	var_shift -= pMfccVar->nFFTStage;
-#endif	// #ifdef FIXED_POINT_FE
-
-	// FFT bins --> mel power spectrum
-	memset(melSpecPower, 0, sizeof(melSpecPower));
+	// samples --> mel power spectrum
+#ifndef FIXED_POINT_FE
 	if (pMfccVar->nMFCCType == HTK_MFCC) {
-		FX_SigProc_FFT2HTKMelSpectrum(xfft_out,
-									  melSpecPower,
-									  pMfccData,
-									  pMfccVar,
-									  var_shift);
-	}
-	else if (pMfccVar->nMFCCType == ETSI_MFCC) {
-		FX_SigProc_FFT2ETSIMelSpectrum(xfft_out,
-									   melSpecPower,
-									   pMfccVar,
-									   var_shift);
-	}
-	else if (pMfccVar->nMFCCType == DPS_MFCC) {
-		FX_SigProc_FFT2MelDiffPowerSpectrum(xfft_out,
-											melSpecPower,
-											pMfccVar,
-											var_shift);
+		if (_FX_Wave2Mfcc_fuseFrameToHTKMelSpectrum(pMfccVar, pMfccData, pFrameBuf, melSpecPower, &nLogPower) < 0) {
+			return -1;	// for initial 2 frames
+		}
 	}
-	else {		// PDPS_MFCC
-		FX_SigProc_FFT2MelPredictiveDiffPowerSpectrum(xfft_out,
-													  melSpecPower,
-													  pMfccVar,
-													  var_shift);
+	else
+#endif	// #ifndef FIXED_POINT_FE
+	if (_FX_Wave2Mfcc_computeMelSpectrum(pMfccVar, pMfccData, pFrameBuf, melSpecPower, &nLogPower, &var_shift) < 0) {
+		return -1;	// for initial 2 frames
 	}
 
 	// add frame energy into static feature vector
@@ -335,12 +327,18 @@ FX_Wave2Mfcc_convertSingleFrameToMfccVector(MfccParameters *pMfccVar,	///< (i) s
     //KKLEE : melscale filter bank 
     memcpy(pMfccData->fbankLogEn, melSpecPower, NUM_FILTERBANK * sizeof(hci_mfcc_t));
 	// mel power spectrum --> cepstrum
+#ifdef FIXED_POINT_FE
 	FX_SigProc_MelSpectrum2MFCC(pMfccData->mfccVec,
 								melSpecPower,
 								pMfccVar->dctCosTable,
 								pMfccVar->nNumCepstra,
 								pMfccVar->nNumFilters,
 								pMfccVar->weightC0);
+#else	// !FIXED_POINT_FE
+	_FX_Wave2Mfcc_melSpectrum2MFCC(pMfccData->mfccVec,
+								   melSpecPower,
+								   pMfccVar);
+#endif	// #ifdef FIXED_POINT_FE
 
 	// cepstral weighting
 	if (pMfccVar->nCepLiftOrder > 0) {
@@ -424,6 +422,344 @@ _FX_Wave2Mfcc_checkAllZeroSamples(hci_int16 *pFrameBuf,		///< In : frame sample
 	return 0;
 }
 
+
+/**
+ *	Convert one frame of samples to a mel power spectrum (generic path)
+ */
+HCILAB_PRIVATE hci_int32
+_FX_Wave2Mfcc_computeMelSpectrum(MfccParameters *pMfccVar,	///< In : structure for feature-extraction environments
+								 MFCC_UserData *pMfccData,	///< In/Out : temporary/output data of feature extraction
+								 hci_int16 *pFrameBuf,		///< In : a single frame sample buffer
+								 hci_mfcc32 *melSpecPower,	///< Out : mel-frequency spectral power
+								 hci_mfcc32 *pLogPower,		///< Out : log frame power
+								 hci_int16 *pVarShift)		///< Out : left shift count of FFT outputs
+{
+	hci_int16 *pRawBuf = 0;
+	hci_int16 *pLastBuf = 0;
+	hci_mfcc16 *pInBuf = 0;
+	hci_int16 var_shift = 0;
+	hci_mfcc32 nLogPower = 0;
+	hci_mfcc16 inBuf[BB_FRAME_SHIFT];
+	hci_mfcc16 ALIGNED_(MFCC_ALN) xfft_in[BB_FFT_SIZE];			// input of FFT
+	hci_mfcc16 ALIGNED_(MFCC_ALN) xfft_out[BB_FFT_SIZE];		// output of FFT
+
+	// frame buffering
+	memset(inBuf, 0, sizeof(inBuf));
+#ifdef FIXED_POINT_FE
+	memcpy(inBuf, pFrameBuf, (size_t)pMfccVar->nFrameShift*sizeof(hci_int16));
+#else	// !FIXED_POINT_FE
+	pRawBuf = pFrameBuf;
+	pLastBuf = pRawBuf + pMfccVar->nFrameShift;
+	pInBuf = inBuf;
+	while (pRawBuf < pLastBuf) {
+		*pInBuf++ = (hci_mfcc16)(*pRawBuf++);
+		*pInBuf++ = (hci_mfcc16)(*pRawBuf++);
+		*pInBuf++ = (hci_mfcc16)(*pRawBuf++);
+		*pInBuf++ = (hci_mfcc16)(*pRawBuf++);
+	}
+#endif	// #ifdef FIXED_POINT_FE
+
+	// pre-emphasis
+	FX_SigProc_preEmphasize(inBuf,
+							&(pMfccData->nPriorSample),
+							pMfccVar->PreEmphasis,
+							pMfccVar->nFrameShift);
+
+	// compute log frame power
+	nLogPower = FX_SigProc_computeLogFramePower(inBuf,
+												pMfccData->blockPower,
+												pMfccData->logPower,
+												&(pMfccData->frameEn),
+												pMfccVar->logAddTbl,
+												pMfccVar->nFrameShift,
+												pMfccData->nInputFrame);
+
+    pMfccData->nInputFrame = PowerASR_BasicOP_add_32_32(pMfccData->nInputFrame, 1); // PowerASR_BasicOP_add_16_16(pMfccData->nInputFrame, 1);
+	pMfccData->frameEn = nLogPower;	////
+	*pLogPower = nLogPower;
+
+	//if (0 == nLogPower) {	// for initial 2 frames
+	if (pMfccData->nInputFrame <= 2) {	// for initial 2 frames
+		if (1 == pMfccData->nInputFrame) {
+			memcpy(pMfccData->prevBuf, inBuf, (size_t)pMfccVar->nFrameShift*sizeof(hci_mfcc16));
+		}
+		else {
+			memcpy(pMfccData->prevBuf+pMfccVar->nFrameShift, inBuf, (size_t)pMfccVar->nFrameShift*sizeof(hci_mfcc16));
+		}
+		return -1;
+	}
+
+	memset(xfft_in, 0, sizeof(xfft_in));
+	memcpy(xfft_in, pMfccData->prevBuf, (size_t)(2*pMfccVar->nFrameShift)*sizeof(hci_mfcc16));
+	memcpy(xfft_in+2*pMfccVar->nFrameShift, inBuf, (size_t)pMfccVar->nFrameShift*sizeof(hci_mfcc16));
+
+#ifdef FIXED_POINT_FE
+	//_FX_Wave2Mfcc_checkAllZeroSamples(xfft, pMfccVar->nFrameSize);
+	var_shift = PowerASR_BasicOP_getNormalShiftCountOfVector_16_16(xfft_in, pMfccVar->nFrameSize, FFTHEAD);
+#endif	// #ifdef FIXED_POINT_FE
+
+	// hamming windowing
+	FX_SigProc_applyHamming(xfft_in,
+							pMfccVar->hamWin,
+							pMfccVar->nFrameSize);
+
+	// update frame buffer for next processing
+	memcpy(pMfccData->prevBuf, pMfccData->prevBuf+pMfccVar->nFrameShift, (size_t)pMfccVar->nFrameShift*sizeof(hci_mfcc16));
+	memcpy(pMfccData->prevBuf+pMfccVar->nFrameShift, inBuf, (size_t)pMfccVar->nFrameShift*sizeof(hci_mfcc16));
+
+
+	// FFT
+#ifdef FIXED_POINT_FE
+	FX_SigProc_realFFT(xfft_in,
+					   pMfccVar->phs_tbl,
+					   pMfccVar->nFFTSize,
+					   pMfccVar->nHalfFFT,
+					   pMfccVar->nFFTStage);
+	memcpy(xfft_out, xfft_in, pMfccVar->nFFTSize*sizeof(xfft_in[0]));	// in-place FFT
+#else	// !FIXED_POINT_FE
+	pffft_transform_ordered(pMfccVar->fftSetup, xfft_in, xfft_out, pffft_cache_work(pMfccVar->nFFTSize, PFFFT_REAL), PFFFT_FORWARD);
+#endif	// #ifdef FIXED_POINT_FE
+
+	// kklee 20150924
+	memcpy(pMfccData->xfft, xfft_out, pMfccVar->nFFTSize*sizeof(xfft_out[0]));
+	pMfccData->xfft_len = pMfccVar->nFFTSize;
+
+#ifdef FIXED_POINT_FE
+	var_shift += PowerASR_BasicOP_getNormalShiftCountOfVector_16_16(xfft_out, pMfccVar->nFFTSize, 0);
+	var_shift -= pMfccVar->nFFTStage;
+#endif	// #ifdef FIXED_POINT_FE
+
+	// FFT bins --> mel power spectrum
+	memset(melSpecPower, 0, (size_t)pMfccVar->nNumFilters*sizeof(melSpecPower[0]));
+	if (pMfccVar->nMFCCType == HTK_MFCC) {
+		FX_SigProc_FFT2HTKMelSpectrum(xfft_out,
+									  melSpecPower,
+									  pMfccData,
+									  pMfccVar,
+									  var_shift);
+	}
+	else if (pMfccVar->nMFCCType == ETSI_MFCC) {
+		FX_SigProc_FFT2ETSIMelSpectrum(xfft_out,
+									   melSpecPower,
+									   pMfccVar,
+									   var_shift);
+	}
+	else if (pMfccVar->nMFCCType == DPS_MFCC) {
+		FX_SigProc_FFT2MelDiffPowerSpectrum(xfft_out,
+											melSpecPower,
+											pMfccVar,
+											var_shift);
+	}
+	else {		// PDPS_MFCC
+		FX_SigProc_FFT2MelPredictiveDiffPowerSpectrum(xfft_out,
+													  melSpecPower,
+													  pMfccVar,
+													  var_shift);
+	}
+
+	*pVarShift = var_shift;
+
+	return 0;
+}
+
+
+#ifndef FIXED_POINT_FE
+
+/**
+ *	build tables for the fused float path (mel bin ranges, transposed DCT matrix)
+ */
+HCILAB_PRIVATE void
+_FX_Wave2Mfcc_buildFusedTables(MfccParameters *pMfccVar)		///< In/Out : structure for feature-extraction environments
+{
+	hci_int16 chan = 0;
+	hci_int16 bin = 0;
+	hci_int16 i = 0;
+
+	// lowerChan[] never decreases over [nLowBin, nHighBin],
+	// so bins of lower channel (chan-1) are [melBinFirst[chan], melBinFirst[chan+1])
+	bin = pMfccVar->nLowBin;
+	for (chan = 0; chan <= pMfccVar->nNumFilters + 1; chan++) {
+		while (bin <= pMfccVar->nHighBin && pMfccVar->lowerChan[bin] < chan - 1) bin++;
+		pMfccVar->melBinFirst[chan] = bin;
+	}
+
+	// [filter][cepstrum] copy of dctCosTable, unused cepstra stay 0
+	memset(pMfccVar->dctCosTableT, 0, sizeof(pMfccVar->dctCosTableT));
+	for (i = 0; i < pMfccVar->nNumCepstra; i++) {
+		for (chan = 0; chan < pMfccVar->nNumFilters; chan++) {
+			pMfccVar->dctCosTableT[chan*DIM_CEPSTRUM + i] = pMfccVar->dctCosTable[i*pMfccVar->nNumFilters + chan];
+		}
+	}
+}
+
+
+/**
+ *	Convert one frame of samples to a HTK mel power spectrum in fused float kernels
+ *		- int16 conversion, pre-emphasis, overlap and hamming window in a single pass,
+ *		  prevBuf is used as a circular buffer of two frame shifts
+ *		- power spectrum and magnitude split over the lower/upper filter in SIMD
+ *		- mel filter bank as a banded sum over contiguous bin ranges
+ *	gives the same values as FX_SigProc_preEmphasize() ~ FX_SigProc_FFT2HTKMelSpectrum()
+ */
+HCILAB_PRIVATE hci_int32
+_FX_Wave2Mfcc_fuseFrameToHTKMelSpectrum(MfccParameters *pMfccVar,	///< In : structure for feature-extraction environments
+										MFCC_UserData *pMfccData,	///< In/Out : temporary/output data of feature extraction
+										hci_int16 *pFrameBuf,		///< In : a single frame sample buffer
+										hci_mfcc32 *melSpecPower,	///< Out : mel-frequency spectral power
+										hci_mfcc32 *pLogPower)		///< Out : log frame power
+{
+	const hci_int16 nShift = pMfccVar->nFrameShift;
+	const hci_int16 nHighBin = pMfccVar->nHighBin;
+	const v4sf preE = LD_PS1(pMfccVar->PreEmphasis);
+	hci_mfcc16 *hamWin = pMfccVar->hamWin;
+	hci_mfcc16 *lowerWeight = pMfccVar->lowerWeight;
+	hci_int16 *melBinFirst = pMfccVar->melBinFirst;
+	hci_mfcc32 *subbandFrameEng = pMfccData->subbandFrameEng;
+	hci_mfcc16 *pOldest = pMfccData->prevBuf + pMfccData->idxPrevBuf * nShift;		// first third of the window
+	hci_mfcc16 *pMiddle = pMfccData->prevBuf + (1 - pMfccData->idxPrevBuf) * nShift;	// second third of the window
+	hci_mfcc16 *xfft_out = 0;
+	hci_mfcc32 melPower = 0;
+	hci_int16 i = 0;
+	hci_int16 bin = 0;
+	hci_int16 chan = 0;
+	hci_mfcc16 ALIGNED_(MFCC_ALN) inBuf[SIMD_SZ+BB_FRAME_SHIFT];	// prior sample at [SIMD_SZ-1], new samples from [SIMD_SZ]
+	hci_mfcc16 ALIGNED_(MFCC_ALN) xfft_in[BB_FFT_SIZE];			// input of FFT
+	hci_mfcc16 ALIGNED_(MFCC_ALN) xfft_buf[BB_FFT_SIZE];		// output of FFT if pMfccData->xfft is not aligned
+	hci_mfcc16 ALIGNED_(MFCC_ALN) ekLower[NB_FFT_SIZE];		// bin magnitude to lowerChan[bin]
+	hci_mfcc16 ALIGNED_(MFCC_ALN) ekUpper[NB_FFT_SIZE];		// bin magnitude to lowerChan[bin]+1
+
+	// frame buffering
+	inBuf[SIMD_SZ-1] = pMfccData->nPriorSample;
+	for (i = 0; i < nShift; i++) {
+		inBuf[SIMD_SZ+i] = (hci_mfcc16)pFrameBuf[i];
+	}
+	pMfccData->nPriorSample = inBuf[SIMD_SZ+nShift-1];
+
+	// pre-emphasis + hamming windowing, new samples overwrite the oldest frame shift
+	for (i = 0; i < nShift; i += SIMD_SZ) {
+		v4sf x = VSUB(VLOAD(inBuf+SIMD_SZ+i), VMUL(preE, VLOADU(inBuf+SIMD_SZ-1+i)));
+		VSTORE(xfft_in+i, VMUL(VLOADU(pOldest+i), VLOADU(hamWin+i)));
+		VSTORE(xfft_in+nShift+i, VMUL(VLOADU(pMiddle+i), VLOADU(hamWin+nShift+i)));
+		VSTORE(xfft_in+2*nShift+i, VMUL(x, VLOADU(hamWin+2*nShift+i)));
+		VSTOREU(pOldest+i, x);
+	}
+	memset(xfft_in+3*nShift, 0, (size_t)(pMfccVar->nFFTSize-3*nShift)*sizeof(hci_mfcc16));
+
+	// compute log frame power
+	*pLogPower = FX_SigProc_computeLogFramePower(pOldest,
+												 pMfccData->blockPower,
+												 pMfccData->logPower,
+												 &(pMfccData->frameEn),
+												 pMfccVar->logAddTbl,
+												 nShift,
+												 pMfccData->nInputFrame);
+
+	pMfccData->nInputFrame = PowerASR_BasicOP_add_32_32(pMfccData->nInputFrame, 1);
+	pMfccData->frameEn = *pLogPower;
+	pMfccData->idxPrevBuf = (hci_int16)(1 - pMfccData->idxPrevBuf);
+
+	if (pMfccData->nInputFrame <= 2) {	// for initial 2 frames
+		return -1;
+	}
+
+	// FFT, written in place into pMfccData->xfft when it is aligned
+	xfft_out = (((size_t)pMfccData->xfft) & 0xF) ? xfft_buf : pMfccData->xfft;
+	pffft_transform_ordered(pMfccVar->fftSetup, xfft_in, xfft_out, pffft_cache_work(pMfccVar->nFFTSize, PFFFT_REAL), PFFFT_FORWARD);
+	if (xfft_out != pMfccData->xfft) {
+		memcpy(pMfccData->xfft, xfft_out, pMfccVar->nFFTSize*sizeof(xfft_out[0]));
+	}
+	pMfccData->xfft_len = pMfccVar->nFFTSize;
+
+	// power spectrum, magnitude split into lower/upper filter shares
+	for (bin = pMfccVar->nLowBin; bin + SIMD_SZ - 1 <= nHighBin; bin += SIMD_SZ) {
+		v4sf re, im, L_ek, ek, ek_compl;
+		VLOAD_CPLX(xfft_out + 2*bin, re, im);
+		L_ek = VADD(VMUL(re, re), VMUL(im, im));
+		VSTOREU(subbandFrameEng+bin, L_ek);
+		ek = VSQRT(L_ek);
+		ek_compl = VSUB(ek, VMUL(VLOADU(lowerWeight+bin), ek));
+		VSTOREU(ekLower+bin, VSUB(ek, ek_compl));
+		VSTOREU(ekUpper+bin, ek_compl);
+	}
+	for (; bin <= nHighBin; bin++) {
+		hci_mfcc16 t1 = xfft_out[2*bin];
+		hci_mfcc16 t2 = xfft_out[2*bin+1];
+		hci_mfcc32 L_ek = t1*t1 + t2*t2;
+		hci_mfcc16 ek = (hci_mfcc32) sqrt(L_ek);
+		hci_mfcc16 ek_compl = ek - lowerWeight[bin] * ek;
+		subbandFrameEng[bin] = L_ek;
+		ekLower[bin] = ek - ek_compl;
+		ekUpper[bin] = ek_compl;
+	}
+
+	// mel filter bank, bins summed in ascending order
+	for (chan = 0; chan < pMfccVar->nNumFilters; chan++) {
+		melPower = 0.0f;
+		for (bin = melBinFirst[chan]; bin < melBinFirst[chan+1]; bin++) {
+			melPower += ekUpper[bin];
+		}
+		for (; bin < melBinFirst[chan+2]; bin++) {
+			melPower += ekLower[bin];
+		}
+		melSpecPower[chan] = melPower;
+	}
+
+	/* Take logs */
+	for (chan = 0; chan < pMfccVar->nNumFilters; chan++) {
+		if (melSpecPower[chan] < 1.0f) {
+			melSpecPower[chan] = 0.0f;
+		}
+		else {
+			melSpecPower[chan] = (hci_mfcc32) log(melSpecPower[chan]);
+		}
+	}
+
+	return 0;
+}
+
+
+/**
+ *	DCT of mel spectrum as a small matrix-vector product over the transposed cosine table
+ *		- same summation order as FX_SigProc_MelSpectrum2MFCC()
+ */
+HCILAB_PRIVATE void
+_FX_Wave2Mfcc_melSpectrum2MFCC(hci_mfcc_t *pCepVec,			///< Out : cepstrum vector
+							   hci_mfcc32 *melSpecPower,	///< In : mel-freq. spectrum power
+							   MfccParameters *pMfccVar)	///< In : structure for feature-extraction environments
+{
+	hci_mfcc16 *pDCTWgt = pMfccVar->dctCosTableT;
+	hci_int16 i = 0;
+	hci_int16 j = 0;
+	v4sf acc[DIM_CEPSTRUM/SIMD_SZ];		// DIM_CEPSTRUM is a multiple of the vector width
+	hci_mfcc_t ALIGNED_(MFCC_ALN) cepVec[DIM_CEPSTRUM];
+
+	for (i = 0; i < DIM_CEPSTRUM/SIMD_SZ; i++) {
+		acc[i] = VZERO();
+	}
+	for (j = 0; j < pMfccVar->nNumFilters; j++, pDCTWgt += DIM_CEPSTRUM) {
+		v4sf mel = LD_PS1(melSpecPower[j]);
+		for (i = 0; i < DIM_CEPSTRUM/SIMD_SZ; i++) {
+			acc[i] = VADD(acc[i], VMUL(mel, VLOADU(pDCTWgt+i*SIMD_SZ)));
+		}
+	}
+	for (i = 0; i < DIM_CEPSTRUM/SIMD_SZ; i++) {
+		VSTORE(cepVec+i*SIMD_SZ, acc[i]);
+	}
+	memcpy(pCepVec, cepVec, pMfccVar->nNumCepstra*sizeof(hci_mfcc_t));
+
+	if (pMfccVar->weightC0 > 0.0f) {
+		hci_mfcc_t nLogEnergy = 0;
+		for (j = 0; j < pMfccVar->nNumFilters; j++) {
+			nLogEnergy += melSpecPower[j];
+		}
+		nLogEnergy /= (float)pMfccVar->nNumFilters;
+		pCepVec[pMfccVar->nNumCepstra] *= (1.0f - pMfccVar->weightC0);
+		pCepVec[pMfccVar->nNumCepstra] += pMfccVar->weightC0 * nLogEnergy;
+	}
+}
+
+#endif	// #ifndef FIXED_POINT_FE
+
 /* end of file */
 
 
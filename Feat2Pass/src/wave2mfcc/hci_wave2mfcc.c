@@ -24,7 +24,7 @@
 #include <stdlib.h>
 #include <string.h>
 
-#include "pffft.h"
+#include "pffft_cache.h"
 
 #include "base/hci_malloc.h"
 #include "base/hci_msg.h"
@@ -165,11 +165,65 @@ PowerASR_FX_Wave2Mfcc_closeWave2MfccConverter(PowerASR_FX_Wave2Mfcc *pThis)	///<
 {
 	Wave2Mfcc_Inner* pInner = (Wave2Mfcc_Inner*)pThis->pInner;
 	if (pInner->paraMfcc.fftSetup)
-		pffft_destroy_setup(pInner->paraMfcc.fftSetup);
+		pffft_cache_release(pInner->paraMfcc.fftSetup);
 	return (pThis ? 0 : -1);
 }
 
 
+/**
+ *	return the image of the wave-to-mfcc converter set-up, to be saved in a snapshot.
+ *	the image is the inner data struct as it is, valid only for the same build.
+ *
+ *	@return return the image size in bytes, otherwise return -1.
+ */
+HCILAB_PUBLIC HCI_WAVE2MFCC_API hci_int32
+PowerASR_FX_Wave2Mfcc_getImage(PowerASR_FX_Wave2Mfcc *pThis,				///< (i) pointer to the wave-to-mfcc converter
+							   const void **ppImage)						///< (o) image of the wave-to-mfcc converter
+{
+	if (0 == pThis || 0 == ppImage) {
+		return -1;
+	}
+
+	*ppImage = pThis->pInner;
+
+	return (hci_int32)sizeof(Wave2Mfcc_Inner);
+}
+
+
+/**
+ *	set-up environments for wave-to-mfcc converter from an image returned by PowerASR_FX_Wave2Mfcc_getImage,
+ *	instead of the configuration file.
+ *
+ *	@return return 0 if the image is set-up correctly, otherwise return -1.
+ */
+HCILAB_PUBLIC HCI_WAVE2MFCC_API hci_int32
+PowerASR_FX_Wave2Mfcc_openWave2MfccConverterFromImage(PowerASR_FX_Wave2Mfcc *pThis,	///< (i/o) pointer to the wave-to-mfcc converter
+													  const void *pImage,	///< (i) image saved by PowerASR_FX_Wave2Mfcc_getImage
+													  const hci_int32 nSize,	///< (i) image size in bytes
+													  hci_logadd_t *pLogAddTbl)	///< (i) pointer to log-addition table
+{
+	Wave2Mfcc_Inner *pInner = 0;
+
+	if (0 == pThis || 0 == pImage) {
+		return -1;
+	}
+
+	if (nSize != (hci_int32)sizeof(Wave2Mfcc_Inner)) {
+		HCIMSG_ERROR("image size mismatch (%d, %d).\n", nSize, (hci_int32)sizeof(Wave2Mfcc_Inner));
+		return -1;
+	}
+
+	pInner = (Wave2Mfcc_Inner *) pThis->pInner;
+
+	memcpy(pInner, pImage, sizeof(Wave2Mfcc_Inner));
+
+	pInner->paraMfcc.logAddTbl = pLogAddTbl;
+	pInner->paraMfcc.fftSetup = pffft_cache_setup(pInner->paraMfcc.nFFTSize, PFFFT_REAL);	// shared by all channels
+
+	return 0;
+}
+
+
 /**
  *	initialize data buffers for wave-to-mfcc converter.
  *
@@ -492,7 +546,7 @@ _FX_Wave2Mfcc_loadConfigurations(PowerASR_FX_Wave2Mfcc *pThis,
 	pszValue = PowerASR_Base_getArgumentValue("PREEMPHASIS_ALPHA");
 	if (pszValue) {
 #ifdef FIXED_POINT_FE
-		pMfccVar->PreEmphasis = (hci_mfcc16)atoi(pszValue);
+		pMfccVar->PreEmphasis = (hci_mfcc16)CONFIG2Q15(atof(pszValue));
 #else	// !FIXED_POINT_FE
 		pMfccVar->PreEmphasis = (hci_mfcc16)atof(pszValue);
 #endif	// #ifdef FIXED_POINT_FE
@@ -24,11 +24,65 @@
 #include "wiener/ParmInterface.h"
 #include "wiener/MelProcExports.h"
 
+#include <string.h>
+
+#include "pffft.h"
+
 /*------------------------
  * Definitions and Macros
  *------------------------*/
 #define etsi_max(a,b) ((a>b)?(a):(b))
 
+#define ALN_MEL 64
+#if defined(_MSC_VER)
+#define ALIGNED_(x) __declspec(align(x))
+#else
+#if defined(__GNUC__)
+#define ALIGNED_(x) __attribute__ ((aligned(x)))
+#endif
+#endif
+
+// define MELPROC_SIMD_DISABLE to use scalar code (same vector macros as pffft.c)
+//#define MELPROC_SIMD_DISABLE
+#if !defined(MELPROC_SIMD_DISABLE) && (defined(__x86_64__) || defined(_M_X64) || defined(i386) || defined(_M_IX86))
+#include <xmmintrin.h>
+typedef __m128 v4sf;
+#  define SIMD_SZ 4
+#  define VZERO() _mm_setzero_ps()
+#  define VADD(a,b) _mm_add_ps(a,b)
+#  define VMUL(a,b) _mm_mul_ps(a,b)
+#  define LD_PS1(f) _mm_set1_ps(f)
+#  define VLOAD(p) _mm_load_ps(p)
+#  define VLOADU(p) _mm_loadu_ps(p)
+#  define VSTORE(p,v) _mm_store_ps(p,v)
+#  define VREDUCE(v,s) { v4sf t_ = _mm_add_ps(v, _mm_movehl_ps(v, v)); \
+		s = _mm_cvtss_f32(_mm_add_ss(t_, _mm_shuffle_ps(t_, t_, 1))); }
+#elif !defined(MELPROC_SIMD_DISABLE) && defined(__ARM_NEON)
+#include <arm_neon.h>
+typedef float32x4_t v4sf;
+#  define SIMD_SZ 4
+#  define VZERO() vdupq_n_f32(0)
+#  define VADD(a,b) vaddq_f32(a,b)
+#  define VMUL(a,b) vmulq_f32(a,b)
+#  define LD_PS1(f) vdupq_n_f32(f)
+#  define VLOAD(p) vld1q_f32(p)
+#  define VLOADU(p) vld1q_f32(p)
+#  define VSTORE(p,v) vst1q_f32(p,v)
+#  define VREDUCE(v,s) { float32x2_t t_ = vadd_f32(vget_low_f32(v), vget_high_f32(v)); \
+		s = vget_lane_f32(vpadd_f32(t_, t_), 0); }
+#else
+typedef float v4sf;
+#  define SIMD_SZ 1
+#  define VZERO() 0.f
+#  define VADD(a,b) ((a)+(b))
+#  define VMUL(a,b) ((a)*(b))
+#  define LD_PS1(f) (f)
+#  define VLOAD(p) (*(p))
+#  define VLOADU(p) (*(p))
+#  define VSTORE(p,v) (*(p) = (v))
+#  define VREDUCE(v,s) { s = (v); }
+#endif
+
 /*------------------
  * mel FB functions 
  *------------------*/
@@ -36,39 +90,75 @@
 /*----------------------------------------------------------------------------
  * FUNCTION NAME: CMelFBAlloc
  *
- * PURPOSE:       Memory allocation of first Mel window
+ * PURPOSE:       Memory allocation of Mel filter bank
  *              
  * INPUT:
  *   none     
  *
  * OUTPUT:
- *   *FirstWin    Pointer to Mel window
+ *   *Bank        Pointer to Mel filter bank
  *
  * RETURN VALUE:
- *   *FirstWin    Pointer to Mel window
+ *   *Bank        Pointer to Mel filter bank
  *
  *---------------------------------------------------------------------------*/
-MelFB_Window *CMelFBAlloc ()
+MelFB_Bank *CMelFBAlloc ()
 {
-  MelFB_Window *FirstWin = calloc (1, sizeof (MelFB_Window));
+  MelFB_Bank *Bank = calloc (1, sizeof (MelFB_Bank));
 
-  if (FirstWin == NULL)
+  if (Bank == NULL)
     return NULL;
   else
-    return FirstWin;
+    return Bank;
+}
+
+/*----------------------------------------------------------------------------
+ * FUNCTION NAME: AllocMelFBData
+ *
+ * PURPOSE:       Lays out the coefficient rows of all channels (StartingPoint
+ *                and Length must be set) in one zeroed, aligned block
+ *
+ * INPUT:
+ *   Bank         Pointer to Mel filter bank
+ *
+ * OUTPUT
+ *                Offset, NumBins and Data of the filter bank
+ *
+ * RETURN VALUE:
+ *   none
+ *
+ *---------------------------------------------------------------------------*/
+static void AllocMelFBData (MelFB_Bank *Bank)
+{
+  int i, size = 0;
+
+  Bank->NumBins = 0;
+  for (i=0 ; i<Bank->NumChannels ; i++)
+	{
+	  Bank->Offset [i] = size;
+	  size += MELFB_ROUNDUP (Bank->Length [i]);
+	  Bank->NumBins = etsi_max (Bank->NumBins, Bank->StartingPoint [i] + Bank->Length [i]);
+	}
+  assert (Bank->NumBins <= MELFB_MAX_BINS);
+
+  Bank->Data = (float *) pffft_aligned_malloc (sizeof (float) * etsi_max (size, 1));
+  if (Bank->Data == NULL)
+	{
+	  fprintf (stderr, "ERROR:   Memory allocation error occured!\r\n");
+	  exit(0);
+	}
+  memset (Bank->Data, 0, sizeof (float) * etsi_max (size, 1));
 }
 
 /*---------------------------------------------------------------------------
  * FUNCTION NAME: DoMelFB
  *
  * PURPOSE:       Performs mel filtering on FFT magnitude spectrum using the
- *                filter bank defined by a chained list of FFT window
- *                structures
+ *                filter bank coefficient block
  *
  * INPUT:
  *   SigFFT       Pointer to signal FFT magnitude spectrum
- *   FirstWin     Pointer to the first channel of the filter bank (first
- *                element in the chained list of FFT window data structures)
+ *   Bank         Pointer to the Mel filter bank
  *
  * OUTPUT
  *                Filter bank outputs stored at the beginning of input signal
@@ -78,39 +168,113 @@ MelFB_Window *CMelFBAlloc ()
  *   none
  *
  *---------------------------------------------------------------------------*/
-void DoMelFB (float *SigFFT, MelFB_Window *FirstWin)
+void DoMelFB (float *SigFFT, const MelFB_Bank *Bank)
 {
-  MelFB_Window *p1;
-  float Sum [WF_MEL_ORDER];
+  float ALIGNED_(ALN_MEL) Spec [MELFB_MAX_BINS + MELFB_ALIGN];
   int i, j;
 
-  p1 = FirstWin;
-  j = 0;
-  while (p1)
+  // zero padded copy: padded rows read up to MELFB_ALIGN-1 bins past the triangle
+  for (i=0 ; i<Bank->NumBins ; i++) Spec [i] = SigFFT [i];
+  for ( ; i<Bank->NumBins + MELFB_ALIGN ; i++) Spec [i] = 0.0;
+
+  for (j=0 ; j<Bank->NumChannels ; j++)
 	{
-	  Sum[j] = 0.0;
-	  for (i = 0; i < p1->Length; i++)
-		Sum[j] += SigFFT[p1->StartingPoint + i] * p1->Data[i];
+	  const float *pSpec = Spec + Bank->StartingPoint [j];
+	  const float *pCoef = Bank->Data + Bank->Offset [j];
+	  v4sf acc = VZERO();
 
-	  j++;
-	  p1 = p1->Next;
+	  for (i=0 ; i<Bank->Length [j] ; i+=SIMD_SZ)
+		acc = VADD (acc, VMUL (VLOADU (pSpec + i), VLOAD (pCoef + i)));
+
+	  VREDUCE (acc, SigFFT [j]);
 	}
 
-  for (j-- ; j>=0 ; j--)
-	SigFFT [j] = Sum [j];
+  return;
+}
+
+#ifdef FIXED_POINT_FE
+/*----------------------------------------------------------------------------
+ * FUNCTION NAME: InitMelFBFx
+ *
+ * PURPOSE:       Makes the Q15 copy of the filter bank coefficient block
+ *                used by DoMelFBFx (same layout as Data)
+ *
+ * INPUT:
+ *   Bank         Pointer to an initialized Mel filter bank
+ *
+ * OUTPUT
+ *                DataFx of the filter bank
+ *
+ * RETURN VALUE:
+ *   none
+ *
+ *---------------------------------------------------------------------------*/
+void InitMelFBFx (MelFB_Bank *Bank)
+{
+  const int last = Bank->NumChannels - 1;
+  const int size = Bank->Offset [last] + MELFB_ROUNDUP (Bank->Length [last]);
+  int i;
+
+  free (Bank->DataFx);
+  Bank->DataFx = (int *) malloc (sizeof (int) * etsi_max (size, 1));
+  if (Bank->DataFx == NULL)
+	{
+	  fprintf (stderr, "ERROR:   Memory allocation error occured!\r\n");
+	  exit(0);
+	}
+  for (i=0 ; i<size ; i++)
+	Bank->DataFx [i] = (int) floor (Bank->Data [i] * 32768.0 + 0.5);
+}
+
+/*---------------------------------------------------------------------------
+ * FUNCTION NAME: DoMelFBFx
+ *
+ * PURPOSE:       Fixed-point DoMelFB, Q15 coefficients from InitMelFBFx
+ *
+ * INPUT:
+ *   SigFFT       Pointer to signal FFT magnitude spectrum (Q15)
+ *   Bank         Pointer to the Mel filter bank
+ *
+ * OUTPUT
+ *                Filter bank outputs (Q15) stored at the beginning of input
+ *                signal FFT buffer pointed by *SigFFT*
+ *
+ * RETURN VALUE
+ *   none
+ *
+ *---------------------------------------------------------------------------*/
+void DoMelFBFx (int *SigFFT, const MelFB_Bank *Bank)
+{
+  int Spec [MELFB_MAX_BINS];
+  int i, j;
+
+  for (i=0 ; i<Bank->NumBins ; i++) Spec [i] = SigFFT [i];
+
+  for (j=0 ; j<Bank->NumChannels ; j++)
+	{
+	  const int *pSpec = Spec + Bank->StartingPoint [j];
+	  const int *pCoef = Bank->DataFx + Bank->Offset [j];
+	  long long acc = 0;
+
+	  for (i=0 ; i<Bank->Length [j] ; i++)
+		acc += (long long) pSpec [i] * pCoef [i];
+
+	  SigFFT [j] = (int) ((acc + 16384) >> 15);
+	}
 
   return;
 }
+#endif	// #ifdef FIXED_POINT_FE
 
 /*----------------------------------------------------------------------------
  * FUNCTION NAME: InitMelFBwindows
  *
- * PURPOSE:       Initializes data structure for FFT windows (mel filter bank).
+ * PURPOSE:       Initializes the Mel filter bank (FFT windows).
  *                Computes starting point and length of each window, allocates
- *                memory for window coefficients.
+ *                memory for and computes window coefficients.
  *
  * INPUT:
- *   FirstWin     Pointer to first FFT window structure
+ *   Bank         Pointer to Mel filter bank
  *   StFreq       Starting frequency of mel filter bank
  *   SmplFreq     Sampling frequency
  *   FFTLength    FFT length
@@ -118,23 +282,23 @@ void DoMelFB (float *SigFFT, MelFB_Window *FirstWin)
  *   normalize    Boolean
  *
  * OUTPUT
- *                Chained list of FFT window data structures.
+ *                Filter bank coefficient block.
  *
  * RETURN VALUE:
  *   none
  *
  *---------------------------------------------------------------------------*/
-void InitMelFBwindows (MelFB_Window *FirstWin, float StFreq, float SmplFreq, int FFTLength, int NumChannels, ETSI_BOOL normalize)
+void InitMelFBwindows (MelFB_Bank *Bank, float StFreq, float SmplFreq, int FFTLength, int NumChannels, ETSI_BOOL normalize)
 {
   int i, j, k;
-  int *centrFreq;
+  int centrFreq [MELFB_MAX_CHANNELS];
   float freq;
   float start_mel;
   float fs_per_2_mel;
   float normFBconst;
-  MelFB_Window *p1, *p2;
+  float *pCoef;
 
-  centrFreq = (int *) malloc (sizeof (int) * NumChannels);
+  assert (NumChannels >= 2 && NumChannels <= MELFB_MAX_CHANNELS);
 
   /* Constants for calculation */
   start_mel = 2595.0 * log10 (1.0 + (float) StFreq / 700.0);
@@ -145,91 +309,71 @@ void InitMelFBwindows (MelFB_Window *FirstWin, float StFreq, float SmplFreq, int
 	  freq = 700 * (pow (10, (start_mel + (float) i / (NumChannels - 1) * (fs_per_2_mel - start_mel)) / 2595.0) - 1.0);
 	  centrFreq [i] = (int) (FFTLength * freq / SmplFreq + 0.5);
 	}
-  p1 = FirstWin;
+
+  /*------------------------------
+   * window positions and lengths
+   *------------------------------*/
+  Bank->NumChannels = NumChannels;
+  Bank->StartingPoint [0] = centrFreq [0];
+  Bank->Length [0]        = centrFreq [1] - centrFreq [0];
+  for (i=1 ; i<NumChannels-1 ; i++)
+	{
+	  Bank->StartingPoint [i] = centrFreq [i-1] + 1;
+	  Bank->Length [i]        = centrFreq [i+1] - centrFreq [i-1] - 1;
+	}
+  Bank->StartingPoint [NumChannels - 1] = centrFreq [NumChannels - 2] + 1;
+  Bank->Length [NumChannels - 1]        = centrFreq [NumChannels - 1] - centrFreq [NumChannels - 2];
+
+  AllocMelFBData (Bank);
 
   /*----------------------
    * first freq. window 0 
    *----------------------*/
-  p1->StartingPoint = centrFreq [0];
-  p1->Length        = centrFreq [1] - centrFreq [0];
-  p1->Data          = (float *) malloc (sizeof (float) * p1->Length);
-  if (p1->Data == NULL)
-	{
-	  fprintf (stderr, "ERROR:   Memory allocation error occured!\r\n");
-	  exit(0);
-	}
+  pCoef = Bank->Data + Bank->Offset [0];
   normFBconst = 0.0;
-  for (j=0; j < p1->Length; j++)
+  for (j=0; j < Bank->Length [0]; j++)
 	{
-	  p1->Data [j] = 1.0 - (float) j / (float) p1->Length;
-	  normFBconst += p1->Data [j];
+	  pCoef [j] = 1.0 - (float) j / (float) Bank->Length [0];
+	  normFBconst += pCoef [j];
 	}
   if (normalize)
-    for (j=0; j < p1->Length; j++) p1->Data [j] /= normFBconst;
-  p2 = (MelFB_Window *) malloc (sizeof (MelFB_Window));
-  if (p2 == NULL)
-	{
-	  fprintf (stderr, "ERROR:   Memory allocation error occured!\r\n");
-	  exit(0);
-	}
-  p1->Next = p2;
-  p1 = p2;
+    for (j=0; j < Bank->Length [0]; j++) pCoef [j] /= normFBconst;
 
   /*----------------------------------
    * freq. windows 1->NumChannels - 2
    *----------------------------------*/
   for (i=1 ; i<NumChannels-1 ; i++)
 	{
-	  p1->StartingPoint = centrFreq [i-1] + 1;
-	  p1->Length        = centrFreq [i+1] - centrFreq [i-1] - 1;
-	  p1->Data          = (float *) malloc (sizeof (float) * p1->Length);
-	  if (p1->Data == NULL)
-		{
-		  fprintf (stderr, "ERROR:   Memory allocation error occured!\r\n");
-		  exit(0) ;
-		}
+	  pCoef = Bank->Data + Bank->Offset [i];
 	  normFBconst = 0.0;
 	  for (j=0 ; j<(centrFreq[i]-centrFreq[i-1]) ; j++)
 		{
-		  p1->Data [j] = (float) (j + 1) / (float) (centrFreq [i] - centrFreq [i-1]);
-		  normFBconst += p1->Data [j];
+		  pCoef [j] = (float) (j + 1) / (float) (centrFreq [i] - centrFreq [i-1]);
+		  normFBconst += pCoef [j];
 		}
-	  for (j=(centrFreq[i]-centrFreq[i-1]),k=0 ; j<p1->Length ; j++,k++)
+	  for (j=(centrFreq[i]-centrFreq[i-1]),k=0 ; j<Bank->Length [i] ; j++,k++)
 		{
-		  p1->Data [j] = 1.0 - (k + 1) / (float) (centrFreq [i+1] - centrFreq [i]);
-		  normFBconst += p1->Data [j];
+		  pCoef [j] = 1.0 - (k + 1) / (float) (centrFreq [i+1] - centrFreq [i]);
+		  normFBconst += pCoef [j];
 		}
 	  if (normalize)
-		for (j=0 ; j<p1->Length ; j++) p1->Data [j] /= normFBconst;
-
-	  p2 = (MelFB_Window *) malloc (sizeof (MelFB_Window));
-	  if (p2 == NULL)
-		{
-		  fprintf (stderr, "ERROR:   Memory allocation error occured!\r\n");
-		  exit(0);
-		}
-	  p1->Next = p2;
-	  p1 = p2;
+		for (j=0 ; j<Bank->Length [i] ; j++) pCoef [j] /= normFBconst;
 	}
 
   /*-----------------------------------
    * last freq. window NumChannels - 1
    *-----------------------------------*/
-  p1->StartingPoint = centrFreq [NumChannels - 2] + 1;
-  p1->Length        = centrFreq [NumChannels - 1] - centrFreq [NumChannels - 2];
-  p1->Data          = (float *) malloc (sizeof (float) * p1->Length);
+  i = NumChannels - 1;
+  pCoef = Bank->Data + Bank->Offset [i];
   normFBconst = 0.0;
-  for (j=0 ; j<p1->Length ; j++)
+  for (j=0 ; j<Bank->Length [i] ; j++)
 	{
-	  p1->Data [j] = (float) (j + 1) / (float) p1->Length;
-	  normFBconst += p1->Data [j];
+	  pCoef [j] = (float) (j + 1) / (float) Bank->Length [i];
+	  normFBconst += pCoef [j];
 	}
   if (normalize)
-    for (j=0 ; j<p1->Length ; j++) p1->Data [j] /= normFBconst;
-
-  p1->Next = NULL;
+    for (j=0 ; j<Bank->Length [i] ; j++) pCoef [j] /= normFBconst;
 
-  free (centrFreq);
 
   return;
 }
@@ -237,10 +381,10 @@ void InitMelFBwindows (MelFB_Window *FirstWin, float StFreq, float SmplFreq, int
 /*---------------------------------------------------------------------------
  * FUNCTION NAME: ReleaseMelFBwindows
  *
- * PURPOSE:       Releases memory allocated for FFT windows
+ * PURPOSE:       Releases memory allocated for the filter bank coefficients
  *
  * INPUT:
- *   FirstWin     Pointer to first FFT window structure
+ *   Bank         Pointer to Mel filter bank
  *
  * OUTPUT
  *   none
@@ -249,19 +393,17 @@ void InitMelFBwindows (MelFB_Window *FirstWin, float StFreq, float SmplFreq, int
  *   none
  *
  *---------------------------------------------------------------------------*/
-void ReleaseMelFBwindows (MelFB_Window *FirstWin )
+void ReleaseMelFBwindows (MelFB_Bank *Bank)
 {
-  MelFB_Window *p;
-
-  while (FirstWin->Next != NULL)
-	{
-	  p = FirstWin->Next->Next;
-	  free (FirstWin->Next->Data);
-	  free (FirstWin->Next);
-	  FirstWin->Next = p;
-	}
-
-  free (FirstWin->Data);
+  if (Bank == NULL)
+	return;
+
+  pffft_aligned_free (Bank->Data);
+  Bank->Data = NULL;
+#ifdef FIXED_POINT_FE
+  free (Bank->DataFx);
+  Bank->DataFx = NULL;
+#endif
 }
 
 /*--------------------
@@ -273,21 +415,23 @@ void ReleaseMelFBwindows (MelFB_Window *FirstWin )
  * PURPOSE:       Initializes Mel IDCT basis
  *              
  * INPUT:
- *   *FirstWin    Pointer to the first Mel filter bank window
+ *   *Bank        Pointer to the Mel filter bank
  *   melorder     Order of Mel filter bank
  *   sampFreq     Sampling frequency
  *   FFTLength    FFT length
  *
  * OUTPUT:
- *   Inverse DCT basis are stored in **melIDCTbasis
+ *   Inverse DCT basis are stored in *melIDCTbasis, frequency-major:
+ *   melIDCTbasis [f * MELFB_ROUNDUP(melorder) + t], padding is zeroed
  *
  * RETURN VALUE:
  *   none
  *
  *---------------------------------------------------------------------------*/
-void InitMelIDCTbasis (float **melIDCTbasis, MelFB_Window *FirstWin, short melorder, int sampFreq, int FFTLength)
+void InitMelIDCTbasis (float *melIDCTbasis, const MelFB_Bank *Bank, short melorder, int sampFreq, int FFTLength)
 {
-  MelFB_Window *p1;
+  const int stride = MELFB_ROUNDUP (melorder);
+  const float *pCoef;
   float centrFreq [WF_MEL_ORDER];
   float deltaFreq [WF_MEL_ORDER];
   float startingFreq;
@@ -300,32 +444,30 @@ void InitMelIDCTbasis (float **melIDCTbasis, MelFB_Window *FirstWin, short melor
   /*-------------------------------------
    * calculating centrFreq and deltaFreq 
    *-------------------------------------*/
-  p1 = FirstWin;
   for (j=0 ; j<melorder ; j++)
 	{
 	  if (j == 0)  // freq. window 0
 		{                                                 
-		  centrFreq [j] = p1->StartingPoint * linStep;
-		  p1 = p1->Next;
+		  centrFreq [j] = Bank->StartingPoint [j] * linStep;
 		}
 	  else 
 		{
 		  if (j == (melorder-1)) // freq. window melorder-
 			{                                       
-			  centrFreq [j] = (p1->StartingPoint + p1->Length - 1) * linStep;
+			  centrFreq [j] = (Bank->StartingPoint [j] + Bank->Length [j] - 1) * linStep;
 			}
 		  else // freq. windows 1->(melorder-2)
 			{                                                  
-			  startingFreq = p1->StartingPoint * linStep;
+			  pCoef = Bank->Data + Bank->Offset [j];
+			  startingFreq = Bank->StartingPoint [j] * linStep;
 			  sum = 0.0;
 			  centrFreq [j] = 0.0;
-			  for (i=0; i<p1->Length ; i++) 
+			  for (i=0; i<Bank->Length [j] ; i++) 
 				{
-				  centrFreq [j] += p1->Data[i] * (startingFreq + i * linStep);
-				  sum += p1->Data[i];
+				  centrFreq [j] += pCoef [i] * (startingFreq + i * linStep);
+				  sum += pCoef [i];
 				}
 			  centrFreq [j] /= sum;
-			  p1 = p1->Next;
 			}
 		}
 	}
@@ -345,9 +487,10 @@ void InitMelIDCTbasis (float **melIDCTbasis, MelFB_Window *FirstWin, short melor
   /*------
    * IDCT 
    *------*/
+  memset (melIDCTbasis, 0, sizeof (float) * melorder * stride);
   for (i=0 ; i<melorder ; i++)         // time axis
     for (j=0 ; j<melorder ; j++)       // frequency axis
-      melIDCTbasis [i][j] = deltaFreq [j] * cos (PIx2 * i * centrFreq[j] / sampFreq);
+      melIDCTbasis [j * stride + i] = deltaFreq [j] * cos (PIx2 * i * centrFreq[j] / sampFreq);
 }
 
 /*----------------------------------------------------------------------------
@@ -357,9 +500,9 @@ void InitMelIDCTbasis (float **melIDCTbasis, MelFB_Window *FirstWin, short melor
  *              
  * INPUT:
  *   *inData         Pointer to input Mel filter bank bands
- *   **melIDCTbasis  Double pointer to Mel inverse DCT basis
+ *   *melIDCTbasis   Pointer to aligned Mel inverse DCT basis (see InitMelIDCTbasis)
  *   melOrder        Mel filter bank order
- *   timeLength      Length of output data
+ *   timeLength      Length of output data (<= WF_MEL_ORDER)
  *
  * OUTPUT:
  *   Output impulse response is in *inData
@@ -368,55 +511,126 @@ void InitMelIDCTbasis (float **melIDCTbasis, MelFB_Window *FirstWin, short melor
  *   none
  *
  *---------------------------------------------------------------------------*/
-void DoMelIDCT (float *inData, float **melIDCTbasis, int melOrder, int timeLength)
+void DoMelIDCT (float *inData, const float *melIDCTbasis, int melOrder, int timeLength)
 {
+  const int stride = MELFB_ROUNDUP (timeLength);
+  v4sf acc [WF_MEL_IDCT_STRIDE / SIMD_SZ];
+  float ALIGNED_(ALN_MEL) outData [WF_MEL_IDCT_STRIDE];
   int t, f;
-  float *outData;
 
-  outData = (float *) malloc (sizeof (float) * timeLength);
-  if (outData == NULL)
+  assert (timeLength <= WF_MEL_ORDER);
+
+  for (t=0 ; t<stride ; t+=SIMD_SZ)
+	acc [t / SIMD_SZ] = VZERO();
+
+  // all output taps at once, one basis row per mel band
+  for (f=0 ; f<melOrder ; f++)
 	{
-	  fprintf (stderr, "ERROR:   Memory allocation error occured!\r\n");
-	  exit(0);
+	  const v4sf in = LD_PS1 (inData [f]);
+	  const float *pBasis = melIDCTbasis + f * stride;
+
+	  for (t=0 ; t<stride ; t+=SIMD_SZ)
+		acc [t / SIMD_SZ] = VADD (acc [t / SIMD_SZ], VMUL (in, VLOAD (pBasis + t)));
 	}
 
+  for (t=0 ; t<stride ; t+=SIMD_SZ)
+	VSTORE (outData + t, acc [t / SIMD_SZ]);
   for (t=0 ; t<timeLength ; t++)
+    inData [t] = outData [t];
+}
+
+#ifdef FIXED_POINT_FE
+/*----------------------------------------------------------------------------
+ * FUNCTION NAME: InitMelIDCTbasisFx
+ *
+ * PURPOSE:       Q15 copy of the Mel IDCT basis made by InitMelIDCTbasis
+ *
+ * INPUT:
+ *   *melIDCTbasis  Mel inverse DCT basis (see InitMelIDCTbasis)
+ *   melOrder       Mel filter bank order
+ *   timeLength     Length of the basis rows
+ *
+ * OUTPUT:
+ *   *melIDCTbasisFx  Q15 basis, same layout
+ *
+ * RETURN VALUE:
+ *   none
+ *
+ *---------------------------------------------------------------------------*/
+void InitMelIDCTbasisFx (int *melIDCTbasisFx, const float *melIDCTbasis, int melOrder, int timeLength)
+{
+  const int size = melOrder * MELFB_ROUNDUP (timeLength);
+  int i;
+
+  for (i=0 ; i<size ; i++)
+	melIDCTbasisFx [i] = (int) floor (melIDCTbasis [i] * 32768.0 + 0.5);
+}
+
+/*----------------------------------------------------------------------------
+ * FUNCTION NAME: DoMelIDCTFx
+ *
+ * PURPOSE:       Fixed-point DoMelIDCT
+ *
+ * INPUT:
+ *   *inData          Pointer to input Mel filter bank bands (Q15)
+ *   *melIDCTbasisFx  Pointer to the Q15 basis (see InitMelIDCTbasisFx)
+ *   melOrder         Mel filter bank order
+ *   timeLength       Length of output data (<= WF_MEL_ORDER)
+ *
+ * OUTPUT:
+ *   Output impulse response (Q15) is in *inData
+ *
+ * RETURN VALUE:
+ *   none
+ *
+ *---------------------------------------------------------------------------*/
+void DoMelIDCTFx (int *inData, const int *melIDCTbasisFx, int melOrder, int timeLength)
+{
+  const int stride = MELFB_ROUNDUP (timeLength);
+  long long acc [WF_MEL_IDCT_STRIDE];
+  int t, f;
+
+  assert (timeLength <= WF_MEL_ORDER);
+
+  for (t=0 ; t<timeLength ; t++)
+	acc [t] = 0;
+
+  for (f=0 ; f<melOrder ; f++)
 	{
-	  outData [t] = 0.0;
-	  for (f=0 ; f<melOrder ; f++)
-		{
-		  outData [t] += inData [f] * melIDCTbasis [t][f];
-		}
+	  const int *pBasis = melIDCTbasisFx + f * stride;
+
+	  for (t=0 ; t<timeLength ; t++)
+		acc [t] += (long long) inData [f] * pBasis [t];
 	}
-  for (t=0 ; t<timeLength ; t++)
-    inData [t] = outData [t];
 
-  free (outData);
+  for (t=0 ; t<timeLength ; t++)
+	inData [t] = (int) ((acc [t] + 16384) >> 15);
 }
+#endif	// #ifdef FIXED_POINT_FE
 
 /*---------------------------------------------------------------------------
  * FUNCTION NAME: InitFFTWindows
  *
- * PURPOSE:       Initializes data structure for FFT windows (mel filter bank).
+ * PURPOSE:       Initializes the Mel filter bank (FFT windows).
  *                Computes starting point and length of each window, allocates
  *                memory for window coefficients.
  *
  * INPUT:
- *   FirstWin     Pointer to first FFT window structure
+ *   Bank         Pointer to Mel filter bank
  *   StFreq       Starting frequency of mel filter bank
  *   SmplFreq     Sampling frequency
  *   FFTLength    FFT length
  *   NumChannels  Number of channels
  *
  * OUTPUT
- *                Chained list of FFT window data structures. NOTE FFT window
- *                coefficients are not computed yet.
+ *                Filter bank layout. NOTE FFT window coefficients are not
+ *                computed yet.
  *
  * RETURN VALUE
  *   none
  *
  *---------------------------------------------------------------------------*/
-void InitFFTWindows (MelFB_Window * FirstWin,
+void InitFFTWindows (MelFB_Bank *Bank,
 					 float StFreq,
 					 float SmplFreq,
 					 int FFTLength,
@@ -425,7 +639,8 @@ void InitFFTWindows (MelFB_Window * FirstWin,
 {
   int i, TmpInt;
   float freq, start_mel, fs_per_2_mel;
-  MelFB_Window *p1, *p2;
+
+  assert (NumChannels <= MELFB_MAX_CHANNELS);
 
   /*---------------------------
    * Constants for calculation
@@ -433,7 +648,7 @@ void InitFFTWindows (MelFB_Window * FirstWin,
   start_mel = 2595.0 * log10 (1.0 + (float) StFreq / 700.0);
   fs_per_2_mel = 2595.0 * log10 (1.0 + (SmplFreq / 2) / 700.0);
 
-  p1 = FirstWin;
+  Bank->NumChannels = NumChannels;
 
   for (i=0 ; i<NumChannels ; i++)
     {
@@ -448,7 +663,7 @@ void InitFFTWindows (MelFB_Window * FirstWin,
 	  /*---------
 	   * Storing
 	   *---------*/
-	  p1->StartingPoint = TmpInt;
+	  Bank->StartingPoint [i] = TmpInt;
 
 	  /*-----------------------------------------------------------------
 	   * Calculating mel-scaled frequency for the upper edge of the band
@@ -459,26 +674,14 @@ void InitFFTWindows (MelFB_Window * FirstWin,
 	  /*---------------------------------------------------------------------
 	   * Calculating and storing the length of the band in terms of FFT-bins
 	   *---------------------------------------------------------------------*/
-	  p1->Length = (int) (FFTLength * freq / SmplFreq + 0.5) - TmpInt + 1;
-
-	  /*--------------------------------------
-	   * Allocating memory for the data field
-	   *--------------------------------------*/
-	  p1->Data = (float *) malloc (sizeof (float) * p1->Length);
-
-	  /*--------------------------------------------
-	   * Continuing with the next data structure or
-	   * close the last structure with NULL
-	   *--------------------------------------------*/
-	  if (i < NumChannels-1)
-        {
-		  p2 = (MelFB_Window *) malloc (sizeof (MelFB_Window));
-		  p1->Next = p2;
-		  p1 = p2;
-        }
-	  else
-		p1->Next = NULL;
+	  Bank->Length [i] = (int) (FFTLength * freq / SmplFreq + 0.5) - TmpInt + 1;
     }
+
+  /*--------------------------------------------
+   * Allocating memory for the coefficient rows
+   *--------------------------------------------*/
+  AllocMelFBData (Bank);
+
   return;
 }
 
@@ -486,57 +689,51 @@ void InitFFTWindows (MelFB_Window * FirstWin,
  * FUNCTION NAME: ComputeTriangle
  *
  * PURPOSE:       Computes and stores FFT window coefficients (triangle points)
- *                into initialized chained list of FFT window structures
+ *                into the initialized filter bank
  *
  * INPUT:
- *   FirstWin     Pointer to first FFT window structure
+ *   Bank         Pointer to Mel filter bank
  *
  * OUTPUT
- *                Chained list of FFT window data structures with correct
- *                window coefficients
+ *                Filter bank with correct window coefficients
  *
  * RETURN VALUE
  *   none
  *
  *---------------------------------------------------------------------------*/
-void ComputeTriangle (MelFB_Window * FirstWin)
+void ComputeTriangle (MelFB_Bank *Bank)
 {
-  MelFB_Window *p1;
+  float *pCoef;
 
   int low_part_length, hgh_part_length, TmpInt=0, i, j;
 
-  p1 = FirstWin;
-  j = 0;
-  while (p1)
+  for (j=0 ; j<Bank->NumChannels ; j++)
     {
-	  low_part_length = p1->Next ? 
-		p1->Next->StartingPoint - p1->StartingPoint + 1 :
-		TmpInt - p1->StartingPoint + 1;
+	  pCoef = Bank->Data + Bank->Offset [j];
 
-	  hgh_part_length = p1->Length - low_part_length + 1;
+	  low_part_length = (j < Bank->NumChannels - 1) ? 
+		Bank->StartingPoint [j+1] - Bank->StartingPoint [j] + 1 :
+		TmpInt - Bank->StartingPoint [j] + 1;
+
+	  hgh_part_length = Bank->Length [j] - low_part_length + 1;
 
 	  /*--------------------------------------
 	   * Lower frequency part of the triangle
 	   *--------------------------------------*/
 	  for (i=0 ; i<low_part_length ; i++)
-		p1->Data[i] = (float) (i + 1) / low_part_length;
+		pCoef [i] = (float) (i + 1) / low_part_length;
 
 	  /*---------------------------------------
 	   * Higher frequency part of the triangle
 	   *---------------------------------------*/
 	  for (i=1 ; i<hgh_part_length ; i++)
-		p1->Data[low_part_length + i - 1] =
+		pCoef [low_part_length + i - 1] =
 		  (float) (hgh_part_length - i) / hgh_part_length;
 
 	  /*------------------------------------------------------
 	   * Store upper edge (for calculating the last triangle)
 	   *------------------------------------------------------*/
-	  TmpInt = p1->StartingPoint + p1->Length - 1;
-
-	  /*------------------
-	   * Next triangle...
-	   *------------------*/
-	  p1 = p1->Next;
+	  TmpInt = Bank->StartingPoint [j] + Bank->Length [j] - 1;
     }
   return;
 }
@@ -24,6 +24,7 @@
 #include <assert.h>
 
 #include "pffft.h"
+#include "pffft_cache.h"
 
 #include "wiener/ParmInterface.h"
 #include "wiener/NoiseSup.h"
@@ -34,6 +35,11 @@
 #include "wiener/dsrAfeVad.h"
 #include "wiener/preProc.h"
 
+#ifdef FIXED_POINT_FE
+#include "basic_op/basic_op.h"
+#include "wave2mfcc/fx_sigproc.h"
+#endif	// #ifdef FIXED_POINT_FE
+
 #define MIN_MEL_MEAN	(0.07f)	//(0.10f)	//(0.12f)
 #define MAX_MEL_MEAN	(0.15f)	//(0.22f)
 #define SPEECH_MEL_TH	(0.7f)
@@ -57,6 +63,32 @@
 #define etsi_max(a,b) (((a)>(b))?(a):(b))
 #define etsi_min(a,b) (((a)>(b))?(b):(a))
 
+/*-------------------------------------------------------------
+ * Spectrum, filter and level types: integers in the
+ * fixed-point build (FIXED_POINT_FE), samples are NS_SAMPLE
+ *-------------------------------------------------------------*/
+#ifdef FIXED_POINT_FE
+typedef hci_int64 NS_SPEC;                 // spectra, power in Q8, magnitude in Q4
+typedef X_INT32   NS_GAIN;                 // filter gains, windows and impulse response, Q15
+typedef X_INT32   NS_LEVEL;                // log energies and SNRs, Q10
+
+#define NS_POW_Q          8
+#define NS_MAG_Q          4
+#define NS_RATIO_MAX      ((hci_int64) 0x7fffffff)   // spectrum ratios in Q16, saturated
+#define NS_FFT_IN_MAX     16383                      // windowed frame peak, 1 bit FFT headroom
+#define NS_FFT_STAGES     7                          // radix-2 stages of the NS_FFT_LENGTH/2 complex FFT
+
+#define NS_Q10(x)         ((X_INT32) ((x) * 1024.0 + ((x) < 0 ? -0.5 : 0.5)))
+#define NS_Q15(x)         ((X_INT32) ((x) * 32768.0 + 0.5))
+#define NS_Q16(x)         ((X_INT32) ((x) * 65536.0 + 0.5))
+#define NS_MULT_Q16(a,b)  ((((hci_int64) (a)) * (b) + 32768) >> 16)
+#define NS_DB_PER_LOG2    65761                      // 20 * log10(2) / 3 in Q15 (averSNR)
+#else	// !FIXED_POINT_FE
+typedef X_FLOAT32 NS_SPEC;
+typedef X_FLOAT32 NS_GAIN;
+typedef X_FLOAT32 NS_LEVEL;
+#endif	// #ifdef FIXED_POINT_FE
+
 typedef struct vad_data_ns VAD_DATA_NS;
 typedef struct vad_data_fd VAD_DATA_FD;
 typedef struct vad_data_ca VAD_DATA_CA;
@@ -68,8 +100,8 @@ typedef struct spectrum    SPECTRUM;
 
 struct dc_filter
 {
-  X_FLOAT32 lastSampleIn;                  // last input sample of DC offset compensation
-  X_FLOAT32 lastDCOut;                     // last output sample of DC offset compensation
+  NS_SAMPLE lastSampleIn;                  // last input sample of DC offset compensation
+  NS_SAMPLE lastDCOut;                     // last output sample of DC offset compensation (Q4 in fixed point)
 } ;
 
 struct vad_data_ns
@@ -78,7 +110,7 @@ struct vad_data_ns
   X_INT16   flagVAD;                       // VAD flag (1 == SPEECH, 0 == NON SPEECH)
   X_INT16   hangOver;                      // hangover
   X_INT16   nbSpeechFrames;                // nb speech frames (used to set hangover)
-  X_FLOAT32 meanEn;                        // mean energy
+  NS_LEVEL  meanEn;                        // mean energy
 };
 
 struct vad_data_ca
@@ -92,7 +124,11 @@ struct vad_data_ca
 struct vad_data_fd
 {
   X_FLOAT32 MelMean;			           //
+#ifdef FIXED_POINT_FE
+  hci_int64 VarMean;			           // Q30
+#else	// !FIXED_POINT_FE
   X_FLOAT32 VarMean;			           //
+#endif	// #ifdef FIXED_POINT_FE
   X_FLOAT32 AccTest;			           //
   X_FLOAT32 AccTest2;			           //
   X_FLOAT32 SpecMean;			           //
@@ -104,9 +140,9 @@ struct vad_data_fd
 
 struct gain_fact
 {
-  X_FLOAT32 denEn1 [3];                    // previous denoised frames energies
-  X_FLOAT32 lowSNRtrack;                   // low SNR track
-  X_FLOAT32 alfaGF;                        // gain factor applied in 2nd stage
+  NS_SPEC   denEn1 [3];                    // previous denoised frames energies
+  NS_LEVEL  lowSNRtrack;                   // low SNR track
+  NS_GAIN   alfaGF;                        // gain factor applied in 2nd stage
 };
 
 struct buffers
@@ -115,23 +151,23 @@ struct buffers
   X_INT32 nbFramesInSecondStage;           // nb frames in second stage
   X_INT32 nbFramesOutSecondStage;          // nb frames out of second stage
 
-  X_FLOAT32 FirstStageInFloatBuffer  [NS_BUFFER_SIZE]; // first stage buffer
-  X_FLOAT32 SecondStageInFloatBuffer [NS_BUFFER_SIZE]; // second stage buffer
+  NS_SAMPLE FirstStageInFloatBuffer  [NS_BUFFER_SIZE]; // first stage buffer
+  NS_SAMPLE SecondStageInFloatBuffer [NS_BUFFER_SIZE]; // second stage buffer
 };
 
 struct spectrum
 {
-  X_FLOAT32 nSigSE1 [NS_SPEC_ORDER];       // 1st stage noisy signal spectrum estimation
-  X_FLOAT32 nSigSE2 [NS_SPEC_ORDER];       // 2nd stage noisy signal spectrum estimation
-  X_FLOAT32 noiseSE1 [NS_SPEC_ORDER];      // 1st stage noise spectrum estimation
-  X_FLOAT32 noiseSE2 [NS_SPEC_ORDER];      // 2nd stage noise spectrum estimation
-  X_FLOAT32 denSigSE1 [NS_SPEC_ORDER];     // 1st stage denoised signal spectrum estimation
-  X_FLOAT32 denSigSE2 [NS_SPEC_ORDER];     // 2nd stage denoised signal spectrum estimation
+  NS_SPEC   nSigSE1 [NS_SPEC_ORDER];       // 1st stage noisy signal spectrum estimation
+  NS_SPEC   nSigSE2 [NS_SPEC_ORDER];       // 2nd stage noisy signal spectrum estimation
+  NS_SPEC   noiseSE1 [NS_SPEC_ORDER];      // 1st stage noise spectrum estimation
+  NS_SPEC   noiseSE2 [NS_SPEC_ORDER];      // 2nd stage noise spectrum estimation
+  NS_SPEC   denSigSE1 [NS_SPEC_ORDER];     // 1st stage denoised signal spectrum estimation
+  NS_SPEC   denSigSE2 [NS_SPEC_ORDER];     // 2nd stage denoised signal spectrum estimation
 
   X_INT16   indexBuffer1;                  // where to enter new PSD, alternatively 0 and 1
   X_INT16   indexBuffer2;                  // where to enter new PSD, alternatively 0 and 1
-  X_FLOAT32 PSDMeanBuffer1 [NS_SPEC_ORDER][NS_PSD_MEAN_ORDER]; // 1st stage PSD Mean buffer
-  X_FLOAT32 PSDMeanBuffer2 [NS_SPEC_ORDER][NS_PSD_MEAN_ORDER]; // 2nd stage PSD Mean buffer
+  NS_SPEC   PSDMeanBuffer1 [NS_SPEC_ORDER][NS_PSD_MEAN_ORDER]; // 1st stage PSD Mean buffer
+  NS_SPEC   PSDMeanBuffer2 [NS_SPEC_ORDER][NS_PSD_MEAN_ORDER]; // 2nd stage PSD Mean buffer
 };
 
 struct ns_var
@@ -148,11 +184,22 @@ struct ns_var
 
 typedef struct ns_tmp
 {
-  MelFB_Window *FirstWindow;               // chained list for Mel filtering
-  X_FLOAT32 **melIDCTbasis;                // mel-frequency inverse DCT basis
+  MelFB_Bank *FirstWindow;                 // Mel filter bank coefficients
+  X_FLOAT32 *melIDCTbasis;                 // mel-frequency inverse DCT basis [WF_MEL_ORDER][WF_MEL_IDCT_STRIDE]
   X_FLOAT32 IRWindow [NS_FILTER_LENGTH];   // filter impulse response window
   X_FLOAT32 sigWindow [NS_FRAME_LENGTH];   // signal window
+#ifdef FIXED_POINT_FE
+  NS_GAIN IRWindowFx [NS_FILTER_LENGTH];   // IRWindow in Q15
+  NS_GAIN sigWindowFx [NS_FRAME_LENGTH];   // sigWindow in Q15
+  NS_GAIN melIDCTbasisFx [WF_MEL_ORDER * WF_MEL_IDCT_STRIDE]; // melIDCTbasis in Q15
+  hci_mfcc16 fftPhase [NS_FFT_LENGTH];     // phase table of the fixed-point real FFT, Q15
+#else	// !FIXED_POINT_FE
+  PFFFT_Setup *fftSetup;                   // shared real FFT setup (pffft_cache)
+  const int *fftZorder;                    // unordered -> ordered FFT index map
+  X_INT16 psdIndex [NS_FFT_LENGTH/4];      // PSD bin of each bin pair of the unordered FFT
+  ETSI_BOOL bUnorderedFFT;                 // psdIndex valid, PSD taken from the unordered FFT
   X_FLOAT32 ALIGNED_(ALN_NS) tmpMem[NS_SCRATCH_MEM_SIZE];  // scratch memory
+#endif	// #ifdef FIXED_POINT_FE
 } NS_TMP;
 
 struct NoiseSupStructX
@@ -167,24 +214,34 @@ struct CompCepsStructX
   X_FLOAT32 StartingFrequency;               //
   X_FLOAT32 HammingWindow [NS_FRAME_LENGTH]; //
   X_FLOAT32 *pDCTMatrix;                     //
-  MelFB_Window *FirstWindow;                 //
+  MelFB_Bank *FirstWindow;                   //
 };
 
 /*------------
  * Prototypes
  *------------*/
-static void DCOffsetFil (X_FLOAT32 *Data, DC_FILTER *prevSamples, X_INT16 DataLength);
+static void DCOffsetFil (NS_SAMPLE *Data, DC_FILTER *prevSamples, X_INT16 DataLength);
+#ifdef FIXED_POINT_FE
+static X_INT32 NsSqrt (hci_int64 x);
+static hci_int64 NsRatio (hci_int64 num, hci_int64 den);
+static NS_LEVEL NsLog2 (hci_int64 x);
+static X_INT16 DoSigWindowing (const NS_SAMPLE *Data, const NS_GAIN *window, hci_mfcc16 *FFTData, X_INT16 frameLength, X_INT16 FFTLength);
+static void FFTtoPSD (const hci_mfcc16 *FFTIn, X_INT16 FFTShift, NS_SPEC *PSDOut);
+#else	// !FIXED_POINT_FE
 static void DoSigWindowing (X_FLOAT32 *Data, X_FLOAT32 *window, X_INT16 frameLength, X_INT16 FFTLength);
 static void FFTtoPSD (const X_FLOAT32 *FFTIn, X_FLOAT32 *PSDOut, X_INT16 FFTLength);
-static void PSDMean (X_INT16 *indexBuffer, X_FLOAT32 *PSDIn, X_FLOAT32 *PSDOut, X_FLOAT32 *PSDbuffer);
-static void ApplyWF (const X_FLOAT32 *data, const X_FLOAT32 *predata, const X_FLOAT32 *filter, X_FLOAT32 *result, const X_INT16 frameShift, const X_INT16 melOrder);
-static void VAD (X_INT16 fstage, VAD_DATA_NS *vadNS, const X_FLOAT32 *newShiftFrame);
-static void FilterCalc (X_INT16 fstage, NoiseSupStructX *NSX, X_FLOAT32 *PSDMeaned, X_FLOAT32 *W);
-static void DoGainFact (X_INT16 fstage, NoiseSupStructX *NSX, X_FLOAT32 *W);
-static void DoFilterWindowing (X_FLOAT32 *filterIRIn, X_FLOAT32 *hanningWindow, X_FLOAT32 *filterIROut);
+static void UnorderedFFTtoPSD (const X_FLOAT32 *FFTIn, X_FLOAT32 *PSDOut, const X_INT16 *psdIndex, const int *zorder);
+static void InitUnorderedPSD (NS_TMP *nsTmp);
+#endif	// #ifdef FIXED_POINT_FE
+static void PSDMean (X_INT16 *indexBuffer, NS_SPEC *PSDIn, NS_SPEC *PSDOut, NS_SPEC *PSDbuffer);
+static void ApplyWF (const NS_SAMPLE *data, const NS_SAMPLE *predata, const NS_GAIN *filter, NS_SAMPLE *result, const X_INT16 frameShift, const X_INT16 melOrder);
+static void VAD (X_INT16 fstage, VAD_DATA_NS *vadNS, const NS_SAMPLE *newShiftFrame);
+static void FilterCalc (X_INT16 fstage, NoiseSupStructX *NSX, NS_SPEC *PSDMeaned, NS_GAIN *W);
+static void DoGainFact (X_INT16 fstage, NoiseSupStructX *NSX, NS_GAIN *W);
+static void DoFilterWindowing (NS_GAIN *filterIRIn, NS_GAIN *hanningWindow, NS_GAIN *filterIROut);
 static X_INT16 SpeechQSpec (FEParamsX *This);
 static X_INT16 SpeechQMel (FEParamsX *This);
-static X_INT16 SpeechQVar (FEParamsX *This, X_FLOAT32 *W);
+static X_INT16 SpeechQVar (FEParamsX *This, NS_GAIN *W);
 
 /*-----------
  * Functions
@@ -207,24 +264,132 @@ static X_INT16 SpeechQVar (FEParamsX *This, X_FLOAT32 *W);
  *   none
  *
  *---------------------------------------------------------------------------*/
-static void DCOffsetFil (X_FLOAT32 *Data, DC_FILTER *prevSamples, X_INT16 DataLength)
+static void DCOffsetFil (NS_SAMPLE *Data, DC_FILTER *prevSamples, X_INT16 DataLength)
 {
   X_INT16 i;
-  X_FLOAT32 aux;
-  X_FLOAT32 *Prev_x = &(prevSamples->lastSampleIn);
-  X_FLOAT32 *Prev_y = &(prevSamples->lastDCOut);
+  NS_SAMPLE aux;
+  NS_SAMPLE *Prev_x = &(prevSamples->lastSampleIn);
+  NS_SAMPLE *Prev_y = &(prevSamples->lastDCOut);
 
   // y[n] = x[n] - x[n-1] + 0.9990234375 * y[n-1]
 
   for (i=0 ; i<DataLength ; i++)
 	{
 	  aux = Data[i];
+#ifdef FIXED_POINT_FE
+	  // 0.9990234375 = 1 - 2^-10, y[n-1] in Q4
+	  *Prev_y += (Data[i] - *Prev_x) * 16 - ((*Prev_y + 512) >> 10);
+	  Data[i] = (*Prev_y + 8) >> 4;
+	  *Prev_x = aux;
+#else	// !FIXED_POINT_FE
 	  Data[i] = Data[i] - *Prev_x + 0.9990234375 * *Prev_y;
 	  *Prev_x = aux;
 	  *Prev_y = Data[i];
+#endif	// #ifdef FIXED_POINT_FE
+	}
+}
+
+#ifdef FIXED_POINT_FE
+/*----------------------------------------------------------------------------
+ * FUNCTION NAME: NsSqrt
+ *
+ * PURPOSE:       Integer square root of a 64 bit value
+ *
+ * INPUT:
+ *   x            Value (>= 0)
+ *
+ * OUTPUT:
+ *   none
+ *
+ * RETURN VALUE:
+ *   floor (sqrt (x))
+ *
+ *---------------------------------------------------------------------------*/
+static X_INT32 NsSqrt (hci_int64 x)
+{
+  unsigned long long rem = (unsigned long long) x;
+  unsigned long long root = 0;
+  unsigned long long bit = 1ULL << 62;
+
+  while (bit > rem) bit >>= 2;
+
+  while (bit != 0)
+	{
+	  if (rem >= root + bit)
+		{
+		  rem -= root + bit;
+		  root = (root >> 1) + bit;
+		}
+	  else
+		root >>= 1;
+	  bit >>= 2;
 	}
+
+  return (X_INT32) root;
 }
 
+/*----------------------------------------------------------------------------
+ * FUNCTION NAME: NsRatio
+ *
+ * PURPOSE:       Ratio of two spectrum values
+ *
+ * INPUT:
+ *   num, den     Values (>= 0) in the same Q format
+ *
+ * OUTPUT:
+ *   none
+ *
+ * RETURN VALUE:
+ *   num / den in Q16, saturated at NS_RATIO_MAX
+ *
+ *---------------------------------------------------------------------------*/
+static hci_int64 NsRatio (hci_int64 num, hci_int64 den)
+{
+  hci_int64 ratio;
+
+  // num << 16 must not overflow
+  while (num >= ((hci_int64) 1 << 46))
+	{
+	  num >>= 1;
+	  den >>= 1;
+	}
+  if (den <= 0)
+	return NS_RATIO_MAX;
+
+  ratio = ((num << 16) + (den >> 1)) / den;
+
+  return etsi_min (ratio, NS_RATIO_MAX);
+}
+
+/*----------------------------------------------------------------------------
+ * FUNCTION NAME: NsLog2
+ *
+ * PURPOSE:       Base 2 logarithm of a 64 bit value
+ *
+ * INPUT:
+ *   x            Value (> 0)
+ *
+ * OUTPUT:
+ *   none
+ *
+ * RETURN VALUE:
+ *   log2 (x) in Q10
+ *
+ *---------------------------------------------------------------------------*/
+static NS_LEVEL NsLog2 (hci_int64 x)
+{
+  X_INT16 shift = 0;
+
+  while (x > 0x7fffffff)
+	{
+	  x >>= 1;
+	  shift++;
+	}
+
+  return PowerASR_BasicOP_fixedLOG_2 ((hci_int32) x) + shift * 1024;
+}
+#endif	// #ifdef FIXED_POINT_FE
+
 /*----------------------------------------------------------------------------
  * FUNCTION NAME: DoSigWindowing
  *
@@ -238,11 +403,42 @@ static void DCOffsetFil (X_FLOAT32 *Data, DC_FILTER *prevSamples, X_INT16 DataLe
  *
  * OUTPUT:
  *   *Data        Output frame
+ *   *FFTData     Output frame of the fixed-point build, Q15 windowed frame
+ *                shifted right by the returned count
  *
  * RETURN VALUE:
- *   none
+ *   none, fixed-point build: the shift of FFTData
  *
  *---------------------------------------------------------------------------*/
+#ifdef FIXED_POINT_FE
+static X_INT16 DoSigWindowing (const NS_SAMPLE *Data, const NS_GAIN *window, hci_mfcc16 *FFTData, X_INT16 frameLength, X_INT16 FFTLength)
+{
+  X_INT16 i;
+  X_INT16 shift = 0;
+  hci_int64 windowed [NS_FRAME_LENGTH];
+  hci_int64 maxAbs = 0;
+
+  // windowing (Q15)
+  for (i=0 ; i<frameLength ; i++)
+	{
+	  windowed [i] = (hci_int64) Data[i] * window [i];
+	  maxAbs = etsi_max (maxAbs, windowed [i] < 0 ? -windowed [i] : windowed [i]);
+	}
+
+  // block floating point input of the 16 bit FFT
+  while (((maxAbs + ((1LL << shift) >> 1)) >> shift) > NS_FFT_IN_MAX)
+	shift++;
+
+  for (i=0 ; i<frameLength ; i++)
+	FFTData [i] = (hci_mfcc16) ((windowed [i] + ((1LL << shift) >> 1)) >> shift);
+
+  // zero padding
+  for (i=frameLength ; i<FFTLength ; i++)
+    FFTData [i] = 0;
+
+  return shift;
+}
+#else	// !FIXED_POINT_FE
 static void DoSigWindowing (X_FLOAT32 *Data, X_FLOAT32 *window, X_INT16 frameLength, X_INT16 FFTLength)
 {
   X_INT16 i;
@@ -257,6 +453,7 @@ static void DoSigWindowing (X_FLOAT32 *Data, X_FLOAT32 *window, X_INT16 frameLen
 
   return;
 }
+#endif	// #ifdef FIXED_POINT_FE
 
 /*----------------------------------------------------------------------------
  * FUNCTION NAME: FFTtoPSD
@@ -266,14 +463,41 @@ static void DoSigWindowing (X_FLOAT32 *Data, X_FLOAT32 *window, X_INT16 frameLen
  * INPUT:
  *   *FFTIn       Input Spectrum 
  *   FFTLenth     FFT length
+ *   FFTShift     Fixed-point build: shift of the FFT input (DoSigWindowing)
  *
  * OUTPUT:
- *   *PSDOut      Output PSD
+ *   *PSDOut      Output PSD (Q8 in the fixed-point build)
  *
  * RETURN VALUE:
  *   none
  *
  *---------------------------------------------------------------------------*/
+#ifdef FIXED_POINT_FE
+static void FFTtoPSD (const hci_mfcc16 *FFTIn, X_INT16 FFTShift, NS_SPEC *PSDOut)
+{
+	// FFTIn is the spectrum of the Q15 frame >> FFTShift, divided by 2^7 (FFT stages),
+	// (spec0 + spec1) / 2 in Q8 is (spec0 + spec1) << (2 * (FFTShift + 7 - 15) + 8 - 1)
+	const int pow = 2 * FFTShift - 9;
+	hci_int64 spec;
+
+	for (int i = 1; i < NS_SPEC_ORDER-1; i++)
+	{
+		int re0 = 4 * i;
+		int im0 = re0 + 1;
+		int re1 = re0 + 2;
+		int im1 = re0 + 3;
+		spec = (hci_int64) FFTIn[re0] * FFTIn[re0] + (hci_int64) FFTIn[im0] * FFTIn[im0]
+			+ (hci_int64) FFTIn[re1] * FFTIn[re1] + (hci_int64) FFTIn[im1] * FFTIn[im1];
+		PSDOut[i] = pow >= 0 ? spec << pow : spec >> -pow;
+	}
+	spec = (hci_int64) FFTIn[0] * FFTIn[0] + (hci_int64) FFTIn[2] * FFTIn[2] + (hci_int64) FFTIn[3] * FFTIn[3];
+	PSDOut[0] = pow >= 0 ? spec << pow : spec >> -pow;
+	spec = 2 * (hci_int64) FFTIn[1] * FFTIn[1];
+	PSDOut[NS_SPEC_ORDER-1] = pow >= 0 ? spec << pow : spec >> -pow;
+
+  return;
+}
+#else	// !FIXED_POINT_FE
 static void FFTtoPSD (const X_FLOAT32 *FFTIn, X_FLOAT32 *PSDOut, X_INT16 FFTLength)
 {
 	for (int i = 1; i < NS_SPEC_ORDER-1; i++)
@@ -291,6 +515,105 @@ static void FFTtoPSD (const X_FLOAT32 *FFTIn, X_FLOAT32 *PSDOut, X_INT16 FFTLeng
 
   return;
 }
+#endif	// #ifdef FIXED_POINT_FE
+
+#ifndef FIXED_POINT_FE
+/*----------------------------------------------------------------------------
+ * FUNCTION NAME: UnorderedFFTtoPSD
+ *
+ * PURPOSE:       Compute PSD from the unordered (z-domain) pffft output,
+ *                same values as FFTtoPSD on the ordered spectrum
+ *              
+ * INPUT:
+ *   *FFTIn       Unordered spectrum: blocks of 4 real parts followed by
+ *                the 4 imaginary parts of the same bins
+ *   *psdIndex    PSD bin of each bin pair (see InitUnorderedPSD)
+ *   *zorder      Unordered -> ordered FFT index map
+ *
+ * OUTPUT:
+ *   *PSDOut      Output PSD
+ *
+ * RETURN VALUE:
+ *   none
+ *
+ *---------------------------------------------------------------------------*/
+static void UnorderedFFTtoPSD (const X_FLOAT32 *FFTIn, X_FLOAT32 *PSDOut, const X_INT16 *psdIndex, const int *zorder)
+{
+	const X_FLOAT32 DC = FFTIn[zorder[0]];
+	const X_FLOAT32 Nyq = FFTIn[zorder[1]];
+	const X_FLOAT32 re1 = FFTIn[zorder[2]];
+	const X_FLOAT32 im1 = FFTIn[zorder[3]];
+	X_FLOAT32 spec [4];
+
+	for (int g = 0; g < NS_FFT_LENGTH/8; g++)
+	{
+		const X_FLOAT32 *re = FFTIn + 8 * g;
+		const X_FLOAT32 *im = re + 4;
+
+		for (int l = 0; l < 4; l++)
+			spec[l] = re[l] * re[l] + im[l] * im[l];
+
+		PSDOut[psdIndex[2 * g]] = (spec[0] + spec[1]) / 2.f;
+		PSDOut[psdIndex[2 * g + 1]] = (spec[2] + spec[3]) / 2.f;
+	}
+
+	// DC and Nyquist share one lane, PSD[0] written by the loop is not valid
+	PSDOut[0] = ((DC*DC) + (re1*re1 + im1*im1)) / 2.f;
+	PSDOut[NS_SPEC_ORDER-1] = Nyq * Nyq;
+
+  return;
+}
+
+/*----------------------------------------------------------------------------
+ * FUNCTION NAME: InitUnorderedPSD
+ *
+ * PURPOSE:       Map the bin pairs of the unordered pffft output to PSD bins.
+ *                bUnorderedFFT stays FALSE if the layout is not the SIMD one
+ *                (blocks of 4 real + 4 imaginary parts of adjacent bins).
+ *              
+ * INPUT:
+ *   *nsTmp       fftSetup, fftZorder
+ *
+ * OUTPUT:
+ *   *nsTmp       psdIndex, bUnorderedFFT
+ *
+ * RETURN VALUE:
+ *   none
+ *
+ *---------------------------------------------------------------------------*/
+static void InitUnorderedPSD (NS_TMP *nsTmp)
+{
+	int zpos [NS_FFT_LENGTH];	// ordered -> unordered inverse
+	int k, g, l;
+
+	nsTmp->bUnorderedFFT = FALSE;
+	if (nsTmp->fftZorder == NULL)
+		return;
+
+	for (k = 0; k < NS_FFT_LENGTH; k++)
+		zpos[nsTmp->fftZorder[k]] = k;
+
+	for (g = 0; g < NS_FFT_LENGTH/8; g++)
+	{
+		int bin [4];
+		for (l = 0; l < 4; l++)
+		{
+			const int re = zpos[8 * g + l];
+			const int im = zpos[8 * g + 4 + l];
+			if ((re & 1) || im != re + 1)
+				return;
+			bin[l] = re / 2;
+		}
+		if (bin[0] / 2 != bin[1] / 2 || bin[2] / 2 != bin[3] / 2)
+			return;
+		nsTmp->psdIndex[2 * g] = (X_INT16)(bin[0] / 2);
+		nsTmp->psdIndex[2 * g + 1] = (X_INT16)(bin[2] / 2);
+	}
+	nsTmp->bUnorderedFFT = TRUE;
+
+  return;
+}
+#endif	// #ifndef FIXED_POINT_FE
 
 /*----------------------------------------------------------------------------
  * FUNCTION NAME: PSDMean
@@ -309,7 +632,7 @@ static void FFTtoPSD (const X_FLOAT32 *FFTIn, X_FLOAT32 *PSDOut, X_INT16 FFTLeng
  *   none
  *
  *---------------------------------------------------------------------------*/
-static void PSDMean (X_INT16 *indexBuffer, X_FLOAT32 *PSDIn, X_FLOAT32 *PSDOut, X_FLOAT32 *PSDBuffer)
+static void PSDMean (X_INT16 *indexBuffer, NS_SPEC *PSDIn, NS_SPEC *PSDOut, NS_SPEC *PSDBuffer)
 {
   X_INT16 i, index;
 
@@ -344,11 +667,22 @@ static void PSDMean (X_INT16 *indexBuffer, X_FLOAT32 *PSDIn, X_FLOAT32 *PSDOut,
  *   none
  *
  *---------------------------------------------------------------------------*/
-static void ApplyWF(const X_FLOAT32 *data, const X_FLOAT32 *predata, const X_FLOAT32 *filter, X_FLOAT32 *result, const X_INT16 frameShift, const X_INT16 melOrder)
+static void ApplyWF(const NS_SAMPLE *data, const NS_SAMPLE *predata, const NS_GAIN *filter, NS_SAMPLE *result, const X_INT16 frameShift, const X_INT16 melOrder)
 {
 	for (int i = 0; i<frameShift; i++)
 	{
 		int j_max = i<=melOrder ? i : melOrder;
+#ifdef FIXED_POINT_FE
+		hci_int64 sum = 0;	// Q15
+
+		for (int j = -melOrder; j <= j_max; j++)
+			sum += ((hci_int64) filter[j + melOrder] * data[i-j]);
+
+		for (int j = i+1; j <= melOrder; j++)
+			sum += ((hci_int64) filter[j + melOrder] * predata[frameShift - j + i]);
+
+		result[i] = (NS_SAMPLE) ((sum + 16384) >> 15);
+#else	// !FIXED_POINT_FE
 		float sum = 0.f;
 
 		for (int j = -melOrder; j <= j_max; j++)
@@ -358,6 +692,7 @@ static void ApplyWF(const X_FLOAT32 *data, const X_FLOAT32 *predata, const X_FLO
 			sum += (filter[j + melOrder] * predata[frameShift - j + i]);
 
 		result[i] = sum;
+#endif	// #ifdef FIXED_POINT_FE
 	}
 }
 
@@ -378,16 +713,21 @@ static void ApplyWF(const X_FLOAT32 *data, const X_FLOAT32 *predata, const X_FLO
  *   none
  *
  *---------------------------------------------------------------------------*/
-static void VAD (X_INT16 fstage, VAD_DATA_NS *vadNS, const X_FLOAT32 *newShiftFrame)
+static void VAD (X_INT16 fstage, VAD_DATA_NS *vadNS, const NS_SAMPLE *newShiftFrame)
 {
   X_INT16 i;
   X_INT16 flagVAD;
   X_INT16 hangOver;
   X_INT16 nbSpeechFrames;
   X_INT32 nbFrame;
-  X_FLOAT32 meanEn;
-  X_FLOAT32 frameEn;
+  NS_LEVEL meanEn;
+  NS_LEVEL frameEn;
+#ifdef FIXED_POINT_FE
+  X_INT32 lambdaLTE;                       // Q16
+  hci_int64 sumEn;
+#else	// !FIXED_POINT_FE
   X_FLOAT32 lambdaLTE;
+#endif	// #ifdef FIXED_POINT_FE
 
   nbFrame        = vadNS->nbFrame [fstage];
   meanEn         = vadNS->meanEn;
@@ -400,6 +740,30 @@ static void VAD (X_INT16 fstage, VAD_DATA_NS *vadNS, const X_FLOAT32 *newShiftFr
 
   if (fstage == 1) return;
 
+#ifdef FIXED_POINT_FE
+  if (nbFrame < NS_NB_FRAME_THRESHOLD_LTE)
+    lambdaLTE = 65536 - 65536 / nbFrame;
+  else
+    lambdaLTE = NS_Q16 (NS_LAMBDA_LTE_LOWER_E);
+
+  sumEn = 64;
+
+  for (i=0 ; i<NS_FRAME_SHIFT ; i++)
+    sumEn += (hci_int64) newShiftFrame[i] * newShiftFrame[i];
+
+  frameEn = NS_Q10 (0.5) + (NsLog2 (sumEn) - NS_Q10 (6.0)) * 16;
+
+  if (((frameEn - meanEn) < NS_SNR_THRESHOLD_UPD_LTE * 1024) || (nbFrame < NS_MIN_FRAME))
+	{
+	  if ((frameEn < meanEn) || (nbFrame < NS_MIN_FRAME))
+		meanEn += (NS_LEVEL) NS_MULT_Q16 (65536 - lambdaLTE, frameEn - meanEn);
+	  else
+		meanEn += (NS_LEVEL) NS_MULT_Q16 (NS_Q16 (1 - NS_LAMBDA_LTE_HIGHER_E), frameEn - meanEn);
+
+	  if (meanEn < NS_Q10 (NS_ENERGY_FLOOR))
+		meanEn = NS_Q10 (NS_ENERGY_FLOOR);
+	}
+#else	// !FIXED_POINT_FE
   if (nbFrame < NS_NB_FRAME_THRESHOLD_LTE)
     lambdaLTE = 1 - 1 / (X_FLOAT32) nbFrame;
   else
@@ -422,9 +786,14 @@ static void VAD (X_INT16 fstage, VAD_DATA_NS *vadNS, const X_FLOAT32 *newShiftFr
 	  if (meanEn < NS_ENERGY_FLOOR)
 		meanEn = NS_ENERGY_FLOOR;
 	}
+#endif	// #ifdef FIXED_POINT_FE
   if (nbFrame > 4)
   	{
+#ifdef FIXED_POINT_FE
+	  if ((frameEn - meanEn) > NS_SNR_THRESHOLD_VAD * 1024)
+#else	// !FIXED_POINT_FE
 	  if ((frameEn - meanEn) > NS_SNR_THRESHOLD_VAD)
+#endif	// #ifdef FIXED_POINT_FE
 		{
 		  flagVAD = 1;
 		  nbSpeechFrames++;
@@ -468,16 +837,14 @@ static void VAD (X_INT16 fstage, VAD_DATA_NS *vadNS, const X_FLOAT32 *newShiftFr
  *   none
  *
  *---------------------------------------------------------------------------*/
-static void FilterCalc (X_INT16 fstage, NoiseSupStructX *NSX, X_FLOAT32 *PSDMeaned, X_FLOAT32 *W)
+static void FilterCalc (X_INT16 fstage, NoiseSupStructX *NSX, NS_SPEC *PSDMeaned, NS_GAIN *W)
 {
   const X_INT16 flagVAD = NSX->nsVar.vadNS.flagVAD;
   const X_INT32 nbFrame = NSX->nsVar.vadNS.nbFrame[fstage];
 
-  X_FLOAT32 lambdaNSE;
-
-  X_FLOAT32 *nSigSE   = NSX->nsVar.spectrum.nSigSE1;
-  X_FLOAT32 *noiseSE  = NSX->nsVar.spectrum.noiseSE1;
-  X_FLOAT32 *denSigSE = NSX->nsVar.spectrum.denSigSE1;
+  NS_SPEC *nSigSE   = NSX->nsVar.spectrum.nSigSE1;
+  NS_SPEC *noiseSE  = NSX->nsVar.spectrum.noiseSE1;
+  NS_SPEC *denSigSE = NSX->nsVar.spectrum.denSigSE1;
   if (fstage == 1)
 	{
 	  nSigSE    = NSX->nsVar.spectrum.nSigSE2;
@@ -485,6 +852,85 @@ static void FilterCalc (X_INT16 fstage, NoiseSupStructX *NSX, X_FLOAT32 *PSDMean
 	  denSigSE  = NSX->nsVar.spectrum.denSigSE2;
 	}
 
+#ifdef FIXED_POINT_FE
+  /*------------------------------------------------------------
+   * same steps as the float code below: power spectra in Q8,
+   * magnitudes in Q4, ratios and SNRs in Q16, W in Q15
+   *------------------------------------------------------------*/
+  if (fstage == 1)
+	{
+	  // noise estimation in energy
+	  for (int i = 0; i < NS_SPEC_ORDER; i++)
+		noiseSE[i] *= noiseSE[i];
+
+	  if (nbFrame < 11)
+		{
+		  for (int i = 0; i < NS_SPEC_ORDER; i++)
+			{
+			  noiseSE[i] += (PSDMeaned[i] - noiseSE[i]) / nbFrame;
+			  if (noiseSE[i] < 1) noiseSE[i] = 1;
+			}
+		}
+	  else
+		{
+		  hci_int64 upDate;
+		  hci_int64 inv;
+		  for (int i = 0; i < NS_SPEC_ORDER; i++)
+			{
+			  // 0.9 + 0.1 * (P / (P + N)) * (1 + 10 / (10 + P / N))
+			  inv = ((hci_int64) 10 << 32) / (10 * 65536 + NsRatio (PSDMeaned[i], noiseSE[i]));
+			  upDate = NS_MULT_Q16 (NsRatio (PSDMeaned[i], PSDMeaned[i] + noiseSE[i]), 65536 + inv);
+			  upDate = NS_Q16 (0.9) + (upDate + 5) / 10;
+			  noiseSE[i] = (noiseSE[i] >> 16) * upDate + (((noiseSE[i] & 0xffff) * upDate + 32768) >> 16);
+			}
+		}
+
+	  // store noise estimation values in magnitude
+	  for (int i = 0; i < NS_SPEC_ORDER; i++)
+		{
+		  noiseSE[i] = NsSqrt (noiseSE[i]);
+		  if (noiseSE[i] < 1) noiseSE[i] = 1;
+		}
+	}
+
+  for (int i = 0; i < NS_SPEC_ORDER; i++)
+	{
+	  nSigSE[i]    = NsSqrt (nSigSE[i]);
+	  PSDMeaned[i] = NsSqrt (PSDMeaned[i]);
+	}
+
+  if (fstage == 0)
+	{
+	  if (flagVAD == 0)
+		{
+		  for (int i = 0; i < NS_SPEC_ORDER; i++)
+			{
+			  if (nbFrame < NS_NB_FRAME_THRESHOLD_NSE)
+				noiseSE[i] += (PSDMeaned[i] - noiseSE[i]) / nbFrame;
+			  else
+				noiseSE[i] += NS_MULT_Q16 (NS_Q16 (1 - NS_LAMBDA_NSE), PSDMeaned[i] - noiseSE[i]);
+			  if (noiseSE[i] < 1) noiseSE[i] = 1;
+			}
+		}
+	}
+
+  for (int i = 0; i < NS_SPEC_ORDER; i++)
+	{
+	  const hci_int64 SNRpost = NsRatio (PSDMeaned[i], noiseSE[i]) - 65536;
+	  hci_int64 SNRprio = NS_MULT_Q16 (NS_Q16 (NS_BETA), NsRatio (denSigSE[i], noiseSE[i]))
+		+ NS_MULT_Q16 (NS_Q16 (1 - NS_BETA), etsi_max (0, SNRpost));
+	  const hci_int64 W1 = (SNRprio << 16) / (65536 + SNRprio);   // Q16
+	  SNRprio = etsi_min (NS_MULT_Q16 (W1, NsRatio (PSDMeaned[i], noiseSE[i])), NS_RATIO_MAX);
+	  SNRprio = etsi_max (SNRprio, NS_Q16 (NS_RSB_MIN));
+	  W[i] = (NS_GAIN) (((SNRprio << 15) + ((65536 + SNRprio) >> 1)) / (65536 + SNRprio));
+	}
+  for (int i = 0; i < NS_SPEC_ORDER; i++)
+	{
+	  denSigSE [i] = ((hci_int64) W[i] * nSigSE[i] + 16384) >> 15;
+	}
+#else	// !FIXED_POINT_FE
+  X_FLOAT32 lambdaNSE;
+
 
   /*-------------------------------------------------------
    * Choice of the Noise Estimation according to 2WF stage
@@ -573,6 +1019,7 @@ static void FilterCalc (X_INT16 fstage, NoiseSupStructX *NSX, X_FLOAT32 *PSDMean
 	{
 	  denSigSE [i] = W[i] * nSigSE[i];
 	}
+#endif	// #ifdef FIXED_POINT_FE
 
   return;
 }
@@ -593,15 +1040,19 @@ static void FilterCalc (X_INT16 fstage, NoiseSupStructX *NSX, X_FLOAT32 *PSDMean
  *   none
  *
  *---------------------------------------------------------------------------*/
-static void DoGainFact (X_INT16 fstage, NoiseSupStructX *NSX, X_FLOAT32 *W)
+static void DoGainFact (X_INT16 fstage, NoiseSupStructX *NSX, NS_GAIN *W)
 {
   X_INT16 i;
 
-  X_FLOAT32 averSNR;
-  X_FLOAT32 noiseEn;
+  NS_LEVEL averSNR;
+  NS_SPEC noiseEn;
+#ifdef FIXED_POINT_FE
+  X_INT32 lambdaSNR;                       // Q16
+#else	// !FIXED_POINT_FE
   X_FLOAT32 lambdaSNR;
-  X_FLOAT32 *noiseSE  = NSX->nsVar.spectrum.noiseSE2;
-  X_FLOAT32 *denSigSE = NSX->nsVar.spectrum.denSigSE1;
+#endif	// #ifdef FIXED_POINT_FE
+  NS_SPEC *noiseSE  = NSX->nsVar.spectrum.noiseSE2;
+  NS_SPEC *denSigSE = NSX->nsVar.spectrum.denSigSE1;
 
   GAIN_FACT *gainFact = &(NSX->nsVar.gainFact);
 
@@ -609,9 +1060,57 @@ static void DoGainFact (X_INT16 fstage, NoiseSupStructX *NSX, X_FLOAT32 *W)
 	{
 	  gainFact->denEn1 [0] = gainFact->denEn1 [1];
 	  gainFact->denEn1 [1] = gainFact->denEn1 [2];
-	  gainFact->denEn1 [2] = 0.0;
+	  gainFact->denEn1 [2] = 0;
 	  for (i=0 ; i<NS_SPEC_ORDER ; i++) gainFact->denEn1 [2] += denSigSE [i]; // new denEn1
 	}
+#ifdef FIXED_POINT_FE
+  else
+	{
+	  // magnitudes in Q4, dB in Q10
+	  noiseEn = 0;
+	  for (i=0 ; i<NS_SPEC_ORDER ; i++) noiseEn += noiseSE [i];
+
+	  if (gainFact->denEn1 [0] > 0 && gainFact->denEn1 [1] > 0 && gainFact->denEn1 [2] > 0)
+		{
+		  averSNR = (NS_LEVEL) (((hci_int64) (NsLog2 (gainFact->denEn1 [0]) + NsLog2 (gainFact->denEn1 [1])
+			+ NsLog2 (gainFact->denEn1 [2]) - 3 * NsLog2 (noiseEn)) * NS_DB_PER_LOG2 + 16384) >> 15);
+		  averSNR = etsi_max (averSNR, NS_Q10 (-100.0 / 3.0));
+		}
+	  else
+		averSNR = NS_Q10 (-100.0 / 3.0);
+
+	  if ( ((averSNR - gainFact->lowSNRtrack) < NS_Q10 (10.0)) || (NSX->nsVar.vadNS.nbFrame[fstage] < NS_MIN_FRAME) )
+		{
+		  if (NSX->nsVar.vadNS.nbFrame[fstage] < NS_MIN_FRAME)
+			lambdaSNR = 65536 - 65536 / NSX->nsVar.vadNS.nbFrame[fstage];
+		  else 
+			{
+			  if (averSNR < gainFact->lowSNRtrack)
+				lambdaSNR = NS_Q16 (0.95);
+			  else
+				lambdaSNR = NS_Q16 (0.99);
+			}
+		  gainFact->lowSNRtrack += (NS_LEVEL) NS_MULT_Q16 (65536 - lambdaSNR, averSNR - gainFact->lowSNRtrack);
+		}
+
+	  if (gainFact->denEn1 [2] > (100 << NS_MAG_Q)) // no change if very low signal
+		{
+		  if (averSNR < (gainFact->lowSNRtrack + NS_Q10 (3.5)))
+			{
+			  gainFact->alfaGF += NS_Q15 (0.15);
+			  if (gainFact->alfaGF > NS_Q15 (0.8)) gainFact->alfaGF = NS_Q15 (0.8);
+			}
+		  else 
+			{
+			  gainFact->alfaGF -= NS_Q15 (0.3);
+			  if (gainFact->alfaGF < NS_Q15 (0.1)) gainFact->alfaGF = NS_Q15 (0.1);
+			}
+		}
+
+	  for (i=0 ; i<WF_MEL_ORDER ; i++)
+		W[i] = (NS_GAIN) (((hci_int64) gainFact->alfaGF * W[i] + (hci_int64) (32768 - gainFact->alfaGF) * 32768 + 16384) >> 15);
+	}
+#else	// !FIXED_POINT_FE
   else
 	{
 	  noiseEn = 0.0;
@@ -654,6 +1153,7 @@ static void DoGainFact (X_INT16 fstage, NoiseSupStructX *NSX, X_FLOAT32 *W)
 	  for (i=0 ; i<WF_MEL_ORDER ; i++)
 		W[i] = gainFact->alfaGF * W[i] + (1.0 - gainFact->alfaGF) * 1.0;
 	}
+#endif	// #ifdef FIXED_POINT_FE
 }
 
 /*----------------------------------------------------------------------------
@@ -672,13 +1172,17 @@ static void DoGainFact (X_INT16 fstage, NoiseSupStructX *NSX, X_FLOAT32 *W)
  *   none
  *
  *---------------------------------------------------------------------------*/
-static void DoFilterWindowing (X_FLOAT32 *filterIRIn, X_FLOAT32 *hanningWindow, X_FLOAT32 *filterIROut)
+static void DoFilterWindowing (NS_GAIN *filterIRIn, NS_GAIN *hanningWindow, NS_GAIN *filterIROut)
 {
   X_INT16 i, j;
 
   for (i=NS_HALF_FILTER_LENGTH,j=0 ; i<NS_FILTER_LENGTH ; i++,j++)
 	{
+#ifdef FIXED_POINT_FE
+	  filterIROut [NS_HALF_FILTER_LENGTH+j] = (NS_GAIN) (((hci_int64) filterIRIn [j] * hanningWindow [i] + 16384) >> 15);
+#else	// !FIXED_POINT_FE
 	  filterIROut [NS_HALF_FILTER_LENGTH+j] = filterIRIn [j] * hanningWindow [i];
+#endif	// #ifdef FIXED_POINT_FE
 	  filterIROut [NS_HALF_FILTER_LENGTH-j] = filterIROut [NS_HALF_FILTER_LENGTH+j];
 	}
 }
@@ -824,13 +1328,49 @@ static X_INT16 SpeechQMel (FEParamsX *This)
  *   none
  *
  *---------------------------------------------------------------------------*/
-static X_INT16 SpeechQVar (FEParamsX *This, X_FLOAT32 *W)
+static X_INT16 SpeechQVar (FEParamsX *This, NS_GAIN *W)
 {
   NoiseSupStructX *NSX = This->NSX;
   VAD_DATA_FD *vadFD = &(NSX->nsVar.vadFD);
   X_INT16 i; 
   X_INT16 ssize = NS_FFT_LENGTH / 4;
   X_INT32 FrameCounter = This->NSX->nsVar.vadNS.nbFrame[0];
+#ifdef FIXED_POINT_FE
+  hci_int64 var = 0;                       // Q30
+  hci_int64 mean = 0;                      // Q15
+  hci_int64 specVar = 0;                   // Q30
+
+  for (i=0 ; i<ssize ; i++)
+	{
+	  mean += W[i];
+	  var  += (hci_int64) W[i] * W[i];
+	}
+  specVar = (var / ssize)  - mean * mean / (ssize * ssize);
+
+  if (FrameCounter < INIT_NS_FRAME)
+	{
+	  vadFD->VarMean = etsi_max (vadFD->VarMean, specVar);
+	}
+
+  if (specVar * 2 < vadFD->VarMean * 3 && specVar * 100 > vadFD->VarMean * 85)
+	{
+	  vadFD->VarMean = (vadFD->VarMean * 4 + specVar) / 5;
+	}
+
+  if (specVar * 4 <= vadFD->VarMean)
+	{
+	  vadFD->VarMean = (vadFD->VarMean * 97 + specVar * 3) / 100;
+	}
+
+  if (specVar * 100 > vadFD->VarMean * 165)
+	{
+	  return 1;
+	}
+  else
+	{
+	  return 0;
+	}
+#else	// !FIXED_POINT_FE
   X_FLOAT32 var = 0.0;
   X_FLOAT32 mean = 0.0;
   X_FLOAT32 specVar = 0.0;
@@ -865,6 +1405,7 @@ static X_INT16 SpeechQVar (FEParamsX *This, X_FLOAT32 *W)
 	{
 	  return 0;
 	}
+#endif	// #ifdef FIXED_POINT_FE
 }
 
 
@@ -1055,7 +1596,7 @@ extern NoiseSupStructX *DoNoiseSupAlloc (void)
   InitMelFBwindows (NSX->nsTmp.FirstWindow, 0.0, (X_FLOAT32)NSX->nsVar.SampFreq, 2*(NS_SPEC_ORDER-1), WF_MEL_ORDER, 1);
 
   // mel IDCT
-  NSX->nsTmp.melIDCTbasis = (X_FLOAT32 **) malloc (sizeof (X_FLOAT32 *) * WF_MEL_ORDER);
+  NSX->nsTmp.melIDCTbasis = (X_FLOAT32 *) pffft_aligned_malloc (sizeof (X_FLOAT32) * WF_MEL_ORDER * WF_MEL_IDCT_STRIDE);
   if (NSX->nsTmp.melIDCTbasis == NULL)
 	{
 	  fprintf (stderr, "ERROR:   Memory allocation error occured!\r\n");
@@ -1063,18 +1604,42 @@ extern NoiseSupStructX *DoNoiseSupAlloc (void)
 	  return NULL;
 	}
 
-  for (i=0 ; i<WF_MEL_ORDER ; i++)
+  InitMelIDCTbasis (NSX->nsTmp.melIDCTbasis, NSX->nsTmp.FirstWindow, WF_MEL_ORDER, NSX->nsVar.SampFreq, 2*(NS_SPEC_ORDER-1));
+
+#ifdef FIXED_POINT_FE
+  // Q15 copies of the tables above
+  for (i=0 ; i<NS_FRAME_LENGTH ; i++)
+	NSX->nsTmp.sigWindowFx[i] = NS_Q15 (NSX->nsTmp.sigWindow[i]);
+  for (i=0 ; i<NS_FILTER_LENGTH ; i++)
+	NSX->nsTmp.IRWindowFx[i] = NS_Q15 (NSX->nsTmp.IRWindow[i]);
+
+  InitMelFBFx (NSX->nsTmp.FirstWindow);
+  if (NSX->nsTmp.FirstWindow->DataFx == NULL)
 	{
-	  NSX->nsTmp.melIDCTbasis[i] = (X_FLOAT32 *) malloc (sizeof (X_FLOAT32) * WF_MEL_ORDER);
-	  if (NSX->nsTmp.melIDCTbasis[i] == NULL)
-		{
-		  fprintf (stderr, "ERROR:   Memory allocation error occured!\r\n");
-		  DoNoiseSupDelete( NSX );
-		  return NULL;
-		}
+	  fprintf (stderr, "ERROR:   Memory allocation error occured!\r\n");
+	  DoNoiseSupDelete( NSX );
+	  return NULL;
 	}
+  InitMelIDCTbasisFx (NSX->nsTmp.melIDCTbasisFx, NSX->nsTmp.melIDCTbasis, WF_MEL_ORDER, WF_MEL_ORDER);
 
-  InitMelIDCTbasis (NSX->nsTmp.melIDCTbasis, NSX->nsTmp.FirstWindow, WF_MEL_ORDER, NSX->nsVar.SampFreq, 2*(NS_SPEC_ORDER-1));
+  // phase table of the real FFT : cos, sin of 2*pi*i/N, Q15
+  for (i=0 ; i<NS_FFT_LENGTH/2 ; i++)
+	{
+	  NSX->nsTmp.fftPhase[2*i]   = (hci_mfcc16) etsi_min (32767, floor (32768.0 * cos (PIx2 * i / NS_FFT_LENGTH) + 0.5));
+	  NSX->nsTmp.fftPhase[2*i+1] = (hci_mfcc16) etsi_min (32767, floor (32768.0 * sin (PIx2 * i / NS_FFT_LENGTH) + 0.5));
+	}
+#else	// !FIXED_POINT_FE
+  // real FFT, setup shared by all channels
+  NSX->nsTmp.fftSetup = pffft_cache_setup (NS_FFT_LENGTH, PFFFT_REAL);
+  if (NSX->nsTmp.fftSetup == NULL)
+	{
+	  fprintf (stderr, "ERROR:   FFT setup error occured!\r\n");
+	  DoNoiseSupDelete( NSX );
+	  return NULL;
+	}
+  NSX->nsTmp.fftZorder = pffft_cache_zorder (NSX->nsTmp.fftSetup);
+  InitUnorderedPSD (&NSX->nsTmp);
+#endif	// #ifdef FIXED_POINT_FE
 
   return NSX;
 }
@@ -1114,7 +1679,11 @@ extern void DoNoiseSupInit (FEParamsX *This)
   /*-----------
    * gain_fact
    *-----------*/
+#ifdef FIXED_POINT_FE
+  NSX->nsVar.gainFact.alfaGF = NS_Q15 (0.8);
+#else	// !FIXED_POINT_FE
   NSX->nsVar.gainFact.alfaGF = 0.8;
+#endif	// #ifdef FIXED_POINT_FE
 
   /*-------------
    * vad_data_ns
@@ -1127,7 +1696,11 @@ extern void DoNoiseSupInit (FEParamsX *This)
    *----------*/
   for (int i = 0; i<NS_SPEC_ORDER; i++)
 	{
+#ifdef FIXED_POINT_FE
+	  NSX->nsVar.spectrum.noiseSE1[i]    = NSX->nsVar.spectrum.noiseSE2[i]    = 1;	// smallest Q4 magnitude
+#else	// !FIXED_POINT_FE
 	  NSX->nsVar.spectrum.noiseSE1[i]    = NSX->nsVar.spectrum.noiseSE2[i]    = NS_EPS;
+#endif	// #ifdef FIXED_POINT_FE
 	}
 }
 
@@ -1148,17 +1721,15 @@ extern void DoNoiseSupInit (FEParamsX *This)
  *---------------------------------------------------------------------------*/
 extern void DoNoiseSupDelete (NoiseSupStructX *NSX)
 {
-  X_INT16 i;
-
   if (NSX != NULL)
 	{
 	  ReleaseMelFBwindows (NSX->nsTmp.FirstWindow);
 	  free (NSX->nsTmp.FirstWindow);
 
-	  for (i=0 ; i<WF_MEL_ORDER ; i++)
-		free (NSX->nsTmp.melIDCTbasis[i]);
-
-	  free (NSX->nsTmp.melIDCTbasis);
+	  pffft_aligned_free (NSX->nsTmp.melIDCTbasis);
+#ifndef FIXED_POINT_FE
+	  pffft_cache_release (NSX->nsTmp.fftSetup);
+#endif
 
 	  free (NSX); 
 	}
@@ -1291,15 +1862,15 @@ const static X_FLOAT32 afPePower[NS_FFT_LENGTH/2+1] = {
  *   FALSE        If no frame outputed (happens at the beginning due to the latency)
  *
  *---------------------------------------------------------------------------*/
-extern ETSI_BOOL DoNoiseSup(const X_FLOAT32 *InData, X_FLOAT32 *OutData, FEParamsX *This)
+extern ETSI_BOOL DoNoiseSup(const NS_SAMPLE *InData, NS_SAMPLE *OutData, FEParamsX *This)
 {
   X_INT16 i; 
   X_INT16 fstage;                      // noise suppression filter stage
 
   NoiseSupStructX *NSX = This->NSX;
 
-  X_FLOAT32 *FirstStageInFloatBuffer  = NSX->nsVar.buffers.FirstStageInFloatBuffer;
-  X_FLOAT32 *SecondStageInFloatBuffer = NSX->nsVar.buffers.SecondStageInFloatBuffer;
+  NS_SAMPLE *FirstStageInFloatBuffer  = NSX->nsVar.buffers.FirstStageInFloatBuffer;
+  NS_SAMPLE *SecondStageInFloatBuffer = NSX->nsVar.buffers.SecondStageInFloatBuffer;
 
   X_INT32 *nbFramesInFirstStage     = &(NSX->nsVar.buffers.nbFramesInFirstStage);
   X_INT32 *nbFramesInSecondStage    = &(NSX->nsVar.buffers.nbFramesInSecondStage);
@@ -1307,17 +1878,27 @@ extern ETSI_BOOL DoNoiseSup(const X_FLOAT32 *InData, X_FLOAT32 *OutData, FEParam
 
   X_INT16 *indexBuffer = NULL;     //
 
-  X_FLOAT32 *prvFrame = NULL;      //
-  X_FLOAT32 *curFrame = NULL;      //
-  X_FLOAT32 *nSigSE = NULL;        //
-  X_FLOAT32 *PSDMeanBuffer = NULL; //
-
+  NS_SAMPLE *prvFrame = NULL;      //
+  NS_SAMPLE *curFrame = NULL;      //
+  NS_SPEC *nSigSE = NULL;          //
+  NS_SPEC *PSDMeanBuffer = NULL;   //
+
+#ifdef FIXED_POINT_FE
+  NS_GAIN W [NS_SPEC_ORDER];                  // spectrum gains, then mel gains and filter
+  NS_GAIN filterIR [NS_FILTER_LENGTH];        // windowed impulse response
+  NS_SAMPLE signalIn [NS_FRAME_LENGTH];       // analysis frame
+  hci_mfcc16 signalFft [NS_FFT_LENGTH];       // windowed frame, then its FFT
+  X_INT16 fftShift;                           // block exponent of signalFft
+  NS_SAMPLE signalOut [NS_FRAME_SHIFT];       // filtered shift frame
+  NS_SPEC PSDMeaned [NS_SPEC_ORDER];          // smoothed PSD
+#else	// !FIXED_POINT_FE
   X_FLOAT32 *W = NSX->nsTmp.tmpMem + NS_SPEC_ORDER;               // scratch memory
   X_FLOAT32 *filterIR = This->NSX->nsTmp.tmpMem;                  // scratch memory
-  X_FLOAT32 ALIGNED_(ALN_NS) signalIn[NS_SCRATCH_MEM_SIZE] = { 0 };
-  X_FLOAT32 ALIGNED_(ALN_NS) signalFft[NS_SCRATCH_MEM_SIZE] = { 0 };
+  X_FLOAT32 ALIGNED_(ALN_NS) signalIn[NS_SCRATCH_MEM_SIZE];   // fully written by DoSigWindowing
+  X_FLOAT32 ALIGNED_(ALN_NS) signalFft[NS_SCRATCH_MEM_SIZE];  // fully written by the FFT
   X_FLOAT32 *signalOut = This->NSX->nsTmp.tmpMem + NS_SPEC_ORDER; // scratch memory
   X_FLOAT32 *PSDMeaned = This->NSX->nsTmp.tmpMem;                 // scratch memory
+#endif	// #ifdef FIXED_POINT_FE
 
   ETSI_BOOL dataToProcess;           // data to process ?
 
@@ -1343,7 +1924,7 @@ extern ETSI_BOOL DoNoiseSup(const X_FLOAT32 *InData, X_FLOAT32 *OutData, FEParam
 	/*---------------------------------------------------
 	 * input next shift frame in FirstStageInFloatBuffer
 	 *---------------------------------------------------*/
-	memcpy(&FirstStageInFloatBuffer[NS_DATA_IN_BUFFER], InData, NS_FRAME_SHIFT * sizeof(X_FLOAT32));
+	memcpy(&FirstStageInFloatBuffer[NS_DATA_IN_BUFFER], InData, NS_FRAME_SHIFT * sizeof(NS_SAMPLE));
   
 	(*nbFramesInFirstStage)++;
 
@@ -1396,6 +1977,17 @@ extern ETSI_BOOL DoNoiseSup(const X_FLOAT32 *InData, X_FLOAT32 *OutData, FEParam
 
 		if (!dataToProcess) continue; // no processing required
 
+#ifdef FIXED_POINT_FE
+		// pfInpSpeech only feeds the disabled frame classification below
+
+		/*-----------------------------------------------
+		 * signal windowing, zero padding and FFT, Q15
+		 * FFT with a block exponent, PSD in Q8
+		 *-----------------------------------------------*/
+		fftShift = DoSigWindowing (signalIn, NSX->nsTmp.sigWindowFx, signalFft, NS_FRAME_LENGTH, NS_FFT_LENGTH);
+		FX_SigProc_realFFT (signalFft, NSX->nsTmp.fftPhase, NS_FFT_LENGTH, NS_FFT_LENGTH/2, NS_FFT_STAGES);
+		FFTtoPSD (signalFft, fftShift, nSigSE);
+#else	// !FIXED_POINT_FE
 		/*
 		 * Capture Input Speech Signal for Pitch related pre-processing
 		 */
@@ -1418,9 +2010,13 @@ extern ETSI_BOOL DoNoiseSup(const X_FLOAT32 *InData, X_FLOAT32 *OutData, FEParam
 		/*-----
 		 * FFT
 		 *-----*/
-		pffft_transform_ordered(This->fft_setup, signalIn, signalFft, 0, PFFFT_FORWARD);
+		// only the PSD is used, the unordered output saves the reordering pass
+		if (NSX->nsTmp.bUnorderedFFT)
+			pffft_transform(NSX->nsTmp.fftSetup, signalIn, signalFft, pffft_cache_work(NS_FFT_LENGTH, PFFFT_REAL), PFFFT_FORWARD);
+		else
+			pffft_transform_ordered(NSX->nsTmp.fftSetup, signalIn, signalFft, pffft_cache_work(NS_FFT_LENGTH, PFFFT_REAL), PFFFT_FORWARD);
 
-#if 0	// DNN trigger - Disabled VAD frame classification for speed
+#if 0	// DNN trigger - Disabled VAD frame classification for speed (needs the ordered FFT)
 		// VAD for frame classification
 		if ((fstage == 0) && (*nbFramesInFirstStage >= 3))
 		{
@@ -1558,7 +2154,11 @@ extern ETSI_BOOL DoNoiseSup(const X_FLOAT32 *InData, X_FLOAT32 *OutData, FEParam
 		/*-------------------------------------------------------------
 		 * FFT spectrum (signalFft) -> power spectrum (NSX->nSigSE)
 		 *-------------------------------------------------------------*/
-		FFTtoPSD(signalFft, nSigSE, NS_FFT_LENGTH);
+		if (NSX->nsTmp.bUnorderedFFT)
+			UnorderedFFTtoPSD(signalFft, nSigSE, NSX->nsTmp.psdIndex, NSX->nsTmp.fftZorder);
+		else
+			FFTtoPSD(signalFft, nSigSE, NS_FFT_LENGTH);
+#endif	// #ifdef FIXED_POINT_FE
 
 		/*---------
 		 * PSDMean
@@ -1586,7 +2186,11 @@ extern ETSI_BOOL DoNoiseSup(const X_FLOAT32 *InData, X_FLOAT32 *OutData, FEParam
 		/*-----------------
 		 * mel filter bank
 		 *-----------------*/
+#ifdef FIXED_POINT_FE
+		DoMelFBFx (W, NSX->nsTmp.FirstWindow);
+#else	// !FIXED_POINT_FE
 		DoMelFB (W, NSX->nsTmp.FirstWindow);
+#endif	// #ifdef FIXED_POINT_FE
 
 #if 0	// DNN trigger - Disabled VAD frame classification for speed
 		/*------------------------
@@ -1625,13 +2229,21 @@ extern ETSI_BOOL DoNoiseSup(const X_FLOAT32 *InData, X_FLOAT32 *OutData, FEParam
 		/*-----------------
 		 * mel inverse DCT
 		 *-----------------*/
+#ifdef FIXED_POINT_FE
+		DoMelIDCTFx (W, NSX->nsTmp.melIDCTbasisFx, WF_MEL_ORDER, WF_MEL_ORDER);
+#else	// !FIXED_POINT_FE
 		DoMelIDCT (W, NSX->nsTmp.melIDCTbasis, WF_MEL_ORDER, WF_MEL_ORDER);
+#endif	// #ifdef FIXED_POINT_FE
 		for (i=1 ; i<WF_MEL_ORDER ; i++) W [2 * WF_MEL_ORDER - 1 - i] = W [i];
 
 		/*------------------
 		 * filter windowing
 		 *------------------*/
+#ifdef FIXED_POINT_FE
+		DoFilterWindowing (W, NSX->nsTmp.IRWindowFx, filterIR);
+#else	// !FIXED_POINT_FE
 		DoFilterWindowing (W, NSX->nsTmp.IRWindow, filterIR);
+#endif	// #ifdef FIXED_POINT_FE
 
 		/*--------------------------------------------------------------
 		 * apply WF to noisy signal, output samples stored in signalOut
@@ -20,8 +20,6 @@
 #include <stdio.h>
 #include <string.h>
 
-#include "pffft.h"
-
 #include "wiener/ParmInterface.h"
 #include "wiener/NoiseSup.h"
 #include "wiener/pitchInterface.h"
@@ -98,7 +96,7 @@ FEParamsX* AdvProcessAlloc (int SamplingFrequency)
   pFEParX->pfDownSampledProcSpeech = (X_FLOAT32*)
 	  calloc(sizeof(X_FLOAT32), (FRAME_LENGTH+HISTORY_LENGTH)/DOWN_SAMP_FACTOR+1);
 
-  pFEParX->CurFrame = (X_FLOAT32*)calloc (1, sizeof (pFEParX->CurFrame[0]) * pFEParX->FrameShift);
+  pFEParX->CurFrame = (NS_SAMPLE*)calloc (1, sizeof (pFEParX->CurFrame[0]) * pFEParX->FrameShift);
 
   pFEParX->denoisedBuf = 
 	  BufInAlloc (pFEParX->FrameLength +                         // at least FrameLength
@@ -161,8 +159,6 @@ void AdvProcessInit (FEParamsX *pFEParX)
   memset(pFEParX->GSM_HPF_B_Buf, 0, sizeof(pFEParX->GSM_HPF_B_Buf));
   memset(pFEParX->avgNoiseSpec, 0, sizeof(pFEParX->avgNoiseSpec));
   pFEParX->avgNoiseLogE = 0;
-  
-  pFEParX->fft_setup = pffft_new_setup(NS_FFT_LENGTH, PFFFT_REAL);
 }
 
 
@@ -267,17 +263,26 @@ Whitening(FEParamsX *pFEParX, FILE_TYPE *CurrentFrame, int dithering_factor)
  *
  * OUTPUT:
  *   pFEParX      Pointer to front end parameter structure
- *	 CurFrame	  float-type HPF current frame
+ *	 CurFrame	  HPF current frame (float, Q0 integers in the fixed-point build)
  *
  * RETURN VALUE:
  *   none
  *
  *---------------------------------------------------------------------------*/
-static void GSM_HPF (FEParamsX *pFEParX, FILE_TYPE *CurrentFrame, X_FLOAT32 *CurFrame )
+static void GSM_HPF (FEParamsX *pFEParX, FILE_TYPE *CurrentFrame, NS_SAMPLE *CurFrame )
 {
 	FILE_TYPE *pSample = 0;
 	FILE_TYPE *pLastSample = 0;
-	X_FLOAT32 *pOutput = 0;
+	NS_SAMPLE *pOutput = 0;
+#ifdef FIXED_POINT_FE
+	X_INT32 x;
+
+	// the coefficients below in Q28, output history in Q8
+	const X_INT32 anB[3]={248920198, -497813553, 248920198};
+	const X_INT32 anA[3]={268435456, -511611136, 244652075};
+
+	hci_int64 sum = 0;		// Q8.28
+#else	// !FIXED_POINT_FE
 	X_FLOAT32 x;
 	
 	float anB[3]={0.9273f,   -1.8545f,     0.9273f};
@@ -285,11 +290,30 @@ static void GSM_HPF (FEParamsX *pFEParX, FILE_TYPE *CurrentFrame, X_FLOAT32 *Cur
 	
 	float sumA  = 0;		// Q15.32
 	float sumB  = 0;		// Q15.32
+#endif	// #ifdef FIXED_POINT_FE
 	
 	pSample     = CurrentFrame;
 	pLastSample = pSample + pFEParX->NbSamplesToRead;
 	pOutput     = CurFrame;
 	while (pSample < pLastSample) {
+#ifdef FIXED_POINT_FE
+		x = (X_INT32)(*pSample);
+
+		sum  = (hci_int64)x * anB[0] * 256;
+		sum += (hci_int64)pFEParX->GSM_HPF_B_Buf[1] * anB[1] * 256;
+		sum += (hci_int64)pFEParX->GSM_HPF_B_Buf[2] * anB[2] * 256;
+
+		sum -= (hci_int64)pFEParX->GSM_HPF_A_Buf[1] * anA[1];
+		sum -= (hci_int64)pFEParX->GSM_HPF_A_Buf[2] * anA[2];
+
+		pFEParX->GSM_HPF_B_Buf[2] = pFEParX->GSM_HPF_B_Buf[1];
+		pFEParX->GSM_HPF_B_Buf[1] = x;
+
+		pFEParX->GSM_HPF_A_Buf[2] = pFEParX->GSM_HPF_A_Buf[1];
+		pFEParX->GSM_HPF_A_Buf[1] = (X_INT32)((sum + (1 << 27)) >> 28);
+
+		*pOutput = (pFEParX->GSM_HPF_A_Buf[1] + 128) >> 8;
+#else	// !FIXED_POINT_FE
 		x = (float)(*pSample);
 
 		sumB  = x * anB[0];
@@ -306,6 +330,7 @@ static void GSM_HPF (FEParamsX *pFEParX, FILE_TYPE *CurrentFrame, X_FLOAT32 *Cur
 			
 		pFEParX->GSM_HPF_A_Buf[2] = pFEParX->GSM_HPF_A_Buf[1];
 		pFEParX->GSM_HPF_A_Buf[1] = *pOutput;
+#endif	// #ifdef FIXED_POINT_FE
 			
 		pSample++; pOutput++;
 	}
@@ -336,10 +361,16 @@ ETSI_BOOL DoAdvProcess (FILE_TYPE *CurrentFrame,
   int i;
   int FrameShift;
   int dithering_factor = 256;
-  X_FLOAT32 *CurFrame;
+  NS_SAMPLE *CurFrame;
+#ifdef FIXED_POINT_FE
+  NS_SAMPLE ptDenoised[FRAME_SHIFT];	// denoisedBuf holds float, not used here
+
+  hci_int64 FrameCheck;
+#else	// !FIXED_POINT_FE
   X_FLOAT32 *ptDenoised;
 
   float FrameCheck;
+#endif	// #ifdef FIXED_POINT_FE
 
   long NonZeroFrameOnset;
   long ZeroFrameCounter;
@@ -368,19 +399,29 @@ ETSI_BOOL DoAdvProcess (FILE_TYPE *CurrentFrame,
    * and returns pointer to the new available part of
    * denoisedBuf => (denoisedBuf->size - FrameShift + 1)
    *-----------------------------------------------------------------*/
+#ifndef FIXED_POINT_FE
   ptDenoised = BufInShiftToPut (pFEParX->denoisedBuf, pFEParX->FrameShift);
+#endif	// #ifndef FIXED_POINT_FE
 
   /*-------------------------------------------------
    * convert input samples from X_INT16 to X_FLOAT32
    *-------------------------------------------------*/
-  FrameCheck = 0.0;
+  FrameCheck = 0;
   for (i=0 ; i<FrameShift; i++)
 	{
 //	  CurFrame[i] = (X_FLOAT32)(CurrentFrame[i]);
+#ifdef FIXED_POINT_FE
+        FrameCheck += (hci_int64)CurFrame[i] * CurFrame[i];
+#else	// !FIXED_POINT_FE
         FrameCheck += CurFrame[i] * CurFrame[i];
+#endif	// #ifdef FIXED_POINT_FE
 	}
 
+#ifdef FIXED_POINT_FE
+  if ((FrameCheck != 0) || (NonZeroFrameOnset != 0))
+#else	// !FIXED_POINT_FE
   if (((int)FrameCheck != 0) || (NonZeroFrameOnset != 0))
+#endif	// #ifdef FIXED_POINT_FE
 	{ 
 	  pFEParX->NonZeroFrameOnset = 1;
 
@@ -391,7 +432,11 @@ ETSI_BOOL DoAdvProcess (FILE_TYPE *CurrentFrame,
 				int d = 0, out = 0;
 				
 				for ( d = 0; d < pFEParX->FrameShift; d++) {
+#ifdef FIXED_POINT_FE
+					out = ptDenoised[d];
+#else	// !FIXED_POINT_FE
 					out = FLOAT2FIX32_ANY( ptDenoised[d], 0 );
+#endif	// #ifdef FIXED_POINT_FE
 					if ( out > MAX_INT16 ) OutputBuffer[d] = MAX_INT16;
 					else if ( out < MIN_INT16 ) OutputBuffer[d] = MIN_INT16;
 					else OutputBuffer[d] = (X_INT16)out;
@@ -442,8 +487,6 @@ void AdvProcessDelete (FEParamsX **ppFEParX)
   ReleaseMelFBwindows ((*ppFEParX)->FirstWindow);
   free((*ppFEParX)->FirstWindow);
 
-  pffft_destroy_setup((*ppFEParX)->fft_setup);
-
   free (*ppFEParX);
   *ppFEParX = NULL;
 }
@@ -159,6 +159,56 @@ PowerASR_NR_Wiener_closeWienerNR(PowerASR_NR_Wiener *pThis)		///< (i/o) pointer
 }
 
 
+/**
+ *	return the image of the Wiener noise reducer set-up, to be saved in a snapshot.
+ *	the image is the inner data struct as it is, valid only for the same build.
+ *
+ *	@return return the image size in bytes, otherwise return -1.
+ */
+HCILAB_PUBLIC HCI_WIENER_API hci_int32
+PowerASR_NR_Wiener_getImage(PowerASR_NR_Wiener *pThis,						///< (i) pointer to the Wiener noise reducer
+							const void **ppImage)							///< (o) image of the Wiener noise reducer
+{
+	if (0 == pThis || 0 == ppImage) {
+		return -1;
+	}
+
+	*ppImage = pThis->pInner;
+
+	return (hci_int32)sizeof(Wiener_Inner);
+}
+
+
+/**
+ *	set-up environments for Wiener noise reducer from an image returned by PowerASR_NR_Wiener_getImage,
+ *	instead of the configuration file.
+ *
+ *	@return return 0 if the image is set-up correctly, otherwise return -1.
+ */
+HCILAB_PUBLIC HCI_WIENER_API hci_int32
+PowerASR_NR_Wiener_openWienerNRFromImage(PowerASR_NR_Wiener *pThis,			///< (i/o) pointer to the Wiener noise reducer
+										 const void *pImage,				///< (i) image saved by PowerASR_NR_Wiener_getImage
+										 const hci_int32 nSize)				///< (i) image size in bytes
+{
+	Wiener_Inner *pInner = 0;
+
+	if (0 == pThis || 0 == pImage) {
+		return -1;
+	}
+
+	if (nSize != (hci_int32)sizeof(Wiener_Inner)) {
+		HCIMSG_ERROR("image size mismatch (%d, %d).\n", nSize, (hci_int32)sizeof(Wiener_Inner));
+		return -1;
+	}
+
+	pInner = (Wiener_Inner *) pThis->pInner;
+
+	memcpy(pInner, pImage, sizeof(Wiener_Inner));
+
+	return 0;
+}
+
+
 /**
  *	initialize data buffers for Wiener noise reducer.
  *
@@ -185,6 +235,8 @@ PowerASR_NR_Wiener_initializeWienerNR(PowerASR_NR_Wiener *pThis,		///< (i) point
 
     if ( pUserData->dataWiener ) {
 		AdvProcessInit ((FEParamsX *)pUserData->dataWiener);
+		pUserData->nNRMode = NR_MODE_TWO_STAGE;
+		pUserData->bSpeechVAD = 1;
 		return 0;
 	}
 	else {
@@ -221,6 +273,46 @@ PowerASR_NR_Wiener_releaseWienerNR(PowerASR_NR_Wiener *pThis,		///< (i) pointer
 }
 
 
+/**
+ *	select the noise reduction mode of a channel.
+ *	the Wiener filter states are re-initialized when noise reduction is switched on or
+ *	between single/two-stage, so a few frames of NR latency are re-introduced.
+ *
+ *	@return Return 0 if the mode is set, otherwise return -1.
+ */
+HCILAB_PUBLIC HCI_WIENER_API hci_int32
+PowerASR_NR_Wiener_setNRMode(PowerASR_NR_Wiener *pThis,		///< (i) pointer to the Wiener noise reducer
+							 Wiener_UserData *pUserData,	///< (i/o) channel-specific Wiener data
+							 const hci_int32 nNRMode)		///< (i) noise reduction mode (NR_Mode)
+{
+	FEParamsX *dataWiener = 0;
+
+	if (0 == pThis) {
+		return -1;
+	}
+	if (0 == pUserData || 0 == pUserData->dataWiener) {
+		return -1;
+	}
+	if (nNRMode < NR_MODE_OFF || nNRMode > NR_MODE_TWO_STAGE) {
+		HCIMSG_ERROR("invalid noise reduction mode: %d.\n", nNRMode);
+		return -1;
+	}
+	if (nNRMode == pUserData->nNRMode) {
+		return 0;
+	}
+
+	dataWiener = (FEParamsX *)pUserData->dataWiener;
+	if (nNRMode != NR_MODE_OFF) {
+		// filter states of the previous mode are stale (not fed or fed to the other stage)
+		dataWiener->DoNoiseSupInit(dataWiener);
+		dataWiener->bApply2ndStage = (nNRMode == NR_MODE_TWO_STAGE) ? 1 : 0;
+	}
+	pUserData->nNRMode = nNRMode;
+
+	return 0;
+}
+
+
 /**
  *	produce noise-reduced samples from a noisy input frame buffer.
  *
@@ -252,6 +344,14 @@ PowerASR_NR_Wiener_procFrameBuffer(PowerASR_NR_Wiener *pThis,		///< (i) pointer
 
 	dataWiener = (FEParamsX *)pUserData->dataWiener;
 
+	if (pUserData->nNRMode == NR_MODE_OFF) {	// bypass, no VAD decision
+		pUserData->flagVAD = 0;
+		pUserData->bSpeechFound = 0;
+		pUserData->specEntropy = 0.0f;
+		pUserData->bSpeechVAD = 1;
+		return (pInner->nSampleRate / 100);
+	}
+
 	memset( OutputBuffer, 0, sizeof(OutputBuffer) );
 	if (pInner->bUseDithering == TRUE) {
 		_NR_Wiener_dithering( pInput, (pInner->nSampleRate / 100) );
@@ -262,6 +362,7 @@ PowerASR_NR_Wiener_procFrameBuffer(PowerASR_NR_Wiener *pThis,		///< (i) pointer
 		pUserData->flagVAD = dataWiener->FrameClass;
 		pUserData->bSpeechFound = dataWiener->SpeechFoundMel;
 		pUserData->specEntropy = dataWiener->specEntropy;
+		pUserData->bSpeechVAD = dataWiener->SpeechFoundVADNS;
 	}
 
 	if ( pInner->nSampleRate == 16000 ) {
@@ -274,6 +375,7 @@ PowerASR_NR_Wiener_procFrameBuffer(PowerASR_NR_Wiener *pThis,		///< (i) pointer
 			pUserData->bSpeechFound = (pUserData->bSpeechFound + 1) / 2;
 			pUserData->specEntropy += dataWiener->specEntropy;
 			pUserData->specEntropy *= 0.5f;
+			pUserData->bSpeechVAD |= dataWiener->SpeechFoundVADNS;
 		}
 	}
 
@@ -89,6 +89,33 @@ PowerASR_FrontEnd_openFrontEndEngine(PowerASR_FrontEnd *pThis,		///< (i/o) point
 );
 
 
+/**
+ *	Save the set-up of ASR front-end engine opened by PowerASR_FrontEnd_openFrontEndEngine,
+ *	to open other engines by PowerASR_FrontEnd_openFrontEndEngineFromImage without the configuration files.
+ *	the image is valid only for the same build.
+ *
+ *	@return return the image size in bytes (the size needed if pBuf is null), otherwise return -1.
+ */
+HCILAB_PUBLIC HCI_FE_API hci_int32
+PowerASR_FrontEnd_saveImage(PowerASR_FrontEnd *pThis,		///< (i) pointer to the ASR front-end engine
+							void *pBuf,						///< (o) image buffer, 16 bytes aligned
+							const hci_int32 nBufSize		///< (i) size of image buffer
+);
+
+
+/**
+ *	Set-up environments for ASR front-end engine from an image saved by PowerASR_FrontEnd_saveImage,
+ *	without loading configuration files and knowledge bases.
+ *
+ *	@return return 0 if ASR front-end environments are set-up correctly, otherwise return -1.
+ */
+HCILAB_PUBLIC HCI_FE_API hci_int32
+PowerASR_FrontEnd_openFrontEndEngineFromImage(PowerASR_FrontEnd *pThis,		///< (i/o) pointer to the ASR front-end engine
+											  const void *pImage,			///< (i) front-end image
+											  const hci_int32 nSize			///< (i) image size in bytes
+);
+
+
 /**
  *	Free memories allocated to the ASR front-end engine.
  *
@@ -223,6 +250,18 @@ HCILAB_PUBLIC HCI_FE_API hci_int32
 PowerASR_FrontEnd_getLogSpeechMargin(PowerASR_FrontEnd *pThis			///< (i) pointer to the ASR front-end engine
 );
 
+/**
+ *	switch noise reduction mode of a channel (NR_MODE_OFF, NR_MODE_SINGLE_STAGE, NR_MODE_TWO_STAGE).
+ *	must be called from the thread feeding the channel.
+ *
+ *	@return return 0 if the mode is set, otherwise return -1.
+ */
+HCILAB_PUBLIC HCI_FE_API hci_int32
+PowerASR_FrontEnd_setNoiseReductionMode(PowerASR_FrontEnd *pThis,				///< (i) pointer to the ASR front-end engine
+										FrontEnd_UserData *pChannelDataFE,		///< (i/o) channel-specific front-end data struct
+										const hci_int32 nNRMode					///< (i) noise reduction mode (NR_Mode)
+);
+
 #ifdef __cplusplus
 }
 #endif
@@ -24,6 +24,7 @@
 
 #include "base/hci_type.h"
 #include "wave2mfcc/fx_mfcc_common.h"//KSH_20150917
+#include "frontend/hci_FrontEnd.h"
 
 #if defined(HCI_MSC_32)
 #ifdef POWERDSR_FRONTEND_EXPORTS
@@ -87,6 +88,32 @@ PowerDSR_FE_Connect(const CHAR* pszASRPath,				///< (i) ASR main path
 					int nMaxChannelCount
 );
 
+/**
+ *	Create a new DSR Front-End engine from the images saved by PowerDSR_FE_SaveImage,
+ *	without loading configuration files and knowledge bases.
+ *
+ *	@return return POWERDSR_FE_CONNECTED if DSR front-end engine was connected successfully, otherwise return POWERDSR_FE_FAILED.
+ */
+HCILAB_PUBLIC POWERDSR_FE_API LONG
+PowerDSR_FE_ConnectImage(const void *pImage16k,				///< (i) image of 16k front-end engine
+						 const LONG nSize16k,				///< (i) size of 16k image
+						 const void *pImage8k,				///< (i) image of 8k front-end engine
+						 const LONG nSize8k,				///< (i) size of 8k image
+						 int nMaxChannelCount
+);
+
+/**
+ *	Save the set-up of the connected DSR front-end engine of a sampling rate (16000 or 8000),
+ *	to connect by PowerDSR_FE_ConnectImage. the image is valid only for the same build.
+ *
+ *	@return return the image size in bytes (the size needed if pBuf is null), otherwise return POWERDSR_FE_FAILED.
+ */
+HCILAB_PUBLIC POWERDSR_FE_API LONG
+PowerDSR_FE_SaveImage(const LONG nSampleRate,			///< (i) sampling frequency in Hz
+					  void *pBuf,						///< (o) image buffer, 16 bytes aligned
+					  const LONG nBufSize				///< (i) size of image buffer
+);
+
 // ش ä EPD Queue ׿ִ EPD  ´
 // input : 
 //  - nChannelID : ä 
@@ -160,6 +187,44 @@ HCILAB_PUBLIC POWERDSR_FE_API VOID
 PowerDSR_FE_ReleaseFrontEndEngine(const LONG nChannelID			///< (i) DSR front-end channel index
 );
 
+/**
+ *	Switch noise reduction mode of a DSR front-end channel.
+ *
+ *	- nNRMode : NR_MODE_OFF, NR_MODE_SINGLE_STAGE or NR_MODE_TWO_STAGE
+ *	- call from the thread feeding the channel, takes effect from the next frame.
+ *
+ *	@return Return 0 if the mode is set, otherwise return -1.
+ */
+HCILAB_PUBLIC POWERDSR_FE_API LONG
+PowerDSR_FE_SetNoiseReductionMode(const LONG nChannelID,			///< (i) DSR front-end channel index
+								  const LONG nNRMode			///< (i) noise reduction mode
+);
+
+/**
+ *	Get the speech activity of a DSR front-end channel.
+ *
+ *	- energy VAD of the Wiener noise suppressor for the last input frame, without hangover.
+ *	- always 1 when noise reduction is off (no VAD decision).
+ *
+ *	@return Return 1 for speech, 0 for non-speech, -1 on an invalid channel.
+ */
+HCILAB_PUBLIC POWERDSR_FE_API LONG
+PowerDSR_FE_GetSpeechActivity(const LONG nChannelID			///< (i) DSR front-end channel index
+);
+
+/**
+ *	Get the front-end engine and the data of a DSR front-end channel.
+ *
+ *	- for the stage times of the channel (CFeat2pass::getStageTime).
+ *
+ *	@return Return 0 on success, -1 on an invalid channel.
+ */
+HCILAB_PUBLIC POWERDSR_FE_API LONG
+PowerDSR_FE_GetChannelData(const LONG nChannelID,				///< (i) DSR front-end channel index
+						   PowerASR_FrontEnd **ppFrontEnd,		///< (o) front-end engine of the channel
+						   FrontEnd_UserData **ppChannelData	///< (o) channel-specific front-end data
+);
+
 /**
  *	Convert encoded speech stream into feature stream.
  *
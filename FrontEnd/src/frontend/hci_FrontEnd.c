@@ -28,6 +28,7 @@
 
 #include "base/hci_malloc.h"
 #include "base/hci_msg.h"
+#include "base/hci_clock.h"
 #include "base/parse_config.h"
 #include "base/case.h"
 #include "basic_op/basic_op.h"
@@ -66,6 +67,7 @@ typedef struct
 	char *pszMfcc2FeatCfgFile;				///< configuration file for MFCC-to-feature converter
 
 	hci_int32 nLenLogSpeechMargin;
+	hci_int32 nNRMode;						///< initial noise reduction mode of channels (NR_Mode)
 
 
 	float *refSilFeat;						/// KSH 15. 10. 19 // LG u+
@@ -74,6 +76,21 @@ typedef struct
 
 } FrontEnd_Inner;
 
+#define FE_IMAGE_ALIGN		16		///< alignment of module images in a front-end image
+
+/**
+ *	@struct header of a front-end image (PowerASR_FrontEnd_saveImage),
+ *	followed by the images of BasicOP, Wiener, Wave2Mfcc, EPD, Mfcc2Feat modules (FE_IMAGE_ALIGN aligned)
+ */
+typedef struct
+{
+	hci_int32 nSizeofImage;					///< sizeof(FrontEnd_Image), to reject images of other builds
+	hci_int32 nLenLogSpeechMargin;
+	hci_int32 nNRMode;
+	hci_int32 nSampleRate;
+	hci_int32 nSizeModule[5];				///< image size of each module
+} FrontEnd_Image;
+
 // local functions
 #ifdef __cplusplus
 extern "C" {
@@ -332,6 +349,150 @@ PowerASR_FrontEnd_openFrontEndEngine(PowerASR_FrontEnd *pThis,		///< (i/o) point
 	return bSetup;
 
 }
+
+
+/**
+ *	Save the set-up of ASR front-end engine opened by PowerASR_FrontEnd_openFrontEndEngine,
+ *	to open other engines by PowerASR_FrontEnd_openFrontEndEngineFromImage without the configuration files.
+ *
+ *	front-end  ʱȭ ¸ ϳ image Ѵ. ( build ȿ)
+ *
+ *	@return return the image size in bytes (the size needed if pBuf is null), otherwise return -1.
+ */
+HCILAB_PUBLIC HCI_FE_API hci_int32
+PowerASR_FrontEnd_saveImage(PowerASR_FrontEnd *pThis,		///< (i) pointer to the ASR front-end engine
+							void *pBuf,						///< (o) image buffer, FE_IMAGE_ALIGN aligned
+							const hci_int32 nBufSize)		///< (i) size of image buffer
+{
+	FrontEnd_Inner *pInner = 0;
+	FrontEnd_Image header;
+	const void *pModuleImage[5] = { 0 };
+	hci_int32 nOffset = 0;
+	hci_int32 i = 0;
+
+	if (0 == pThis || 0 == pThis->pInner) {
+		return -1;
+	}
+
+	pInner = (FrontEnd_Inner *) pThis->pInner;
+
+	memset(&header, 0, sizeof(header));
+	header.nSizeofImage = (hci_int32)sizeof(FrontEnd_Image);
+	header.nLenLogSpeechMargin = pInner->nLenLogSpeechMargin;
+	header.nNRMode = pInner->nNRMode;
+	header.nSampleRate = pInner->nSampleRate;
+
+	header.nSizeModule[0] = PowerASR_BasicOP_getImage(pInner->pBasicOP, &pModuleImage[0]);
+	header.nSizeModule[1] = PowerASR_NR_Wiener_getImage(pInner->pNR_Wiener, &pModuleImage[1]);
+	header.nSizeModule[2] = PowerASR_FX_Wave2Mfcc_getImage(pInner->pFX_Wave2Mfcc, &pModuleImage[2]);
+	header.nSizeModule[3] = PowerASR_EPD_getImage(pInner->pEpd, &pModuleImage[3]);
+	header.nSizeModule[4] = PowerASR_FX_Mfcc2Feat_getImage(pInner->pFX_Mfcc2Feat, &pModuleImage[4]);
+
+	nOffset = (sizeof(FrontEnd_Image) + FE_IMAGE_ALIGN - 1) / FE_IMAGE_ALIGN * FE_IMAGE_ALIGN;
+	for (i = 0; i < 5; i++) {
+		if (header.nSizeModule[i] < 0) {
+			return -1;
+		}
+		if (pBuf) {
+			if (nBufSize < nOffset + header.nSizeModule[i]) {
+				return -1;
+			}
+			memcpy((char *)pBuf + nOffset, pModuleImage[i], header.nSizeModule[i]);
+		}
+		nOffset += (header.nSizeModule[i] + FE_IMAGE_ALIGN - 1) / FE_IMAGE_ALIGN * FE_IMAGE_ALIGN;
+	}
+
+	if (pBuf) {
+		memcpy(pBuf, &header, sizeof(header));
+	}
+
+	return nOffset;
+}
+
+
+/**
+ *	Set-up environments for ASR front-end engine from an image saved by PowerASR_FrontEnd_saveImage,
+ *	without loading configuration files and knowledge bases.
+ *
+ *	front-end   imageκ ʱȭѴ.
+ *
+ *	@return return 0 if ASR front-end environments are set-up correctly, otherwise return -1.
+ */
+HCILAB_PUBLIC HCI_FE_API hci_int32
+PowerASR_FrontEnd_openFrontEndEngineFromImage(PowerASR_FrontEnd *pThis,		///< (i/o) pointer to the ASR front-end engine
+											  const void *pImage,			///< (i) front-end image
+											  const hci_int32 nSize)		///< (i) image size in bytes
+{
+	FrontEnd_Inner *pInner = 0;
+	FrontEnd_Image header;
+	const char *pModuleImage[5] = { 0 };
+	hci_logadd_t *pLogAddTbl_FE = 0;
+	hci_int32 nOffset = 0;
+	hci_int32 i = 0;
+
+	if (0 == pThis || 0 == pThis->pInner || 0 == pImage) {
+		return -1;
+	}
+
+	pInner = (FrontEnd_Inner *) pThis->pInner;
+
+	if (nSize < (hci_int32)sizeof(FrontEnd_Image)) {
+		return -1;
+	}
+	memcpy(&header, pImage, sizeof(header));
+	if (header.nSizeofImage != (hci_int32)sizeof(FrontEnd_Image)) {
+		HCIMSG_ERROR("front-end image of another build.\n");
+		return -1;
+	}
+
+	nOffset = (sizeof(FrontEnd_Image) + FE_IMAGE_ALIGN - 1) / FE_IMAGE_ALIGN * FE_IMAGE_ALIGN;
+	for (i = 0; i < 5; i++) {
+		if (header.nSizeModule[i] < 0 || nSize < nOffset + header.nSizeModule[i]) {
+			return -1;
+		}
+		pModuleImage[i] = (const char *)pImage + nOffset;
+		nOffset += (header.nSizeModule[i] + FE_IMAGE_ALIGN - 1) / FE_IMAGE_ALIGN * FE_IMAGE_ALIGN;
+	}
+
+	pInner->nLenLogSpeechMargin = header.nLenLogSpeechMargin;
+	pInner->nNRMode = header.nNRMode;
+	pInner->nSampleRate = header.nSampleRate;
+
+	if (pInner->pBasicOP) {
+		if ((-1) == PowerASR_BasicOP_setImage(pInner->pBasicOP, pModuleImage[0], header.nSizeModule[0])) {
+			return -1;
+		}
+		pLogAddTbl_FE = PowerASR_BasicOP_getLogAdditionTable(pInner->pBasicOP);
+	}
+
+	if (pInner->pNR_Wiener) {
+		if ((-1) == PowerASR_NR_Wiener_openWienerNRFromImage(pInner->pNR_Wiener, pModuleImage[1], header.nSizeModule[1])) {
+			return -2;
+		}
+	}
+
+	if (pInner->pFX_Wave2Mfcc) {
+		if ((-1) == PowerASR_FX_Wave2Mfcc_openWave2MfccConverterFromImage(pInner->pFX_Wave2Mfcc, pModuleImage[2], header.nSizeModule[2], pLogAddTbl_FE)) {
+			return -3;
+		}
+	}
+
+	if (pInner->pEpd) {
+		if ((-1) == PowerASR_EPD_openEPDetectorFromImage(pInner->pEpd, pModuleImage[3], header.nSizeModule[3])) {
+			return -4;
+		}
+	}
+
+	if (pInner->pFX_Mfcc2Feat) {
+		if ((-1) == PowerASR_FX_Mfcc2Feat_openMfcc2FeatConverterFromImage(pInner->pFX_Mfcc2Feat, pModuleImage[4], header.nSizeModule[4])) {
+			return -5;
+		}
+	}
+
+	return 0;
+}
+
+
 HCILAB_PUBLIC HCI_FE_API hci_int32 PowerASR_FrontEnd_releaseFrontEndWiener(FrontEnd_UserData *pUserThis,PowerASR_FrontEnd *pFronEndThis)
 {
 	Wiener_UserData *pWienerUser_Inner;
@@ -421,6 +582,12 @@ PowerASR_FrontEnd_initializeFrontEndforASR(PowerASR_FrontEnd *pThis,				///< (i)
 			HCIMSG_ERROR("[Warning] cannot initialize Wiener Noise Reducer !!\n");
 			return -1;
 		}
+		if ((-1) == PowerASR_NR_Wiener_setNRMode(pInner->pNR_Wiener,
+												 &pChannelDataFE->dataWiener,
+												 pInner->nNRMode)) {
+			HCIMSG_ERROR("[Warning] cannot set noise reduction mode !!\n");
+			return -1;
+		}
 	}
 
 	if (pInner->pFX_Wave2Mfcc) {
@@ -541,6 +708,7 @@ PowerASR_FrontEnd_framebyframeFeatureExtraction(PowerASR_FrontEnd *pThis,			///<
 	W2M_Status w2m_stat;
 	hci_int32 nLenOutWave = 0;
 	ARData* dioEpd = pChannelDataFE->st;
+	unsigned long long t_stage = 0;
 
 	if (!pFrameWave && bEOS) {
 		pASRFeat->epd_result.epd_state = UTTER_END;
@@ -552,13 +720,16 @@ PowerASR_FrontEnd_framebyframeFeatureExtraction(PowerASR_FrontEnd *pThis,			///<
 
 	if (!pFrameWave)	return M2F_FALSE;
 
+	HCI_STAGE_START(t_stage);
 
 	nLenOutWave = PowerASR_NR_Wiener_procFrameBuffer(pInner->pNR_Wiener, pWienerData, pFrameWave);
+	HCI_STAGE_TIME(pChannelDataFE->nTimeNR, t_stage);
 	if (nLenOutWave != pFX->nFrameSampleSize)	return M2F_FALSE;
 
 
 	w2m_stat = PowerASR_FX_Wave2Mfcc_convertFrameSample2Mfcc(
 		pInner->pFX_Wave2Mfcc, pMfccData, pFrameWave, (hci_int16)(pWienerData->flagVAD/2));
+	HCI_STAGE_TIME(pChannelDataFE->nTimeMfcc, t_stage);
 	if (W2M_TRUE != w2m_stat)	return M2F_FALSE;
 
 #if 0
@@ -640,6 +811,7 @@ PowerASR_FrontEnd_framebyframeFeatureExtraction(PowerASR_FrontEnd *pThis,			///<
 	//pASRFeat->epd_result.frame_class = VOICED_FRAME;
 	m2f_state = PowerASR_FX_Mfcc2Feat_convertMfccStream2FeatureVector(
 		pInner->pFX_Mfcc2Feat, pASRFeat, pMfccData, TRUE);
+	HCI_STAGE_TIME(pChannelDataFE->nTimeFeat, t_stage);
 
 	return m2f_state;
 }
@@ -823,6 +995,33 @@ PowerASR_FrontEnd_getLogSpeechMargin(PowerASR_FrontEnd *pThis)		///< (i) pointer
 }
 
 
+/**
+ *	switch noise reduction mode of a channel (NR_MODE_OFF, NR_MODE_SINGLE_STAGE, NR_MODE_TWO_STAGE).
+ *	must be called from the thread feeding the channel.
+ *
+ *	@return return 0 if the mode is set, otherwise return -1.
+ */
+HCILAB_PUBLIC HCI_FE_API hci_int32
+PowerASR_FrontEnd_setNoiseReductionMode(PowerASR_FrontEnd *pThis,				///< (i) pointer to the ASR front-end engine
+										FrontEnd_UserData *pChannelDataFE,		///< (i/o) channel-specific front-end data struct
+										const hci_int32 nNRMode)				///< (i) noise reduction mode (NR_Mode)
+{
+	FrontEnd_Inner *pInner = 0;
+
+	if (0 == pThis || 0 == pChannelDataFE) {
+		return -1;
+	}
+
+	pInner = (FrontEnd_Inner *) pThis->pInner;
+
+	if (0 == pInner || 0 == pInner->pNR_Wiener) {
+		return -1;
+	}
+
+	return PowerASR_NR_Wiener_setNRMode(pInner->pNR_Wiener, &pChannelDataFE->dataWiener, nNRMode);
+}
+
+
 /**
  * setup default environments for PowerASR front-end modules
  */
@@ -841,6 +1040,8 @@ _FrontEnd_defaultConfigurations(PowerASR_FrontEnd *pThis)		///< (i/o) pointer to
 		return -1;
 	}
 
+	pInner->nNRMode = NR_MODE_TWO_STAGE;
+
 	return 0;
 }
 
@@ -920,6 +1121,28 @@ _FrontEnd_loadConfigurations(PowerASR_FrontEnd *pThis,		///< (i/o) pointer to th
 		pInner->nLenLogSpeechMargin = 200 * 16;
 	}
 
+	// noise reduction mode (off, single, two_stage)
+	pszValue = PowerASR_Base_getArgumentValue("NR_MODE");
+	if (pszValue) {
+		if (PowerASR_Base_strnocasecmp(pszValue, "off") == 0) {
+			pInner->nNRMode = NR_MODE_OFF;
+		}
+		else if (PowerASR_Base_strnocasecmp(pszValue, "single") == 0) {
+			pInner->nNRMode = NR_MODE_SINGLE_STAGE;
+		}
+		else if (PowerASR_Base_strnocasecmp(pszValue, "two_stage") == 0) {
+			pInner->nNRMode = NR_MODE_TWO_STAGE;
+		}
+		else {
+			HCIMSG_ERROR("invalid NR_MODE: %s.\n", pszValue);
+			PowerASR_Base_closeConfigurations();
+			return -1;
+		}
+	}
+	else {
+		pInner->nNRMode = NR_MODE_TWO_STAGE;
+	}
+
 	PowerASR_Base_closeConfigurations();
 
 	return 0;
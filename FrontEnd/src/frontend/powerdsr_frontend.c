@@ -121,6 +121,18 @@ _PowerDSR_FE_updateFeatureNormalizer(const LONG nChannelID );		///< (i) channel
 HCILAB_PRIVATE VOID
 _PowerDSR_FE_initializeFrontEnd(LONG nChanID);
 
+/**
+ *	create the DSR front-end engines from the configuration files, or from images if given
+ */
+static LONG
+_PowerDSR_FE_connect(const CHAR* pszASRPath,
+					 const CHAR* pszConfigFile,
+					 const void *pImage16k,
+					 const hci_int32 nSize16k,
+					 const void *pImage8k,
+					 const hci_int32 nSize8k,
+					 int nMaxChannelCount);
+
 #ifdef __cplusplus
 }
 #endif
@@ -136,15 +148,76 @@ PowerDSR_FE_Connect(const CHAR* pszASRPath,				///< (i) ASR main path
 					const CHAR* pszConfigFile,			///< (i) main ASR configuration file
 					int nMaxChannelCount				///< (i) Max Channel Count
 					)
+{
+	if (0 == pszConfigFile || 0 == pszASRPath) {
+		return POWERDSR_FE_NO_CFG_FILE;
+	}
+
+	return _PowerDSR_FE_connect(pszASRPath, pszConfigFile, 0, 0, 0, 0, nMaxChannelCount);
+}
+
+
+/**
+ *	Create a new DSR Front-End engine from the images saved by PowerDSR_FE_SaveImage,
+ *	without loading configuration files and knowledge bases.
+ *
+ *	@return return POWERDSR_FE_CONNECTED if DSR front-end engine was connected successfully, otherwise return POWERDSR_FE_FAILED.
+ */
+HCILAB_PUBLIC POWERDSR_FE_API LONG
+PowerDSR_FE_ConnectImage(const void *pImage16k,				///< (i) image of 16k front-end engine
+						 const LONG nSize16k,				///< (i) size of 16k image
+						 const void *pImage8k,				///< (i) image of 8k front-end engine
+						 const LONG nSize8k,				///< (i) size of 8k image
+						 int nMaxChannelCount				///< (i) Max Channel Count
+						 )
+{
+	if (0 == pImage16k || 0 == pImage8k) {
+		return POWERDSR_FE_NO_CFG_FILE;
+	}
+
+	return _PowerDSR_FE_connect(0, 0, pImage16k, nSize16k, pImage8k, nSize8k, nMaxChannelCount);
+}
+
+
+/**
+ *	Save the set-up of the connected DSR front-end engine of a sampling rate (16000 or 8000),
+ *	to connect by PowerDSR_FE_ConnectImage. the image is valid only for the same build.
+ *
+ *	@return return the image size in bytes (the size needed if pBuf is null), otherwise return POWERDSR_FE_FAILED.
+ */
+HCILAB_PUBLIC POWERDSR_FE_API LONG
+PowerDSR_FE_SaveImage(const LONG nSampleRate,			///< (i) sampling frequency in Hz
+					  void *pBuf,						///< (o) image buffer, 16 bytes aligned
+					  const LONG nBufSize				///< (i) size of image buffer
+					  )
+{
+	PowerASR_FrontEnd *pFE = (8000 == nSampleRate) ? g_DSR_FE_8k : g_DSR_FE;
+	hci_int32 nSize = 0;
+
+	if (0 == pFE) {
+		return POWERDSR_FE_FAILED;
+	}
+
+	nSize = PowerASR_FrontEnd_saveImage(pFE, pBuf, (hci_int32)nBufSize);
+
+	return (nSize < 0) ? POWERDSR_FE_FAILED : nSize;
+}
+
+
+static LONG
+_PowerDSR_FE_connect(const CHAR* pszASRPath,
+					 const CHAR* pszConfigFile,
+					 const void *pImage16k,
+					 const hci_int32 nSize16k,
+					 const void *pImage8k,
+					 const hci_int32 nSize8k,
+					 int nMaxChannelCount)
 {
 	hci_int32	nResult = 0;
 	hci_int32	iChan = 0;
 	int channelID = 0;
 
 
-	if (0 == pszConfigFile || 0 == pszASRPath) {
-		return POWERDSR_FE_NO_CFG_FILE;
-	}
 	if (nMaxChannelCount < 0) {
 		return POWERDSR_FE_FAILED;
 	}
@@ -194,7 +267,12 @@ PowerDSR_FE_Connect(const CHAR* pszASRPath,				///< (i) ASR main path
 			return POWERDSR_FE_FAILED;
 		}
 		
-		nResult = PowerASR_FrontEnd_openFrontEndEngine(g_DSR_FE, pszASRPath, pszConfigFile, 16000);
+		if (pImage16k) {
+			nResult = PowerASR_FrontEnd_openFrontEndEngineFromImage(g_DSR_FE, pImage16k, nSize16k);
+		}
+		else {
+			nResult = PowerASR_FrontEnd_openFrontEndEngine(g_DSR_FE, pszASRPath, pszConfigFile, 16000);
+		}
 		if (0 != nResult) {
 			PowerASR_FrontEnd_closeFrontEndEngine(g_DSR_FE);
 			PowerASR_FrontEnd_delete(g_DSR_FE);
@@ -209,7 +287,12 @@ PowerDSR_FE_Connect(const CHAR* pszASRPath,				///< (i) ASR main path
 			return POWERDSR_FE_FAILED;
 		}
 		
-		nResult = PowerASR_FrontEnd_openFrontEndEngine(g_DSR_FE_8k, pszASRPath, pszConfigFile, 8000);
+		if (pImage8k) {
+			nResult = PowerASR_FrontEnd_openFrontEndEngineFromImage(g_DSR_FE_8k, pImage8k, nSize8k);
+		}
+		else {
+			nResult = PowerASR_FrontEnd_openFrontEndEngine(g_DSR_FE_8k, pszASRPath, pszConfigFile, 8000);
+		}
 		if (0 != nResult) {
 			PowerASR_FrontEnd_closeFrontEndEngine(g_DSR_FE_8k);
 			PowerASR_FrontEnd_delete(g_DSR_FE_8k);
@@ -615,6 +698,88 @@ PowerDSR_FE_ReleaseFrontEndEngine(const LONG nChannelID)			///< (i) DSR front-en
 }
 
 
+/**
+ *	Switch noise reduction mode of a DSR front-end channel.
+ *
+ *	- nNRMode : NR_MODE_OFF, NR_MODE_SINGLE_STAGE or NR_MODE_TWO_STAGE
+ *	- call from the thread feeding the channel, takes effect from the next frame.
+ *
+ *	@return Return 0 if the mode is set, otherwise return -1.
+ */
+HCILAB_PUBLIC POWERDSR_FE_API LONG
+PowerDSR_FE_SetNoiseReductionMode(const LONG nChannelID,			///< (i) DSR front-end channel index
+								  const LONG nNRMode)			///< (i) noise reduction mode
+{
+	FrontEnd_UserData*	pChannelData = 0;
+	PowerASR_FrontEnd* g_FE = NULL;
+
+	if ( 0 == g_DSR_FE ) return -1;
+	if ( nChannelID < 0L || nChannelID >= g_nCHNL_FE ) return -1;
+
+	pChannelData = g_chanDSRFE[nChannelID];
+
+	if (0 == pChannelData) return -1;
+	if (pChannelData->nSampleRate == 16000) {
+		g_FE = g_DSR_FE;
+	} else {
+		g_FE = g_DSR_FE_8k;
+	}
+
+	return PowerASR_FrontEnd_setNoiseReductionMode(g_FE, pChannelData, (hci_int32)nNRMode);
+}
+
+
+/**
+ *	Get the speech activity of a DSR front-end channel.
+ *
+ *	- energy VAD of the Wiener noise suppressor for the last input frame, without hangover.
+ *	- always 1 when noise reduction is off (no VAD decision).
+ *
+ *	@return Return 1 for speech, 0 for non-speech, -1 on an invalid channel.
+ */
+HCILAB_PUBLIC POWERDSR_FE_API LONG
+PowerDSR_FE_GetSpeechActivity(const LONG nChannelID)			///< (i) DSR front-end channel index
+{
+	FrontEnd_UserData*	pChannelData = 0;
+
+	if ( 0 == g_DSR_FE ) return -1;
+	if ( nChannelID < 0L || nChannelID >= g_nCHNL_FE ) return -1;
+
+	pChannelData = g_chanDSRFE[nChannelID];
+
+	if (0 == pChannelData) return -1;
+
+	return (pChannelData->dataWiener.bSpeechVAD ? 1 : 0);
+}
+
+
+/**
+ *	Get the front-end engine and the data of a DSR front-end channel.
+ *
+ *	- for the stage times of the channel (CFeat2pass::getStageTime).
+ *
+ *	@return Return 0 on success, -1 on an invalid channel.
+ */
+HCILAB_PUBLIC POWERDSR_FE_API LONG
+PowerDSR_FE_GetChannelData(const LONG nChannelID,				///< (i) DSR front-end channel index
+						   PowerASR_FrontEnd **ppFrontEnd,		///< (o) front-end engine of the channel
+						   FrontEnd_UserData **ppChannelData)	///< (o) channel-specific front-end data
+{
+	FrontEnd_UserData*	pChannelData = 0;
+
+	if ( 0 == ppFrontEnd || 0 == ppChannelData ) return -1;
+	if ( nChannelID < 0L || nChannelID >= g_nCHNL_FE ) return -1;
+
+	pChannelData = g_chanDSRFE[nChannelID];
+	if (0 == pChannelData) return -1;
+
+	*ppFrontEnd = (pChannelData->nSampleRate == 16000) ? g_DSR_FE : g_DSR_FE_8k;
+	*ppChannelData = pChannelData;
+
+	return 0;
+}
+
+
 /**
  *	Convert encoded speech stream into feature stream.
  *
@@ -759,13 +924,13 @@ PowerDSR_FE_SpeechStream2FeatureStream(const LONG nChannelID,		///< (i) DSR fron
 
 	if ( nDataSize > 0 ) {
 		if ( pSpeexData->len_rec_wave ) {
-			pSpeexData->rec_wave = (short *) realloc( pSpeexData->rec_wave, 
+			pSpeexData->rec_wave = (short *) hci_realloc( pSpeexData->rec_wave, 
 								(pSpeexData->len_rec_wave + nDataSize) * sizeof(short) );
 		}
 		else  {
 			//pSpeexData->rec_wave = (short *)calloc(nDataSize, sizeof(short));
 			if (!pSpeexData->rec_wave)//yowon 2016-07-25
-				pSpeexData->rec_wave = (short *) calloc( nDataSize, sizeof(short) );//yowon 2016-07-25
+				pSpeexData->rec_wave = (short *) hci_calloc( nDataSize, sizeof(short) );//yowon 2016-07-25
 		}
 		memcpy( pSpeexData->rec_wave + pSpeexData->len_rec_wave, waveData, nDataSize * sizeof(short) );	
 		pSpeexData->len_rec_wave += nDataSize;
@@ -2,6 +2,8 @@
 #include <string.h>
 #include "Selvy_Trigger_API.h"
 #include "dnn_trigger.h"
+#include "config.h"
+#include "snapshot.h"
 #include <stdexcept>
 #include <string>
 #define USE_THROW 1
@@ -33,6 +35,12 @@
 //}
 
 Selvy_DNN_Trigger::Selvy_DNN_Trigger(const char *root_path, const char *config_path,const char *license_string)
+    : Selvy_DNN_Trigger(root_path, config_path, license_string, 16000, TRG_SAMPLE_S16)
+{
+}
+
+Selvy_DNN_Trigger::Selvy_DNN_Trigger(const char *root_path, const char *config_path,const char *license_string,
+    const int sample_rate, const TriggerSampleFormat format)
 {
     __impl__ = NULL;
 #ifdef TIMELOCK
@@ -62,7 +70,7 @@ Selvy_DNN_Trigger::Selvy_DNN_Trigger(const char *root_path, const char *config_p
 
     //if (!strcmp(CLASS_NAME_DNN_Trigger, class_name))
     {
-        CDnnTrigger *_new_inst_ = new CDnnTrigger(root_path, config_path);
+        CDnnTrigger *_new_inst_ = new CDnnTrigger(root_path, config_path, sample_rate, format);
         err = _new_inst_->getError();
 #ifdef USE_THROW
         if(err){
@@ -89,11 +97,74 @@ int Selvy_DNN_Trigger::detect(const int len_sample, const int16_t *pcm_buf,int *
     return __impl__->detect(len_sample,pcm_buf,p_st_frame_info);
 }
 
+int Selvy_DNN_Trigger::detectAudio(const int len_sample, const void *buf,int *p_st_frame_info) {
+    if(__impl__==NULL) throw std::runtime_error("Create Class Error: " + err);
+    return __impl__->detectAudio(len_sample,buf,p_st_frame_info);
+}
+
 bool Selvy_DNN_Trigger::reset() {
     if(__impl__==NULL) throw std::runtime_error("Create Class Error: " + err);
     return __impl__->reset();
 }
 
+bool Selvy_DNN_Trigger::getTriggerSpan(TriggerSpan* span) {
+    if(__impl__==NULL) throw std::runtime_error("Create Class Error: " + err);
+    return __impl__->getTriggerSpan(span);
+}
+
+bool Selvy_DNN_Trigger::getParam(TriggerParam* param) {
+    if(__impl__==NULL) throw std::runtime_error("Create Class Error: " + err);
+    return __impl__->getParam(param);
+}
+
+bool Selvy_DNN_Trigger::setParam(const TriggerParam* param) {
+    if(__impl__==NULL) throw std::runtime_error("Create Class Error: " + err);
+    return __impl__->setParam(param);
+}
+
+bool Selvy_DNN_Trigger::getStats(TriggerStats* stats) {
+    if(__impl__==NULL) throw std::runtime_error("Create Class Error: " + err);
+    return __impl__->getStats(stats);
+}
+
+void Selvy_DNN_Trigger::resetStats() {
+    if(__impl__==NULL) throw std::runtime_error("Create Class Error: " + err);
+    __impl__->resetStats();
+}
+
+void Selvy_DNN_Trigger::setConfigText(const char name[], const char text[]) {
+    CConfig::setText(name, text);
+}
+
+int Selvy_DNN_Trigger::saveSnapshot(const char root_path[], const char config_path[], const char snapshot_path[]) {
+    CDnnTrigger trigger(root_path, config_path);
+    if (trigger.getError()) return trigger.getError();
+    return trigger.saveSnapshot(snapshot_path);
+}
+
+Selvy_DNN_Trigger* Selvy_DNN_Trigger::fromSnapshot(const char snapshot_path[], const int sample_rate, const TriggerSampleFormat format) {
+    CSnapshot *snapshot = new CSnapshot;
+    int ret = snapshot->open(snapshot_path);
+    if (ret) {
+        delete snapshot;
+#ifdef USE_THROW
+        throw ret;
+#endif
+        return NULL;
+    }
+
+    CDnnTrigger *_new_inst_ = new CDnnTrigger(snapshot, sample_rate, format);
+    ret = _new_inst_->getError();
+    if (ret) {
+        delete _new_inst_;
+#ifdef USE_THROW
+        throw ret;
+#endif
+        return NULL;
+    }
+    return new Selvy_DNN_Trigger(_new_inst_);
+}
+
 //int Selvy_DNN_Trigger::getOutSPFrame() {
 //    if(__impl__==NULL) throw std::runtime_error("Create Class Error: " + err);
 //    return __impl__->getOutSPFrame();
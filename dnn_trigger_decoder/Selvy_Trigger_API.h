@@ -16,25 +16,100 @@
 #define EXPORT_SDK_API
 #endif	// _WIN32, __GNUC__
 
+// keyword span of the last detection
+// frames are 10ms feature frames, samples are offsets in the input stream since the last reset()
+// (sample frames at the sample_rate of detectAudio(), the resampler delay removed)
+typedef struct TriggerSpan {
+	int frame_begin;
+	int frame_end;
+	int64_t sample_begin;
+	int64_t sample_end;	// exclusive
+} TriggerSpan;
+
+// detector parameters tunable at runtime ([trigger] section of the config file)
+typedef struct TriggerParam {
+	float prob_threshold;
+	int w_max;			// <= max(w_max, w_span) at startup
+	int cm_threshold2;	// _CM_THRESHOLD2
+} TriggerParam;
+
+// input sample format of detectAudio(), stereo is interleaved and mixed down to mono
+typedef enum TriggerSampleFormat {
+	TRG_SAMPLE_S16 = 0,
+	TRG_SAMPLE_F32,			// [-1, 1]
+	TRG_SAMPLE_S16_STEREO,
+	TRG_SAMPLE_F32_STEREO,
+} TriggerSampleFormat;
+
+// hot-path profiling counters of detect() since the last resetStats(), not collected in a TRG_NO_STATS build
+// times are ns of a monotonic clock summed over the frames
+#define TRG_STATS_LAYERS	8
+#define TRG_STATS_BUCKETS	128
+typedef struct TriggerStats {
+	uint64_t frames;			// 10ms frames through the front end
+	uint64_t dnn_frames;		// frames through the DNN, frames skipped by the speech gate are not
+	uint64_t fe_ns;				// front end total, includes nr/mfcc/mfcc2feat
+	uint64_t nr_ns;
+	uint64_t mfcc_ns;
+	uint64_t mfcc2feat_ns;		// end-point detection and MFCC-to-feature
+	uint64_t dnn_ns;			// DNN total, includes dnn_layer_ns
+	int dnn_layers;
+	uint64_t dnn_layer_ns[TRG_STATS_LAYERS];	// first TRG_STATS_LAYERS layers
+	uint64_t detector_ns;		// detector and verifier
+	uint64_t queue_overrun;		// input samples dropped by the full input queue
+	// per-frame latency (front end to detector), HDR-style buckets, 4 per power of 2:
+	// bucket b < 4 : b ns, b >= 4 : [(4 + b%4) << (b/4 - 1), (5 + b%4) << (b/4 - 1)) ns, the last one open-ended
+	uint32_t latency[TRG_STATS_BUCKETS];
+	uint64_t latency_max_ns;
+} TriggerStats;
+
 class EXPORT_SDK_API ITriggerAPI {
 
 public:
     virtual ~ITriggerAPI(){};
 	virtual int detect(const int len_sample, const int16_t pcm_buf[],int *p_trigger_frame_info=NULL) = 0;
 	virtual bool reset() = 0;
+	// len_sample sample frames at the sample rate / format given to the constructor
+	virtual int detectAudio(const int len_sample, const void* buf, int *p_trigger_frame_info=NULL) { return detect(len_sample, (const int16_t*)buf, p_trigger_frame_info); }
+	virtual bool getTriggerSpan(TriggerSpan* span) { return false; }
+	virtual bool getParam(TriggerParam* param) { return false; }
+	virtual bool setParam(const TriggerParam* param) { return false; }
+	virtual bool getStats(TriggerStats* stats) { return false; }
+	virtual void resetStats() {}
 };
 
 class EXPORT_SDK_API Selvy_DNN_Trigger : public ITriggerAPI{
     int err;
 public:
     Selvy_DNN_Trigger(const char root_path[], const char config_path[],const char *license_string=NULL);
+    // detectAudio() input at sample_rate/format (resampled to the 16k of the model)
+    Selvy_DNN_Trigger(const char root_path[], const char config_path[],const char *license_string,
+        const int sample_rate, const TriggerSampleFormat format=TRG_SAMPLE_S16);
     virtual ~Selvy_DNN_Trigger();
     virtual int detect(const int len_sample, const int16_t *pcm_buf,int *p_trigger_frame_info=NULL);
+    virtual int detectAudio(const int len_sample, const void *buf,int *p_trigger_frame_info=NULL);
     virtual bool reset();
+    virtual bool getTriggerSpan(TriggerSpan* span);
+    virtual bool getParam(TriggerParam* param);
+    virtual bool setParam(const TriggerParam* param);
+    virtual bool getStats(TriggerStats* stats);
+    virtual void resetStats();
     int getError() { return err; }
 
+    // in-memory config : a trigger made with config_path == name reads text instead of root_path/config_path
+    // (call before the constructor, the .ini files of the DNN and the front end are still read from root_path)
+    static void setConfigText(const char name[], const char text[]);
+
+    // startup snapshot : the trigger of root_path/config_path initialized once and saved to snapshot_path
+    // (0 / error code), fromSnapshot() maps it and constructs without reading any other file.
+    // the snapshot is tied to the build that wrote it, fromSnapshot() fails (-2) with another one
+    static int saveSnapshot(const char root_path[], const char config_path[], const char snapshot_path[]);
+    static Selvy_DNN_Trigger* fromSnapshot(const char snapshot_path[],
+        const int sample_rate=16000, const TriggerSampleFormat format=TRG_SAMPLE_S16);
+
 private:
     ITriggerAPI* __impl__;
+    Selvy_DNN_Trigger(ITriggerAPI* impl) : err(0), __impl__(impl) {}
 };
 
 
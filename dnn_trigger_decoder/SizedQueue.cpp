@@ -1,11 +1,17 @@
 #include "SizedQueue.h"
 
+#include <string.h>
+
 #include <algorithm>
 
 
 SizedQueue::SizedQueue(const size_t size)
 {
+	data.resize(size);
+	head = 0;
+	count = 0;
 	max_size = size;
+	dropped = 0;
 }
 
 
@@ -16,9 +22,33 @@ SizedQueue::~SizedQueue()
 
 size_t SizedQueue::putItems(const size_t num, const int16_t* buffer)
 {
-	data.insert(data.end(), buffer, buffer + num);
-	if (max_size < data.size())
-		data.erase(data.begin(), data.begin() + data.size() - max_size);
+	if (0 == max_size)
+	{
+		dropped += num;
+		return 0;
+	}
+
+	// only the last max_size items can stay
+	size_t n = num;
+	if (max_size < n)
+	{
+		dropped += n - max_size;
+		buffer += n - max_size;
+		n = max_size;
+	}
+	if (max_size < count + n)
+	{
+		const size_t over = count + n - max_size;
+		dropped += over;
+		head = (head + over) % max_size;
+		count -= over;
+	}
+
+	const size_t tail = (head + count) % max_size;
+	const size_t first = std::min(n, max_size - tail);
+	memcpy(&data[tail], buffer, first * sizeof(int16_t));
+	memcpy(&data[0], buffer + first, (n - first) * sizeof(int16_t));
+	count += n;
 
 	return std::min(num, max_size);
 }
@@ -26,13 +56,18 @@ size_t SizedQueue::putItems(const size_t num, const int16_t* buffer)
 
 size_t SizedQueue::getItems(const size_t num, int16_t* array)
 {
-	size_t num_copy = std::min(num, data.size());
-	std::copy_n(data.begin(), num_copy, array);
-	data.erase(data.begin(), data.begin() + num_copy);
+	const size_t num_copy = std::min(num, count);
+	if (0 == num_copy)	return 0;
+
+	const size_t first = std::min(num_copy, max_size - head);
+	memcpy(array, &data[head], first * sizeof(int16_t));
+	memcpy(array + first, &data[0], (num_copy - first) * sizeof(int16_t));
+	head = (head + num_copy) % max_size;
+	count -= num_copy;
 
 	return num_copy;
 }
 
 
-size_t SizedQueue::size() { return data.size(); }
-void SizedQueue::clear() { data.clear(); }
+size_t SizedQueue::size() { return count; }
+void SizedQueue::clear() { head = 0; count = 0; }
@@ -4,7 +4,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 
-#include <deque>
+#include <vector>
 
 
 class SizedQueue
@@ -17,10 +17,15 @@ public:
 	size_t getItems(const size_t num, int16_t* buffer);
 	size_t size();
 	void clear();
+	uint64_t getDropped() { return dropped; }	// oldest items dropped by putItems() on overrun
+	void clearDropped() { dropped = 0; }
 
 private:
-	std::deque<int16_t> data;
+	std::vector<int16_t> data;	// ring of max_size items, allocated once
+	size_t head;	// oldest item
+	size_t count;
 	size_t max_size;
+	uint64_t dropped;
 };
 
 #endif	// __LVCSR_CLIENT_SIZED_QUEUE_H__
@@ -0,0 +1,73 @@
+// alloc_stats.cpp
+// Allocation accounting of the per-frame pipeline, see alloc_stats.h
+
+#include "alloc_stats.h"
+
+#include "base/hci_malloc.h"
+
+#if defined(_MSC_VER) && _MSC_VER < 1900
+#define ALLOC_THREAD_LOCAL	__declspec(thread)
+#else
+#define ALLOC_THREAD_LOCAL	thread_local
+#endif
+
+
+std::atomic<bool> CAllocStats::on(false);
+
+// no allocation here, count() may be called from operator new
+static std::atomic<uint64_t> stage_allocs[CAllocStats::STAGES];
+static std::atomic<uint64_t> stage_bytes[CAllocStats::STAGES];
+static ALLOC_THREAD_LOCAL int thread_stage = CAllocStats::OTHER;
+
+
+static void hci_hook(size_t size)
+{
+	CAllocStats::count(size);
+}
+
+
+bool CAllocStats::start(const bool hci)
+{
+	bool off = false;
+	if (!on.compare_exchange_strong(off, true))	return false;
+
+	for (int s = 0; s < STAGES; s++)
+	{
+		stage_allocs[s].store(0);
+		stage_bytes[s].store(0);
+	}
+	hci_set_alloc_hook(hci ? hci_hook : NULL);
+	return true;
+}
+
+
+void CAllocStats::stop()
+{
+	on.store(false);
+	hci_set_alloc_hook(NULL);
+}
+
+
+void CAllocStats::get(Counts* counts)
+{
+	for (int s = 0; s < STAGES; s++)
+	{
+		counts->allocs[s] = stage_allocs[s].load(std::memory_order_relaxed);
+		counts->bytes[s] = stage_bytes[s].load(std::memory_order_relaxed);
+	}
+}
+
+
+void CAllocStats::set_stage(const Stage stage)
+{
+	thread_stage = stage;
+}
+
+
+void CAllocStats::count(const size_t size)
+{
+	if (!enabled())	return;
+
+	stage_allocs[thread_stage].fetch_add(1, std::memory_order_relaxed);
+	stage_bytes[thread_stage].fetch_add(size, std::memory_order_relaxed);
+}
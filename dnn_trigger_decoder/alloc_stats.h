@@ -0,0 +1,51 @@
+// alloc_stats.h
+// Allocation accounting of the per-frame pipeline : heap allocations counted per stage (front end, DNN, detector)
+// of the thread that makes them, to check that detect() doesn't allocate once warmed up
+//
+// the hci_malloc functions (Feat2Pass, FrontEnd) are counted by the library, operator new (std containers)
+// and plain malloc/calloc only when the process replaces them with ones calling count(), see
+// trg_bench/alloc_check.cpp
+
+
+#ifndef __TRIGGER_ALLOC_STATS_H__
+#define __TRIGGER_ALLOC_STATS_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <atomic>
+
+
+class CAllocStats
+{
+public:
+	enum Stage { OTHER = 0, FRONT_END, DNN, DETECTOR, STAGES };
+
+	struct Counts
+	{
+		uint64_t allocs[STAGES];
+		uint64_t bytes[STAGES];
+	};
+
+private:
+	static std::atomic<bool> on;
+
+	static void set_stage(const Stage stage);
+
+public:
+	// counters cleared, false if already on. hci : count the hci_malloc functions, off when the process
+	// counts malloc itself (they would be counted twice)
+	static bool start(const bool hci = true);
+	static void stop();
+	static void get(Counts* counts);
+
+	static bool enabled() { return on.load(std::memory_order_relaxed); }
+
+	// stage of the following allocations of this thread, the triggers set it around their stages
+	static void setStage(const Stage stage) { if (enabled()) set_stage(stage); }
+
+	// one allocation of size bytes, to the stage of this thread
+	static void count(const size_t size);
+};
+
+#endif	// __TRIGGER_ALLOC_STATS_H__
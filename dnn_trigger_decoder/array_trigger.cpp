@@ -0,0 +1,294 @@
+// array_trigger.cpp
+// Voice trigger(word detector) for a microphone array
+// front end per channel, one batched DNN pass for all channels, fused posteriors to a single detector
+
+#define TRG_DLLEXPORT
+#include "array_trigger.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <algorithm>
+
+#include "clog.h"
+#define TRG_CLOG 1
+
+#include "SizedQueue.h"
+
+#include "config.h"
+#include "feat_2pass.h"
+#include "dnn_decoder.h"
+#include "detector_word.h"
+
+
+#ifndef _MAX_PATH
+#define _MAX_PATH 255
+#endif
+
+#define FEAT_BUF_LEN	(40960 + 10)	// as CTrigger::feat_buf
+
+
+CArrayTrigger::CArrayTrigger(const char root_path[], const char config_path[], const int channels)
+{
+	char tmp_path[_MAX_PATH] = { 0 };
+	output_frame = -1;
+	sp_output_frame = 0;
+	feat_extractor = NULL;
+	dnn_decoder = NULL;
+	dnn_prob_output = NULL;
+	detector = NULL;
+	pcm_stream = NULL;
+	span_valid = false;
+	num_class = 0;
+	this->channels = channels;
+
+	if (channels <= 0) { err = 5001; return; }
+
+	const std::shared_ptr<const CConfig> config = CConfig::open(root_path, config_path);
+
+	// log settings
+	config->gets("log", "output", "", tmp_path, _MAX_PATH);
+	if ('\0' != tmp_path[0])
+	{
+		clog_init_path(TRG_CLOG, tmp_path);
+		clog_set_level(TRG_CLOG, (clog_level)config->getl("log", "level", CLOG_ERROR));
+		if (config->getl("log", "async", 0))
+			clog_set_async(TRG_CLOG, config->getl("log", "async_records", 4096));
+	}
+
+	// init feature extractor, one FE channel per microphone
+	for (int c = 0; c < channels; c++)
+	{
+		ch_fe.push_back(new CFeat2pass(root_path));
+		if (ch_fe[c]->getError()) { err = 1000 + ch_fe[c]->getError(); return; }
+	}
+	feat_extractor = ch_fe[0];
+
+	// init DNN decoder, all channels in one batch
+	config->gets("trigger", "dnn_ini", "", tmp_path, _MAX_PATH);
+	dnn_decoder = new CDnnDecoder(root_path, tmp_path, channels);
+	if (dnn_decoder->getError()) { err = 2000 + dnn_decoder->getError(); return; }
+	if (config->getl("trigger", "dnn_fixed", DNN_FIXED_DEFAULT) && dnn_decoder->setFixedPoint(true)) { err = 2004; return; }
+	num_class = dnn_decoder->getNumOutNode();
+
+	// init word detector on the fused posteriors
+	detector = new CDetectorWord(num_class - 2, *config);
+	if (detector->getError()) { err = 3000 + detector->getError(); return; }
+	if (_clog_loggers[TRG_CLOG])
+		detector->setClog(TRG_CLOG);
+
+	// posterior fusion : max (per class over channels) or attention (channels weighted by keyword posterior mass)
+	config->gets("array", "fusion", "max", tmp_path, _MAX_PATH);
+	if (0 == strcmp(tmp_path, "max"))
+		fusion = FUSION_MAX;
+	else if (0 == strcmp(tmp_path, "attention"))
+		fusion = FUSION_ATTENTION;
+	else { err = 5002; return; }
+
+	attention_temp = config->getf("array", "attention_temp", 0.1f);
+	if (attention_temp <= 0.f) { err = 5003; return; }
+
+	// memory alloc
+	pcm_stream = new SizedQueue(16000 * channels);
+	frame_pcm.resize(160 * channels);
+	ch_pcm.resize(160 * channels);
+	ch_feat.resize((size_t)FEAT_BUF_LEN * (channels - 1));
+	ch_prob.resize(num_class * channels);
+	ch_weight.resize(channels);
+	feat_in.resize(channels);
+	prob_out.resize(channels);
+	for (int c = 0; c < channels; c++)
+		prob_out[c] = &ch_prob[c * num_class];
+	dnn_prob_output = new float[num_class];
+
+	err = 0;
+}
+
+
+CArrayTrigger::~CArrayTrigger()
+{
+	delete pcm_stream;
+	delete[] dnn_prob_output;
+
+	for (auto fe : ch_fe)
+		delete fe;
+	delete dnn_decoder;
+	delete detector;
+
+	clog_free(TRG_CLOG);
+}
+
+
+bool CArrayTrigger::reset()
+{
+	if (pcm_stream)	pcm_stream->clear();
+
+	for (auto fe : ch_fe)
+		fe->reset();
+	if (dnn_decoder)	dnn_decoder->reset();
+	if (detector)	detector->reset();
+	span_valid = false;
+
+	return true;
+}
+
+
+int CArrayTrigger::setNRMode(const int mode)
+{
+	for (auto fe : ch_fe)
+		if (fe->setNRMode(mode))	return -1;
+
+	return 0;
+}
+
+
+bool CArrayTrigger::getParam(TriggerParam* param)
+{
+	if (!detector || NULL == param)
+		return false;
+
+	detector->getParam(param);
+	return true;
+}
+
+
+bool CArrayTrigger::setParam(const TriggerParam* param)
+{
+	if (!detector)
+		return false;
+
+	return detector->setParam(param);
+}
+
+
+bool CArrayTrigger::getTriggerSpan(TriggerSpan* span)
+{
+	if (!span_valid || NULL == span)
+		return false;
+
+	*span = trigger_span;
+	return true;
+}
+
+
+// per-channel posteriors (ch_prob) -> dnn_prob_output
+void CArrayTrigger::fuse()
+{
+	if (FUSION_MAX == fusion)
+	{
+		std::copy_n(prob_out[0], num_class, dnn_prob_output);
+		for (int c = 1; c < channels; c++)
+			for (int k = 0; k < num_class; k++)
+				dnn_prob_output[k] = std::max(dnn_prob_output[k], prob_out[c][k]);
+		return;
+	}
+
+	// attention : softmax over channels of the keyword posterior mass (classes 2..)
+	float* w = ch_weight.data();
+	float w_max = -1.f;
+	for (int c = 0; c < channels; c++)
+	{
+		float kw_sum = 0.f;
+		for (int k = 2; k < num_class; k++)
+			kw_sum += prob_out[c][k];
+		w[c] = kw_sum / attention_temp;
+		w_max = std::max(w_max, w[c]);
+	}
+
+	float w_sum = 0.f;
+	for (int c = 0; c < channels; c++)
+	{
+		w[c] = expf(w[c] - w_max);
+		w_sum += w[c];
+	}
+
+	std::fill_n(dnn_prob_output, num_class, 0.f);
+	for (int c = 0; c < channels; c++)
+		for (int k = 0; k < num_class; k++)
+			dnn_prob_output[k] += w[c] / w_sum * prob_out[c][k];
+}
+
+
+int CArrayTrigger::detect_frame(const int16_t pcm[])
+{
+	int detected_frame = 0;
+
+	// interleaved -> [channel][sample]
+	for (int s = 0; s < 160; s++)
+		for (int c = 0; c < channels; c++)
+			ch_pcm[c * 160 + s] = pcm[s * channels + c];
+
+	// feature frames, the FE channels run in lockstep
+	int num_frames = 0;
+	for (int c = 0; c < channels; c++)
+	{
+		feat_t* feat = (0 == c) ? feat_buf : &ch_feat[(size_t)FEAT_BUF_LEN * (c - 1)];
+		long len_feat = 0;
+		ch_fe[c]->getFeature(160, &ch_pcm[c * 160], &len_feat, feat);
+
+		const int frames = (2 < len_feat) ? (int)(len_feat - 2 + 50) / 51 : 0;
+		num_frames = (0 == c) ? frames : std::min(num_frames, frames);
+	}
+
+	for (int f = 0; f < num_frames; f++)
+	{
+		for (int c = 0; c < channels; c++)
+			feat_in[c] = ((0 == c) ? feat_buf : &ch_feat[(size_t)FEAT_BUF_LEN * (c - 1)]) + 2 + f * 51;
+
+		output_frame = dnn_decoder->decodeBatch(feat_in.data(), prob_out.data());
+		fuse();
+
+		if (0 < detector->detect(dnn_prob_output))
+		{
+			detected_frame = output_frame;
+
+			// feature frame n covers 16 kHz samples [n*160, n*160+480), TriggerSpan holds input samples
+			trigger_span.frame_begin = std::max(0, output_frame - detector->getSpanBegin());
+			trigger_span.frame_end = std::max(trigger_span.frame_begin, output_frame - detector->getSpanEnd());
+			trigger_span.sample_begin = inputSample((int64_t)trigger_span.frame_begin * 160);
+			trigger_span.sample_end = inputSample((int64_t)trigger_span.frame_end * 160 + 480);
+			span_valid = true;
+			sp_output_frame = detector->getTriggerFrameLen();	// legacy p_trigger_frame_info[1], the keyword span is getTriggerSpan()
+		}
+	}
+
+	return detected_frame;
+}
+
+
+int CArrayTrigger::detect(const int len_sample, const int16_t pcm_buf[], int* p_info)
+{
+	int detected_frame = 0;
+	int used = 0;
+
+	// as CDnnTrigger::detect() : a queued remainder is topped up to a frame, then whole frames are taken in
+	// place from pcm_buf and only the rest is queued
+	const int queued = (int)pcm_stream->size() / channels;
+	if (0 < queued && 160 <= queued + len_sample)
+	{
+		used = 160 - queued;
+		pcm_stream->getItems(queued * channels, frame_pcm.data());
+		memcpy(&frame_pcm[queued * channels], pcm_buf, sizeof(int16_t) * used * channels);
+
+		if (const int f = detect_frame(frame_pcm.data()))
+			detected_frame = f;
+	}
+
+	if (0 == pcm_stream->size())
+	{
+		for (; used + 160 <= len_sample; used += 160)
+			if (const int f = detect_frame(&pcm_buf[used * channels]))
+				detected_frame = f;
+	}
+
+	pcm_stream->putItems((len_sample - used) * channels, &pcm_buf[used * channels]);
+
+	if (p_info != NULL)
+	{
+		p_info[0] = output_frame;
+		p_info[1] = detected_frame > 0 ? sp_output_frame : 0;
+	}
+
+	return detected_frame;
+}
@@ -0,0 +1,61 @@
+// array_trigger.h
+// Voice trigger(word detector) for a microphone array
+// front end per channel, one batched DNN pass for all channels, fused posteriors to a single detector
+
+
+#ifndef __TRIGGER_ARRAY_TRIGGER_H__
+#define __TRIGGER_ARRAY_TRIGGER_H__
+
+#include <vector>
+
+#include "trigger.h"
+
+
+class CDetectorWord;
+class SizedQueue;
+
+
+class POWER_DEEPNET_API CArrayTrigger : public CTrigger
+{
+private:
+	int channels;
+	std::vector<CFeat2pass*> ch_fe;		// ch_fe[0] == feat_extractor
+	CDetectorWord* detector;
+	SizedQueue* pcm_stream;				// interleaved samples
+
+	std::vector<int16_t> frame_pcm;		// one 10ms frame, interleaved, queued remainder + pcm_buf
+	std::vector<int16_t> ch_pcm;		// one 10ms frame, [channel][sample]
+	std::vector<feat_t> ch_feat;		// feature output of channel 1.., channel 0 uses feat_buf
+	std::vector<float> ch_prob;			// DNN posteriors, [channel][class]
+	std::vector<float> ch_weight;		// fusion weights
+	std::vector<const feat_t*> feat_in;
+	std::vector<float*> prob_out;
+	int num_class;
+
+	// posterior fusion over channels
+	enum { FUSION_MAX, FUSION_ATTENTION } fusion;
+	float attention_temp;	// softmax temperature of the per-channel keyword posterior mass
+	void fuse();
+
+	int detect_frame(const int16_t pcm[]);	// one 10ms frame, interleaved
+
+	TriggerSpan trigger_span;
+	bool span_valid;
+
+public:
+	CArrayTrigger(const char root_path[], const char config_path[], const int channels);
+	~CArrayTrigger();
+
+	virtual bool reset();
+	// len_sample : samples per channel, pcm_buf : len_sample * channels interleaved samples
+	// 16 kHz int16 only, detectAudio() is detect()
+	virtual int detect(const int len_sample, const int16_t pcm_buf[], int* spinfo=NULL);
+	virtual bool getTriggerSpan(TriggerSpan* span);
+	virtual bool getParam(TriggerParam* param);
+	virtual bool setParam(const TriggerParam* param);
+
+	int setNRMode(const int mode);	// all channels
+	int getChannels() { return channels; }
+};
+
+#endif	// __TRIGGER_ARRAY_TRIGGER_H__
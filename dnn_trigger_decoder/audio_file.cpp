@@ -0,0 +1,308 @@
+// audio_file.cpp
+// Audio input of the offline tools, see audio_file.h
+
+#include "audio_file.h"
+
+#include <string.h>
+
+#include "Selvy_Trigger_API.h"
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#include <windows.h>
+#define strcasecmp _stricmp
+#else
+#include <fcntl.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+#define WAV_FORMAT_PCM			1
+#define WAV_FORMAT_FLOAT		3
+#define WAV_FORMAT_EXTENSIBLE	0xFFFE
+
+
+static uint16_t get_u16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t get_u32(const uint8_t* p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24); }
+
+
+static void set_raw_format(AudioFormat* fmt, const int raw_rate)
+{
+	fmt->sample_rate = raw_rate;
+	fmt->channels = 1;
+	fmt->format = TRG_SAMPLE_S16;
+	fmt->frame_bytes = 2;
+}
+
+
+// "fmt " chunk body -> fmt, return 0, -2 not supported
+static int parse_fmt_chunk(const uint8_t* p, const uint32_t len, AudioFormat* fmt)
+{
+	if (len < 16)	return -2;
+
+	uint16_t tag = get_u16(p);
+	const int channels = get_u16(p + 2);
+	const int bits = get_u16(p + 14);
+	if (WAV_FORMAT_EXTENSIBLE == tag && 26 <= len)
+		tag = get_u16(p + 24);	// first 2 bytes of the sub format GUID
+
+	fmt->sample_rate = (int)get_u32(p + 4);
+	fmt->channels = channels;
+	if (WAV_FORMAT_PCM == tag && 16 == bits)
+		fmt->format = (1 == channels) ? TRG_SAMPLE_S16 : TRG_SAMPLE_S16_STEREO;
+	else if (WAV_FORMAT_FLOAT == tag && 32 == bits)
+		fmt->format = (1 == channels) ? TRG_SAMPLE_F32 : TRG_SAMPLE_F32_STEREO;
+	else
+		return -2;
+	if (channels < 1 || 2 < channels || fmt->sample_rate <= 0)
+		return -2;
+
+	fmt->frame_bytes = channels * bits / 8;
+	return 0;
+}
+
+
+// RIFF/WAVE in memory, return 0 and the sample data, -2 not supported
+static int parse_wav(const uint8_t* p, const size_t len, AudioFormat* fmt, const uint8_t** data, size_t* data_len)
+{
+	bool has_fmt = false;
+	for (size_t pos = 12; pos + 8 <= len; )
+	{
+		const uint32_t chunk_len = get_u32(p + pos + 4);
+		const uint8_t* body = p + pos + 8;
+		const size_t avail = len - pos - 8;
+
+		if (!memcmp(p + pos, "fmt ", 4))
+		{
+			if (avail < chunk_len || parse_fmt_chunk(body, chunk_len, fmt))	return -2;
+			has_fmt = true;
+		}
+		else if (!memcmp(p + pos, "data", 4))
+		{
+			if (!has_fmt)	return -2;
+			*data = body;
+			*data_len = (chunk_len < avail) ? chunk_len : avail;	// streamed files leave the size 0 or -1
+			if (0 == chunk_len)	*data_len = avail;
+			return 0;
+		}
+
+		pos += 8 + (size_t)chunk_len + (chunk_len & 1);
+	}
+	return -2;
+}
+
+
+// .raw/.pcm/.wav, or "-" (stdin)
+bool isAudioFile(const char path[])
+{
+	if (!strcmp(path, "-"))	return true;
+
+	const char* dot = strrchr(path, '.');
+	return dot && (!strcasecmp(dot, ".raw") || !strcasecmp(dot, ".pcm") || !strcasecmp(dot, ".wav"));
+}
+
+
+CAudioFileReader::CAudioFileReader()
+{
+	map = NULL;
+	map_len = 0;
+#if defined(_WIN32)
+	h_file = INVALID_HANDLE_VALUE;
+	h_map = NULL;
+#endif
+	samples = NULL;
+	frames = 0;
+	set_raw_format(&fmt, 16000);
+}
+
+
+CAudioFileReader::~CAudioFileReader()
+{
+	close();
+}
+
+
+// return 0, -1 cannot map, -2 not supported
+int CAudioFileReader::open(const char path[], const int raw_rate)
+{
+	close();
+
+#if defined(_WIN32)
+	h_file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (INVALID_HANDLE_VALUE == h_file)	return -1;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(h_file, &size) || 0 == size.QuadPart) { close(); return -2; }
+	map_len = (size_t)size.QuadPart;
+
+	h_map = CreateFileMappingA(h_file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!h_map) { close(); return -1; }
+	map = MapViewOfFile(h_map, FILE_MAP_READ, 0, 0, 0);
+	if (!map) { close(); return -1; }
+#else
+	const int fd = ::open(path, O_RDONLY);
+	if (fd < 0)	return -1;
+
+	struct stat st;
+	if (0 != fstat(fd, &st) || 0 == st.st_size) { ::close(fd); return -2; }
+	map_len = (size_t)st.st_size;
+
+	map = mmap(NULL, map_len, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (MAP_FAILED == map) { map = NULL; return -1; }
+	madvise(map, map_len, MADV_SEQUENTIAL);
+#endif
+
+	const uint8_t* p = (const uint8_t*)map;
+	size_t data_len = map_len;
+	samples = p;
+	set_raw_format(&fmt, raw_rate);
+
+	if (12 <= map_len && !memcmp(p, "RIFF", 4) && !memcmp(p + 8, "WAVE", 4))
+	{
+		if (parse_wav(p, map_len, &fmt, &samples, &data_len)) { close(); return -2; }
+	}
+
+	frames = (long)(data_len / fmt.frame_bytes);
+
+	// chunks before "data" may leave it misaligned for float samples, the views are read as float*
+	if ((uintptr_t)samples % (fmt.frame_bytes / fmt.channels))
+	{
+		aligned.resize((data_len + sizeof(float) - 1) / sizeof(float));
+		memcpy(aligned.data(), samples, data_len);
+		samples = (const uint8_t*)aligned.data();
+	}
+	return 0;
+}
+
+
+void CAudioFileReader::close()
+{
+#if defined(_WIN32)
+	if (map)	UnmapViewOfFile(map);
+	if (h_map)	CloseHandle(h_map);
+	if (INVALID_HANDLE_VALUE != h_file)	CloseHandle(h_file);
+	h_map = NULL;
+	h_file = INVALID_HANDLE_VALUE;
+#else
+	if (map)	munmap(map, map_len);
+#endif
+	map = NULL;
+	map_len = 0;
+	samples = NULL;
+	std::vector<float>().swap(aligned);
+	frames = 0;
+}
+
+
+CAudioStreamReader::CAudioStreamReader()
+{
+	fp = NULL;
+	own_fp = false;
+	pending = pending_off = 0;
+	set_raw_format(&fmt, 16000);
+}
+
+
+CAudioStreamReader::~CAudioStreamReader()
+{
+	close();
+}
+
+
+// return 0, -1 cannot open, -2 not supported
+int CAudioStreamReader::open(const char path[], const int raw_rate)
+{
+	close();
+
+	if (!strcmp(path, "-"))
+	{
+#if defined(_WIN32)
+		_setmode(_fileno(stdin), _O_BINARY);
+#endif
+		fp = stdin;
+		own_fp = false;
+	}
+	else
+	{
+		fp = fopen(path, "rb");
+		own_fp = true;
+	}
+	if (!fp)	return -1;
+
+	const int ret = readHeader(raw_rate);
+	if (ret)	close();
+	return ret;
+}
+
+
+// WAV header up to the "data" chunk, anything else is raw and stays in buf
+int CAudioStreamReader::readHeader(const int raw_rate)
+{
+	set_raw_format(&fmt, raw_rate);
+	buf.resize(12);
+	pending_off = 0;
+	pending = fread(buf.data(), 1, 12, fp);
+	if (12 != pending || memcmp(buf.data(), "RIFF", 4) || memcmp(&buf[8], "WAVE", 4))
+		return 0;
+	pending = 0;
+
+	bool has_fmt = false;
+	uint8_t chunk[8];
+	while (8 == fread(chunk, 1, 8, fp))
+	{
+		const uint32_t chunk_len = get_u32(chunk + 4);
+		if (!memcmp(chunk, "data", 4))
+			return has_fmt ? 0 : -2;	// the size is not trusted, a pipe reads to the end
+
+		// other chunks are skipped by reading, pipes can't seek
+		const size_t body_len = (size_t)chunk_len + (chunk_len & 1);
+		if (64 * 1024 * 1024 < body_len)	return -2;
+		buf.resize(body_len);
+		if (body_len != fread(buf.data(), 1, body_len, fp))	return -2;
+
+		if (!memcmp(chunk, "fmt ", 4))
+		{
+			if (parse_fmt_chunk(buf.data(), chunk_len, &fmt))	return -2;
+			has_fmt = true;
+		}
+	}
+	return -2;
+}
+
+
+void CAudioStreamReader::close()
+{
+	if (fp && own_fp)	fclose(fp);
+	fp = NULL;
+	own_fp = false;
+	pending = pending_off = 0;
+}
+
+
+// block read of up to max_frames, a partial frame at the end of the stream is dropped
+long CAudioStreamReader::read(const long max_frames, const void** data)
+{
+	if (!fp)	return 0;
+
+	const size_t want = (size_t)max_frames * fmt.frame_bytes;
+	if (buf.size() < want)	buf.resize(want);
+
+	size_t len = (pending < want) ? pending : want;
+	if (pending_off)	memmove(buf.data(), &buf[pending_off], len);
+	pending -= len;
+	pending_off = pending ? pending_off + len : 0;
+	while (len < want)
+	{
+		const size_t n = fread(&buf[len], 1, want - len, fp);
+		if (0 == n)	break;
+		len += n;
+	}
+
+	*data = buf.data();
+	return (long)(len / fmt.frame_bytes);
+}
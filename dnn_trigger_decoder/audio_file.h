@@ -0,0 +1,80 @@
+// audio_file.h
+// Audio input of the offline tools : raw PCM / WAV files mapped read-only and handed to detectAudio()
+// as views in large chunks, and a streaming reader for stdin or pipes (ffmpeg, sox) without temp files
+//
+// raw : int16 mono at the rate given to open()
+// WAV : PCM int16 or IEEE float32, mono or stereo, little endian (TriggerSampleFormat)
+
+
+#ifndef __TRIGGER_AUDIO_FILE_H__
+#define __TRIGGER_AUDIO_FILE_H__
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include <vector>
+
+
+typedef struct AudioFormat {
+	int sample_rate;
+	int channels;
+	int format;			// TriggerSampleFormat
+	int frame_bytes;	// bytes per sample frame (all channels)
+} AudioFormat;
+
+
+class CAudioFileReader
+{
+private:
+	void* map;
+	size_t map_len;
+#if defined(_WIN32)
+	void* h_file;
+	void* h_map;
+#endif
+	const uint8_t* samples;
+	std::vector<float> aligned;	// copy of the sample data when it doesn't start on a sample boundary
+	long frames;
+	AudioFormat fmt;
+
+public:
+	CAudioFileReader();
+	~CAudioFileReader();
+
+	int open(const char path[], const int raw_rate = 16000);	// maps the whole file read-only
+	void close();
+
+	const AudioFormat& getFormat() { return fmt; }
+	long getFrames() { return frames; }
+	// frames f.., in place unless the WAV data offset is not a multiple of the sample size (float)
+	const void* frame(const long f) { return samples + (size_t)f * fmt.frame_bytes; }
+};
+
+
+class CAudioStreamReader
+{
+private:
+	FILE* fp;
+	bool own_fp;
+	std::vector<uint8_t> buf;
+	size_t pending;		// bytes read by the header check not returned yet, buf[pending_off, pending_off + pending)
+	size_t pending_off;
+	AudioFormat fmt;
+
+	int readHeader(const int raw_rate);
+
+public:
+	CAudioStreamReader();
+	~CAudioStreamReader();
+
+	int open(const char path[], const int raw_rate = 16000);	// "-" : stdin
+	void close();
+
+	const AudioFormat& getFormat() { return fmt; }
+	long read(const long max_frames, const void** data);	// frames in *data, 0 at the end
+};
+
+
+bool isAudioFile(const char path[]);	// .raw/.pcm/.wav, or "-"
+
+#endif	// __TRIGGER_AUDIO_FILE_H__
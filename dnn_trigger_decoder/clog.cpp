@@ -1,2 +1,361 @@
 #define CLOG_MAIN
 #include "clog.h"
+
+// async mode of clog (clog_set_async) : binary records in a bounded MPMC queue (sequence numbered
+// slots), formatted and written by a thread per logger
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+
+#define CLOG_ASYNC_ARGS		8
+#define CLOG_ASYNC_TEXT		240		// %s arguments, or the message formatted in the caller
+#define CLOG_ASYNC_WRITE	65536	// write() batch of the writer thread
+
+
+enum clog_arg_kind { ARG_INT, ARG_LONG, ARG_LLONG, ARG_SIZE, ARG_INTMAX, ARG_PTRDIFF, ARG_DOUBLE, ARG_LDOUBLE, ARG_PTR, ARG_STR };
+
+union clog_arg
+{
+	long long i;
+	size_t z;
+	intmax_t j;
+	ptrdiff_t t;
+	double d;
+	long double ld;
+	const void* p;
+	unsigned str;	// offset in text
+};
+
+struct clog_record
+{
+	std::atomic<size_t> seq;
+	const char* sfile;
+	int sline;
+	enum clog_level level;
+	const char* fmt;	// NULL : text holds the message
+	int nargs;
+	unsigned char kind[CLOG_ASYNC_ARGS];
+	clog_arg arg[CLOG_ASYNC_ARGS];
+	char text[CLOG_ASYNC_TEXT];
+};
+
+struct clog_async
+{
+	clog_record* ring;
+	size_t mask;
+	std::atomic<size_t> head;	// next push
+	std::atomic<size_t> tail;	// next pop, writer thread only
+	std::atomic<unsigned long> dropped;
+	std::atomic<bool> stop;
+	std::thread writer;
+};
+
+
+// conversion spec at fmt ('%'), its length, the argument kind, -1 if not supported (or no argument : %%)
+static int parse_spec(const char* fmt, int* kind)
+{
+	const char* p = fmt + 1;
+	while (*p && strchr("-+ #0", *p))	p++;
+	while ('0' <= *p && *p <= '9')	p++;
+	if ('.' == *p)
+		for (p++; '0' <= *p && *p <= '9'; p++);
+
+	int len_mod = 0;	// h, hh : 0, l 1, ll 2, z 3, j 4, t 5, L 6
+	if ('h' == *p) { p++; if ('h' == *p) p++; }
+	else if ('l' == *p) { p++; len_mod = 1; if ('l' == *p) { p++; len_mod = 2; } }
+	else if ('z' == *p) { p++; len_mod = 3; }
+	else if ('j' == *p) { p++; len_mod = 4; }
+	else if ('t' == *p) { p++; len_mod = 5; }
+	else if ('L' == *p) { p++; len_mod = 6; }
+
+	static const int int_kind[6] = { ARG_INT, ARG_LONG, ARG_LLONG, ARG_SIZE, ARG_INTMAX, ARG_PTRDIFF };
+	switch (*p)
+	{
+	case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+		if (6 == len_mod)	return -1;
+		*kind = int_kind[len_mod];
+		break;
+	case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+		*kind = (6 == len_mod) ? ARG_LDOUBLE : ARG_DOUBLE;
+		break;
+	case 's':
+		if (len_mod)	return -1;
+		*kind = ARG_STR;
+		break;
+	case 'p':
+		*kind = ARG_PTR;
+		break;
+	default:	// %%, %n, '*' width / precision
+		return -1;
+	}
+	return (int)(p - fmt) + 1;
+}
+
+
+// arguments of fmt into rec, false if fmt has a spec not handled or they don't fit
+static bool capture_args(clog_record* rec, const char* fmt, va_list ap)
+{
+	unsigned text_len = 0;
+	rec->nargs = 0;
+
+	for (const char* p = fmt; *p; p++)
+	{
+		if ('%' != *p)	continue;
+		if ('%' == p[1]) { p++; continue; }
+
+		int kind;
+		const int len = parse_spec(p, &kind);
+		if (len < 0 || CLOG_ASYNC_ARGS <= rec->nargs)	return false;
+		p += len - 1;
+
+		clog_arg& a = rec->arg[rec->nargs];
+		switch (kind)
+		{
+		case ARG_INT:		a.i = va_arg(ap, int);	break;
+		case ARG_LONG:		a.i = va_arg(ap, long);	break;
+		case ARG_LLONG:		a.i = va_arg(ap, long long);	break;
+		case ARG_SIZE:		a.z = va_arg(ap, size_t);	break;
+		case ARG_INTMAX:	a.j = va_arg(ap, intmax_t);	break;
+		case ARG_PTRDIFF:	a.t = va_arg(ap, ptrdiff_t);	break;
+		case ARG_DOUBLE:	a.d = va_arg(ap, double);	break;
+		case ARG_LDOUBLE:	a.ld = va_arg(ap, long double);	break;
+		case ARG_PTR:		a.p = va_arg(ap, void*);	break;
+		case ARG_STR:
+		{
+			const char* s = va_arg(ap, const char*);
+			if (!s)	s = "(null)";
+			const size_t n = strlen(s) + 1;
+			if (CLOG_ASYNC_TEXT < text_len + n)	return false;
+			memcpy(&rec->text[text_len], s, n);
+			a.str = text_len;
+			text_len += (unsigned)n;
+			break;
+		}
+		}
+		rec->kind[rec->nargs++] = (unsigned char)kind;
+	}
+	return true;
+}
+
+
+// message of a record, the specs one by one with their argument
+static void format_record(const clog_record* rec, char* buf, const size_t buf_size)
+{
+	if (!rec->fmt)
+	{
+		snprintf(buf, buf_size, "%s", rec->text);
+		return;
+	}
+
+	size_t len = 0;
+	int n = 0;
+	for (const char* p = rec->fmt; *p && len + 1 < buf_size; )
+	{
+		if ('%' != *p) { buf[len++] = *p++; continue; }
+		if ('%' == p[1]) { buf[len++] = '%'; p += 2; continue; }
+
+		int kind;
+		const int spec_len = parse_spec(p, &kind);
+		char spec[32];
+		if (spec_len < 0 || (int)sizeof(spec) <= spec_len || rec->nargs <= n)	break;
+		memcpy(spec, p, spec_len);
+		spec[spec_len] = '\0';
+		p += spec_len;
+
+		const clog_arg& a = rec->arg[n++];
+		char* out = &buf[len];
+		const size_t room = buf_size - len;
+		int w = 0;
+		switch (kind)
+		{
+		case ARG_INT:		w = snprintf(out, room, spec, (int)a.i);	break;
+		case ARG_LONG:		w = snprintf(out, room, spec, (long)a.i);	break;
+		case ARG_LLONG:		w = snprintf(out, room, spec, a.i);	break;
+		case ARG_SIZE:		w = snprintf(out, room, spec, a.z);	break;
+		case ARG_INTMAX:	w = snprintf(out, room, spec, a.j);	break;
+		case ARG_PTRDIFF:	w = snprintf(out, room, spec, a.t);	break;
+		case ARG_DOUBLE:	w = snprintf(out, room, spec, a.d);	break;
+		case ARG_LDOUBLE:	w = snprintf(out, room, spec, a.ld);	break;
+		case ARG_PTR:		w = snprintf(out, room, spec, a.p);	break;
+		case ARG_STR:		w = snprintf(out, room, spec, &rec->text[a.str]);	break;
+		}
+		if (w < 0)	break;
+		len = std::min(len + (size_t)w, buf_size - 1);
+	}
+	buf[len] = '\0';
+}
+
+
+static bool pop_record(clog_async* q, clog_record* out)
+{
+	const size_t pos = q->tail.load(std::memory_order_relaxed);
+	clog_record& rec = q->ring[pos & q->mask];
+	if (rec.seq.load(std::memory_order_acquire) != pos + 1)
+		return false;
+
+	out->sfile = rec.sfile;
+	out->sline = rec.sline;
+	out->level = rec.level;
+	out->fmt = rec.fmt;
+	out->nargs = rec.nargs;
+	memcpy(out->kind, rec.kind, sizeof(rec.kind));
+	memcpy(out->arg, rec.arg, sizeof(rec.arg));
+	memcpy(out->text, rec.text, sizeof(rec.text));
+
+	rec.seq.store(pos + q->mask + 1, std::memory_order_release);
+	q->tail.store(pos + 1, std::memory_order_relaxed);
+	return true;
+}
+
+
+static void write_all(struct clog* logger, const char* buf, const size_t len)
+{
+	if (len && -1 == write(logger->fd, buf, (unsigned)len))
+		_clog_err("Unable to write to log file: %s\n", strerror(errno));
+}
+
+
+// drains the queue every few ms, the last time after stop
+static void writer_thread(struct clog* logger, clog_async* q)
+{
+	std::vector<char> batch(CLOG_ASYNC_WRITE);
+	clog_record rec;
+	char message[4096], line[4096];
+	size_t batch_len = 0;
+
+	for (;;)
+	{
+		const bool stopping = q->stop.load(std::memory_order_acquire);
+
+		while (pop_record(q, &rec))
+		{
+			format_record(&rec, message, sizeof(message));
+			const char* s = _clog_format(logger, line, sizeof(line), rec.sfile, rec.sline, CLOG_LEVEL_NAMES[rec.level], message);
+			const size_t n = strlen(s);
+			if (batch.size() < batch_len + n)
+			{
+				write_all(logger, batch.data(), batch_len);
+				batch_len = 0;
+			}
+			if (batch.size() < n)
+				write_all(logger, s, n);
+			else
+			{
+				memcpy(&batch[batch_len], s, n);
+				batch_len += n;
+			}
+			if (s != line)	free((void*)s);
+		}
+
+		write_all(logger, batch.data(), batch_len);
+		batch_len = 0;
+
+		const unsigned long dropped = q->dropped.exchange(0);
+		if (dropped)
+		{
+			snprintf(message, sizeof(message), "clog: %lu records dropped, queue full\n", dropped);
+			write_all(logger, message, strlen(message));
+		}
+
+		if (stopping)	break;
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+}
+
+
+// caller side : one slot claimed by CAS, filled and published, nothing else
+void _clog_async_push(struct clog* logger, const char* sfile, int sline, enum clog_level level, const char* fmt, va_list ap)
+{
+	clog_async* q = (clog_async*)logger->async;
+
+	size_t pos = q->head.load(std::memory_order_relaxed);
+	clog_record* rec;
+	for (;;)
+	{
+		rec = &q->ring[pos & q->mask];
+		const intptr_t diff = (intptr_t)rec->seq.load(std::memory_order_acquire) - (intptr_t)pos;
+		if (0 == diff)
+		{
+			if (q->head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+		{
+			q->dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		else
+			pos = q->head.load(std::memory_order_relaxed);
+	}
+
+	rec->sfile = sfile;
+	rec->sline = sline;
+	rec->level = level;
+	rec->fmt = fmt;
+
+	va_list args;
+	va_copy(args, ap);
+	const bool captured = capture_args(rec, fmt, args);
+	va_end(args);
+	if (!captured)
+	{
+		// spec not handled (%*d, %n) or too many / long arguments : formatted here, truncated
+		rec->fmt = NULL;
+		vsnprintf(rec->text, sizeof(rec->text), fmt, ap);
+	}
+
+	rec->seq.store(pos + 1, std::memory_order_release);
+}
+
+
+void _clog_async_free(struct clog* logger)
+{
+	clog_async* q = (clog_async*)logger->async;
+	if (!q)	return;
+
+	q->stop.store(true, std::memory_order_release);
+	q->writer.join();
+
+	delete[] q->ring;
+	delete q;
+	logger->async = NULL;
+}
+
+
+int clog_set_async(int id, int records)
+{
+	struct clog* logger = _clog_loggers[id];
+	if (logger == NULL) {
+		_clog_err("clog_set_async: No such logger: %d\n", id);
+		return 1;
+	}
+
+	_clog_async_free(logger);
+	if (records <= 0)
+		return 0;
+
+	size_t size = 2;
+	while (size < (size_t)records)
+		size *= 2;
+
+	clog_async* q = new clog_async;
+	q->ring = new clog_record[size];
+	q->mask = size - 1;
+	for (size_t i = 0; i < size; i++)
+		q->ring[i].seq.store(i);
+	q->head.store(0);
+	q->tail.store(0);
+	q->dropped.store(0);
+	q->stop.store(false);
+	q->writer = std::thread(writer_thread, logger, q);
+
+	logger->async = q;
+	return 0;
+}
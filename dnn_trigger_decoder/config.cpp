@@ -0,0 +1,236 @@
+// config.cpp
+// Trigger configuration parsed once, see config.h
+
+#include "config.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <mutex>
+
+
+// a loaded file, shared while its modification time and size are unchanged
+struct FileEntry
+{
+	std::shared_ptr<const CConfig> config;
+	time_t mtime;
+	long long size;
+};
+
+static std::mutex config_mutex;		// text_cache, file_cache
+static std::unordered_map<std::string, std::shared_ptr<const CConfig> > text_cache;	// setText() name
+static std::unordered_map<std::string, FileEntry> file_cache;	// path
+
+
+static bool stat_file(const char path[], FileEntry* entry)
+{
+	struct stat st;
+	if (0 != stat(path, &st))	return false;
+
+	entry->mtime = st.st_mtime;
+	entry->size = (long long)st.st_size;
+	return true;
+}
+
+
+// loaded path, cached with the modification time and size it had before the read. Failed loads are
+// not cached, a file that appears later is read by the next open()
+static std::shared_ptr<const CConfig> load_file(const std::string& path)
+{
+	FileEntry entry;
+	std::shared_ptr<CConfig> config(new CConfig);
+	if (!stat_file(path.c_str(), &entry) || !config->load(path.c_str()))
+	{
+		file_cache.erase(path);
+		return config;
+	}
+
+	entry.config = config;
+	file_cache[path] = entry;
+	return config;
+}
+
+
+static const char* skip_leading(const char* s, const char* end)
+{
+	while (s < end && (unsigned char)*s <= ' ')
+		s++;
+	return s;
+}
+
+static const char* skip_trailing(const char* s, const char* begin)
+{
+	while (begin < s && (unsigned char)*(s - 1) <= ' ')
+		s--;
+	return s;
+}
+
+
+// value after '=' : trailing comment and surrounding double quotes removed, as minIni cleanstring()
+static std::string clean_value(const char* s, const char* end)
+{
+	bool in_string = false;
+	const char* ep = s;
+	for (; ep < end && ((*ep != ';' && *ep != '#') || in_string); ep++)
+	{
+		if ('"' == *ep)
+		{
+			if (ep + 1 < end && '"' == ep[1])	ep++;
+			else	in_string = !in_string;
+		}
+		else if ('\\' == *ep && ep + 1 < end && '"' == ep[1])
+			ep++;
+	}
+	ep = skip_trailing(ep, s);
+
+	if (2 <= ep - s && '"' == *s && '"' == *(ep - 1))
+	{
+		std::string value;
+		for (const char* p = s + 1; p < ep - 1; p++)
+		{
+			if (('"' == *p || '\\' == *p) && p + 1 < ep - 1 && '"' == p[1])
+				p++;
+			value += *p;
+		}
+		return value;
+	}
+	return std::string(s, ep);
+}
+
+
+CConfig::CConfig()
+{
+	loaded = false;
+}
+
+
+std::string CConfig::makeKey(const char section[], const char key[])
+{
+	std::string k(section ? section : "");
+	k += '\n';
+	k += key;
+	for (size_t i = 0; i < k.size(); i++)
+		k[i] = (char)tolower((unsigned char)k[i]);
+	return k;
+}
+
+
+bool CConfig::load(const char path[])
+{
+	FILE* fp = fopen(path, "rb");
+	if (!fp)	return false;
+
+	std::string text;
+	char buf[4096];
+	size_t n;
+	while (0 < (n = fread(buf, 1, sizeof(buf), fp)))
+		text.append(buf, n);
+	fclose(fp);
+
+	loadText(text.c_str());
+	return true;
+}
+
+
+// the first value of a key wins, as the minIni scan
+void CConfig::loadText(const char text[])
+{
+	values.clear();
+	this->text = text;
+
+	std::string section;
+	for (const char* line = text; *line; )
+	{
+		const char* end = strchr(line, '\n');
+		if (!end)	end = line + strlen(line);
+
+		const char* sp = skip_leading(line, end);
+		if (sp < end && '[' == *sp)
+		{
+			const char* ep = (const char*)memchr(sp, ']', end - sp);
+			if (ep)	section.assign(sp + 1, ep);
+		}
+		else if (sp < end && ';' != *sp && '#' != *sp)
+		{
+			const char* ep = (const char*)memchr(sp, '=', end - sp);
+			if (!ep)	ep = (const char*)memchr(sp, ':', end - sp);
+			if (ep)
+			{
+				const std::string key(sp, skip_trailing(ep, sp));
+				values.insert(std::make_pair(makeKey(section.c_str(), key.c_str()), clean_value(skip_leading(ep + 1, end), end)));
+			}
+		}
+
+		line = *end ? end + 1 : end;
+	}
+
+	loaded = true;
+}
+
+
+const std::string* CConfig::find(const char section[], const char key[]) const
+{
+	const auto it = values.find(makeKey(section, key));
+	return (values.end() == it) ? NULL : &it->second;
+}
+
+
+int CConfig::gets(const char section[], const char key[], const char def[], char buf[], const int size) const
+{
+	if (NULL == buf || size <= 0)	return 0;
+
+	const std::string* value = find(section, key);
+	const char* s = value ? value->c_str() : def;
+	snprintf(buf, size, "%s", s ? s : "");
+	return (int)strlen(buf);
+}
+
+
+long CConfig::getl(const char section[], const char key[], const long def) const
+{
+	const std::string* value = find(section, key);
+	if (!value || value->empty())	return def;
+
+	const bool hex = 2 <= value->size() && 'X' == toupper((unsigned char)(*value)[1]);
+	return strtol(value->c_str(), NULL, hex ? 16 : 10);
+}
+
+
+float CConfig::getf(const char section[], const char key[], const float def) const
+{
+	const std::string* value = find(section, key);
+	if (!value || value->empty())	return def;
+
+	return (float)strtod(value->c_str(), NULL);
+}
+
+
+// setText() names are shared for the process, files while their stamp (mtime, size) is unchanged
+std::shared_ptr<const CConfig> CConfig::open(const char root_path[], const char config_path[])
+{
+	const std::string path = std::string(root_path) + "/" + config_path;
+
+	std::lock_guard<std::mutex> lock(config_mutex);
+	const auto text_it = text_cache.find(config_path);
+	if (text_cache.end() != text_it)	return text_it->second;
+
+	const auto it = file_cache.find(path);
+	FileEntry now;
+	if (file_cache.end() != it && stat_file(path.c_str(), &now) && now.mtime == it->second.mtime && now.size == it->second.size)
+		return it->second.config;
+
+	return load_file(path);
+}
+
+
+void CConfig::setText(const char name[], const char text[])
+{
+	std::shared_ptr<CConfig> config(new CConfig);
+	config->loadText(text);
+
+	std::lock_guard<std::mutex> lock(config_mutex);
+	text_cache[name] = config;
+}
@@ -0,0 +1,48 @@
+// config.h
+// Trigger configuration (ini) parsed once into a hash map, read with the minIni rules
+// (case-insensitive section / key, ';' '#' comments, quoted values)
+//
+// CConfig::open() shares one parsed instance per file while the file is unchanged (modification time
+// and size), setText() registers an in-memory (embedded) config under a name so that open() does no
+// file I/O for it
+
+
+#ifndef __TRIGGER_CONFIG_H__
+#define __TRIGGER_CONFIG_H__
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+
+class CConfig
+{
+private:
+	std::unordered_map<std::string, std::string> values;	// "section\nkey" in lower case -> value
+	std::string text;	// as loaded, saved in snapshots
+	bool loaded;
+
+	static std::string makeKey(const char section[], const char key[]);
+	const std::string* find(const char section[], const char key[]) const;
+
+public:
+	CConfig();
+
+	bool load(const char path[]);		// false if the file can't be read
+	void loadText(const char text[]);
+	bool isLoaded() const { return loaded; }
+	const std::string& getText() const { return text; }
+
+	// as ini_gets / ini_getl / ini_getf
+	int gets(const char section[], const char key[], const char def[], char buf[], const int size) const;
+	long getl(const char section[], const char key[], const long def) const;
+	float getf(const char section[], const char key[], const float def) const;
+
+	// shared instance of root_path/config_path, or of config_path registered by setText()
+	// never NULL, not loaded if the file can't be read (every key gives its default, not cached).
+	// Hold the returned pointer while the instance is used, a changed file replaces the cached one
+	static std::shared_ptr<const CConfig> open(const char root_path[], const char config_path[]);
+	static void setText(const char name[], const char text[]);
+};
+
+#endif	// __TRIGGER_CONFIG_H__
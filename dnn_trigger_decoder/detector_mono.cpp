@@ -7,27 +7,16 @@
 #include <stdlib.h>
 
 #include <algorithm>
-#include <iostream>
 #include <string>
 
 #include "clog.h"
-
-#define MININI_ANSI
-#define INI_READONLY 
-#include "minIni.h"
+#include "config.h"
+#include "prob_ring.h"
 
 #include "lexicon/text2lex.h"
 #pragma comment(lib, "Feat2Pass")
 #pragma comment(lib, "FrontEnd")
 
-#ifndef _MAX_PATH
-#define _MAX_PATH 255
-#endif
-
-//#define wsmooth_length 10
-#define wsmooth_length 30
-#define wmax 300
-
 #include <sstream>
 namespace std
 {
@@ -110,33 +99,42 @@ static const float prob_smooth_len[] = {
 	 8.507745,  7.443124, 13.952400, 14.276915, 10.119273,
 };
 
-CDetectorMono::CDetectorMono(const int phon_num, const char root_path[], const char config_path[])
+CDetectorMono::CDetectorMono(const int phon_num, const CConfig& config)
 {
 	this->phon_num = phon_num;
 	clog_id = 0;
-
-	char ini_config[_MAX_PATH];
-	snprintf(ini_config, sizeof(ini_config), "%s/%s", root_path, config_path);
-
+	past_prob = NULL;
+	phon_prob_ring = NULL;
+	smooth_len = NULL;
+	phon_buf = NULL;
+	worker_count = 0;
 
 	// tigger settings
-	prob_thr = ini_getf("mono", "prob_threshold", -1.f, ini_config);
+	prob_thr = config.getf("mono", "prob_threshold", -1.f);
 	if (prob_thr <= 0.f) { err = 4; return; }
 
-	pause_thr = ini_getl("mono", "pause_threshold", -1, ini_config) / 10;
+	pause_thr = config.getl("mono", "pause_threshold", -1) / 10;
 	if (pause_thr < 0) { err = 5; return; }
 
-	score_thr = ini_getf("mono", "score_threshold", -1.f, ini_config);
+	score_thr = config.getf("mono", "score_threshold", -1.f);
 	if (pause_thr < 0.f) { err = 5; return; }
 
+	// smoothing / max window (frames)
+	w_smooth = (int)config.getl("mono", "w_smooth", 30);
+	if (w_smooth <= 1) { err = 5; return; }
+
+	w_max = (int)config.getl("mono", "w_max", 300);
+	if (w_max <= 0) { err = 5; return; }
+
 	// memory alloc
-	past_prob = new float*[phon_num]();
-	for (int i = 0; i < phon_num; i++)
-		past_prob[i] = new float[wsmooth_length]();
+	past_prob = new CProbRing(w_smooth, phon_num);
+	phon_prob_ring = new CProbRing(w_max, phon_num);
+	phon_buf = new float[past_prob->getStride()]();
 
-	phon_prob_ring = new float*[phon_num]();
-	for (int i = 0; i < phon_num; i++)
-		phon_prob_ring[i] = new float[wmax]();
+	// the current frame takes one slot of past_prob
+	smooth_len = new float[past_prob->getStride()]();
+	for (int k = 0; k < phon_num; k++)
+		smooth_len[k] = (float)std::min((int)round(prob_smooth_len[k]/2), w_smooth - 1);
 	clear();
 
 	if (41 == phon_num)
@@ -167,18 +165,16 @@ CDetectorMono::~CDetectorMono()
 		int seq_len = work_seq.size();
 		for (int p = 0; p < seq_len; p++)	// phone
 		{
-			delete work_seq[p];
-			work_seq[p] = NULL;
+			free_worker(work_seq[p]);
 		}
 	}
+	for (size_t i = 0; i < worker_pool.size(); i++)
+		delete worker_pool[i];
 
-	for (int i = 0; i < phon_num; i++)
-		delete[] past_prob[i];
-	delete[] past_prob;
-
-	for (int i = 0; i < phon_num; i++)
-		delete[] phon_prob_ring[i];
-	delete[] phon_prob_ring;
+	delete past_prob;
+	delete phon_prob_ring;
+	delete[] smooth_len;
+	delete[] phon_buf;
 }
 
 
@@ -206,23 +202,20 @@ std::string CDetectorMono::word2phone(const char word[])
 }
 
 
-static float prob_variable_smooth(const float prob[], const int frame_idx, const int smooth_len)
+// out[k] = mean of prob rows [frame_idx - smooth_len[k], frame_idx)
+static void prob_variable_smooth(const CProbRing* prob, const int frame_idx, const float smooth_len[], const int max_len, const int phon_num, float out[])
 {
-	const int hsmooth_start = std::max(0, frame_idx - smooth_len);
-	const int hsmooth_len = frame_idx - hsmooth_start;
-	if (hsmooth_len <= 0)	return 0.f;
-
-	float accum_post_prob = 0.f;
-	for (int k = hsmooth_start; k < frame_idx; k++)
-		accum_post_prob += prob[k%wsmooth_length];
+	prob->sumRowsTail(frame_idx, smooth_len, max_len, out);
 
-	float post_outprob = accum_post_prob / hsmooth_len;
-
-	return post_outprob;
+	for (int k = 0; k < phon_num; k++)
+	{
+		const int hsmooth_len = std::min((int)smooth_len[k], frame_idx);
+		out[k] = (0 < hsmooth_len) ? out[k] / hsmooth_len : 0.f;
+	}
 }
 
 
-static float calc_prob_max_sum(float** const post_dnn_outprob, const int start_idx, const int end_idx, std::vector<char> phon_set)
+static float calc_prob_max_sum(const CProbRing* post_dnn_outprob, const int start_idx, const int end_idx, const std::vector<char>& phon_set, float max_class_prob[])
 {
 	if (start_idx < 0
 		|| end_idx < 0
@@ -230,15 +223,12 @@ static float calc_prob_max_sum(float** const post_dnn_outprob, const int start_i
 		|| 0 == phon_set.size())
 		return 0.f;
 
+	post_dnn_outprob->maxRows(start_idx, end_idx, max_class_prob);
+
 	float cm_score = 0.f;
 	for (auto i = phon_set.begin(); i != phon_set.end(); i++)
-	{
-		float max_class_prob = 0.f;
-		for (int k = start_idx; k < end_idx; k++)
-			max_class_prob = std::max(max_class_prob, post_dnn_outprob[*i][k%wmax]);
+		cm_score += max_class_prob[*i];
 
-		cm_score += max_class_prob;
-	}
 	if (cm_score < FLT_MIN)	return 0.f;
 	return cm_score;
 }
@@ -254,6 +244,7 @@ int CDetectorMono::addPhonSeq(const char sequence[])
 
 	phon_seqs.push_back(phone_seq);
 	work_seq_pool.push_back(std::vector<phoneseq_worker*>(phone_seq.length(), nullptr));
+	reserve_workers(phone_seq.length() + 1);
 	return phon_seqs.size();
 }
 
@@ -267,10 +258,60 @@ int CDetectorMono::addPhonSeq(const std::string sequence)
 
 	phon_seqs.push_back(phone_seq);
 	work_seq_pool.push_back(std::vector<phoneseq_worker*>(phone_seq.length(), nullptr));
+	reserve_workers(phone_seq.length() + 1);
 	return phon_seqs.size();
 }
 
 
+// workers of a sequence : one per phone slot and the copy being made, the pool only grows so
+// detect() reuses them (and the capacity of their strings / vectors) instead of allocating
+void CDetectorMono::reserve_workers(const size_t n)
+{
+	worker_count += n;
+	worker_pool.reserve(worker_count);
+	for (size_t i = 0; i < n; i++)
+	{
+		phoneseq_worker* w = new phoneseq_worker();
+		w->history.reserve(WORKER_RESERVE * 3);
+		w->all_hist.reserve(WORKER_RESERVE * 3);
+		w->detected_phons.reserve(WORKER_RESERVE);
+		w->ex_pool.reserve(WORKER_RESERVE);
+		worker_pool.push_back(w);
+	}
+}
+
+
+// a cleared worker from the pool (a new one if it ran out)
+phoneseq_worker* CDetectorMono::new_worker()
+{
+	if (worker_pool.empty())
+		reserve_workers(1);
+
+	phoneseq_worker* w = worker_pool.back();
+	worker_pool.pop_back();
+
+	w->history.clear();
+	w->all_hist.clear();
+	w->frm_begin = w->frm_end = 0;
+	w->window_len = 0;
+	w->phon_begin = 0;
+	w->detected_phon = w->all_phon = 0;
+	w->detected_phons.clear();
+	w->ex_pool.clear();
+	return w;
+}
+
+
+// back to the pool, w = NULL
+void CDetectorMono::free_worker(phoneseq_worker*& w)
+{
+	if (!w)	return;
+
+	worker_pool.push_back(w);
+	w = NULL;
+}
+
+
 // clear buffer to continue word detection
 void CDetectorMono::clear()
 {
@@ -282,16 +323,12 @@ void CDetectorMono::clear()
 		int seq_len = work_seq.size();
 		for (int p = 0; p < seq_len; p++)	// phone
 		{
-			delete work_seq[p];
-			work_seq[p] = NULL;
+			free_worker(work_seq[p]);
 		}
 	}
 
-	for (int k = 0; k < phon_num; k++)
-		memset(past_prob[k], 0, sizeof(float)*wsmooth_length);
-
-	for (int k = 0; k < phon_num; k++)
-		memset(phon_prob_ring[k], 0, sizeof(float)*wmax);
+	past_prob->clear();
+	phon_prob_ring->clear();
 }
 
 
@@ -304,6 +341,12 @@ bool CDetectorMono::reset()
 	phon_seqs.clear();
 	work_seq_pool.clear();
 
+	// every worker is in the pool after clear()
+	for (size_t i = 0; i < worker_pool.size(); i++)
+		delete worker_pool[i];
+	worker_pool.clear();
+	worker_count = 0;
+
 	return true;
 }
 
@@ -313,13 +356,11 @@ int CDetectorMono::detect(const float prob[])
 	proc_count++;
 
 	// fill ring buffer
-	const int idx = proc_count % wsmooth_length;
-	for (int k = 0; k < phon_num; k++)
-		past_prob[k][idx] = prob[k];
+	memcpy(past_prob->row(proc_count), prob, sizeof(float)*phon_num);
 
-	const int idx_key_prob = proc_count % wmax;
-	for (int k = 0; k < phon_num; k++)
-		phon_prob_ring[k][idx_key_prob] = prob_variable_smooth(past_prob[k], proc_count, (int)round(prob_smooth_len[k]/2));
+	float* const phon_prob = phon_prob_ring->row(proc_count);
+	float* const phon_prob1 = phon_prob_ring->row(proc_count-1);
+	prob_variable_smooth(past_prob, proc_count, smooth_len, w_smooth - 1, phon_num, phon_prob);
 
 #if 0
 	if (_clog_loggers[clog_id] 
@@ -330,16 +371,15 @@ int CDetectorMono::detect(const float prob[])
 		for (int k = 0; k < phon_num; k++)
 		{
 			prob_str += "\t";
-			prob_str += std::to_string(phon_prob_ring[k][idx_key_prob]);
+			prob_str += std::to_string(phon_prob[k]);
 		}
 		clog_debug(CLOG(clog_id), prob_str.c_str());
 
 
-		const int idx_key_prob1 = (proc_count-1) % wmax;
 		for (int k = 0; k < phon_num; k++)
 		{
-			if (phon_prob_ring[k][idx_key_prob1] < prob_thr
-				&& prob_thr < phon_prob_ring[k][idx_key_prob])
+			if (phon_prob1[k] < prob_thr
+				&& prob_thr < phon_prob[k])
 				printf("%s", hangul_table[k]);
 		}
 	}
@@ -358,14 +398,14 @@ int CDetectorMono::detect(const float prob[])
 			if (!w)	continue;
 
 			char last_phon = seq[p];
-			if (prob_thr < phon_prob_ring[last_phon][idx_key_prob])
+			if (prob_thr < phon_prob[last_phon])
 				w->frm_end = proc_count;
 
 			for (int i = 0; i < w->window_len; i++)	// phone window
 			{
 				if (seq_len <= p+i+1)	// word detected
 				{
-					float sum_target = calc_prob_max_sum(phon_prob_ring, w->frm_begin, proc_count, w->detected_phons);
+					float sum_target = calc_prob_max_sum(phon_prob_ring, w->frm_begin, proc_count, w->detected_phons, phon_buf);
 
 					// ooc Ȯ 
 					float sum_ex = 0.f;
@@ -373,23 +413,10 @@ int CDetectorMono::detect(const float prob[])
 					{
 						sum_ex += (*i).max_prob;
 					}
-#ifndef __ANDROID__	// for Android build (Android toolchain does not support to_string)
+					// one record, formatted by clog (in its writer thread in async mode)
 					if (_clog_loggers[clog_id])
-					{
-						std::string log_str;
-						log_str += "\t" + std::to_string(w->frm_end - w->frm_begin);
-						log_str += "\t" + std::to_string(w->detected_phon);
-						log_str += "\t" + std::to_string(w->all_phon);
-						log_str += "\t" + w->history;
-						log_str += "\t" + w->all_hist;
-						log_str += "\t" + std::to_string(sum_target);
-						log_str += "\t" + std::to_string(sum_ex);
-						log_str += "\t" + std::to_string(sum_target/sum_ex);
-
-						std::cout << log_str << std::endl;
-						clog_debug(CLOG(clog_id), log_str.c_str());
-					}
-#endif	// !_GLIBCXX_HAVE_BROKEN_VSWPRINTF
+						clog_debug(CLOG(clog_id), "\t%d\t%d\t%d\t%s\t%s\t%f\t%f\t%f", w->frm_end - w->frm_begin,
+							w->detected_phon, w->all_phon, w->history.c_str(), w->all_hist.c_str(), sum_target, sum_ex, sum_target/sum_ex);
 					if (sum_ex <= 0.f || score_thr < sum_target/sum_ex)	//  Ȯ  ǽ
 						detected = s+1;
 
@@ -415,10 +442,11 @@ int CDetectorMono::detect(const float prob[])
 				if (proc_count - w->phon_begin < len_min_phon)
 					continue;
 
-				if (phon_prob_ring[phon][idx_key_prob] < prob_thr)	continue;	// phone ̰
+				if (phon_prob[phon] < prob_thr)	continue;	// phone ̰
 
 				// phone detected
-				phoneseq_worker* w_new = new phoneseq_worker(*w);	// copy
+				phoneseq_worker* w_new = new_worker();
+				*w_new = *w;	// copy
 				w_new->frm_end = proc_count;
 				w_new->phon_begin = proc_count;
 				w_new->window_len -= i;
@@ -435,19 +463,17 @@ int CDetectorMono::detect(const float prob[])
 				{
 					if (0 == i)
 					{
-						delete work_seq[p];
-						work_seq[p] = NULL;
+						free_worker(work_seq[p]);
 					}
-					delete w_new;
+					free_worker(w_new);
 					break;
 				}
 
-				delete work_seq[p+i+1];	// delete existing worker
+				free_worker(work_seq[p+i+1]);	// delete existing worker
 				work_seq[p+i+1] = w_new;	// put worker to new position
 				if (0 == i)
 				{
-					delete work_seq[p];
-					work_seq[p] = NULL;
+					free_worker(work_seq[p]);
 				}
 				break;
 			}	// i = phone window
@@ -466,10 +492,10 @@ int CDetectorMono::detect(const float prob[])
 			if (work_seq[i])	continue;	// ̹ ش phone   skip
 
 			char phon = seq[i];
-			if (phon_prob_ring[phon][idx_key_prob] < prob_thr)	continue;	// phone ̰
+			if (phon_prob[phon] < prob_thr)	continue;	// phone ̰
 
 			// phone detected
-			phoneseq_worker* w = new phoneseq_worker();
+			phoneseq_worker* w = new_worker();
 			w->frm_begin = proc_count;
 			w->frm_end = proc_count;
 			w->phon_begin = proc_count;
@@ -499,8 +525,7 @@ int CDetectorMono::detect(const float prob[])
 				//	printf("\nt\t");
 				//	puts(w->history.c_str());
 				//}
-				delete work_seq[p];
-				work_seq[p] = NULL;
+				free_worker(work_seq[p]);
 				continue;
 			}
 
@@ -517,16 +542,15 @@ int CDetectorMono::detect(const float prob[])
 					continue;
 				}
 
-				(*i).max_prob = std::max((*i).max_prob, phon_prob_ring[k][idx_key_prob]);
+				(*i).max_prob = std::max((*i).max_prob, phon_prob[k]);
 			}
 
 			// detect non-kw phone(ex phone)
-			const int idx_key_prob1 = (proc_count-1) % wmax;
 			for (int k = 0; k < phon_num; k++)
 			{
 				if (!(
-					phon_prob_ring[k][idx_key_prob1] < prob_thr
-					&& prob_thr < phon_prob_ring[k][idx_key_prob])
+					phon_prob1[k] < prob_thr
+					&& prob_thr < phon_prob[k])
 					)
 					continue;
 
@@ -561,7 +585,7 @@ int CDetectorMono::detect(const float prob[])
 				
 				ex_phon exp;
 				exp.phon = k;
-				exp.max_prob = phon_prob_ring[k][idx_key_prob];
+				exp.max_prob = phon_prob[k];
 				w->ex_pool.push_back(exp);
 			}
 		}
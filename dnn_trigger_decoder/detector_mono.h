@@ -11,6 +11,8 @@
 
 
 typedef struct phoneseq_worker phoneseq_worker;
+class CConfig;
+class CProbRing;
 
 
 class CDetectorMono
@@ -21,13 +23,25 @@ class CDetectorMono
 	const char** hangul_table;
 
 	int phon_num;
-	float** phon_prob_ring;	// after smoothing
-	float** past_prob;	// prob history
+	CProbRing* phon_prob_ring;	// after smoothing, [frame][phone]
+	CProbRing* past_prob;	// prob history, [frame][phone]
+	float* smooth_len;	// per-phone smoothing length (past_prob->getStride() floats)
+	float* phon_buf;	// scratch row (past_prob->getStride() floats)
+	int w_smooth;
+	int w_max;
 	void clear();
 
 	std::vector<std::string> phon_seqs;
 	std::vector<std::vector<phoneseq_worker*>> work_seq_pool;
 
+	// free workers, reused by detect()
+	enum { WORKER_RESERVE = 64 };	// phones reserved per worker history
+	std::vector<phoneseq_worker*> worker_pool;
+	size_t worker_count;	// workers made, in the pool or in work_seq_pool
+	void reserve_workers(const size_t n);
+	phoneseq_worker* new_worker();
+	void free_worker(phoneseq_worker*& w);
+
 	float prob_thr;
 	float score_thr;
 	int pause_thr;
@@ -38,7 +52,7 @@ class CDetectorMono
 	std::string word2phone(const char word[]);
 
 public:
-	CDetectorMono(const int keyword_num, const char root_path[], const char config_path[]);
+	CDetectorMono(const int keyword_num, const CConfig& config);
 	~CDetectorMono();
 	int addPhonSeq(const char sequence[]);
 	int addPhonSeq(const std::string sequence);
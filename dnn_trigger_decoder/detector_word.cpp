@@ -14,83 +14,86 @@
 #include <algorithm>
 
 #include "clog.h"
-
-#define MININI_ANSI
-#define INI_READONLY
-#include "minIni.h"
-
-
-#ifndef _MAX_PATH
-#define _MAX_PATH 255
-#endif
+#include "config.h"
+#include "prob_ring.h"
 
 //#define wmax 50
 //#define _CM_THRESHOLD2 10 // _CM_THRESHOLD  ū frame  ̺  
 
-float CDetectorWord::posterior_smoothing_ring_buffer(const float dnn_out_prob[], const int frame_idx)//frame_idx  0 Ŀ.
+void CDetectorWord::posterior_smoothing_ring_buffer(const int frame_idx, float post_dnn_outprob[])//frame_idx  0 Ŀ.
 {
-	float accum_post_dnnprob = 0;
-	const int hsmooth_length = std::max(1, frame_idx - wsmooth_length + 1);
+	const int hsmooth_length = std::max(1, frame_idx - wsmooth + 1);
 	const float hsmooth_value = 1 / (float)(frame_idx - hsmooth_length + 1);
 
-	for (int k = hsmooth_length - 1; k < frame_idx; k++)
-	{
-		accum_post_dnnprob += dnn_out_prob[k%wsmooth_length];
-	}
-
-	float post_dnn_outprob = hsmooth_value*accum_post_dnnprob;
+	// all keywords at once, one row per frame
+	kw_hist->sumRows(hsmooth_length - 1, frame_idx, post_dnn_outprob);
 
-	return post_dnn_outprob;
+	for (int i = 0; i < keyword_num; i++)
+		post_dnn_outprob[i] = hsmooth_value*post_dnn_outprob[i];
 }
 
 
-float CDetectorWord::calc_confidence_score_ring_buffer(float **post_dnn_outprob, int const frame_idx, const int class_num)
+float CDetectorWord::calc_confidence_score_ring_buffer(int const frame_idx)
 {
 	float cm_score = 1.f;
 	const int hmax = std::max(1, frame_idx - wmax + 1);
 
-	for (int i = 0; i < class_num; i++)
-	{
-		float max_class_prob = 0.f;
-		for (int k = hmax - 1; k < frame_idx; k++)
-			max_class_prob = std::max(max_class_prob, post_dnn_outprob[i][k%wmax]);
+	float* max_class_prob = kw_buf;
+	kw_smooth->maxRows(hmax - 1, frame_idx, max_class_prob);
+
+	for (int i = 0; i < keyword_num; i++)
+		cm_score = cm_score * max_class_prob[i];
 
-		cm_score = cm_score * max_class_prob;
-	}
 	if (cm_score < FLT_MIN)	return 0.f;
-	return powf(cm_score, 1.f/class_num);
+	return powf(cm_score, 1.f/keyword_num);
 }
 
 
-CDetectorWord::CDetectorWord(const int keyword_num, const char root_path[], const char config_path[])
+CDetectorWord::CDetectorWord(const int keyword_num, const CConfig& config, const char section[])
 {
 	this->keyword_num = keyword_num;
 	clog_id = 0;
-
-	char ini_config[_MAX_PATH];
-	snprintf(ini_config, sizeof(ini_config), "%s/%s", root_path, config_path);
-
+	kw_hist = NULL;
+	kw_smooth = NULL;
+	kw_buf = NULL;
+	span_begin = 0;
+	span_end = 0;
+	ini_section = section;
+	param_dirty = false;
 
 	/* ** tigger settings ** */
-	prob_thr = ini_getf("trigger", "prob_threshold", -1.f, ini_config);
+	prob_thr = config.getf(section, "prob_threshold", -1.f);
 	if (prob_thr <= 0.f) { err = 4; return; }
 
+	// init posterior smoothing window
+	wsmooth = (int)config.getl(section, "w_smooth", 20);
+	if (wsmooth <= 0) { err = 4; return; }
+
 	// init wmax value
-	wmax = ini_getINT("trigger", "w_max", 50, ini_config);
+	wmax = (int)config.getl(section, "w_max", 50);
 	if (wmax <= 0) { err = 4; return; }
 
+	// init keyword span look-back (frames)
+	wspan = (int)config.getl(section, "w_span", 150);
+	if (wspan <= 0) { err = 4; return; }
+
 	// init _CM_THRESHLOD2 value   : _CM_THRESHOLD  ū frame  ̺  
-	_CM_THRESHOLD2 = ini_getINT("trigger", "_CM_THRESHOLD2", 10, ini_config);
+	_CM_THRESHOLD2 = (int)config.getl(section, "_CM_THRESHOLD2", 10);
 	if (_CM_THRESHOLD2 <= 0) { err = 4; return; }
 
-	// memory alloc
-	past_prob.kw_prob = new float*[keyword_num]();
-	for (int i = 0; i < keyword_num; i++)
-		past_prob.kw_prob[i] = new float[wsmooth_length]();
+	// init posterior gate : keyword posterior sum floor (0 = off), must stay under prob_threshold
+	gate_floor = config.getf(section, "gate_floor", 0.f);
+	if (gate_floor < 0.f || prob_thr <= gate_floor) { err = 4; return; }
 
-	keyword_prob_ring = (float **)(calloc(keyword_num, sizeof(float *)));
-	for (int i = 0; i < keyword_num; i++)
-		keyword_prob_ring[i] = (float *)calloc(wmax, sizeof(float));
+	// gated frames are re-smoothed from the kw history, so keep a kw_smooth ring more frames of it
+	const int smooth_len = std::max(wmax, wspan);
+	hist_len = (0.f < gate_floor) ? wsmooth + smooth_len : wsmooth;
+	gate_settle = wsmooth + wmax;
+
+	// memory alloc
+	kw_hist = new CProbRing(hist_len, keyword_num);
+	kw_smooth = new CProbRing(smooth_len, keyword_num);
+	kw_buf = new float[kw_smooth->getStride()]();
 	clear();
 
 	err = 0;
@@ -99,13 +102,9 @@ CDetectorWord::CDetectorWord(const int keyword_num, const char root_path[], cons
 
 CDetectorWord::~CDetectorWord()
 {
-	for (int i = 0; i < keyword_num; i++)
-		delete[] past_prob.kw_prob[i];
-	delete[] past_prob.kw_prob;
-
-	for (int i = 0; i < keyword_num; i++)
-		free(keyword_prob_ring[i]);
-	free(keyword_prob_ring);
+	delete kw_hist;
+	delete kw_smooth;
+	delete[] kw_buf;
 }
 
 void CDetectorWord::setClog(int log_id)
@@ -119,17 +118,12 @@ void CDetectorWord::clear()
 	trigger_word_count = 0;
 	trg_sp_count = 0;
 	sp_detected_frame = -1;
+	gate_idle = 0;
+	gate_skip_from = -1;
 
 
-	memset(past_prob.sil_outprob, 0, sizeof(past_prob.sil_outprob));
-	memset(past_prob.filler_prob, 0, sizeof(past_prob.filler_prob));
-
-	for (int k = 0; k < keyword_num; k++)
-		memset(past_prob.kw_prob[k], 0, sizeof(float)*wsmooth_length);
-
-
-	for (int k = 0; k < keyword_num; k++)
-		memset(keyword_prob_ring[k], 0x00, sizeof(float)*wmax);
+	kw_hist->clear();
+	kw_smooth->clear();
 }
 
 bool CDetectorWord::reset()
@@ -144,26 +138,27 @@ int CDetectorWord::getError() { return err; }
 
 int CDetectorWord::detect(const float prob[])
 {
+	if (param_dirty)
+		apply_param();
+
 	proc_count++;
 
 	// fill ring buffer  ( linkedList )
-	const int idx = proc_count % wsmooth_length;
+	float* kw_row = kw_hist->row(proc_count);
 #ifdef FILE_LOG
 //	FILE *fp = fopen("keyword_posterior.txt", "a+");
 //	FILE *cm_fp = fopen("cm_score.txt", "a+");
 	//fprintf(fp, "kw_prob >> ");
 #endif
-	past_prob.sil_outprob[idx] = prob[0];
-	past_prob.filler_prob[idx] = prob[1];
 	
 #ifdef FILE_LOG
 //	fprintf(fp, "%dclass : %f ", 0, (float)prob[0]);  fprintf(fp, "%dclass : %f ", 1, (float)prob[1]);
 //	fprintf(cm_fp, "%dclass : %f ", 0, (float)prob[0]);  fprintf(cm_fp, "%dclass : %f ", 1, (float)prob[1]);
 #endif
 	for (int k = 0; k < keyword_num; k++){       //keyword_num = class number - 2 (2 = silence + filler)
-		past_prob.kw_prob[k][idx] = prob[k + 2];
+		kw_row[k] = prob[k + 2];
 		// Detect Starting point
-		if (past_prob.kw_prob[0][idx] > 0.8){
+		if (kw_row[0] > 0.8){
 			trg_sp_count++;
 			if (trg_sp_count == 10){
 				sp_detected_frame = proc_count-10-10 ;   // -10 : trg_starting point frame , -10 : concat_after_frame
@@ -183,21 +178,43 @@ int CDetectorWord::detect(const float prob[])
 //	fprintf(fp, "\n");
 #endif
 
-	const int idx_key_prob = proc_count % wmax;
+	// posterior gate : while no keyword is active, keep only the counters and the kw history
+	if (0.f < gate_floor)
+	{
+		float kw_sum = 0.f;
+		for (int k = 0; k < keyword_num; k++)
+			kw_sum += prob[k + 2];
 
-	for (int k = 0; k < keyword_num; k++){
-		keyword_prob_ring[k][idx_key_prob] = posterior_smoothing_ring_buffer(past_prob.kw_prob[k], proc_count + 1);
-#ifdef FILE_LOG
-		//fprintf(fp, "%dclass : %f ", k + 2, (float)prob[k + 2]);
-//		fprintf(cm_fp, "%dclass : %f ", k + 2, (float)prob[k + 2]);
-#endif
+		if (kw_sum < gate_floor)
+		{
+			// after gate_settle quiet frames kw_cm_score < gate_floor < prob_thr, nothing to compute
+			if (gate_settle <= gate_idle++)
+			{
+				if (gate_skip_from < 0)
+					gate_skip_from = proc_count;
+				trigger_word_count = 0;
+				frigger_frame_len = proc_count - sp_detected_frame;
+				return 0;
+			}
+		}
+		else
+		{
+			gate_idle = 0;
+		}
+
+		// also after w_max grew while gated
+		if (0 <= gate_skip_from)
+			rebuild_gated_frames();
 	}
+
+	float* kw_smooth_row = kw_smooth->row(proc_count);
+	posterior_smoothing_ring_buffer(proc_count + 1, kw_smooth_row);
 #ifdef FILE_LOG
 	//fprintf(fp, "\n");
 //	fprintf(cm_fp, "\n");
 #endif
 	
-	float kw_cm_score = calc_confidence_score_ring_buffer(keyword_prob_ring, proc_count + 1, keyword_num);
+	float kw_cm_score = calc_confidence_score_ring_buffer(proc_count + 1);
 #ifdef FILE_LOG
 //	if (kw_cm_score >= 0.7)
 //		fprintf(cm_fp, "kw_cm_score = %f\n", (float)kw_cm_score);
@@ -210,7 +227,7 @@ int CDetectorWord::detect(const float prob[])
 	{
 		trigger_word_count++;
 		if (trigger_word_count > _CM_THRESHOLD2                                                                   // cm_socre  (confidence measure score) prob_thr  ū frame  _CM_THRESHOLD2(10)  ̻̾ 
-			&& keyword_prob_ring[keyword_num-2][idx_key_prob] < keyword_prob_ring[keyword_num-1][idx_key_prob]    //  2 class  ؼ   class posterior smoothing   ι° posterior smoothing   Ŀ 
+			&& kw_smooth_row[keyword_num-2] < kw_smooth_row[keyword_num-1]    //  2 class  ؼ   class posterior smoothing   ι° posterior smoothing   Ŀ 
 			)
 		{
 			detected = 1;
@@ -236,17 +253,119 @@ int CDetectorWord::detect(const float prob[])
 
 	if (clog_id)
 		clog_debug(CLOG(clog_id), "%d\t%d\t%f\t%f\t%f", proc_count, trigger_word_count, kw_cm_score,
-			keyword_prob_ring[0][idx_key_prob], keyword_prob_ring[1][idx_key_prob]);
+			kw_smooth_row[0], kw_smooth_row[1]);
 
     frigger_frame_len = proc_count - sp_detected_frame;
 
 	if (!detected)
 		return 0;
 
+	find_keyword_span();
 	this->clear();
 	return 1;
 }
 
+// refill kw_smooth for the frames skipped by the posterior gate (only the ring length is used)
+void CDetectorWord::rebuild_gated_frames()
+{
+	const int first = std::max(gate_skip_from, proc_count - kw_smooth->getFrames() + 1);
+
+	for (int f = first; f < proc_count; f++)
+		posterior_smoothing_ring_buffer(f + 1, kw_smooth->row(f));
+
+	gate_skip_from = -1;
+}
+
+// keyword span from the smoothed ring : per class, the frames around its peak staying over half of it,
+// the word covers all classes. moving average delays the posteriors by (wsmooth-1)/2 frames
+void CDetectorWord::find_keyword_span()
+{
+	const int first = std::max(0, proc_count - kw_smooth->getFrames() + 1);
+	const int delay = (wsmooth - 1) / 2;
+
+	int begin = proc_count;
+	int end = first;
+	for (int k = 0; k < keyword_num; k++)
+	{
+		int peak = first;
+		for (int f = first + 1; f <= proc_count; f++)
+			if (kw_smooth->row(peak)[k] < kw_smooth->row(f)[k])
+				peak = f;
+
+		const float half_peak = 0.5f * kw_smooth->row(peak)[k];
+		int onset = peak;
+		while (first < onset && half_peak <= kw_smooth->row(onset - 1)[k])
+			onset--;
+		int offset = peak;
+		while (offset < proc_count && half_peak <= kw_smooth->row(offset + 1)[k])
+			offset++;
+
+		begin = std::min(begin, onset);
+		end = std::max(end, offset);
+	}
+
+	span_begin = proc_count - (begin - delay);
+	span_end = proc_count - (end - delay);
+}
+
+// current parameters (pending ones if not applied yet)
+void CDetectorWord::getParam(TriggerParam* param)
+{
+	std::lock_guard<std::mutex> lock(param_lock);
+
+	if (param_dirty)
+	{
+		*param = param_pending;
+		return;
+	}
+	param->prob_threshold = prob_thr;
+	param->w_max = wmax;
+	param->cm_threshold2 = _CM_THRESHOLD2;
+}
+
+// thread-safe, the new parameters take effect from the next detect()
+// w_max is bounded by the kw_smooth ring allocated at startup
+bool CDetectorWord::setParam(const TriggerParam* param)
+{
+	if (NULL == param
+		|| param->prob_threshold <= gate_floor
+		|| param->w_max <= 0 || kw_smooth->getFrames() < param->w_max
+		|| param->cm_threshold2 <= 0)
+		return false;
+
+	std::lock_guard<std::mutex> lock(param_lock);
+	param_pending = *param;
+	param_dirty = true;
+
+	return true;
+}
+
+// re-read the runtime parameters from a (re)loaded config, missing keys keep the current value
+bool CDetectorWord::reloadParam(const CConfig& config)
+{
+	TriggerParam param;
+	getParam(&param);
+
+	const char* section = ini_section.c_str();
+	param.prob_threshold = config.getf(section, "prob_threshold", param.prob_threshold);
+	param.w_max = (int)config.getl(section, "w_max", param.w_max);
+	param.cm_threshold2 = (int)config.getl(section, "_CM_THRESHOLD2", param.cm_threshold2);
+
+	return setParam(&param);
+}
+
+// called by the detecting thread between frames
+void CDetectorWord::apply_param()
+{
+	std::lock_guard<std::mutex> lock(param_lock);
+
+	prob_thr = param_pending.prob_threshold;
+	wmax = param_pending.w_max;
+	_CM_THRESHOLD2 = param_pending.cm_threshold2;
+	gate_settle = wsmooth + wmax;
+	param_dirty = false;
+}
+
 int CDetectorWord::getTriggerFrameLen(){
     return (frigger_frame_len);
 }
\ No newline at end of file
@@ -1,15 +1,15 @@
 #ifndef __TRIGGER_DETECTOR_WORD_H__
 #define __TRIGGER_DETECTOR_WORD_H__
 
-#define wsmooth_length 20
+#include <atomic>
+#include <mutex>
+#include <string>
 
-class CDnnDecoder;
+#include "Selvy_Trigger_API.h"
 
-typedef struct _all_probs {
-	float sil_outprob[wsmooth_length];
-	float filler_prob[wsmooth_length];
-	float** kw_prob;
-} all_probs;
+class CConfig;
+class CDnnDecoder;
+class CProbRing;
 
 
 class CDetectorWord
@@ -17,7 +17,9 @@ class CDetectorWord
 private:
 	int keyword_num;
 
-	float **keyword_prob_ring;
+	CProbRing* kw_hist;		// keyword posteriors, [frame][class]
+	CProbRing* kw_smooth;	// smoothed keyword posteriors, [frame][class], max(wmax, wspan) frames
+	float* kw_buf;			// scratch row (kw_smooth->getStride() floats)
 	int proc_count;
 	int trigger_word_count;
 	// start point detection ( 2018.08.29 )
@@ -25,28 +27,55 @@ private:
 	int sp_detected_frame;
     int frigger_frame_len;
 
+	// keyword span of the last detection, frames before the detection frame
+	int span_begin;
+	int span_end;
+	void find_keyword_span();
+
+	int wsmooth;
 	int wmax;
+	int wspan;	// look-back to find the keyword span
 	int _CM_THRESHOLD2;
 
-	all_probs past_prob;
+	int hist_len;	// length of kw_hist ring (wsmooth, or wsmooth + kw_smooth frames when gated)
 
 	float prob_thr;
 
+	// posterior gating: skip smoothing/confidence while keyword posteriors stay under gate_floor
+	float gate_floor;	// 0: gating off
+	int gate_idle;		// consecutive frames under gate_floor
+	int gate_settle;	// idle frames until smoothed state is under prob_thr for sure
+	int gate_skip_from;	// first frame skipped by the gate, -1 if none
+	void rebuild_gated_frames();
+
+	// runtime parameters: set from any thread, swapped in at the start of the next frame
+	std::string ini_section;
+	TriggerParam param_pending;
+	std::mutex param_lock;
+	std::atomic<bool> param_dirty;
+	void apply_param();
+
 	int err;
 	int clog_id;
 	void clear();
 
 public:
-	CDetectorWord(const int keyword_num, const char root_path[], const char config_path[]);
+	CDetectorWord(const int keyword_num, const CConfig& config, const char section[] = "trigger");
 	~CDetectorWord();
 	int getError();
 	int detect(const float prob[]);
 	void setClog(int log_id);
 	bool reset();
 
-	float posterior_smoothing_ring_buffer(const float dnn_out_prob[], const int frame_idx);
-	float calc_confidence_score_ring_buffer(float **post_dnn_outprob, int const frame_idx, const int class_num);
+	void posterior_smoothing_ring_buffer(const int frame_idx, float post_dnn_outprob[]);
+	float calc_confidence_score_ring_buffer(const int frame_idx);
 	int getTriggerFrameLen();
+	int getSpanBegin() { return span_begin; }
+	int getSpanEnd() { return span_end; }
+
+	void getParam(TriggerParam* param);
+	bool setParam(const TriggerParam* param);
+	bool reloadParam(const CConfig& config);
 };
 
 #endif	// __TRIGGER_DETECTOR_WORD_H__
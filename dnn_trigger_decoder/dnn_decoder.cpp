@@ -6,17 +6,24 @@
 
 #include <memory.h>
 #include <stdio.h>
+#include <stdint.h>
 #include <algorithm>
 
 #include "PowerAI_BaseCommon.h"
 #include "bp_train.h"
 
 
-CDnnDecoder::CDnnDecoder(const char root_path[], const char config_path[])
+CDnnDecoder::CDnnDecoder(const char root_path[], const char config_path[], const int streams)
 {
 	feat_pool = NULL;
 	pDeepnet = NULL;
-	p_dnn_output = NULL;
+	shared_net = false;
+	pFixed = NULL;
+	feat_pool_q = NULL;
+	out_q = NULL;
+	layer_time = NULL;
+	this->streams = std::max(1, streams);
+	p_dnn_output = new DNN_LAYER_UNIT*[this->streams]();
 
 	DNN_Resource dnnResource;       // dnnResource = DNN config   (DNN_LoadCibfug Լ , DNN config setting )
 	auto ret_dnnlc = DNN_LoadConfig(&dnnResource, root_path, config_path);   // .ini   ʱȭ, ʱȭ   , 'SUCCESS' retrun, 
@@ -42,16 +49,181 @@ CDnnDecoder::CDnnDecoder(const char root_path[], const char config_path[])
 		return;
 	}
 
-	p_dnn_output = DNN_create_layer_unit(pDeepnet);	//DNN νİ  
-	if (!p_dnn_output)	{ err = 3; return; }
-	err = 0;
+	err = createOutput();
+}
+
+// decoder state of its own on the loaded network of model : the Deepnet struct is copied,
+// the weight arrays are shared read-only (a copied Deepnet keeps its own stageTime)
+CDnnDecoder::CDnnDecoder(const CDnnDecoder* model, const int streams)
+{
+	feat_pool = NULL;
+	pDeepnet = NULL;
+	shared_net = true;
+	pFixed = NULL;
+	feat_pool_q = NULL;
+	out_q = NULL;
+	layer_time = NULL;
+	this->streams = std::max(1, streams);
+	p_dnn_output = new DNN_LAYER_UNIT*[this->streams]();
+
+	if (NULL == model || NULL == model->pDeepnet || model->err) { err = 2; return; }
+
+	concat_before = model->concat_before;
+	concat_after = model->concat_after;
+	feat_dim = model->feat_dim;
+	reset();
+
+	pDeepnet = new Deepnet(*model->pDeepnet);
+	pDeepnet->stageTime = NULL;
+
+	err = createOutput();
+}
+
+
+// header of the network image (saveImage), followed by the stage 0 visible bias and
+// the weights / hidden bias of every stage, each IMAGE_ALIGN aligned from the image start
+struct DnnImage
+{
+	int32_t image_size;		// sizeof(DnnImage), another build's image is rejected
+	int32_t concat_before;
+	int32_t concat_after;
+	int32_t feat_dim;
+	int32_t stages;
+	int32_t nodes[MAX_NUM_LAYER];
+	int32_t nonlinear[MAX_NUM_LAYER];
+};
+
+static long image_align(const long n)
+{
+	return (n + CDnnDecoder::IMAGE_ALIGN - 1) / CDnnDecoder::IMAGE_ALIGN * CDnnDecoder::IMAGE_ALIGN;
+}
+
+// decoder on a network image of saveImage(), the weights are used in place (read-only),
+// image must be IMAGE_ALIGN aligned and outlive the decoder
+CDnnDecoder::CDnnDecoder(const void* image, const long size, const int streams)
+{
+	feat_pool = NULL;
+	pDeepnet = NULL;
+	shared_net = true;
+	pFixed = NULL;
+	feat_pool_q = NULL;
+	out_q = NULL;
+	layer_time = NULL;
+	this->streams = std::max(1, streams);
+	p_dnn_output = new DNN_LAYER_UNIT*[this->streams]();
+
+	const DnnImage* header = (const DnnImage*)image;
+	if (NULL == image || 0 != (uintptr_t)image % IMAGE_ALIGN || size < (long)sizeof(DnnImage)
+		|| (long)sizeof(DnnImage) != header->image_size || header->stages <= 0 || MAX_NUM_STAGE < header->stages)
+	{
+		err = 2;
+		return;
+	}
+
+	concat_before = header->concat_before;
+	concat_after = header->concat_after;
+	feat_dim = header->feat_dim;
+	reset();
+
+	pDeepnet = new Deepnet();
+	pDeepnet->nStage = (short)header->stages;
+
+	const char* base = (const char*)image;
+	long offset = image_align(sizeof(DnnImage));
+	for (int i = 0; i < header->stages; i++)
+	{
+		DNN_Stage& stage = pDeepnet->dnnStage[i];
+		stage.nVisNodes = (short)header->nodes[i];
+		stage.nHidNodes = (short)header->nodes[i + 1];
+		pDeepnet->nonLinearFunc[i] = (DNN_NonLinearUnit)header->nonlinear[i];
+
+		if (0 == i)
+		{
+			stage.dnnVisBias = (float*)(base + offset);
+			offset = image_align(offset + sizeof(float) * stage.nVisNodes);
+		}
+		else
+			stage.dnnVisBias = pDeepnet->dnnStage[i - 1].dnnHidBias;
+		stage.dnnWeight = (float*)(base + offset);
+		offset = image_align(offset + sizeof(float) * stage.nVisNodes * stage.nHidNodes);
+		stage.dnnHidBias = (float*)(base + offset);
+		offset = image_align(offset + sizeof(float) * stage.nHidNodes);
+	}
+	if (size < offset) { err = 2; return; }
+
+	err = createOutput();
+}
+
+// network image of this decoder (float weights) for CDnnDecoder(image, size)
+// return the image size, buf NULL : size only, -1 : no network or size too small
+long CDnnDecoder::saveImage(void* buf, const long size)
+{
+	if (NULL == pDeepnet || err)
+		return -1;
+
+	DnnImage header;
+	memset(&header, 0, sizeof(header));
+	header.image_size = (int32_t)sizeof(DnnImage);
+	header.concat_before = concat_before;
+	header.concat_after = concat_after;
+	header.feat_dim = feat_dim;
+	header.stages = pDeepnet->nStage;
+	header.nodes[0] = pDeepnet->dnnStage[0].nVisNodes;
+	for (int i = 0; i < pDeepnet->nStage; i++)
+	{
+		header.nodes[i + 1] = pDeepnet->dnnStage[i].nHidNodes;
+		header.nonlinear[i] = pDeepnet->nonLinearFunc[i];
+	}
+
+	char* base = (char*)buf;
+	long offset = image_align(sizeof(DnnImage));
+	for (int i = 0; i < pDeepnet->nStage; i++)
+	{
+		const DNN_Stage& stage = pDeepnet->dnnStage[i];
+		const long array_size[3] = { (0 == i) ? (long)sizeof(float) * stage.nVisNodes : 0,
+			(long)sizeof(float) * stage.nVisNodes * stage.nHidNodes, (long)sizeof(float) * stage.nHidNodes };
+		const float* array[3] = { stage.dnnVisBias, stage.dnnWeight, stage.dnnHidBias };
+		for (int a = 0; a < 3; a++)
+		{
+			if (0 == array_size[a])	continue;
+			if (buf && size < offset + array_size[a])	return -1;
+			if (buf)	memcpy(base + offset, array[a], array_size[a]);
+			offset = image_align(offset + array_size[a]);
+		}
+	}
+
+	if (buf)
+	{
+		if (size < (long)sizeof(DnnImage))	return -1;
+		memcpy(buf, &header, sizeof(header));
+	}
+	return offset;
+}
+
+// layer buffers of every stream, return 0 or 3
+int CDnnDecoder::createOutput()
+{
+	p_dnn_output[0] = DNN_create_layer_unit(pDeepnet);	//DNN νİ  
+	if (!p_dnn_output[0])	return 3;
+	for (int s = 1; s < streams; s++)
+	{
+		p_dnn_output[s] = DNN_create_layer_unit(pDeepnet);
+		if (!p_dnn_output[s])	return 3;
+	}
+	return 0;
 }
 
 CDnnDecoder::~CDnnDecoder()
 {
-	DNN_destroy_layer_unit(p_dnn_output);
-	DNN_destroy(pDeepnet);
-	delete feat_pool;
+	for (int s = 0; s < streams; s++)
+		if (p_dnn_output[s])	DNN_destroy_layer_unit(p_dnn_output[s]);
+	delete[] p_dnn_output;
+	if (shared_net)	delete pDeepnet;
+	else if (pDeepnet)	DNN_destroy(pDeepnet);
+	if (pFixed)	DNN_fixed_destroy(pFixed);
+	delete[] feat_pool;
+	delete[] feat_pool_q;
+	delete[] out_q;
 }
 
 
@@ -60,31 +232,206 @@ int CDnnDecoder::reset()
 {
 	frame_input = -1;
 	delete[] feat_pool;
-	feat_pool = new float[feat_dim * (concat_before+1+concat_after)]();
+	feat_pool = new float[streams * feat_dim * (concat_before+1+concat_after)]();
+	delete[] feat_pool_q;
+	feat_pool_q = pFixed ? new short[streams * feat_dim * (concat_before+1+concat_after)]() : NULL;
 
 	return 0;
 }
 
+// switch between the float network and its integer copy (int8 weights, int16 activations)
+// the integer network takes the features in Q(FEAT_Q) and outputs Q16 posteriors,
+// decode()/decodeBatch() keep their float interface
+int CDnnDecoder::setFixedPoint(const bool on)
+{
+	if (NULL == pDeepnet || err)
+		return -1;
+
+	if (on && NULL == pFixed)
+	{
+		pFixed = DNN_fixed_create(pDeepnet);
+		if (NULL == pFixed)
+			return -1;
+		pFixed->stageTime = layer_time;
+		out_q = new int[getNumOutNode()];
+	}
+	else if (!on && pFixed)
+	{
+		DNN_fixed_destroy(pFixed);
+		pFixed = NULL;
+		delete[] out_q;
+		out_q = NULL;
+	}
+
+	return reset();
+}
+
 // get 1 frame feature input, concatenate frames, decode DNN
 // return frame # (if frame# < 0, probability output will be unreliable)
-int CDnnDecoder::decode(float* in, float* out)
+int CDnnDecoder::decode(const float* in, float* out)
 {
-	frame_input++;
+	push(in);
+	return forward(out);
+}
 
-	int shift_len = (concat_before+concat_after) * feat_dim;     // window_size * feature_dimension 
-	memmove(&feat_pool[0], &feat_pool[feat_dim], shift_len*sizeof(feat_pool[0]));     // memmove(Ǵ  ּ,   ּ,  ũ)
-	std::copy_n(in, feat_dim, &feat_pool[shift_len]);   // copy_n(_First, cnt, _Dest) >> _First ġ cnt ŭ _Dest  , Ű  in  
+int CDnnDecoder::decode(const int32_t* in, float* out)
+{
+	push(in);
+	return forward(out);
+}
+
+// decode the concatenation window of stream 0
+// return frame # as decode()
+int CDnnDecoder::forward(float* out)
+{
+	if (pFixed)
+	{
+		forwardFixed(0, out);
+		return frame_input - concat_after;
+	}
 
-	p_dnn_output->unit[0] = feat_pool;
+	p_dnn_output[0]->unit[0] = feat_pool;
 
-	auto ret_dfp = do_forward_prop(pDeepnet, p_dnn_output);
+	auto ret_dfp = do_forward_prop(pDeepnet, p_dnn_output[0]);
 
-	auto output_layer = p_dnn_output->unit[p_dnn_output->n_layer - 1];
+	auto output_layer = p_dnn_output[0]->unit[p_dnn_output[0]->n_layer - 1];
 	std::copy_n(output_layer, pDeepnet->dnnStage[pDeepnet->nStage-1].nHidNodes, out);
 
 	return frame_input - concat_after;
 }
 
+// shift 1 frame feature into the concatenation window without decoding (frame skipped by the caller)
+// return frame # as decode()
+int CDnnDecoder::push(const float* in)
+{
+	frame_input++;
+	shift(0, in);
+
+	return frame_input - concat_after;
+}
+
+int CDnnDecoder::push(const int32_t* in)
+{
+	frame_input++;
+	shift(0, in);
+
+	return frame_input - concat_after;
+}
+
+// get 1 frame feature input of every stream, decode all streams as one batch
+// return frame # as decode()
+int CDnnDecoder::decodeBatch(const float* const in[], float* const out[])
+{
+	frame_input++;
+	for (int s = 0; s < streams; s++)
+		shift(s, in[s]);
+
+	return forwardBatch(out);
+}
+
+int CDnnDecoder::decodeBatch(const int32_t* const in[], float* const out[])
+{
+	frame_input++;
+	for (int s = 0; s < streams; s++)
+		shift(s, in[s]);
+
+	return forwardBatch(out);
+}
+
+// decode the concatenation windows of every stream as one batch
+// return frame # as decode()
+int CDnnDecoder::forwardBatch(float* const out[])
+{
+	if (pFixed)
+	{
+		for (int s = 0; s < streams; s++)
+			forwardFixed(s, out[s]);
+		return frame_input - concat_after;
+	}
+
+	const int window = feat_dim * (concat_before+1+concat_after);
+	for (int s = 0; s < streams; s++)
+		p_dnn_output[s]->unit[0] = &feat_pool[s * window];
+
+	auto ret_dfp = do_forward_prop_batch(pDeepnet, p_dnn_output, streams);
+
+	const int n_out = pDeepnet->dnnStage[pDeepnet->nStage-1].nHidNodes;
+	for (int s = 0; s < streams; s++)
+		std::copy_n(p_dnn_output[s]->unit[p_dnn_output[s]->n_layer - 1], n_out, out[s]);
+
+	return frame_input - concat_after;
+}
+
+// shift 1 frame feature into the concatenation window of a stream
+void CDnnDecoder::shift(const int stream, const float* in)
+{
+	if (pFixed)
+	{
+		short* pool = &feat_pool_q[stream * feat_dim * (concat_before+1+concat_after)];
+
+		int shift_len = (concat_before+concat_after) * feat_dim;
+		memmove(&pool[0], &pool[feat_dim], shift_len*sizeof(pool[0]));
+		for (int i = 0; i < feat_dim; i++)
+		{
+			const float q = in[i] * (1 << FEAT_Q);
+			pool[shift_len + i] = (short)((q >= 32767.f) ? 32767 : ((q <= -32768.f) ? -32768 : (int)(q + (q < 0.f ? -0.5f : 0.5f))));
+		}
+		return;
+	}
+
+	float* pool = &feat_pool[stream * feat_dim * (concat_before+1+concat_after)];
+
+	int shift_len = (concat_before+concat_after) * feat_dim;     // window_size * feature_dimension 
+	memmove(&pool[0], &pool[feat_dim], shift_len*sizeof(pool[0]));     // memmove(Ǵ  ּ,   ּ,  ũ)
+	std::copy_n(in, feat_dim, &pool[shift_len]);   // copy_n(_First, cnt, _Dest) >> _First ġ cnt ŭ _Dest  , Ű  in  
+}
+
+// shift 1 frame of Q15 features into the concatenation window of a stream, Q15 -> Q(FEAT_Q) with
+// integer rounding for the integer network
+void CDnnDecoder::shift(const int stream, const int32_t* in)
+{
+	const int shift_len = (concat_before+concat_after) * feat_dim;
+
+	if (pFixed)
+	{
+		short* pool = &feat_pool_q[stream * feat_dim * (concat_before+1+concat_after)];
+
+		memmove(&pool[0], &pool[feat_dim], shift_len*sizeof(pool[0]));
+		for (int i = 0; i < feat_dim; i++)
+		{
+			const int32_t q = (in[i] + (1 << (14 - FEAT_Q))) >> (15 - FEAT_Q);
+			pool[shift_len + i] = (short)((q > 32767) ? 32767 : ((q < -32768) ? -32768 : q));
+		}
+		return;
+	}
+
+	float* pool = &feat_pool[stream * feat_dim * (concat_before+1+concat_after)];
+
+	memmove(&pool[0], &pool[feat_dim], shift_len*sizeof(pool[0]));
+	for (int i = 0; i < feat_dim; i++)
+		pool[shift_len + i] = in[i] * (1.f / 32768.f);
+}
+
+// integer network on the window of a stream, Q16 -> float posteriors
+void CDnnDecoder::forwardFixed(const int stream, float* out)
+{
+	const short* pool = &feat_pool_q[stream * feat_dim * (concat_before+1+concat_after)];
+
+	do_forward_prop_fixed(pFixed, pool, FEAT_Q, out_q);
+
+	const int n_out = getNumOutNode();
+	for (int k = 0; k < n_out; k++)
+		out[k] = out_q[k] * (1.f / 65536.f);
+}
+
+// time every layer of the forward passes (float or integer network), ns[l] += ns of layer l
+void CDnnDecoder::setLayerTime(unsigned long long ns[])
+{
+	layer_time = ns;
+	if (pDeepnet)	pDeepnet->stageTime = ns;
+	if (pFixed)	pFixed->stageTime = ns;
+}
+
 // get number of output nodes
 int CDnnDecoder::getNumOutNode()
 {
@@ -92,3 +439,11 @@ int CDnnDecoder::getNumOutNode()
 		return 0;
 	return pDeepnet->dnnStage[pDeepnet->nStage-1].nHidNodes;
 }
+
+// get number of layers (weight matrices)
+int CDnnDecoder::getNumLayer()
+{
+	if (NULL == pDeepnet)
+		return 0;
+	return pDeepnet->nStage;
+}
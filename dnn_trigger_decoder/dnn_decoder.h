@@ -5,6 +5,7 @@
 #ifndef __DNN_DECODER_HPP__
 #define __DNN_DECODER_HPP__
 
+#include <stdint.h>
 
 #ifdef DNN_EXPORT
 #define POWER_DEEPNET_API __declspec(dllexport)
@@ -13,18 +14,38 @@
 #endif 
 
 
+// integer network by default in the fixed-point build ([trigger] dnn_fixed)
+#ifdef FIXED_POINT_FE
+#define DNN_FIXED_DEFAULT 1
+#else
+#define DNN_FIXED_DEFAULT 0
+#endif
+
+
 typedef struct DNN_Resource DNN_Resource;
 typedef struct Deepnet Deepnet;
 typedef struct DNN_LAYER_UNIT DNN_LAYER_UNIT;
+typedef struct DeepnetFixed DeepnetFixed;
 
 
 class POWER_DEEPNET_API CDnnDecoder
 {
+public:
+	enum { IMAGE_ALIGN = 64 };	// arrays of a network image (saveImage)
+
 private:
+	enum { FEAT_Q = 7 };	// features in the fixed-point window, |feature| < 256
+
 	Deepnet* pDeepnet;
-	DNN_LAYER_UNIT* p_dnn_output;
+	bool shared_net;	// pDeepnet points at the weights of another decoder
+	DNN_LAYER_UNIT** p_dnn_output;	// one per stream
 
-	float* feat_pool;
+	float* feat_pool;	// concatenation window of each stream
+	DeepnetFixed* pFixed;	// integer network, NULL : float network
+	short* feat_pool_q;		// feat_pool in Q(FEAT_Q), fixed-point mode only
+	int* out_q;				// Q16 posteriors, fixed-point mode only
+	unsigned long long* layer_time;	// ns per layer added by every forward pass, NULL : not timed
+	int streams;		// input streams decoded as one batch (microphone array channels)
 
 	int concat_before;	// concatnate before n frames (past frames)
 	int concat_after;	// concatnate after n frames (future frames)
@@ -34,13 +55,33 @@ private:
 
 	int err;	
 
+	void shift(const int stream, const float* in);
+	void shift(const int stream, const int32_t* in);
+	int forward(float* out);
+	int forwardBatch(float* const out[]);
+	void forwardFixed(const int stream, float* out);
+	int createOutput();
+
 public:
-	CDnnDecoder(const char root_path[], const char config_path[]);
+	CDnnDecoder(const char root_path[], const char config_path[], const int streams = 1);
+	CDnnDecoder(const CDnnDecoder* model, const int streams = 1);	// shares the weights of model, which must outlive it
+	CDnnDecoder(const void* image, const long size, const int streams = 1);	// weights of a saveImage() image in place, which must outlive it
 	~CDnnDecoder();
-	int decode(float* in, float* out);
+	int decode(const float* in, float* out);
+	int push(const float* in);
+	int decodeBatch(const float* const in[], float* const out[]);
+	// Q15 features of the fixed-point front end, shifted into the integer network without float
+	int decode(const int32_t* in, float* out);
+	int push(const int32_t* in);
+	int decodeBatch(const int32_t* const in[], float* const out[]);
 	int reset();
+	int setFixedPoint(const bool on);	// int8/int16 network quantized from the loaded one, resets the decoder
+	bool isFixedPoint() { return NULL != pFixed; }
+	void setLayerTime(unsigned long long ns[]);	// getNumLayer() counters of the forward passes, NULL stops
+	long saveImage(void* buf, const long size);	// float network as one IMAGE_ALIGN aligned image, buf NULL : size only
 
 	int getNumOutNode();
+	int getNumLayer();
 	int getError() { return err; }
 	
 };
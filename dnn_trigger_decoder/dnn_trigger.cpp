@@ -5,20 +5,35 @@
 #define TRG_DLLEXPORT
 #include "dnn_trigger.h"
 
+#include <math.h>
 #include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 #include "clog.h"
 #define TRG_CLOG 1
 
-#define MININI_ANSI
-#define INI_READONLY 
-#include "minIni.h"
+#include "base/hci_clock.h"
+#include "trace.h"
+#include "alloc_stats.h"
+#ifndef TRG_NO_STATS
+#define TRG_STAT(x)	(x)
+#else
+#define TRG_STAT(x)	do { if (0) { (x); } } while (0)
+#endif
 
 #include "SizedQueue.h"
 
+#include "config.h"
 #include "feat_2pass.h"
 #include "dnn_decoder.h"
 #include "detector_word.h"
+#include "snapshot.h"
 
 
 #ifndef _MAX_PATH
@@ -26,50 +41,205 @@
 #endif
 
 
-CDnnTrigger::CDnnTrigger(const char root_path[], const char config_path[])    // CDnnTrigger , config file  ʱȭ
+// config hot-reload thread of a trigger, see CDnnTrigger::watch_config()
+struct ConfigWatcher
+{
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable wake;
+	bool stop;
+};
+
+
+// row of a feature frame counter (frame >= -frames) in a ring of frames x 51 features
+static inline feat_t* feat_row(feat_t* ring, const int frames, const int frame)
+{
+	return ring + ((frame + frames) % frames) * 51;
+}
+
+
+CDnnTrigger::CDnnTrigger(const char root_path[], const char config_path[], const int sample_rate, const int format)    // CDnnTrigger , config file  ʱȭ
+{
+	snapshot = NULL;
+	init(root_path, config_path, sample_rate, format, NULL);
+}
+
+
+CDnnTrigger::CDnnTrigger(const CDnnTrigger* model, const int sample_rate, const int format)
+{
+	snapshot = NULL;
+	init(model->root_dir.c_str(), model->config_file.c_str(), sample_rate, format, model);
+}
+
+
+// no file is read : the config text of the snapshot is registered as "snapshot:<path>" (not hot-reloaded),
+// the front end and the DNNs are set up from their images
+CDnnTrigger::CDnnTrigger(CSnapshot* snapshot, const int sample_rate, const int format)
+{
+	this->snapshot = snapshot;
+
+	long size = 0;
+	const char* text = snapshot ? (const char*)snapshot->find(CSnapshot::CONFIG, &size) : NULL;
+	const std::string name = std::string("snapshot:") + (snapshot ? snapshot->getPath() : "");
+	CConfig::setText(name.c_str(), (text && 0 < size && '\0' == text[size - 1]) ? text : "");
+
+	init(".", name.c_str(), sample_rate, format, NULL);
+}
+
+
+// model : session sharing the DNNs of model (logger, weights), NULL loads them
+void CDnnTrigger::init(const char root_path[], const char config_path[], const int sample_rate, const int format, const CDnnTrigger* model)
 {
 	char tmp_path[_MAX_PATH] = { 0 };
 	int tmp_wmax = 0;
 	output_frame = -1;
-
-	char ini_config[_MAX_PATH];
-	snprintf(ini_config, sizeof(ini_config), "%s/%s", root_path, config_path);
+	verifier_decoder = NULL;
+	verifier = NULL;
+	verifier_prob_output = NULL;
+	feat_hist = NULL;
+	feat_pos = feat_filled = 0;
+	verify_step = 1;
+	verify_row = verify_left = verify_frame = verify_sp_frame = 0;
+	span_valid = false;
+	root_dir = root_path;
+	config_file = config_path;
+	config_full_path = root_dir + "/" + config_file;
+	watcher = NULL;
+	gate_feat = NULL;
+	sil_prob = NULL;
+	vad_idle = 0;
+	gate_begin = gate_end = 0;
+	layer_ns = NULL;
+	memset(&stats, 0, sizeof(stats));
+	log_owner = false;
+	trace_owner = false;
+	trace_fe_ns[0] = trace_fe_ns[1] = trace_fe_ns[2] = 0;
+
+	const std::shared_ptr<const CConfig> config = CConfig::open(root_path, config_path);
 
 	// log settings
-	ini_gets("log", "output", "", tmp_path, _MAX_PATH, ini_config);
-	if ('\0' != tmp_path[0])
+	config->gets("log", "output", "", tmp_path, _MAX_PATH);
+	if ('\0' != tmp_path[0] && !model)
 	{
+		log_owner = true;
 		clog_init_path(TRG_CLOG, tmp_path);
-		clog_set_level(TRG_CLOG, (clog_level)ini_getl("log", "level", CLOG_ERROR, ini_config));
+		clog_set_level(TRG_CLOG, (clog_level)config->getl("log", "level", CLOG_ERROR));
+		if (config->getl("log", "async", 0))
+			clog_set_async(TRG_CLOG, config->getl("log", "async_records", 4096));
+	}
+
+	// event trace, sessions record into it on their own threads
+	config->gets("log", "trace", "", tmp_path, _MAX_PATH);
+	if ('\0' != tmp_path[0] && !model)
+	{
+		trace_path = tmp_path;
+		trace_owner = CTrace::start(config->getl("log", "trace_events", 200000));
 	}
+
+	// input sample rate / format
+	if (initInput(sample_rate, format)) { err = 6001; return; }
 	
 	// init feature extractor
+	if (snapshot)
+	{
+		long size_16k = 0, size_8k = 0;
+		const void* image_16k = snapshot->find(CSnapshot::FE_16K, &size_16k);
+		const void* image_8k = snapshot->find(CSnapshot::FE_8K, &size_8k);
+		const int ret_fe = CFeat2pass::connectImage(image_16k, size_16k, image_8k, size_8k);
+		if (ret_fe) { err = 1000 + ret_fe; return; }
+	}
 	feat_extractor = new CFeat2pass(root_path);
 	if (feat_extractor->getError()) { err = 1000 + feat_extractor->getError(); return; }
 
 	// init DNN decoder
-	ini_gets("trigger", "dnn_ini", "", tmp_path, _MAX_PATH, ini_config);
-	dnn_decoder = new CDnnDecoder(root_path, tmp_path);
+	config->gets("trigger", "dnn_ini", "", tmp_path, _MAX_PATH);
+	long image_size = 0;
+	const void* image = snapshot ? snapshot->find(CSnapshot::DNN, &image_size) : NULL;
+	dnn_decoder = model ? new CDnnDecoder(model->dnn_decoder) : snapshot ? new CDnnDecoder(image, image_size) : new CDnnDecoder(root_path, tmp_path);
 	if (dnn_decoder->getError()) { err = 2000 + dnn_decoder->getError(); return; }
+	const int dnn_fixed = config->getl("trigger", "dnn_fixed", DNN_FIXED_DEFAULT);
+	if (dnn_fixed && dnn_decoder->setFixedPoint(true)) { err = 2004; return; }
 
 	// init word detector
 	auto keyword_num = dnn_decoder->getNumOutNode() - 2;
-	detector = new CDetectorWord(keyword_num, root_path, config_path);
+	detector = new CDetectorWord(keyword_num, *config);
 	if (detector->getError()) { err = 3000 + detector->getError(); return; }
 	if (_clog_loggers[TRG_CLOG])
 		detector->setClog(TRG_CLOG);
 
+	// init verifier (cascade mode), off when [verifier] dnn_ini is empty
+	config->gets("verifier", "dnn_ini", "", tmp_path, _MAX_PATH);
+	if ('\0' != tmp_path[0])
+	{
+		image = snapshot ? snapshot->find(CSnapshot::VERIFIER_DNN, &image_size) : NULL;
+		verifier_decoder = (model && model->verifier_decoder) ? new CDnnDecoder(model->verifier_decoder)
+			: snapshot ? new CDnnDecoder(image, image_size) : new CDnnDecoder(root_path, tmp_path);
+		if (verifier_decoder->getError()) { err = 4000 + verifier_decoder->getError(); return; }
+		if (config->getl("verifier", "dnn_fixed", dnn_fixed) && verifier_decoder->setFixedPoint(true)) { err = 4005; return; }
+
+		verifier = new CDetectorWord(verifier_decoder->getNumOutNode() - 2, *config, "verifier");
+		if (verifier->getError()) { err = 4000 + verifier->getError(); return; }
+
+		verify_frames = config->getl("verifier", "frames", 200);
+		if (verify_frames <= 0) { err = 4004; return; }
+		verify_step = config->getl("verifier", "step", 20);
+		if (verify_step <= 0) { err = 4006; return; }
+
+		feat_hist = new feat_t[verify_frames * 51];
+		verifier_prob_output = new float[verifier_decoder->getNumOutNode()];
+	}
+
+
+	// config hot-reload (check interval in 10ms frames, 0 = off)
+	reload_frames = config->getl("trigger", "reload_check", 0);
+	if (reload_frames < 0) { err = 3004; return; }
+	if (reload_frames)
+		watched_config = config;
+
+	// speech gating (non-speech frames before the DNN is skipped, 0 = off)
+	vad_gate = config->getl("trigger", "vad_gate", 0);
+	vad_catchup = config->getl("trigger", "vad_catchup", 30);
+	if (vad_gate < 0 || vad_catchup < 0) { err = 3005; return; }
+	if (vad_gate)
+		gate_feat = new feat_t[(vad_catchup + 1) * 51];
 
 	// memory alloc
 	pcm_stream = new SizedQueue(16000);
 	dnn_prob_output = new float[dnn_decoder->getNumOutNode()];
 
+	// output classes : silence, filler, keywords
+	sil_prob = new float[dnn_decoder->getNumOutNode()]();
+	sil_prob[0] = 1.f;
+
+#ifndef TRG_NO_STATS
+	layer_ns = new unsigned long long[dnn_decoder->getNumLayer()]();
+	dnn_decoder->setLayerTime(layer_ns);
+#endif
+
+	if (reload_frames)
+	{
+		watcher = new ConfigWatcher;
+		watcher->stop = false;
+		watcher->thread = std::thread(&CDnnTrigger::watch_config, this);
+	}
+
 	err = 0;
 }
 
 
 CDnnTrigger::~CDnnTrigger()
 {
+	if (watcher)
+	{
+		{
+			std::lock_guard<std::mutex> lock(watcher->mutex);
+			watcher->stop = true;
+		}
+		watcher->wake.notify_one();
+		watcher->thread.join();
+		delete watcher;
+	}
+
 	delete pcm_stream;
 	delete[] dnn_prob_output;
 
@@ -77,46 +247,499 @@ CDnnTrigger::~CDnnTrigger()
 	delete dnn_decoder;
 	delete detector;
 
-	clog_free(TRG_CLOG);
+	delete verifier_decoder;
+	delete verifier;
+	delete[] verifier_prob_output;
+	delete[] feat_hist;
+
+	delete[] gate_feat;
+	delete[] sil_prob;
+	delete[] layer_ns;
+
+	// after the decoders, their weights are in the mapping
+	delete snapshot;
+
+	if (log_owner)
+		clog_free(TRG_CLOG);
+
+	if (trace_owner)
+	{
+		CTrace::stop();
+		CTrace::dump(trace_path.c_str());
+	}
 }
 
 
 bool CDnnTrigger::reset()
 {
 	pcm_stream->clear();
+	resetInput();
 
 	if (feat_extractor)	feat_extractor->reset();
 	if (dnn_decoder)	dnn_decoder->reset();
 	if (detector)	detector->reset();
 
+	if (verifier_decoder)	verifier_decoder->reset();
+	if (verifier)	verifier->reset();
+	feat_pos = feat_filled = 0;
+	verify_left = 0;
+	span_valid = false;
+	vad_idle = 0;
+	gate_begin = gate_end = 0;
+
 	return true;
 }
 
-int CDnnTrigger::detect(const int len_sample, const int16_t pcm_buf[],int *p_info)
+
+bool CDnnTrigger::getParam(TriggerParam* param)
+{
+	if (!detector || NULL == param)
+		return false;
+
+	detector->getParam(param);
+	return true;
+}
+
+
+// thread-safe, applied before the next frame
+bool CDnnTrigger::setParam(const TriggerParam* param)
+{
+	if (!detector)
+		return false;
+
+	return detector->setParam(param);
+}
+
+
+// config text, front end images of both sample rates and float DNN weights
+int CDnnTrigger::saveSnapshot(const char path[])
+{
+	if (err || !dnn_decoder)
+		return -1;
+
+	CSnapshot out;
+	const std::string text = CConfig::open(root_dir.c_str(), config_file.c_str())->getText();
+	memcpy(out.add(CSnapshot::CONFIG, text.size() + 1), text.c_str(), text.size() + 1);
+
+	const int fe_rate[2] = { 16000, 8000 };
+	const int fe_id[2] = { CSnapshot::FE_16K, CSnapshot::FE_8K };
+	for (int i = 0; i < 2; i++)
+	{
+		const long size = CFeat2pass::saveImage(fe_rate[i], NULL, 0);
+		if (size <= 0 || size != CFeat2pass::saveImage(fe_rate[i], out.add(fe_id[i], size), size))
+			return -1;
+	}
+
+	long size = dnn_decoder->saveImage(NULL, 0);
+	if (size <= 0 || size != dnn_decoder->saveImage(out.add(CSnapshot::DNN, size), size))
+		return -1;
+	if (verifier_decoder)
+	{
+		size = verifier_decoder->saveImage(NULL, 0);
+		if (size <= 0 || size != verifier_decoder->saveImage(out.add(CSnapshot::VERIFIER_DNN, size), size))
+			return -1;
+	}
+
+	return out.save(path) ? -2 : 0;
+}
+
+
+// config hot-reload off the audio thread : every reload_frames x 10 ms the config file is checked,
+// parsed here when it changed and handed to the detector, which applies it between two frames
+void CDnnTrigger::watch_config()
+{
+	std::unique_lock<std::mutex> lock(watcher->mutex);
+	while (!watcher->wake.wait_for(lock, std::chrono::milliseconds(reload_frames * 10), [this] { return watcher->stop; }))
+	{
+		lock.unlock();
+		check_config();
+		lock.lock();
+	}
+}
+
+
+// re-read detector parameters if the config file was modified (watcher thread)
+void CDnnTrigger::check_config()
+{
+	// same check as every other open() : modification time and size, a file that can't be read is skipped
+	const std::shared_ptr<const CConfig> config = CConfig::open(root_dir.c_str(), config_file.c_str());
+	if (config == watched_config || !config->isLoaded())
+		return;
+	watched_config = config;
+
+	const bool reloaded = detector->reloadParam(*config);
+	if (_clog_loggers[TRG_CLOG])
+		clog_info(CLOG(TRG_CLOG), "config %s %s", config_full_path.c_str(), reloaded ? "reloaded" : "rejected");
+}
+
+
+// counters since the last resetStats(), false in a TRG_NO_STATS build
+bool CDnnTrigger::getStats(TriggerStats* out)
 {
-	// TODO: input  , ʰ ÷ο Ŵ
-	pcm_stream->putItems(len_sample, pcm_buf);
+#ifdef TRG_NO_STATS
+	(void)out;
+	return false;
+#else
+	if (NULL == out || err)
+		return false;
+
+	*out = stats;
+
+	uint64_t fe_ns[3];
+	feat_extractor->getStageTime(fe_ns);
+	out->nr_ns = fe_ns[0];
+	out->mfcc_ns = fe_ns[1];
+	out->mfcc2feat_ns = fe_ns[2];
+
+	out->dnn_layers = dnn_decoder->getNumLayer();
+	for (int l = 0; l < std::min(out->dnn_layers, TRG_STATS_LAYERS); l++)
+		out->dnn_layer_ns[l] = layer_ns[l];
+
+	out->queue_overrun = pcm_stream->getDropped();
+	return true;
+#endif
+}
+
+
+void CDnnTrigger::resetStats()
+{
+	if (err)	return;
+
+	memset(&stats, 0, sizeof(stats));
+	if (layer_ns)
+		std::fill_n(layer_ns, dnn_decoder->getNumLayer(), 0ULL);
+	feat_extractor->clearStageTime();
+	pcm_stream->clearDropped();
+}
+
+
+bool CDnnTrigger::dumpTrace(const char path[])
+{
+	if (!path)	path = trace_path.c_str();
+	if ('\0' == path[0])	return false;
+
+	return CTrace::dump(path);
+}
+
+
+// front end span of a frame, its stages back to back from begin_ns (durations from the stage times,
+// not recorded with TRG_NO_STATS)
+void CDnnTrigger::trace_front_end(const uint64_t begin_ns, const uint64_t end_ns)
+{
+	static const char* const stage_name[3] = { "nr", "mfcc", "mfcc2feat" };
+
+	CTrace::complete("fe", begin_ns, end_ns);
 
+	uint64_t fe_ns[3];
+	feat_extractor->getStageTime(fe_ns);
+
+	uint64_t t = begin_ns;
+	for (int s = 0; s < 3; s++)
+	{
+		const uint64_t ns = fe_ns[s] - trace_fe_ns[s];
+		trace_fe_ns[s] = fe_ns[s];
+		if (!ns || end_ns - begin_ns < ns)	continue;	// not timed this frame (first traced frame, resetStats())
+
+		CTrace::complete(stage_name[s], t, t + ns);
+		t += ns;
+	}
+}
+
+
+// HDR-style bucket of the frame latency, TriggerStats::latency
+void CDnnTrigger::add_latency(const uint64_t ns)
+{
+	int b = (int)ns;
+	if (4 <= ns)
+	{
+		int msb = 2;
+		while (msb < 63 && (ns >> (msb + 1)))
+			msb++;
+		b = (msb - 1) * 4 + (int)((ns >> (msb - 2)) & 3);
+	}
+
+	stats.latency[std::min(b, TRG_STATS_BUCKETS - 1)]++;
+	stats.latency_max_ns = std::max(stats.latency_max_ns, ns);
+}
+
+
+bool CDnnTrigger::getTriggerSpan(TriggerSpan* span)
+{
+	if (!span_valid || NULL == span)
+		return false;
+
+	*span = trigger_span;
+	return true;
+}
+
+
+// first pass fired : the buffered features are re-scored by step_verify(), oldest first
+void CDnnTrigger::start_verify(const TriggerSpan& span)
+{
+	verifier_decoder->reset();
+	verifier->reset();
+
+	verify_row = (feat_pos - feat_filled + verify_frames) % verify_frames;
+	verify_left = feat_filled;
+	verify_frame = output_frame;
+	verify_span = span;
+	verify_sp_frame = detector->getTriggerFrameLen();
+}
+
+// up to verify_step buffered frames through the verifier DNN, stops at the first frame it fires on
+// return the first pass detection frame # when accepted, 0 if still pending or rejected
+int CDnnTrigger::step_verify()
+{
+	for (int n = 0; n < verify_step && verify_left; n++)
+	{
+		verifier_decoder->decode(feat_row(feat_hist, verify_frames, verify_row), verifier_prob_output);
+		verify_row = (verify_row + 1) % verify_frames;
+		verify_left--;
+
+		const bool accepted = 0 < verifier->detect(verifier_prob_output);
+		if (accepted || !verify_left)
+		{
+			if (_clog_loggers[TRG_CLOG])
+				clog_info(CLOG(TRG_CLOG), "verifier %s frame %d at %d", accepted ? "accepted" : "rejected", verify_frame, output_frame);
+			if (!accepted)
+				return 0;
+
+			verify_left = 0;
+			trigger_span = verify_span;
+			span_valid = true;
+			sp_output_frame = verify_sp_frame;
+			return verify_frame;
+		}
+	}
+	return 0;
+}
+
+// one feature frame through the DNN and the detector, skipped frames only fill the DNN context window
+// return detected frame #, 0 if not detected
+int CDnnTrigger::decode_frame(const feat_t feat[], const bool skipped)
+{
+	unsigned long long t_stage = 0;
+	HCI_STAGE_START(t_stage);
+	const bool tracing = CTrace::enabled();
+	const uint64_t t_trace = tracing ? hci_clock_ns() : 0;
+
+	CAllocStats::setStage(CAllocStats::DNN);
+	const float* prob = dnn_prob_output;
+	if (skipped)
+	{
+		output_frame = dnn_decoder->push(feat);
+		prob = sil_prob;
+	}
+	else
+	{
+		TRG_STAT(stats.dnn_frames++);
+		output_frame = dnn_decoder->decode(feat, dnn_prob_output);   // dnn_prob_output = DNN output node µ ,  class  Ȯ , decodeԼ   ޾ƿ
+	}
+
+	HCI_STAGE_TIME(stats.dnn_ns, t_stage);
+	const uint64_t t_trace_dnn = tracing ? hci_clock_ns() : 0;
+
+	CAllocStats::setStage(CAllocStats::DETECTOR);
+	auto detected = detector->detect(prob);						 //  class  Ȯ(dnn_prob_output) Ͽ detect Ȯ
+	HCI_STAGE_TIME(stats.detector_ns, t_stage);
+	if (tracing)
+	{
+		CTrace::complete(skipped ? "dnn_push" : "dnn", t_trace, t_trace_dnn);
+		CTrace::complete("detector", t_trace_dnn, hci_clock_ns());
+	}
+
+	if (0 < detected)
+	{
+		// feature frame n covers 16 kHz samples [n*160, n*160+480), TriggerSpan holds input samples
+		TriggerSpan span;
+		span.frame_begin = std::max(0, output_frame - detector->getSpanBegin());
+		span.frame_end = std::max(span.frame_begin, output_frame - detector->getSpanEnd());
+		span.sample_begin = inputSample((int64_t)span.frame_begin * 160);
+		span.sample_end = inputSample((int64_t)span.frame_end * 160 + 480);
+
+		// cascade : reported by step_verify(), a first pass detection during a verification is dropped
+		if (verifier)
+		{
+			if (!verify_left)
+				start_verify(span);
+			return 0;
+		}
+
+		trigger_span = span;
+		span_valid = true;
+		sp_output_frame = detector->getTriggerFrameLen();	// legacy p_trigger_frame_info[1], the keyword span is getTriggerSpan()
+		return output_frame;
+	}
+	return 0;
+}
+
+// hold a frame skipped by the speech gate, frames older than vad_catchup are given up
+void CDnnTrigger::gate_frame(const feat_t feat[])
+{
+	if (vad_idle == vad_gate + 1 && _clog_loggers[TRG_CLOG])
+		clog_debug(CLOG(TRG_CLOG), "speech gate closed frame %d", output_frame);
+
+	memcpy(feat_row(gate_feat, vad_catchup + 1, gate_end++), feat, sizeof(feat_t) * 51);
+	if (CTrace::enabled())
+		CTrace::counter("gate_pending", gate_end - gate_begin);
+
+	// silence posterior in frame order, can't fire
+	while (vad_catchup < gate_end - gate_begin)
+		decode_frame(feat_row(gate_feat, vad_catchup + 1, gate_begin++), true);
+}
+
+// speech again : decode the held frames before the current one
+// return last detected frame #, 0 if not detected
+int CDnnTrigger::gate_flush()
+{
 	int detected_frame = 0;
 
-	while (160 <= pcm_stream->size())
+	if (gate_begin < gate_end && _clog_loggers[TRG_CLOG])
+		clog_debug(CLOG(TRG_CLOG), "speech gate opened frame %d, %d frames caught up", output_frame, gate_end - gate_begin);
+
+	for (; gate_begin < gate_end; gate_begin++)
 	{
-		int16_t frame_buf[160];
-		pcm_stream->getItems(160, frame_buf);
+		const int f = decode_frame(feat_row(gate_feat, vad_catchup + 1, gate_begin), false);
+		if (f)	detected_frame = f;
+	}
+
+	return detected_frame;
+}
+
+// one feature frame of the input : verifier history, speech gate, DNN and detector
+// return detected frame #, 0 if not detected
+int CDnnTrigger::process_frame(const feat_t feat[], const bool speech)
+{
+	int detected_frame = 0;
+	if (feat_hist)
+	{
+		// pending verification first, it has re-scored the oldest row before the new frame takes it
+		if (verify_left)
+		{
+			unsigned long long t_stage = 0;
+			HCI_STAGE_START(t_stage);
+			CAllocStats::setStage(CAllocStats::DETECTOR);
+			detected_frame = step_verify();
+			HCI_STAGE_TIME(stats.detector_ns, t_stage);
+		}
 
-		long len_feat = 0;
-		feat_extractor->getFeature(160, frame_buf, &len_feat, feat_buf);   // feat_buf :  frame  Ư¡ Ͽ featu_buf(Queue, FIFO ) 
+		memcpy(feat_row(feat_hist, verify_frames, feat_pos), feat, sizeof(feat_t) * 51);
+		feat_pos = (feat_pos + 1) % verify_frames;
+		feat_filled = std::min(feat_filled + 1, verify_frames);
+	}
 
-		for (int i = 2; i < len_feat; i += 51)    // feat_buf[0] Ư¡ ϷǾ  info , feat_buf[1] Ư¡Ⱚ reset Ǿ  info ,  i=2 !  ( powerdsr_fronted.c  ) 
+	if (vad_gate)
+	{
+		vad_idle = speech ? 0 : vad_idle + 1;
+		if (vad_gate < vad_idle)
 		{
-			output_frame = dnn_decoder->decode(&feat_buf[i], dnn_prob_output);   // dnn_prob_output = DNN output node µ ,  class  Ȯ , decodeԼ   ޾ƿ
-			auto detected = detector->detect(dnn_prob_output);					 //  class  Ȯ(dnn_prob_output) Ͽ detect Ȯ
-			if (0 < detected){
-				detected_frame = output_frame;
-				sp_output_frame = detector->getTriggerFrameLen();
-			}
+			gate_frame(feat);
+			return 0;
 		}
+		detected_frame = gate_flush();
+	}
+
+	if (const int f = decode_frame(feat, false))
+		detected_frame = f;
+
+	return detected_frame;
+}
+
+// replay of recorded feature frames (feature file rows), detect() without the front end
+// the NR VAD is not recorded, the speech gate sees every frame as speech
+// (the fixed-point build takes the float rows back to Q15)
+int CDnnTrigger::detectFeatures(const int num_frames, const float feat[], int *p_info)
+{
+	int detected_frame = 0;
+
+	for (int n = 0; n < num_frames; n++)
+	{
+#ifdef FIXED_POINT_FE
+		feat_t q[51];
+		for (int i = 0; i < 51; i++)
+			q[i] = (feat_t)lrintf(feat[n * 51 + i] * 32768.f);
+		if (const int f = process_frame(q, true))
+			detected_frame = f;
+#else
+		if (const int f = process_frame(&feat[n * 51], true))
+			detected_frame = f;
+#endif
+	}
+	CAllocStats::setStage(CAllocStats::OTHER);
+
+	if (p_info != NULL)
+	{
+		p_info[0] = output_frame;
+		p_info[1] = detected_frame > 0 ? sp_output_frame : 0;
+	}
+
+	return detected_frame;
+}
+
+// one 10ms input frame through the front end and process_frame()
+// return detected frame #, 0 if not detected
+int CDnnTrigger::detect_frame(const int16_t frame_buf[])
+{
+	int detected_frame = 0;
+
+	unsigned long long t_stage = 0;
+	HCI_STAGE_START(t_stage);
+	const unsigned long long t_frame = t_stage;
+	const bool tracing = CTrace::enabled();
+	const uint64_t t_trace = tracing ? hci_clock_ns() : 0;
+
+	CAllocStats::setStage(CAllocStats::FRONT_END);
+	long len_feat = 0;
+	feat_extractor->getFeature(160, frame_buf, &len_feat, feat_buf);   // feat_buf :  frame  Ư¡ Ͽ featu_buf(Queue, FIFO ) 
+	const bool speech = !vad_gate || feat_extractor->isSpeech();
+	HCI_STAGE_TIME(stats.fe_ns, t_stage);
+	if (tracing)
+		trace_front_end(t_trace, hci_clock_ns());
+
+	for (int i = 2; i < len_feat; i += 51)    // feat_buf[0] Ư¡ ϷǾ  info , feat_buf[1] Ư¡Ⱚ reset Ǿ  info ,  i=2 !  ( powerdsr_fronted.c  ) 
+	{
+		if (const int f = process_frame(&feat_buf[i], speech))
+			detected_frame = f;
 	}
+	CAllocStats::setStage(CAllocStats::OTHER);
+
+	TRG_STAT(stats.frames++);
+	TRG_STAT(add_latency(hci_clock_ns() - t_frame));
+	if (tracing)
+		CTrace::complete("frame", t_trace, hci_clock_ns());
+
+	return detected_frame;
+}
+
+int CDnnTrigger::detect(const int len_sample, const int16_t pcm_buf[],int *p_info)
+{
+	int detected_frame = 0;
+	int used = 0;
+
+	// a queued remainder is topped up to a frame from pcm_buf, then whole frames are taken in place from
+	// pcm_buf and only the rest is queued : the queue never holds a frame, whatever the chunk lengths
+	const int queued = (int)pcm_stream->size();
+	if (0 < queued && 160 <= queued + len_sample)
+	{
+		int16_t frame_buf[160];
+		used = 160 - queued;
+		pcm_stream->getItems(queued, frame_buf);
+		memcpy(&frame_buf[queued], pcm_buf, sizeof(int16_t) * used);
+
+		if (const int f = detect_frame(frame_buf))
+			detected_frame = f;
+	}
+
+	if (0 == pcm_stream->size())
+	{
+		for (; used + 160 <= len_sample; used += 160)
+			if (const int f = detect_frame(&pcm_buf[used]))
+				detected_frame = f;
+	}
+
+	pcm_stream->putItems(len_sample - used, &pcm_buf[used]);
+	if (CTrace::enabled())
+		CTrace::counter("pcm_queue", pcm_stream->size());
     if(p_info!=NULL) {
         p_info[0] = output_frame;
         p_info[1] = detected_frame>0?sp_output_frame:0;
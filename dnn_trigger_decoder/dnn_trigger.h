@@ -6,10 +6,17 @@
 #ifndef __TRIGGER_DNN_TRIGGER_H__
 #define __TRIGGER_DNN_TRIGGER_H__
 
+#include <memory>
+#include <string>
+
 #include "trigger.h"
 
+class CConfig;
+
 
 class CDetectorWord;
+class CSnapshot;
+struct ConfigWatcher;
 class SizedQueue;
 
 
@@ -20,11 +27,95 @@ private:
 	CDetectorWord* detector;
 	SizedQueue* pcm_stream;
 
+	// second pass (optional) : bigger DNN re-scores the buffered features when the first pass fires.
+	// It runs verify_step frames per input frame, the detection is reported when the verifier fires,
+	// up to verify_frames / verify_step input frames after the first pass
+	CDnnDecoder* verifier_decoder;
+	CDetectorWord* verifier;
+	float* verifier_prob_output;
+	feat_t* feat_hist;	// last verify_frames features, [frame][51]
+	int verify_frames;
+	int verify_step;	// verifier frames per input frame
+	int feat_pos;		// next row of feat_hist, wraps at verify_frames
+	int feat_filled;	// rows of feat_hist holding features, <= verify_frames
+	int verify_row;		// next row of feat_hist to re-score
+	int verify_left;	// rows still to re-score, 0 = no detection under verification
+	int verify_frame;	// first pass detection under verification, its span and trigger frame length
+	TriggerSpan verify_span;
+	int verify_sp_frame;
+
+	void start_verify(const TriggerSpan& span);
+	int step_verify();
+
+	TriggerSpan trigger_span;
+	bool span_valid;
+
+	// speech gating : while the NR VAD reports non-speech, frames skip the DNN and the detector
+	// gets a silence posterior. The last vad_catchup skipped frames are kept and decoded when
+	// speech starts again (VAD onset latency), older ones only enter the DNN context window.
+	int vad_gate;		// non-speech frames before the DNN is skipped, 0 = off
+	int vad_catchup;
+	int vad_idle;		// consecutive non-speech frames
+	feat_t* gate_feat;	// skipped frames not decoded yet, [frame][51], vad_catchup + 1 frames
+	int gate_begin;		// pending frames [gate_begin, gate_end), feature frame counters
+	int gate_end;
+	float* sil_prob;	// posterior fed to the detector for skipped frames
+
+	int decode_frame(const feat_t feat[], const bool skipped);
+	int process_frame(const feat_t feat[], const bool speech);
+	int detect_frame(const int16_t frame_buf[]);
+	void gate_frame(const feat_t feat[]);
+	int gate_flush();
+
+	// config hot-reload : detector parameters are re-read when the config file changes,
+	// by a thread of the trigger (stat and parse off the audio thread)
+	std::string root_dir;
+	std::string config_file;
+	std::string config_full_path;	// root_dir/config_file
+	int reload_frames;	// check interval in 10ms frames, 0 = off
+	std::shared_ptr<const CConfig> watched_config;	// instance in use, CConfig::open() gives another one when the file changed
+	ConfigWatcher* watcher;
+	void watch_config();
+	void check_config();
+
+	// profiling counters of getStats(), not collected with TRG_NO_STATS
+	TriggerStats stats;
+	unsigned long long* layer_ns;	// per layer of dnn_decoder
+	void add_latency(const uint64_t ns);
+
+	bool log_owner;	// clog opened by this instance
+
+	CSnapshot* snapshot;	// warm start : front end images and DNN weights used in place, NULL if loaded from files
+
+	// event trace ([log] trace), started and written by the instance that reads the config
+	std::string trace_path;
+	bool trace_owner;
+	uint64_t trace_fe_ns[3];	// front end stage times at the last traced frame
+	void trace_front_end(const uint64_t begin_ns, const uint64_t end_ns);
+	void init(const char root_path[], const char config_path[], const int sample_rate, const int format, const CDnnTrigger* model);
+
 public:
-	CDnnTrigger(const char root_path[], const char config_path[]);
+	// sample_rate / format : input of detectAudio(), detect() always takes 16 kHz int16 mono
+	CDnnTrigger(const char root_path[], const char config_path[], const int sample_rate = 16000, const int format = TRG_SAMPLE_S16);
+	// session : config and DNN weights of model, decoder/detector state of its own, model must outlive it
+	CDnnTrigger(const CDnnTrigger* model, const int sample_rate = 16000, const int format = TRG_SAMPLE_S16);
+	// warm start from snapshot (opened by CSnapshot::open), owned by the trigger and mapped as long as it lives
+	CDnnTrigger(CSnapshot* snapshot, const int sample_rate = 16000, const int format = TRG_SAMPLE_S16);
 	~CDnnTrigger();
 	virtual bool reset();
 	virtual int detect(const int len_sample, const int16_t pcm_buf[],int* spinfo=NULL);
+	virtual int detectFeatures(const int num_frames, const float feat[], int* spinfo=NULL);
+	virtual bool getTriggerSpan(TriggerSpan* span);
+	virtual bool getParam(TriggerParam* param);
+	virtual bool setParam(const TriggerParam* param);
+	virtual bool getStats(TriggerStats* stats);
+	virtual void resetStats();
+
+	// event trace so far to path (NULL : [log] trace), false if not traced
+	bool dumpTrace(const char path[] = NULL);
+
+	// initialized state (config, front end, DNN weights) for CDnnTrigger(CSnapshot*), 0 / -1 not initialized / -2 cannot write
+	int saveSnapshot(const char path[]);
 };
 
 #endif	// __TRIGGER_DNN_TRIGGER_H__
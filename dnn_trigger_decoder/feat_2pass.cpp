@@ -6,8 +6,10 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "frontend/powerdsr_frontend.h"
+#include "feat_file.h"
 #pragma comment(lib, "Feat2Pass")
 #pragma comment(lib, "FrontEnd")
 
@@ -18,7 +20,10 @@ int CFeat2pass::fe_channel = 16;
 CFeat2pass::CFeat2pass(const char root_path[])
 {
 	chan_id = -1;
+	nr_mode = -1;
+	dump = NULL;
 	err = 0;
+	clearStageTime();
 
 	if (!fe_connected)
 	{
@@ -42,16 +47,44 @@ CFeat2pass::CFeat2pass(const char root_path[])
 }
 
 
+// return 0, 100 + error of PowerDSR_FE_ConnectImage() (as getError())
+// the front end is shared by the process : if already connected, it stays as it is
+int CFeat2pass::connectImage(const void* image_16k, const long size_16k, const void* image_8k, const long size_8k)
+{
+	if (fe_connected)	return 0;
+
+	auto ret_fec = PowerDSR_FE_ConnectImage(image_16k, size_16k, image_8k, size_8k, fe_channel);
+	if (POWERDSR_FE_CONNECTED != ret_fec)
+	{
+		printf("fe connect fail");
+		return 100 + ret_fec;
+	}
+	fe_connected = true;
+	return 0;
+}
+
+
+// sample_rate 16000 or 8000, return the image size or -1
+long CFeat2pass::saveImage(const int sample_rate, void* buf, const long size)
+{
+	if (!fe_connected)	return -1;
+
+	return PowerDSR_FE_SaveImage(sample_rate, buf, size);
+}
+
+
 CFeat2pass::~CFeat2pass()
 {
 	PowerDSR_FE_ReleaseFrontEndEngine(chan_id);
 	PowerDSR_FE_CloseChannel(chan_id);
 	//PowerDSR_FE_Disconnect();
+	delete dump;
 }
 
 // reset and clear buffer
 int CFeat2pass::reset()
 {
+	getStageTime(stage_ns);
 	PowerDSR_FE_ReleaseFrontEndEngine(chan_id);
 	PowerDSR_FE_CloseChannel(chan_id);
 
@@ -63,16 +96,117 @@ int CFeat2pass::reset()
 		return -1;
 	}
 
+	// reopened channel starts with the config default
+	if (nr_mode >= 0)	PowerDSR_FE_SetNoiseReductionMode(chan_id, nr_mode);
+
 	return 0;
 }
 
 
-int CFeat2pass::getFeature(const int in_samples, const int16_t in_pcm[], long* len_feat, float* out_feat)
+// switch noise reduction of this channel, NR filters restart on a change
+int CFeat2pass::setNRMode(const int mode)
+{
+	if (PowerDSR_FE_SetNoiseReductionMode(chan_id, mode) != 0)	return -1;
+
+	nr_mode = mode;
+	return 0;
+}
+
+
+// start (path) or stop (NULL) recording the feature frames, a running dump is closed first
+int CFeat2pass::setDump(const char path[])
+{
+	delete dump;
+	dump = NULL;
+	if (NULL == path || '\0' == path[0])
+		return 0;
+
+	dump = new CFeatFileWriter();
+	if (dump->open(path, 51))
+	{
+		delete dump;
+		dump = NULL;
+		return -1;
+	}
+	return 0;
+}
+
+
+// stage times kept by the front end channel (FrontEnd_UserData), a reopened channel starts from 0
+void CFeat2pass::getStageTime(uint64_t ns[3])
+{
+	ns[0] = stage_ns[0];
+	ns[1] = stage_ns[1];
+	ns[2] = stage_ns[2];
+
+	PowerASR_FrontEnd* fe;
+	FrontEnd_UserData* chan;
+	if (0 == PowerDSR_FE_GetChannelData(chan_id, &fe, &chan))
+	{
+		ns[0] += chan->nTimeNR;
+		ns[1] += chan->nTimeMfcc;
+		ns[2] += chan->nTimeFeat;
+	}
+}
+
+
+void CFeat2pass::clearStageTime()
+{
+	stage_ns[0] = stage_ns[1] = stage_ns[2] = 0;
+
+	PowerASR_FrontEnd* fe;
+	FrontEnd_UserData* chan;
+	if (0 == PowerDSR_FE_GetChannelData(chan_id, &fe, &chan))
+		chan->nTimeNR = chan->nTimeMfcc = chan->nTimeFeat = 0;
+}
+
+
+// speech activity of the last input frame (Wiener NR VAD), errors count as speech
+bool CFeat2pass::isSpeech()
+{
+	return PowerDSR_FE_GetSpeechActivity(chan_id) != 0;
+}
+
+
+// the fixed-point front end writes Q15.32 features after the 2 header values, passed on as they are
+// (CDnnDecoder takes them), the feature file holds float
+int CFeat2pass::getFeature(const int in_samples, const int16_t in_pcm[], long* len_feat, feat_t* out_feat)
 {
 	auto epd_result = PowerDSR_FE_SpeechStream2FeatureStream(chan_id,
-		out_feat, (LONG*)len_feat, (short*)in_pcm, in_samples, 80, 0);
+		(hci_float32*)out_feat, (LONG*)len_feat, (short*)in_pcm, in_samples, 80, 0);
 
 	if (epd_result < 0)	return epd_result;
 
+	if (dump && 2 < *len_feat)
+	{
+#ifdef FIXED_POINT_FE
+		float row[51];
+		for (long f = 2; f + 51 <= *len_feat; f += 51)
+		{
+			for (int i = 0; i < 51; i++)
+				row[i] = out_feat[f + i] * (1.f / 32768.f);
+			dump->write(1, row);
+		}
+#else
+		dump->write((int)(*len_feat - 2) / 51, &out_feat[2]);
+#endif
+	}
+
+	return 0;
+}
+
+#ifdef FIXED_POINT_FE
+int CFeat2pass::getFeature(const int in_samples, const int16_t in_pcm[], long* len_feat, float* out_feat)
+{
+	const int ret = getFeature(in_samples, in_pcm, len_feat, (feat_t*)out_feat);
+	if (ret)	return ret;
+
+	for (long i = 2; i < *len_feat; i++)
+	{
+		int32_t q;
+		memcpy(&q, &out_feat[i], sizeof(q));
+		out_feat[i] = q * (1.f / 32768.f);
+	}
 	return 0;
 }
+#endif
@@ -3,12 +3,31 @@
 
 #include <stdint.h>
 
+class CFeatFileWriter;
+
+// one feature value as the front end writes it : Q15 in the fixed-point build, float otherwise
+#ifdef FIXED_POINT_FE
+typedef int32_t feat_t;
+#define FEAT_Q15	1
+#else
+typedef float feat_t;
+#define FEAT_Q15	0
+#endif
+
 class CFeat2pass {
 public:
 	CFeat2pass(const char root_path[]);
 	~CFeat2pass();
-	int getFeature(const int in_samples, const int16_t in_pcm[], long* len_feat, float* out_feat);
+	int getFeature(const int in_samples, const int16_t in_pcm[], long* len_feat, feat_t* out_feat);
+#ifdef FIXED_POINT_FE
+	int getFeature(const int in_samples, const int16_t in_pcm[], long* len_feat, float* out_feat);	// Q15 converted to float
+#endif
 	int reset();
+	int setNRMode(const int mode);	// NR_MODE_OFF(0), NR_MODE_SINGLE_STAGE(1), NR_MODE_TWO_STAGE(2)
+	bool isSpeech();	// NR energy VAD of the last getFeature() input, true when NR is off
+	int setDump(const char path[]);	// record getFeature() frames to a feature file (feat_file.h), NULL stops
+	void getStageTime(uint64_t ns[3]);	// ns in NR, wave-to-MFCC, MFCC-to-feature since clearStageTime(), 0 with TRG_NO_STATS
+	void clearStageTime();
 	int getError() { return err; };
 	static bool setChannel(int ch) {
 		if (fe_connected == false) {
@@ -19,10 +38,16 @@ public:
 		}
 		return false;
 	}
+	// front end from the images of saveImage() instead of the config files, before the first instance
+	static int connectImage(const void* image_16k, const long size_16k, const void* image_8k, const long size_8k);
+	static long saveImage(const int sample_rate, void* buf, const long size);	// set-up of the connected front end, buf NULL : size only
 private:
 	static bool fe_connected;	// singleton FE loaded
 	static int fe_channel;
 	long chan_id;
+	int nr_mode;	// -1: NR_MODE of hci_frontend.ini
+	uint64_t stage_ns[3];	// stage times of the channels closed by reset()
+	CFeatFileWriter* dump;
 	int err;
 };
 
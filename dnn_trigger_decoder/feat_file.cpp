@@ -0,0 +1,172 @@
+// feat_file.cpp
+// Feature cache file, see feat_file.h
+
+#include "feat_file.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+CFeatFileWriter::CFeatFileWriter()
+{
+	fp = NULL;
+	dim = 0;
+	frames = 0;
+}
+
+
+CFeatFileWriter::~CFeatFileWriter()
+{
+	close();
+}
+
+
+int CFeatFileWriter::open(const char path[], const int dim)
+{
+	close();
+
+	fp = fopen(path, "wb");
+	if (!fp)	return -1;
+
+	this->dim = dim;
+	frames = 0;
+
+	FeatFileHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, FEAT_FILE_MAGIC, 4);
+	header.version = FEAT_FILE_VERSION;
+	header.dim = dim;
+	header.frame_rate = 100;
+	if (1 != fwrite(&header, sizeof(header), 1, fp))
+	{
+		fclose(fp);
+		fp = NULL;
+		return -1;
+	}
+
+	return 0;
+}
+
+
+int CFeatFileWriter::write(const int num_frames, const float feat[])
+{
+	if (!fp)	return -1;
+
+	if ((size_t)num_frames != fwrite(feat, sizeof(float) * dim, num_frames, fp))
+		return -1;
+
+	frames += num_frames;
+	return 0;
+}
+
+
+int CFeatFileWriter::close()
+{
+	if (!fp)	return 0;
+
+	int ret = 0;
+	if (0 != fseek(fp, offsetof(FeatFileHeader, frames), SEEK_SET) || 1 != fwrite(&frames, sizeof(frames), 1, fp))
+		ret = -1;
+	if (0 != fclose(fp))
+		ret = -1;
+	fp = NULL;
+
+	return ret;
+}
+
+
+CFeatFileReader::CFeatFileReader()
+{
+	map = NULL;
+	map_len = 0;
+#if defined(_WIN32)
+	h_file = INVALID_HANDLE_VALUE;
+	h_map = NULL;
+#endif
+	rows = NULL;
+	dim = 0;
+	frames = 0;
+}
+
+
+CFeatFileReader::~CFeatFileReader()
+{
+	close();
+}
+
+
+// return 0, -1 cannot map, -2 not a feature file
+int CFeatFileReader::open(const char path[])
+{
+	close();
+
+#if defined(_WIN32)
+	h_file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (INVALID_HANDLE_VALUE == h_file)	return -1;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(h_file, &size) || size.QuadPart < (LONGLONG)sizeof(FeatFileHeader)) { close(); return -2; }
+	map_len = (size_t)size.QuadPart;
+
+	h_map = CreateFileMappingA(h_file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!h_map) { close(); return -1; }
+	map = MapViewOfFile(h_map, FILE_MAP_READ, 0, 0, 0);
+	if (!map) { close(); return -1; }
+#else
+	const int fd = ::open(path, O_RDONLY);
+	if (fd < 0)	return -1;
+
+	struct stat st;
+	if (0 != fstat(fd, &st) || st.st_size < (off_t)sizeof(FeatFileHeader)) { ::close(fd); return -2; }
+	map_len = (size_t)st.st_size;
+
+	map = mmap(NULL, map_len, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (MAP_FAILED == map) { map = NULL; return -1; }
+	madvise(map, map_len, MADV_SEQUENTIAL);
+#endif
+
+	const FeatFileHeader* header = (const FeatFileHeader*)map;
+	if (0 != memcmp(header->magic, FEAT_FILE_MAGIC, 4) || FEAT_FILE_VERSION != header->version || 0 == header->dim)
+	{
+		close();
+		return -2;
+	}
+
+	dim = header->dim;
+	rows = (const float*)((const char*)map + sizeof(FeatFileHeader));
+
+	// an unfinished file holds the complete rows written so far
+	const uint64_t rows_in_file = (map_len - sizeof(FeatFileHeader)) / (sizeof(float) * dim);
+	frames = (long)((header->frames && header->frames <= rows_in_file) ? header->frames : rows_in_file);
+
+	return 0;
+}
+
+
+void CFeatFileReader::close()
+{
+#if defined(_WIN32)
+	if (map)	UnmapViewOfFile(map);
+	if (h_map)	CloseHandle(h_map);
+	if (INVALID_HANDLE_VALUE != h_file)	CloseHandle(h_file);
+	h_map = NULL;
+	h_file = INVALID_HANDLE_VALUE;
+#else
+	if (map)	munmap(map, map_len);
+#endif
+	map = NULL;
+	map_len = 0;
+	rows = NULL;
+	dim = 0;
+	frames = 0;
+}
@@ -0,0 +1,73 @@
+// feat_file.h
+// Feature cache file : the 51-dim feature frames of CFeat2pass::getFeature(), recorded once and
+// replayed into the DNN decoders and detectors without running the front end again
+//
+// layout (little endian) : FeatFileHeader, then frames x dim float32 rows
+// the rows start at a 64 byte offset, a mapped file is used in place
+
+
+#ifndef __TRIGGER_FEAT_FILE_H__
+#define __TRIGGER_FEAT_FILE_H__
+
+#include <stdio.h>
+#include <stdint.h>
+
+
+#define FEAT_FILE_MAGIC		"TRGF"
+#define FEAT_FILE_VERSION	1
+
+typedef struct FeatFileHeader {
+	char magic[4];			// FEAT_FILE_MAGIC
+	uint32_t version;		// FEAT_FILE_VERSION
+	uint32_t dim;			// floats per frame
+	uint32_t frame_rate;	// frames per second
+	uint64_t frames;		// 0 : writer did not finish, rows up to the file size are valid
+	uint8_t reserved[40];
+} FeatFileHeader;			// 64 bytes
+
+
+class CFeatFileWriter
+{
+private:
+	FILE* fp;
+	int dim;
+	uint64_t frames;
+
+public:
+	CFeatFileWriter();
+	~CFeatFileWriter();
+
+	int open(const char path[], const int dim = 51);
+	int write(const int num_frames, const float feat[]);
+	int close();	// writes the frame count
+	bool isOpen() { return NULL != fp; }
+};
+
+
+class CFeatFileReader
+{
+private:
+	void* map;
+	size_t map_len;
+#if defined(_WIN32)
+	void* h_file;
+	void* h_map;
+#endif
+	const float* rows;
+	int dim;
+	long frames;
+
+public:
+	CFeatFileReader();
+	~CFeatFileReader();
+
+	int open(const char path[]);	// maps the whole file read-only
+	void close();
+
+	int getDim() { return dim; }
+	long getFrames() { return frames; }
+	const float* data() { return rows; }	// frames x dim
+	const float* row(const long frame) { return rows + frame * dim; }
+};
+
+#endif	// __TRIGGER_FEAT_FILE_H__
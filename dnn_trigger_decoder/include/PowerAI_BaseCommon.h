@@ -59,6 +59,16 @@ DNN_Result base_getArgumentValue(const char* pszArg, char* pValue, FILE* fpConfi
 HCILAB_PUBLIC POWER_DEEPNET_API
 DNN_Result base_getArgumentValueWithoutLowCase(char* pszArg, char* pValue, FILE* fpConfig);
 
+// parsed once, then looked up without file I/O (same result as base_getArgumentValue)
+HCILAB_PUBLIC POWER_DEEPNET_API
+DNN_Result base_loadArguments(DNN_ConfigArgs* pArgs, FILE* fpConfig);
+HCILAB_PUBLIC POWER_DEEPNET_API
+DNN_Result base_findArgumentValue(const char* pszArg, char* pValue, const DNN_ConfigArgs* pArgs);
+HCILAB_PUBLIC POWER_DEEPNET_API
+DNN_Result base_findArgumentValueWithoutLowCase(char* pszArg, char* pValue, const DNN_ConfigArgs* pArgs);
+HCILAB_PUBLIC POWER_DEEPNET_API
+void base_freeArguments(DNN_ConfigArgs* pArgs);
+
 HCILAB_PUBLIC POWER_DEEPNET_API
 void base_printDeepnet(Deepnet* pDeepnet, FILE* fpLog);
 /// CPU Common Function ///
@@ -78,6 +88,19 @@ DNN_Result DNN_save_dnn(Deepnet* pDeepnet, short n_stages_to_save, char* sz_file
 HCILAB_PUBLIC POWER_DEEPNET_API
 DNN_Result do_forward_prop(Deepnet* pDeepnet, DNN_LAYER_UNIT* p_dnn_output);
 
+HCILAB_PUBLIC POWER_DEEPNET_API
+DNN_Result do_forward_prop_batch(Deepnet* pDeepnet, DNN_LAYER_UNIT* const p_dnn_output[], const int n_batch);
+
+/// Fixed-point Function ///
+HCILAB_PUBLIC POWER_DEEPNET_API
+DeepnetFixed* DNN_fixed_create(const Deepnet* pDeepnet);
+HCILAB_PUBLIC POWER_DEEPNET_API
+DNN_Result DNN_fixed_destroy(DeepnetFixed* pFixed);
+
+// in : int16 input of the first layer in Q(in_q), out : Q16 output of the last layer (posteriors for SOFTMAX/SIGMOID)
+HCILAB_PUBLIC POWER_DEEPNET_API
+DNN_Result do_forward_prop_fixed(DeepnetFixed* pFixed, const short in[], const int in_q, int out[]);
+
 HCILAB_PUBLIC POWER_DEEPNET_API
 DNN_LAYER_UNIT* DNN_create_layer_unit(Deepnet* pDeepnet);
 HCILAB_PUBLIC POWER_DEEPNET_API
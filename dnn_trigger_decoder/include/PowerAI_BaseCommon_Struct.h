@@ -39,6 +39,15 @@ typedef struct DNN_LAYER_UNIT {
 	float* unit[MAX_NUM_LAYER];	///< pointer to output, dnn_output[0] should be the pointer to input data
 } DNN_LAYER_UNIT;
 
+/** Arguments of a DNN config file, read once by base_loadArguments(). */
+typedef struct {
+	int nLines;
+	char** pszLine;				///< lines as read, for base_findArgumentValueWithoutLowCase()
+	int nArgs;
+	char** pszArg;				///< argument names, lower case
+	char** pszValue;			///< values, lower case as base_getArgumentValue()
+} DNN_ConfigArgs;
+
 /** Structure holding layer pair info for RBM pre-training. */
 typedef struct {
 	short nHidNodes;					///< # of hidden nodes
@@ -53,6 +62,31 @@ typedef struct Deepnet {
 	short nStage;							///< # of layer pairs
 	DNN_Stage dnnStage[MAX_NUM_STAGE];		///< pointer to rbm layer pair
 	DNN_NonLinearUnit nonLinearFunc[MAX_NUM_STAGE];
+	unsigned long long* stageTime;			///< ns per stage added by do_forward_prop(), NULL : not timed
 } Deepnet;
 
+#define DNN_FIXED_LUT_BITS 8
+
+/** Layer pair of the integer network, weight(h,v) = fxWeight[h][v] * rowScale[h] * 2^-(15+rowShift[h]). */
+typedef struct {
+	short nHidNodes;					///< # of hidden nodes
+	short nVisNodes;					///< # of visible nodes
+	signed char* fxWeight;				///< int8 weights, [nHidNodes][nVisNodes]
+	short* rowScale;					///< Q15 mantissa of the row scale
+	short* rowShift;					///< exponent of the row scale
+	int* fxHidBias;						///< Q16 hidden bias
+} DNN_FixedStage;
+
+/** Integer copy of a Deepnet, int8 weights, int16 block floating point activations, int32 accumulation. */
+typedef struct DeepnetFixed {
+	short nStage;								///< # of layer pairs
+	DNN_FixedStage fxStage[MAX_NUM_STAGE];
+	DNN_NonLinearUnit nonLinearFunc[MAX_NUM_STAGE];
+	int sigmoidLut[(1<<DNN_FIXED_LUT_BITS)+1];	///< Q16 sigmoid over [0, 8]
+	int exp2Lut[(1<<DNN_FIXED_LUT_BITS)+1];		///< Q30 2^-x over [0, 1]
+	short* act;									///< int16 layer input (scratch)
+	int* acc;									///< Q16 layer output (scratch)
+	unsigned long long* stageTime;				///< ns per stage added by do_forward_prop_fixed(), NULL : not timed
+} DeepnetFixed;
+
 #endif	// __POWERAI_BASECOMMON_STRUCT_H__
@@ -0,0 +1,44 @@
+/*
+   resampler : streaming polyphase sample rate converter for the trigger input
+
+   Converts any input rate to the 16 kHz of the front end by a rational
+   factor L/M (L = rate_out / gcd, M = rate_in / gcd) with a Kaiser
+   windowed sinc prototype split into L phases of 'taps' coefficients.
+   The delay is taps/2 input samples (about 1.4 ms at 48 kHz).
+   int16 or float32 ([-1, 1]) input, mono or interleaved stereo (averaged),
+   int16 output.
+*/
+
+#ifndef TRG_RESAMPLER_H
+#define TRG_RESAMPLER_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  typedef struct trg_resampler trg_resampler;
+
+  /* NULL when a rate is out of [4000, 192000] */
+  trg_resampler *trg_resampler_create(int rate_in, int rate_out);
+  void trg_resampler_destroy(trg_resampler *rs);
+
+  /* drop the filter history */
+  void trg_resampler_reset(trg_resampler *rs);
+
+  /* upper bound of the output samples of n_in input sample frames */
+  int trg_resampler_max_output(const trg_resampler *rs, int n_in);
+
+  /* filter delay in input sample frames : output n is at input n * rate_in / rate_out - delay */
+  double trg_resampler_delay(const trg_resampler *rs);
+
+  /* n_in sample frames of 'channels' (1 or 2) interleaved samples -> out, returns the output samples */
+  int trg_resampler_process_s16(trg_resampler *rs, const int16_t *in, int n_in, int channels, int16_t *out);
+  int trg_resampler_process_f32(trg_resampler *rs, const float *in, int n_in, int channels, int16_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TRG_RESAMPLER_H
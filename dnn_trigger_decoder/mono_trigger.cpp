@@ -10,12 +10,10 @@
 #include "clog.h"
 #define TRG_CLOG 1
 
-#define MININI_ANSI
-#define INI_READONLY 
-#include "minIni.h"
-
 #include "SizedQueue.h"
+#include "alloc_stats.h"
 
+#include "config.h"
 #include "feat_2pass.h"
 #include "dnn_decoder.h"
 #include "detector_mono.h"
@@ -26,34 +24,39 @@
 #endif
 
 
-CMonoTrigger::CMonoTrigger(const char root_path[], const char config_path[])
+CMonoTrigger::CMonoTrigger(const char root_path[], const char config_path[], const int sample_rate, const int format)
 {
 	char tmp_path[_MAX_PATH] = { 0 };
 	output_frame = -1;
 
-	char ini_config[_MAX_PATH];
-	snprintf(ini_config, sizeof(ini_config), "%s/%s", root_path, config_path);
+	const std::shared_ptr<const CConfig> config = CConfig::open(root_path, config_path);
 
 	// log settings
-	ini_gets("log", "output", "", tmp_path, _MAX_PATH, ini_config);
+	config->gets("log", "output", "", tmp_path, _MAX_PATH);
 	if ('\0' != tmp_path[0])
 	{
 		clog_init_path(TRG_CLOG, tmp_path);
-		clog_set_level(TRG_CLOG, (clog_level)ini_getl("log", "level", CLOG_ERROR, ini_config));
+		clog_set_level(TRG_CLOG, (clog_level)config->getl("log", "level", CLOG_ERROR));
+		if (config->getl("log", "async", 0))
+			clog_set_async(TRG_CLOG, config->getl("log", "async_records", 4096));
 	}
 
+	// input sample rate / format
+	if (initInput(sample_rate, format)) { err = 6001; return; }
+
 	// init feature extractor
 	feat_extractor = new CFeat2pass(root_path);
 	if (feat_extractor->getError()) { err = 1000 + feat_extractor->getError(); return; }
 
 	// init DNN decoder
-	ini_gets("mono", "dnn_ini", "", tmp_path, _MAX_PATH, ini_config);
+	config->gets("mono", "dnn_ini", "", tmp_path, _MAX_PATH);
 	dnn_decoder = new CDnnDecoder(root_path, tmp_path);
 	if (dnn_decoder->getError()) { err = 2000 + dnn_decoder->getError(); return; }
+	if (config->getl("mono", "dnn_fixed", DNN_FIXED_DEFAULT) && dnn_decoder->setFixedPoint(true)) { err = 2004; return; }
 
 	// init word detector
 	auto phon_num = dnn_decoder->getNumOutNode();
-	detector = new CDetectorMono(phon_num, root_path, config_path);
+	detector = new CDetectorMono(phon_num, *config);
 	if (detector->getError()) { err = 3000 + detector->getError(); return; }
 	if (_clog_loggers[TRG_CLOG])
 		detector->setClog(TRG_CLOG);
@@ -97,6 +100,7 @@ int CMonoTrigger::addPhonSeq(const std::string sequence)
 // clear detector to be ready for another sound stream
 bool CMonoTrigger::reset()
 {
+	resetInput();
 	if (feat_extractor)	feat_extractor->reset();
 	if (dnn_decoder)	dnn_decoder->reset();
 	if (detector)	detector->reset();
@@ -116,17 +120,41 @@ int CMonoTrigger::detect(const int len_sample, const int16_t pcm_buf[],int* spin
 		int16_t frame_buf[160];
 		pcm_stream->getItems(160, frame_buf);
 
+		CAllocStats::setStage(CAllocStats::FRONT_END);
 		long len_feat = 0;
 		feat_extractor->getFeature(160, frame_buf, &len_feat, feat_buf);
 
 		for (int i = 2; i < len_feat; i += 51)
 		{
+			CAllocStats::setStage(CAllocStats::DNN);
 			output_frame = dnn_decoder->decode(&feat_buf[i], dnn_prob_output);
+			CAllocStats::setStage(CAllocStats::DETECTOR);
 			auto frame_detected = detector->detect(dnn_prob_output);
 			if (frame_detected)
 				detected_kw = frame_detected;
 		}
+		CAllocStats::setStage(CAllocStats::OTHER);
+	}
+
+	return detected_kw;
+}
+
+
+// replay of recorded feature frames (feature file rows), detect() without the front end
+int CMonoTrigger::detectFeatures(const int num_frames, const float feat[], int* spinfo)
+{
+	int detected_kw = 0;
+
+	for (int n = 0; n < num_frames; n++)
+	{
+		CAllocStats::setStage(CAllocStats::DNN);
+		output_frame = dnn_decoder->decode(&feat[n * 51], dnn_prob_output);
+		CAllocStats::setStage(CAllocStats::DETECTOR);
+		auto frame_detected = detector->detect(dnn_prob_output);
+		if (frame_detected)
+			detected_kw = frame_detected;
 	}
+	CAllocStats::setStage(CAllocStats::OTHER);
 
 	return detected_kw;
 }
@@ -22,11 +22,12 @@ private:
 	SizedQueue* pcm_stream;
 
 public:
-	CMonoTrigger(const char root_path[], const char config_path[]);
+	CMonoTrigger(const char root_path[], const char config_path[], const int sample_rate = 16000, const int format = TRG_SAMPLE_S16);
 	~CMonoTrigger();
 	
 	virtual bool reset();
 	virtual int detect(const int len_sample, const int16_t pcm_buf[],int* spinfo=NULL);
+	virtual int detectFeatures(const int num_frames, const float feat[], int* spinfo=NULL);
 
 	int addPhonSeq(const char sequence[]);
 	int addPhonSeq(const std::string sequence);
@@ -0,0 +1,134 @@
+// prob_ring.cpp
+// Posterior history ring for keyword detectors ([frame][class] layout)
+
+#include "prob_ring.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "pffft.h"
+
+
+// define PROB_RING_SIMD_DISABLE to use scalar code (same vector macros as pffft.c)
+//#define PROB_RING_SIMD_DISABLE
+
+#if !defined(PROB_RING_SIMD_DISABLE) && (defined(__x86_64__) || defined(_M_X64) || defined(i386) || defined(_M_IX86))
+#include <xmmintrin.h>
+typedef __m128 v4sf;
+#  define SIMD_SZ 4
+#  define VZERO() _mm_setzero_ps()
+#  define VADD(a,b) _mm_add_ps(a,b)
+#  define VMAX(a,b) _mm_max_ps(a,b)
+#  define LD_PS1(f) _mm_set1_ps(f)
+#  define VLOAD(p) _mm_load_ps(p)
+#  define VLOADU(p) _mm_loadu_ps(p)
+#  define VSTOREU(p,v) _mm_storeu_ps(p,v)
+#  define VSELECT_LE(a,b,v) _mm_and_ps(_mm_cmple_ps(a,b), v)	// v where a <= b, 0 otherwise
+#elif !defined(PROB_RING_SIMD_DISABLE) && defined(__ARM_NEON)
+#include <arm_neon.h>
+typedef float32x4_t v4sf;
+#  define SIMD_SZ 4
+#  define VZERO() vdupq_n_f32(0)
+#  define VADD(a,b) vaddq_f32(a,b)
+#  define VMAX(a,b) vmaxq_f32(a,b)
+#  define LD_PS1(f) vdupq_n_f32(f)
+#  define VLOAD(p) vld1q_f32(p)
+#  define VLOADU(p) vld1q_f32(p)
+#  define VSTOREU(p,v) vst1q_f32(p,v)
+#  define VSELECT_LE(a,b,v) vreinterpretq_f32_u32(vandq_u32(vcleq_f32(a,b), vreinterpretq_u32_f32(v)))
+#else
+typedef float v4sf;
+#  define SIMD_SZ 1
+#  define VZERO() 0.f
+#  define VADD(a,b) ((a)+(b))
+#  define VMAX(a,b) std::max(a,b)
+#  define LD_PS1(f) (f)
+#  define VLOAD(p) (*(p))
+#  define VLOADU(p) (*(p))
+#  define VSTOREU(p,v) (*(p) = (v))
+#  define VSELECT_LE(a,b,v) ((a) <= (b) ? (v) : 0.f)
+#endif
+
+
+CProbRing::CProbRing(const int frames, const int classes)
+{
+	this->frames = frames;
+	this->classes = classes;
+	stride = (classes + SIMD_SZ - 1) / SIMD_SZ * SIMD_SZ;
+
+	data = (float*)pffft_aligned_malloc(sizeof(float) * frames * stride);
+	clear();
+}
+
+
+CProbRing::~CProbRing()
+{
+	pffft_aligned_free(data);
+}
+
+
+void CProbRing::clear()
+{
+	memset(data, 0, sizeof(float) * frames * stride);
+}
+
+
+void CProbRing::sumRows(const int first, const int last, float out[]) const
+{
+	const float* ring_end = data + frames * stride;
+
+	for (int j = 0; j < stride; j += SIMD_SZ)
+	{
+		v4sf acc = VZERO();
+		const float* p = row(first);
+		for (int f = first; f < last; f++)
+		{
+			acc = VADD(acc, VLOAD(p + j));
+			p += stride;
+			if (p == ring_end)	p = data;
+		}
+		VSTOREU(out + j, acc);
+	}
+}
+
+
+void CProbRing::maxRows(const int first, const int last, float out[]) const
+{
+	const float* ring_end = data + frames * stride;
+	const int first_kept = std::max(first, last - frames);	// older frames are overwritten
+
+	for (int j = 0; j < stride; j += SIMD_SZ)
+	{
+		v4sf acc = VZERO();
+		const float* p = row(first_kept);
+		for (int f = first_kept; f < last; f++)
+		{
+			acc = VMAX(acc, VLOAD(p + j));
+			p += stride;
+			if (p == ring_end)	p = data;
+		}
+		VSTOREU(out + j, acc);
+	}
+}
+
+
+void CProbRing::sumRowsTail(const int last, const float tail_len[], const int max_len, float out[]) const
+{
+	const float* ring_end = data + frames * stride;
+	const int first = std::max(0, last - max_len);
+
+	for (int j = 0; j < stride; j += SIMD_SZ)
+	{
+		v4sf acc = VZERO();
+		const v4sf len = VLOADU(tail_len + j);
+		const float* p = row(first);
+		for (int f = first; f < last; f++)
+		{
+			acc = VADD(acc, VSELECT_LE(LD_PS1((float)(last - f)), len, VLOAD(p + j)));
+			p += stride;
+			if (p == ring_end)	p = data;
+		}
+		VSTOREU(out + j, acc);
+	}
+}
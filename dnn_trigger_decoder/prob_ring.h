@@ -0,0 +1,37 @@
+// prob_ring.h
+// Posterior history ring for keyword detectors ([frame][class] layout)
+
+
+#ifndef __TRIGGER_PROB_RING_H__
+#define __TRIGGER_PROB_RING_H__
+
+
+class CProbRing
+{
+private:
+	float* data;	// frames x stride, rows aligned for SIMD, padding classes stay 0
+	int frames;
+	int classes;
+	int stride;		// classes rounded up to SIMD width
+
+public:
+	CProbRing(const int frames, const int classes);
+	~CProbRing();
+	void clear();
+
+	int getFrames() { return frames; }
+	int getClasses() { return classes; }
+	int getStride() { return stride; }
+
+	// row of a frame counter (frame >= -frames), holds getStride() floats
+	float* row(const int frame) const { return data + ((frame + frames) % frames) * stride; }
+
+	// out[class] = sum of rows [first, last), added from the oldest frame
+	void sumRows(const int first, const int last, float out[]) const;
+	// out[class] = max of rows [first, last)
+	void maxRows(const int first, const int last, float out[]) const;
+	// out[class] = sum of rows [last - tail_len[class], last), tail_len[] holds getStride() lengths <= max_len
+	void sumRowsTail(const int last, const float tail_len[], const int max_len, float out[]) const;
+};
+
+#endif	// __TRIGGER_PROB_RING_H__
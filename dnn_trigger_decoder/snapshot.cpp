@@ -0,0 +1,206 @@
+// snapshot.cpp
+// Startup snapshot, see snapshot.h
+
+#include "snapshot.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+#define SNAPSHOT_MAGIC		"TRGSNAP"
+#define SNAPSHOT_VERSION	1
+
+#ifdef FIXED_POINT_FE
+#define SNAPSHOT_BUILD	(0x100 | (uint32_t)sizeof(void*))
+#else
+#define SNAPSHOT_BUILD	((uint32_t)sizeof(void*))
+#endif
+
+
+struct SnapshotHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t build;		// pointer size, FIXED_POINT_FE
+	uint32_t sections;
+	uint32_t reserved;
+};
+
+struct SnapshotSection
+{
+	uint32_t id;
+	uint32_t reserved;
+	uint64_t offset;	// from the file start, CSnapshot::ALIGN aligned
+	uint64_t size;
+};
+
+
+static uint64_t align_up(const uint64_t n)
+{
+	return (n + CSnapshot::ALIGN - 1) / CSnapshot::ALIGN * CSnapshot::ALIGN;
+}
+
+
+CSnapshot::CSnapshot()
+{
+	map = NULL;
+	map_len = 0;
+#if defined(_WIN32)
+	h_file = INVALID_HANDLE_VALUE;
+	h_map = NULL;
+#endif
+}
+
+
+CSnapshot::~CSnapshot()
+{
+	close();
+}
+
+
+int CSnapshot::open(const char path[])
+{
+	close();
+
+#if defined(_WIN32)
+	h_file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (INVALID_HANDLE_VALUE == h_file)	return -1;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(h_file, &size) || 0 == size.QuadPart) { close(); return -2; }
+	map_len = (size_t)size.QuadPart;
+
+	h_map = CreateFileMappingA(h_file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!h_map) { close(); return -1; }
+	map = MapViewOfFile(h_map, FILE_MAP_READ, 0, 0, 0);
+	if (!map) { close(); return -1; }
+#else
+	const int fd = ::open(path, O_RDONLY);
+	if (fd < 0)	return -1;
+
+	struct stat st;
+	if (0 != fstat(fd, &st) || 0 == st.st_size) { ::close(fd); return -2; }
+	map_len = (size_t)st.st_size;
+
+	map = mmap(NULL, map_len, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (MAP_FAILED == map) { map = NULL; return -1; }
+#endif
+
+	// header and section table of this build, sections inside the file
+	const SnapshotHeader* header = (const SnapshotHeader*)map;
+	if (map_len < sizeof(SnapshotHeader) || memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic))
+		|| SNAPSHOT_VERSION != header->version || SNAPSHOT_BUILD != header->build
+		|| (map_len - sizeof(SnapshotHeader)) / sizeof(SnapshotSection) < header->sections)
+	{
+		close();
+		return -2;
+	}
+
+	const SnapshotSection* section = (const SnapshotSection*)(header + 1);
+	for (uint32_t i = 0; i < header->sections; i++)
+	{
+		if (section[i].offset % ALIGN || map_len < section[i].offset || map_len - section[i].offset < section[i].size)
+		{
+			close();
+			return -2;
+		}
+	}
+
+	this->path = path;
+	return 0;
+}
+
+
+void CSnapshot::close()
+{
+#if defined(_WIN32)
+	if (map)	UnmapViewOfFile(map);
+	if (h_map)	CloseHandle(h_map);
+	if (INVALID_HANDLE_VALUE != h_file)	CloseHandle(h_file);
+	h_map = NULL;
+	h_file = INVALID_HANDLE_VALUE;
+#else
+	if (map)	munmap(map, map_len);
+#endif
+	map = NULL;
+	map_len = 0;
+	path.clear();
+}
+
+
+const void* CSnapshot::find(const int id, long* size) const
+{
+	if (!map)	return NULL;
+
+	const SnapshotHeader* header = (const SnapshotHeader*)map;
+	const SnapshotSection* section = (const SnapshotSection*)(header + 1);
+	for (uint32_t i = 0; i < header->sections; i++)
+	{
+		if ((uint32_t)id != section[i].id)	continue;
+
+		if (size)	*size = (long)section[i].size;
+		return (const char*)map + section[i].offset;
+	}
+	return NULL;
+}
+
+
+void* CSnapshot::add(const int id, const size_t size)
+{
+	pending.push_back(Section());
+	pending.back().id = id;
+	pending.back().data.assign(size, 0);
+	return pending.back().data.data();
+}
+
+
+// header, section table, sections at aligned offsets
+int CSnapshot::save(const char path[])
+{
+	SnapshotHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+	header.version = SNAPSHOT_VERSION;
+	header.build = SNAPSHOT_BUILD;
+	header.sections = (uint32_t)pending.size();
+
+	std::vector<SnapshotSection> table(pending.size());
+	uint64_t offset = align_up(sizeof(SnapshotHeader) + sizeof(SnapshotSection) * pending.size());
+	for (size_t i = 0; i < pending.size(); i++)
+	{
+		table[i].id = (uint32_t)pending[i].id;
+		table[i].reserved = 0;
+		table[i].offset = offset;
+		table[i].size = pending[i].data.size();
+		offset = align_up(offset + table[i].size);
+	}
+
+	FILE* fp = fopen(path, "wb");
+	if (!fp)	return -1;
+
+	static const char zero[ALIGN] = { 0 };
+	bool ok = 1 == fwrite(&header, sizeof(header), 1, fp);
+	if (ok && !table.empty())
+		ok = table.size() == fwrite(table.data(), sizeof(SnapshotSection), table.size(), fp);
+	uint64_t pos = sizeof(SnapshotHeader) + sizeof(SnapshotSection) * table.size();
+	for (size_t i = 0; ok && i < pending.size(); i++)
+	{
+		ok = table[i].offset - pos == fwrite(zero, 1, (size_t)(table[i].offset - pos), fp);
+		if (ok && table[i].size)
+			ok = 1 == fwrite(pending[i].data.data(), (size_t)table[i].size, 1, fp);
+		pos = table[i].offset + table[i].size;
+	}
+
+	if (0 != fclose(fp))	ok = false;
+	return ok ? 0 : -1;
+}
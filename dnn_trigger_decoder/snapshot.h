@@ -0,0 +1,57 @@
+// snapshot.h
+// Startup snapshot : the initialized state of a trigger (config text, front end set-up, DNN weights)
+// in one file of 64-byte aligned sections, mapped read-only and used in place for a warm start
+//
+// the sections are the in-memory layout of this build (struct sizes, pointer size, FIXED_POINT_FE),
+// open() rejects a snapshot written by another build, see CDnnTrigger::saveSnapshot()
+
+
+#ifndef __TRIGGER_SNAPSHOT_H__
+#define __TRIGGER_SNAPSHOT_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+
+class CSnapshot
+{
+public:
+	enum SectionId { CONFIG = 1, FE_16K, FE_8K, DNN, VERIFIER_DNN };
+	enum { ALIGN = 64 };
+
+private:
+	void* map;
+	size_t map_len;
+#if defined(_WIN32)
+	void* h_file;
+	void* h_map;
+#endif
+	std::string path;
+
+	struct Section
+	{
+		int id;
+		std::vector<char> data;
+	};
+	std::vector<Section> pending;	// sections added for save()
+
+public:
+	CSnapshot();
+	~CSnapshot();
+
+	int open(const char path[]);	// 0, -1 cannot map, -2 not a snapshot of this build
+	void close();
+	const char* getPath() const { return path.c_str(); }
+
+	// section in the mapped file, NULL if there isn't
+	const void* find(const int id, long* size) const;
+
+	// writer : zero-filled buffer of a section to fill, valid until the next add()
+	void* add(const int id, const size_t size);
+	int save(const char path[]);	// 0, -1 cannot write
+};
+
+#endif	// __TRIGGER_SNAPSHOT_H__
@@ -17,6 +17,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 {
 	int idx_layer = 0, idx_stage = 0;
 	FILE* fpConfig = 0;
+	DNN_ConfigArgs args;
 	char szArg[MAXSTRLEN] = {0};
 	char szValue[MAXSTRLEN] = {0};
 
@@ -29,9 +30,13 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 	}
 
 	if (!fpConfig) { printf(" (Cannot open config file: %s) ", szConfig); return FAIL; }
+
+	// read once, the arguments are looked up in memory
+	if (base_loadArguments(&args, fpConfig) != SUCCESS) { fclose(fpConfig); printf(" (Cannot read config file: %s) ", szConfig); return FAIL; }
+	fclose(fpConfig);
 	
 	sprintf(szArg,"TASK_TYPE");
-	if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+	if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 	if(!strcmp(szValue,"train")) pDnnResource->taskType = TRAIN;
 	else if(!strcmp(szValue,"test")) pDnnResource->taskType = TEST;
 	else if(!strcmp(szValue,"svd")) pDnnResource->taskType = SVD;
@@ -40,7 +45,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 
 	
 	sprintf(szArg,"FEAT_DIM");
-	if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+	if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 	{
 		int tmp = atoi(szValue);
 		if(tmp == 0) goto CONFIG_FAIL;
@@ -49,7 +54,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		
 
 	sprintf(szArg,"FRAME_CONCAT_BEFORE");
-	if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+	if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 	{
 		int tmp = atoi(szValue);
 		if(tmp == 0) goto CONFIG_FAIL;
@@ -57,7 +62,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 	}
 		
 	sprintf(szArg, "FRAME_CONCAT_AFTER");
-	if (base_getArgumentValue(szArg, szValue, fpConfig) != SUCCESS) goto CONFIG_FAIL;
+	if (base_findArgumentValue(szArg, szValue, &args) != SUCCESS) goto CONFIG_FAIL;
 	{
 		int tmp = atoi(szValue);
 		if (tmp == 0) goto CONFIG_FAIL;
@@ -68,7 +73,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 	}
 		
 	sprintf(szArg,"NUM_HID_NODES");
-	if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+	if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 	{
 		char sz_Num[10] = {0};
 		char* psz_Val = szValue;
@@ -90,7 +95,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 	}
 		
 	sprintf(szArg,"NUM_CLASS");
-	if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+	if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 	{
 		int tmp = atoi(szValue);
 		if(tmp == 0) goto CONFIG_FAIL;
@@ -99,7 +104,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 	}
 		
 	sprintf(szArg,"NUM_LAYER");
-	if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+	if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 	{
 		int tmp = atoi(szValue);
 		if(tmp == 0) goto CONFIG_FAIL;
@@ -107,7 +112,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 	}
 
 	sprintf(szArg,"NON_LINEAR_FUNC");
-	if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+	if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 	{
 		char sz_Func[10] = {0};
 		char* psz_Val = szValue;
@@ -153,7 +158,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 	case TRAIN:
 #if 0		
 		sprintf(szArg,"USE_GPU");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) 
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) 
 		{printf("Default %s option = yes\n",szArg); pDnnResource->dnnTrainParam.bUseGPU = 1;}
 		else{
 			if(!strcmp(szValue,"yes")) {
@@ -167,14 +172,14 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 
 	
 		sprintf(szArg,"MOMENTUM_ALPHA");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			float tmp = atof(szValue);		
 			pDnnResource->dnnTrainParam.alpha = tmp;
 		}
 
 		sprintf(szArg,"USE_FANINOUT_INIT");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS)
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS)
 		{printf("Default %s option = yes\n",szArg); pDnnResource->dnnTrainParam.bUseFanInOutInit = 1;}
 		else{		
 			if(!strcmp(szValue,"yes")) {
@@ -187,7 +192,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		}
 	
 		sprintf(szArg,"DO_SHUFFLE");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) 
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) 
 		{printf("Default %s option = yes\n",szArg); pDnnResource->dnnTrainParam.bShuffle = 1;}
 		else{		
 			if(!strcmp(szValue,"yes")) {
@@ -200,7 +205,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		}
 	
 		sprintf(szArg,"USE_DROPOUT");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) 
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) 
 		{printf("Default %s option = no\n",szArg); pDnnResource->dnnTrainParam.bUseDropOut = 0;}
 		else{
 			if(!strcmp(szValue,"yes")) {
@@ -213,7 +218,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		}
 	
 		sprintf(szArg,"ERR_CHK_LR_CHANGE_ITER");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			int tmp = atoi(szValue);
 			if(tmp == 0) goto CONFIG_FAIL;
@@ -221,7 +226,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		}
 	
 		sprintf(szArg,"LR");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			float tmp = atof(szValue);
 			if(tmp < 0 || tmp > 1) goto CONFIG_FAIL;
@@ -229,7 +234,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		}
 	
 		sprintf(szArg,"LR_SUSTAIN_ITER");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			int tmp = atoi(szValue);
 			if(tmp < 0) goto CONFIG_FAIL;
@@ -237,7 +242,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		}
 	
 		sprintf(szArg,"LR_REDUCE_RATIO");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			float tmp = atof(szValue);
 			if(tmp < 0 || tmp > 1) goto CONFIG_FAIL;
@@ -245,7 +250,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		}
 	
 		sprintf(szArg,"MIN_LR");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			float tmp = atof(szValue);
 			if(tmp < 0 || tmp > 1) goto CONFIG_FAIL;
@@ -253,7 +258,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		}
 	
 		sprintf(szArg,"MAX_EPOCH");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			int tmp = atoi(szValue);
 			if(tmp == 0) goto CONFIG_FAIL;
@@ -261,7 +266,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		}
 	
 		sprintf(szArg,"MINI_BATCH_SIZE");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			int tmp = atoi(szValue);
 			if(tmp == 0) goto CONFIG_FAIL;
@@ -270,12 +275,12 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		
 		if(pDnnResource->dnnTrainParam.bUseGPU == 1){
 			sprintf(szArg,"USE_W_MAX_NORM");
-			if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+			if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 			{
 				if(!strcmp(szValue,"yes")) {
 					pDnnResource->dnnTrainParam.bMaxNorm = 1;
 					sprintf(szArg,"W_MAX_NORM_CONST");
-					if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+					if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 					{
 						float tmp = atof(szValue);
 						if(tmp < 0) goto CONFIG_FAIL;
@@ -292,7 +297,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		
 		if(pDnnResource->dnnTrainParam.bUseGPU == 1){
 			sprintf(szArg,"USE_GRAD_CLASS_NORM");
-			if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+			if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 			{
 				if(!strcmp(szValue,"yes")) {
 					pDnnResource->dnnTrainParam.bGradClassNorm = 1;					
@@ -305,7 +310,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		}
 		
 		sprintf(szArg,"DATA_PATH");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			char tmp[MAXSTRLEN] = {0};
 			sprintf(tmp,"%s",szValue);
@@ -315,14 +320,14 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		}
 	
 		sprintf(szArg,"TRAIN_LIST_FILE");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			if(szValue[0] == 0) goto CONFIG_FAIL;
 			sprintf(pDnnResource->dnnTrainParam.szTrainList, "%s", szValue);
 		}
 	
 		sprintf(szArg,"LABEL_PATH");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			char tmp[MAXSTRLEN] = {0};
 			sprintf(tmp,"%s",szValue);
@@ -332,21 +337,21 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		}
 	
 		sprintf(szArg,"LABEL_EXT");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			if(szValue[0] == 0) goto CONFIG_FAIL;
 			sprintf(pDnnResource->dnnTrainParam.szLableExt, "%s", szValue);
 		}
 	
 		sprintf(szArg,"DNN_SAVE_FILE_NAME");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			if(szValue[0] == 0) goto CONFIG_FAIL;
 			sprintf(pDnnResource->dnnTrainParam.szDnnSaveFileName, "%s", szValue);
 		}
 	
 		sprintf(szArg,"DO_PRINT_TEST_RESULT_TO_CONSOLE");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) 
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) 
 		{printf("Default %s option = no\n",szArg); pDnnResource->dnnTrainParam.bPrintTestResultToConsole = 0;}
 		else{
 			if(!strcmp(szValue,"yes")) {
@@ -359,7 +364,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		}
 	
 		sprintf(szArg,"ERR_MEASURE_FUNC");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			if(!strcmp(szValue,"sqrerr")) {
 				pDnnResource->dnnTrainParam.errMeasureFunc = SQRERR;
@@ -372,7 +377,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 #endif
 /*
 		sprintf(szArg,"USE_SEED_DNN");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			if(!strcmp(szValue,"yes")) {
 				pDnnResource->bUseSeedDnn = 1;
@@ -388,7 +393,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		sprintf(pDnnResource->szSeedDnnFile, "%s", szValue);
 */
 		sprintf(szArg,"USE_SEED_DNN");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			if(!strcmp(szValue,"yes")) {
 				pDnnResource->bUseSeedDnn = 1;
@@ -401,44 +406,44 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		}
 
 		sprintf(szArg,"SEED_DNN_FILE");
-		if (base_getArgumentValueWithoutLowCase(szArg, szValue, fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if (base_findArgumentValueWithoutLowCase(szArg, szValue, &args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			sprintf(pDnnResource->szSeedDnnFile, "%s", szValue);
 			if(pDnnResource->bUseSeedDnn && szValue[0] == 0) goto CONFIG_FAIL;
 		}
 
 		sprintf(szArg,"DEV_TEST_LIST");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			if(szValue[0] == 0) goto CONFIG_FAIL;
 			sprintf(pDnnResource->testDevResource.szTestList, "%s", szValue);
 		}
 		sprintf(szArg,"DEV_CONFMAT");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			if(szValue[0] == 0) goto CONFIG_FAIL;
 			sprintf(pDnnResource->testDevResource.szConfMatLogFile, "%s", szValue);
 		}
 		sprintf(szArg,"DEV_TOT_ERR_LOG");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			if(szValue[0] == 0) goto CONFIG_FAIL;
 			sprintf(pDnnResource->testDevResource.szTotErrLogFile, "%s", szValue);
 		}
 		sprintf(szArg,"VALI_TEST_LIST");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			if(szValue[0] == 0) goto CONFIG_FAIL;
 			sprintf(pDnnResource->testValiResource.szTestList, "%s", szValue);
 		}
 		sprintf(szArg,"VALI_CONFMAT");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			if(szValue[0] == 0) goto CONFIG_FAIL;
 			sprintf(pDnnResource->testValiResource.szConfMatLogFile, "%s", szValue);
 		}
 		sprintf(szArg,"VALI_TOT_ERR_LOG");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			if(szValue[0] == 0) goto CONFIG_FAIL;
 			sprintf(pDnnResource->testValiResource.szTotErrLogFile, "%s", szValue);
@@ -446,7 +451,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		break;
 	case TEST:
 		sprintf(szArg,"USE_DROPOUT");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			if(!strcmp(szValue,"yes")) {
 				pDnnResource->dnnTrainParam.bUseDropOut = 1;
@@ -458,7 +463,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		}
 
 		sprintf(szArg,"DATA_PATH");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			char tmp[MAXSTRLEN] = {0};
 			sprintf(tmp,"%s",szValue);
@@ -468,7 +473,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		}
 	
 		sprintf(szArg,"LABEL_PATH");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			char tmp[MAXSTRLEN] = {0};
 			sprintf(tmp,"%s",szValue);
@@ -478,14 +483,14 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		}
 	
 		sprintf(szArg,"LABEL_EXT");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			if(szValue[0] == 0) goto CONFIG_FAIL;
 			sprintf(pDnnResource->dnnTrainParam.szLableExt, "%s", szValue);
 		}
 	
 		sprintf(szArg,"DO_PRINT_TEST_RESULT_TO_CONSOLE");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			if(!strcmp(szValue,"yes")) {
 				pDnnResource->dnnTrainParam.bPrintTestResultToConsole = 1;
@@ -497,7 +502,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		}
 	
 		sprintf(szArg,"USE_GPU");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			if(!strcmp(szValue,"yes")) {
 				pDnnResource->dnnTrainParam.bUseGPU = 1;
@@ -509,12 +514,12 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		}
 
 		sprintf(szArg,"USE_SEED_DNN");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			if(!strcmp(szValue,"yes")) {
 				pDnnResource->bUseSeedDnn = 1;
 				sprintf(szArg,"SEED_DNN_FILE");
-				if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+				if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 				{
 					if(szValue[0] == 0) goto CONFIG_FAIL;
 					sprintf(pDnnResource->szSeedDnnFile, "%s", szValue);
@@ -527,19 +532,19 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		}
 
 		sprintf(szArg,"VALI_TEST_LIST");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			if(szValue[0] == 0) goto CONFIG_FAIL;
 			sprintf(pDnnResource->testValiResource.szTestList, "%s", szValue);
 		}
 		sprintf(szArg,"VALI_CONFMAT");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			if(szValue[0] == 0) goto CONFIG_FAIL;
 			sprintf(pDnnResource->testValiResource.szConfMatLogFile, "%s", szValue);
 		}
 		sprintf(szArg,"VALI_TOT_ERR_LOG");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			if(szValue[0] == 0) goto CONFIG_FAIL;
 			sprintf(pDnnResource->testValiResource.szTotErrLogFile, "%s", szValue);
@@ -549,7 +554,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 	case SVD:
 //		int idx_layer_svd = 1, idx_stage_svd = 0;//org
 		sprintf(szArg,"SVD_K");		
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			int idx_layer_svd = 1, idx_stage_svd = 0;//yowon 2015-05-12
 
@@ -575,19 +580,19 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 
 		
 		sprintf(szArg,"DNN_SAVE_FILE_NAME");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			if(szValue[0] == 0) goto CONFIG_FAIL;
 			sprintf(pDnnResource->dnnTrainParam.szDnnSaveFileName, "%s", szValue);
 		}
 		
 		sprintf(szArg,"USE_SEED_DNN");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			if(!strcmp(szValue,"yes")) {
 				pDnnResource->bUseSeedDnn = 1;
 				sprintf(szArg,"SEED_DNN_FILE");
-				if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+				if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 				{
 					if(szValue[0] == 0) goto CONFIG_FAIL;
 					sprintf(pDnnResource->szSeedDnnFile, "%s", szValue);
@@ -605,7 +610,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 //yowon 2015-05-12  dnn 𵨿 output    
 	case MODEL_MAKE: 
 		sprintf(szArg,"USE_GPU");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) 
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) 
 		{printf("Default %s option = yes\n",szArg); pDnnResource->dnnTrainParam.bUseGPU = 1;}
 		else{
 			if(!strcmp(szValue,"yes")) {
@@ -619,12 +624,12 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 	
 		if(pDnnResource->dnnTrainParam.bUseGPU == 1){
 			sprintf(szArg,"USE_W_MAX_NORM");
-			if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+			if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 			{
 				if(!strcmp(szValue,"yes")) {
 					pDnnResource->dnnTrainParam.bMaxNorm = 1;
 					sprintf(szArg,"W_MAX_NORM_CONST");
-					if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+					if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 					{
 						float tmp = atof(szValue);
 						if(tmp < 0) goto CONFIG_FAIL;
@@ -641,7 +646,7 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		
 		if(pDnnResource->dnnTrainParam.bUseGPU == 1){
 			sprintf(szArg,"USE_GRAD_CLASS_NORM");
-			if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+			if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 			{
 				if(!strcmp(szValue,"yes")) {
 					pDnnResource->dnnTrainParam.bGradClassNorm = 1;					
@@ -654,14 +659,14 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		}
 		
 		sprintf(szArg,"DNN_SAVE_FILE_NAME");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			if(szValue[0] == 0) goto CONFIG_FAIL;
 			sprintf(pDnnResource->dnnTrainParam.szDnnSaveFileName, "%s", szValue);
 		}
 	
 		sprintf(szArg,"DO_PRINT_TEST_RESULT_TO_CONSOLE");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) 
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) 
 		{printf("Default %s option = no\n",szArg); pDnnResource->dnnTrainParam.bPrintTestResultToConsole = 0;}
 		else{
 			if(!strcmp(szValue,"yes")) {
@@ -674,12 +679,12 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		}
 	
 		sprintf(szArg,"USE_SEED_DNN");
-		if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+		if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 		{
 			if(!strcmp(szValue,"yes")) {
 				pDnnResource->bUseSeedDnn = 1;
 				sprintf(szArg,"SEED_DNN_FILE");
-				if(base_getArgumentValue(szArg,szValue,fpConfig) != SUCCESS) goto CONFIG_FAIL;
+				if(base_findArgumentValue(szArg,szValue,&args) != SUCCESS) goto CONFIG_FAIL;
 				{
 					if(szValue[0] == 0) goto CONFIG_FAIL;
 					sprintf(pDnnResource->szSeedDnnFile, "%s", szValue);
@@ -693,11 +698,11 @@ DNN_Result DNN_LoadConfig(DNN_Resource* pDnnResource, const char* szHomeDir, con
 		break;
 	}
 
-	fclose(fpConfig);
+	base_freeArguments(&args);
 	return SUCCESS;
 
 CONFIG_FAIL:
-	fclose(fpConfig);
+	base_freeArguments(&args);
 	printf(" (Argument error: %s) ",szArg);
 	return FAIL;
 }
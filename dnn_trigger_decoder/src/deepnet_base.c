@@ -161,6 +161,109 @@ DNN_Result base_getArgumentValue(const char* pszArg, char* pValue, FILE* fpConfi
 	return FAIL;
 }
 
+static char* base_strdup(const char* string) {
+	char* copy = (char*)malloc(strlen(string) + 1);
+	if (copy) strcpy(copy, string);
+	return copy;
+}
+
+HCILAB_PUBLIC POWER_DEEPNET_API
+DNN_Result base_loadArguments(DNN_ConfigArgs* pArgs, FILE* fpConfig) {
+	char sz_line[MAXSTRLEN] = {0};
+	char sz_alg[MAXSTRLEN] = {0};
+	char sz_value[MAXSTRLEN] = {0};
+	int nAlloc = 0;
+
+	memset(pArgs, 0, sizeof(DNN_ConfigArgs));
+
+	fseek(fpConfig, 0, SEEK_SET);
+
+	while(fgets(sz_line, MAXSTRLEN, fpConfig) != NULL){
+		if (pArgs->nLines == nAlloc) {
+			char** pszLine;
+			char** pszArg;
+			char** pszValue;
+			nAlloc = nAlloc ? 2 * nAlloc : 64;
+			pszLine = (char**)realloc(pArgs->pszLine, nAlloc * sizeof(char*));
+			if (pszLine) pArgs->pszLine = pszLine;
+			pszArg = (char**)realloc(pArgs->pszArg, nAlloc * sizeof(char*));
+			if (pszArg) pArgs->pszArg = pszArg;
+			pszValue = (char**)realloc(pArgs->pszValue, nAlloc * sizeof(char*));
+			if (pszValue) pArgs->pszValue = pszValue;
+			if (!pszLine || !pszArg || !pszValue) { base_freeArguments(pArgs); return FAIL; }
+		}
+
+		pArgs->pszLine[pArgs->nLines] = base_strdup(sz_line);
+		if (!pArgs->pszLine[pArgs->nLines]) { base_freeArguments(pArgs); return FAIL; }
+		pArgs->nLines++;
+
+		trimLowerCase(sz_line);
+		if(sz_line[0] == 0 || sz_line[0] == 10 ) continue;
+		splitArg(sz_line, sz_alg, sz_value);
+
+		pArgs->pszArg[pArgs->nArgs] = base_strdup(sz_alg);
+		pArgs->pszValue[pArgs->nArgs] = base_strdup(sz_value);
+		pArgs->nArgs++;
+		if (!pArgs->pszArg[pArgs->nArgs - 1] || !pArgs->pszValue[pArgs->nArgs - 1]) { base_freeArguments(pArgs); return FAIL; }
+	}
+	return SUCCESS;
+}
+
+HCILAB_PUBLIC POWER_DEEPNET_API
+DNN_Result base_findArgumentValue(const char* pszArg, char* pValue, const DNN_ConfigArgs* pArgs) {
+	char sz_arg[MAXSTRLEN] = { 0 };
+	int i;
+
+	pValue[0] = '\0';
+
+	strcpy(sz_arg, pszArg);
+	trimLowerCase(sz_arg);
+
+	for (i = 0; i < pArgs->nArgs; i++) {	// first match, as the file scan
+		if (!strcmp(sz_arg, pArgs->pszArg[i])) {
+			strcpy(pValue, pArgs->pszValue[i]);
+			return SUCCESS;
+		}
+	}
+	return FAIL;
+}
+
+HCILAB_PUBLIC POWER_DEEPNET_API
+DNN_Result base_findArgumentValueWithoutLowCase(char* pszArg, char* pValue, const DNN_ConfigArgs* pArgs) {
+	char sz_line[MAXSTRLEN] = { 0 };
+	char sz_alg[MAXSTRLEN] = { 0 };
+	char sz_value[MAXSTRLEN] = { 0 };
+	int i;
+
+	trim(pszArg);
+
+	for (i = 0; i < pArgs->nLines; i++) {
+		strcpy(sz_line, pArgs->pszLine[i]);
+		trim(sz_line);
+		if (sz_line[0] == 0 || sz_line[0] == 10) continue;
+		splitArg(sz_line, sz_alg, sz_value);
+		if (!strcmp(pszArg, sz_alg)){
+			strcpy(pValue, sz_value);
+			return SUCCESS;
+		}
+	}
+	return FAIL;
+}
+
+HCILAB_PUBLIC POWER_DEEPNET_API
+void base_freeArguments(DNN_ConfigArgs* pArgs) {
+	int i;
+	for (i = 0; i < pArgs->nLines; i++)
+		free(pArgs->pszLine[i]);
+	for (i = 0; i < pArgs->nArgs; i++) {
+		free(pArgs->pszArg[i]);
+		free(pArgs->pszValue[i]);
+	}
+	free(pArgs->pszLine);
+	free(pArgs->pszArg);
+	free(pArgs->pszValue);
+	memset(pArgs, 0, sizeof(DNN_ConfigArgs));
+}
 
 #if 0//yowon 2015-03-20
 int base_compare(const void *a , const void *b){
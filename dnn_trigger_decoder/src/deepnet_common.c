@@ -16,6 +16,7 @@
 
 #include "PowerAI_BaseCommon_Struct.h"
 #include "PowerAI_BaseCommon.h"
+#include "base/hci_clock.h"
 
 
 #define DNN_ALN 64
@@ -161,10 +162,58 @@ DNN_Result DNN_destroy_layer_unit(DNN_LAYER_UNIT* p_dnn_output) {
 }
 
 
+// apply the non-linearity of a stage in place
+static DNN_Result _DNN_activate(const DNN_NonLinearUnit func, float *out, const int n_hid) {
+	switch (func) {
+		case SIGMOID: {
+			for (int idx_h = 0; idx_h < n_hid; idx_h++) {
+				out[idx_h] = DNN_sigmoid(out[idx_h]);
+			}
+		} break;
+		case RELU: {
+			for (int idx_h = 0; idx_h < n_hid; idx_h++) {
+				out[idx_h] = DNN_ReLU(out[idx_h]);
+			}
+		} break;
+		case LINEAR: {
+			// do nothing
+		} break;
+		case SOFTMAX: {
+			float f_max = 0.f;	//yowon 2015-03-23
+			for (int idx_h = 0; idx_h < n_hid; idx_h++) {
+				if (out[idx_h] > f_max)
+					f_max = out[idx_h];
+			}
+
+			float denom = 0.f;
+			for (int idx_h = 0; idx_h < n_hid; idx_h++) {
+				if (out[idx_h] > f_max-10.0f) {
+					out[idx_h] = expf(out[idx_h]-f_max);
+				}
+				else {
+					out[idx_h] = 0;
+				}
+				denom += out[idx_h];
+			}
+			denom = 1/denom;
+			for (int idx_h = 0; idx_h < n_hid; idx_h++) {
+				out[idx_h] *= denom;
+			}
+		} break;
+		default: {
+			return FAIL;
+		}
+	}
+	return SUCCESS;
+}
+
 HCILAB_PUBLIC POWER_DEEPNET_API
 DNN_Result do_forward_prop(Deepnet* pDeepnet, DNN_LAYER_UNIT* p_dnn_output) {
 	const short n_stage = pDeepnet->nStage;
 	DNN_NonLinearUnit* nonLinearFunc = pDeepnet->nonLinearFunc;
+	unsigned long long t_stage = 0;
+
+	if (pDeepnet->stageTime)	HCI_STAGE_START(t_stage);
 
 	for (int i = 0; i < n_stage; i++) {
 		const DNN_Stage* pDnnStage = &pDeepnet->dnnStage[i];
@@ -184,47 +233,69 @@ DNN_Result do_forward_prop(Deepnet* pDeepnet, DNN_LAYER_UNIT* p_dnn_output) {
 			output_alt[idx_h] = temp;
 		}
 
-		switch (nonLinearFunc[i]) {
-			case SIGMOID: {
-				for (int idx_h = 0; idx_h < n_hid; idx_h++) {
-					output_alt[idx_h] = DNN_sigmoid(output_alt[idx_h]);
-				}
-			} break;
-			case RELU: {
-				for (int idx_h = 0; idx_h < n_hid; idx_h++) {
-					output_alt[idx_h] = DNN_ReLU(output_alt[idx_h]);
-				}
-			} break;
-			case LINEAR: {
-				// do nothing
-			} break;
-			case SOFTMAX: {
-				float f_max = 0.f;	//yowon 2015-03-23
-				for (int idx_h = 0; idx_h < n_hid; idx_h++) {
-					if (output_alt[idx_h] > f_max)
-						f_max = output_alt[idx_h];
-				}
+		if (_DNN_activate(nonLinearFunc[i], output_alt, n_hid) != SUCCESS)
+			return FAIL;
 
-				float denom = 0.f;
-				for (int idx_h = 0; idx_h < n_hid; idx_h++) {
-					if (output_alt[idx_h] > f_max-10.0f) {
-						output_alt[idx_h] = expf(output_alt[idx_h]-f_max);
-					}
-					else {
-						output_alt[idx_h] = 0;
-					}
-					denom += output_alt[idx_h];
+		if (pDeepnet->stageTime)	HCI_STAGE_TIME(pDeepnet->stageTime[i], t_stage);
+	}
+	return SUCCESS;
+}
+
+// do_forward_prop for n_batch inputs (p_dnn_output[b]->unit[0]) through the same network,
+// the weights of a row are loaded once for up to 4 inputs
+HCILAB_PUBLIC POWER_DEEPNET_API
+DNN_Result do_forward_prop_batch(Deepnet* pDeepnet, DNN_LAYER_UNIT* const p_dnn_output[], const int n_batch) {
+	const short n_stage = pDeepnet->nStage;
+	DNN_NonLinearUnit* nonLinearFunc = pDeepnet->nonLinearFunc;
+	unsigned long long t_stage = 0;
+
+	if (pDeepnet->stageTime)	HCI_STAGE_START(t_stage);
+
+	for (int i = 0; i < n_stage; i++) {
+		const DNN_Stage* pDnnStage = &pDeepnet->dnnStage[i];
+		const int n_hid = (int)pDnnStage->nHidNodes;
+		const int n_vis = (int)pDnnStage->nVisNodes;
+
+		int b = 0;
+		for (; b + 4 <= n_batch; b += 4) {
+			const float *in0 = p_dnn_output[b]->unit[i], *in1 = p_dnn_output[b+1]->unit[i];
+			const float *in2 = p_dnn_output[b+2]->unit[i], *in3 = p_dnn_output[b+3]->unit[i];
+
+			for (int idx_h = 0; idx_h < n_hid; idx_h++) {
+				const float *weight = &pDnnStage->dnnWeight[idx_h * n_vis];
+				float t0 = 0.f, t1 = 0.f, t2 = 0.f, t3 = 0.f;
+				for (int idx_v = 0; idx_v < n_vis; idx_v++) {
+					const float w = weight[idx_v];
+					t0 += w * in0[idx_v];
+					t1 += w * in1[idx_v];
+					t2 += w * in2[idx_v];
+					t3 += w * in3[idx_v];
 				}
-				denom = 1/denom;
-				for (int idx_h = 0; idx_h < n_hid; idx_h++) {
-					output_alt[idx_h] *= denom;
+				p_dnn_output[b]->unit[i+1][idx_h] = t0 + pDnnStage->dnnHidBias[idx_h];
+				p_dnn_output[b+1]->unit[i+1][idx_h] = t1 + pDnnStage->dnnHidBias[idx_h];
+				p_dnn_output[b+2]->unit[i+1][idx_h] = t2 + pDnnStage->dnnHidBias[idx_h];
+				p_dnn_output[b+3]->unit[i+1][idx_h] = t3 + pDnnStage->dnnHidBias[idx_h];
+			}
+		}
+		for (; b < n_batch; b++) {
+			const float *input_alt = p_dnn_output[b]->unit[i];
+			float *output_alt = p_dnn_output[b]->unit[i+1];
+
+			for (int idx_h = 0; idx_h < n_hid; idx_h++) {
+				float temp = 0.f;
+				for (int idx_v = 0; idx_v < n_vis; idx_v++){
+					temp += pDnnStage->dnnWeight[idx_h * n_vis + idx_v] * input_alt[idx_v];
 				}
-			} break;
-			default: {
-				return FAIL;
+				output_alt[idx_h] = temp + pDnnStage->dnnHidBias[idx_h];
 			}
 		}
 
+		for (b = 0; b < n_batch; b++) {
+			if (_DNN_activate(nonLinearFunc[i], p_dnn_output[b]->unit[i+1], n_hid) != SUCCESS)
+				return FAIL;
+		}
+
+		if (pDeepnet->stageTime)	HCI_STAGE_TIME(pDeepnet->stageTime[i], t_stage);
 	}
 	return SUCCESS;
 }
@@ -0,0 +1,274 @@
+/* ====================================================================
+ * Copyright (c) 2014 DIOTEK co., ltd.
+ * ALL RIGHTS RESERVED.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are prohibited provided that permissions by DIOTEK co., ltd.
+ * are not given.
+ *
+ * ====================================================================
+ *
+ */
+
+// Integer forward propagation for targets without a fast FPU
+// int8 weights with a per-row scale, int16 block floating point layer inputs, int32 accumulation,
+// Q16 layer outputs. Floating point is only used by DNN_fixed_create() to quantize a loaded Deepnet.
+
+#include <limits.h>
+#include <math.h>
+#include <memory.h>
+#include <stdlib.h>
+
+#include "PowerAI_BaseCommon_Struct.h"
+#include "PowerAI_BaseCommon.h"
+#include "base/hci_clock.h"
+
+
+#define DNN_FIXED_CHUNK 256		// int32 partial sums of 256 products : 256 * 127 * 32767 < 2^31
+#define DNN_FIXED_LOG2E 94548	// log2(e) in Q16
+#define DNN_FIXED_LUT_SIZE (1<<DNN_FIXED_LUT_BITS)
+
+
+static int _DNN_fixed_sat32(const long long x) {
+	return (x > INT_MAX) ? INT_MAX : ((x < INT_MIN) ? INT_MIN : (int)x);
+}
+
+// y (Q(y_q)) -> x with |x| < 2^15 at the best precision, return the Q of x
+static int _DNN_fixed_normalize(const int* y, const int n, const int y_q, short* x) {
+	unsigned int m = 0;
+	for (int i = 0; i < n; i++) {
+		const unsigned int a = (y[i] < 0) ? 0u - (unsigned int)y[i] : (unsigned int)y[i];
+		if (a > m) m = a;
+	}
+	if (0 == m) {
+		memset(x, 0, n * sizeof(x[0]));
+		return y_q;
+	}
+
+	int bits = 0;
+	while (bits < 32 && (m >> bits) != 0) bits++;
+	const int s = bits - 15;
+
+	if (s > 0) {
+		for (int i = 0; i < n; i++) {
+			const long long r = ((long long)y[i] + (1LL << (s-1))) >> s;
+			x[i] = (short)((r > SHRT_MAX) ? SHRT_MAX : r);
+		}
+	}
+	else {
+		for (int i = 0; i < n; i++)
+			x[i] = (short)(y[i] * (1 << -s));
+	}
+	return y_q - s;
+}
+
+// Q16 x -> Q16 table value, t sampled over [0, range) in DNN_FIXED_LUT_SIZE steps, range = 2^range_bits
+static int _DNN_fixed_lut(const int* t, const int x, const int range_bits) {
+	const int frac_bits = 16 + range_bits - DNN_FIXED_LUT_BITS;
+	const int idx = x >> frac_bits;
+	const int frac = x & ((1 << frac_bits) - 1);
+	return t[idx] + (int)(((long long)(t[idx+1] - t[idx]) * frac) >> frac_bits);
+}
+
+// apply the non-linearity of a stage in place on Q16 values
+static DNN_Result _DNN_fixed_activate(const DeepnetFixed* pFixed, const DNN_NonLinearUnit func, int *out, const int n_hid) {
+	switch (func) {
+		case SIGMOID: {
+			for (int idx_h = 0; idx_h < n_hid; idx_h++) {
+				const int a = (out[idx_h] < 0) ? -out[idx_h] : out[idx_h];
+				const int s = (a >= (8<<16) || a < 0) ? 65536 : _DNN_fixed_lut(pFixed->sigmoidLut, a, 3);
+				out[idx_h] = (out[idx_h] < 0) ? 65536 - s : s;
+			}
+		} break;
+		case RELU: {
+			for (int idx_h = 0; idx_h < n_hid; idx_h++) {
+				if (out[idx_h] < 0) out[idx_h] = 0;
+			}
+		} break;
+		case LINEAR: {
+			// do nothing
+		} break;
+		case SOFTMAX: {
+			int f_max = 0;	// as the float version
+			for (int idx_h = 0; idx_h < n_hid; idx_h++) {
+				if (out[idx_h] > f_max)
+					f_max = out[idx_h];
+			}
+
+			// exp(y - max) = 2^-((max - y) * log2(e)), Q30
+			long long denom = 0;
+			for (int idx_h = 0; idx_h < n_hid; idx_h++) {
+				const long long d = (long long)f_max - out[idx_h];
+				if (d < (10LL<<16)) {
+					const int t = (int)((d * DNN_FIXED_LOG2E) >> 16);
+					out[idx_h] = _DNN_fixed_lut(pFixed->exp2Lut, t & 0xFFFF, 0) >> (t >> 16);
+				}
+				else {
+					out[idx_h] = 0;
+				}
+				denom += out[idx_h];
+			}
+			for (int idx_h = 0; idx_h < n_hid; idx_h++) {
+				out[idx_h] = (denom > 0) ? (int)(((long long)out[idx_h] << 16) / denom) : 0;
+			}
+		} break;
+		default: {
+			return FAIL;
+		}
+	}
+	return SUCCESS;
+}
+
+HCILAB_PUBLIC POWER_DEEPNET_API
+DeepnetFixed* DNN_fixed_create(const Deepnet* pDeepnet) {
+	if (!pDeepnet || pDeepnet->nStage <= 0)	return NULL;
+
+	DeepnetFixed* pFixed = (DeepnetFixed*)calloc(1, sizeof(DeepnetFixed));
+	if (!pFixed)	return NULL;
+
+	pFixed->nStage = pDeepnet->nStage;
+	int max_nodes = pDeepnet->dnnStage[0].nVisNodes;
+
+	for (int i = 0; i < pDeepnet->nStage; i++) {
+		const DNN_Stage* pDnnStage = &pDeepnet->dnnStage[i];
+		DNN_FixedStage* pFxStage = &pFixed->fxStage[i];
+		const int n_hid = pDnnStage->nHidNodes;
+		const int n_vis = pDnnStage->nVisNodes;
+
+		pFixed->nonLinearFunc[i] = pDeepnet->nonLinearFunc[i];
+		pFxStage->nHidNodes = pDnnStage->nHidNodes;
+		pFxStage->nVisNodes = pDnnStage->nVisNodes;
+		if (n_hid > max_nodes)	max_nodes = n_hid;
+
+		pFxStage->fxWeight = (signed char*)malloc((size_t)n_hid * n_vis);
+		pFxStage->rowScale = (short*)malloc(n_hid * sizeof(short));
+		pFxStage->rowShift = (short*)malloc(n_hid * sizeof(short));
+		pFxStage->fxHidBias = (int*)malloc(n_hid * sizeof(int));
+		if (!pFxStage->fxWeight || !pFxStage->rowScale || !pFxStage->rowShift || !pFxStage->fxHidBias) {
+			DNN_fixed_destroy(pFixed);
+			return NULL;
+		}
+
+		for (int idx_h = 0; idx_h < n_hid; idx_h++) {
+			const float *weight = &pDnnStage->dnnWeight[idx_h * n_vis];
+			signed char *fx_weight = &pFxStage->fxWeight[idx_h * n_vis];
+
+			float w_max = 0.f;
+			for (int idx_v = 0; idx_v < n_vis; idx_v++)
+				w_max = DNN_max(w_max, fabsf(weight[idx_v]));
+
+			if (w_max > 0.f) {
+				// scale = w_max / 127 = m * 2^(e-15), m in [2^14, 2^15)
+				int e = 0;
+				const float f = frexpf(w_max / 127.f, &e);
+				int m = (int)floorf(f * 32768.f + 0.5f);
+				if (m > 32767) { m = 16384; e++; }
+				pFxStage->rowScale[idx_h] = (short)m;
+				pFxStage->rowShift[idx_h] = (short)-e;
+
+				const float scale = ldexpf((float)m, e - 15);
+				for (int idx_v = 0; idx_v < n_vis; idx_v++) {
+					const float q = floorf(weight[idx_v] / scale + 0.5f);
+					fx_weight[idx_v] = (signed char)((q > 127.f) ? 127 : ((q < -127.f) ? -127 : q));
+				}
+			}
+			else {
+				pFxStage->rowScale[idx_h] = 0;
+				pFxStage->rowShift[idx_h] = 0;
+				memset(fx_weight, 0, n_vis);
+			}
+
+			pFxStage->fxHidBias[idx_h] = _DNN_fixed_sat32((long long)floor(pDnnStage->dnnHidBias[idx_h] * 65536.0 + 0.5));
+		}
+	}
+
+	for (int i = 0; i <= DNN_FIXED_LUT_SIZE; i++) {
+		pFixed->sigmoidLut[i] = (int)floor(65536.0 / (1.0 + exp(-8.0 * i / DNN_FIXED_LUT_SIZE)) + 0.5);
+		pFixed->exp2Lut[i] = (int)floor(1073741824.0 * pow(2.0, -(double)i / DNN_FIXED_LUT_SIZE) + 0.5);
+	}
+
+	pFixed->act = (short*)malloc(max_nodes * sizeof(short));
+	pFixed->acc = (int*)malloc(max_nodes * sizeof(int));
+	if (!pFixed->act || !pFixed->acc) {
+		DNN_fixed_destroy(pFixed);
+		return NULL;
+	}
+
+	return pFixed;
+}
+
+HCILAB_PUBLIC POWER_DEEPNET_API
+DNN_Result DNN_fixed_destroy(DeepnetFixed* pFixed) {
+	if (!pFixed)	return FAIL;
+
+	for (int i = 0; i < pFixed->nStage; i++) {
+		free(pFixed->fxStage[i].fxWeight);
+		free(pFixed->fxStage[i].rowScale);
+		free(pFixed->fxStage[i].rowShift);
+		free(pFixed->fxStage[i].fxHidBias);
+	}
+	free(pFixed->act);
+	free(pFixed->acc);
+
+	free(pFixed);
+	return SUCCESS;
+}
+
+HCILAB_PUBLIC POWER_DEEPNET_API
+DNN_Result do_forward_prop_fixed(DeepnetFixed* pFixed, const short in[], const int in_q, int out[]) {
+	const short n_stage = pFixed->nStage;
+	short* act = pFixed->act;
+	int* acc = pFixed->acc;
+	unsigned long long t_stage = 0;
+
+	if (pFixed->stageTime)	HCI_STAGE_START(t_stage);
+
+	// the input gets the full 15 bits as every other layer input
+	const int n_in = pFixed->fxStage[0].nVisNodes;
+	for (int idx_v = 0; idx_v < n_in; idx_v++)
+		acc[idx_v] = in[idx_v];
+	int act_q = _DNN_fixed_normalize(acc, n_in, in_q, act);
+
+	for (int i = 0; i < n_stage; i++) {
+		const DNN_FixedStage* pFxStage = &pFixed->fxStage[i];
+		const int n_hid = (int)pFxStage->nHidNodes;
+		const int n_vis = (int)pFxStage->nVisNodes;
+
+		for (int idx_h = 0; idx_h < n_hid; idx_h++) {
+			const signed char *weight = &pFxStage->fxWeight[idx_h * n_vis];
+
+			long long sum = 0;
+			for (int v0 = 0; v0 < n_vis; v0 += DNN_FIXED_CHUNK) {
+				const int v1 = (v0 + DNN_FIXED_CHUNK < n_vis) ? v0 + DNN_FIXED_CHUNK : n_vis;
+				int part = 0;
+				for (int idx_v = v0; idx_v < v1; idx_v++)
+					part += weight[idx_v] * act[idx_v];
+				sum += part;
+			}
+
+			// sum * scale in Q(act_q) -> Q16
+			const long long p = sum * pFxStage->rowScale[idx_h];
+			const int sh = 15 + pFxStage->rowShift[idx_h] + act_q - 16;
+			long long y;
+			if (sh > 0) {
+				y = (sh < 63) ? (p + (1LL << (sh-1))) >> sh : 0;
+			}
+			else {
+				const long long limit = (-sh < 31) ? ((long long)INT_MAX >> -sh) : 0;
+				y = (p > limit) ? INT_MAX : ((p < -limit) ? INT_MIN : p * (1LL << -sh));
+			}
+			acc[idx_h] = _DNN_fixed_sat32(y + pFxStage->fxHidBias[idx_h]);
+		}
+
+		if (_DNN_fixed_activate(pFixed, pFixed->nonLinearFunc[i], acc, n_hid) != SUCCESS)
+			return FAIL;
+
+		if (i + 1 < n_stage)
+			act_q = _DNN_fixed_normalize(acc, n_hid, 16, act);
+		else
+			memcpy(out, acc, n_hid * sizeof(out[0]));
+
+		if (pFixed->stageTime)	HCI_STAGE_TIME(pFixed->stageTime[i], t_stage);
+	}
+	return SUCCESS;
+}
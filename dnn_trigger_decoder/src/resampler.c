@@ -0,0 +1,225 @@
+/*
+   resampler : streaming polyphase sample rate converter for the trigger input
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "resampler.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define RS_MIN_RATE 4000
+#define RS_MAX_RATE 192000
+#define RS_MAX_PHASES 1024		/* L of 8/11.025/22.05/32/44.1/48/96 kHz -> 16 kHz is 2..640 */
+#define RS_BLOCK 512			/* input samples converted per pass */
+#define RS_KAISER_BETA 6.76		/* 70 dB stopband */
+#define RS_PASS 0.45			/* cutoff, fraction of the lower rate */
+#define RS_TAPS_FACTOR 43.2		/* taps per phase * lower rate / input rate for a 0.1 transition band at 70 dB */
+
+/* vector macros of the tap loop (same as pffft.c), define RS_SIMD_DISABLE to use scalar code */
+/*#define RS_SIMD_DISABLE*/
+#if !defined(RS_SIMD_DISABLE) && (defined(__x86_64__) || defined(_M_X64) || defined(i386) || defined(_M_IX86))
+#include <xmmintrin.h>
+typedef __m128 v4sf;
+#  define SIMD_SZ 4
+#  define VZERO() _mm_setzero_ps()
+#  define VADD(a,b) _mm_add_ps(a,b)
+#  define VMUL(a,b) _mm_mul_ps(a,b)
+#  define VLOADU(p) _mm_loadu_ps(p)
+#  define VSTOREU(p,v) _mm_storeu_ps(p,v)
+#elif !defined(RS_SIMD_DISABLE) && defined(__ARM_NEON)
+#include <arm_neon.h>
+typedef float32x4_t v4sf;
+#  define SIMD_SZ 4
+#  define VZERO() vdupq_n_f32(0)
+#  define VADD(a,b) vaddq_f32(a,b)
+#  define VMUL(a,b) vmulq_f32(a,b)
+#  define VLOADU(p) vld1q_f32(p)
+#  define VSTOREU(p,v) vst1q_f32(p,v)
+#else
+typedef float v4sf;
+#  define SIMD_SZ 1
+#  define VZERO() 0.f
+#  define VADD(a,b) ((a)+(b))
+#  define VMUL(a,b) ((a)*(b))
+#  define VLOADU(p) (*(p))
+#  define VSTOREU(p,v) (*(p) = (v))
+#endif
+
+struct trg_resampler {
+  int L, M;
+  int taps;       /* per phase, multiple of 4 */
+  float *coef;    /* [L][taps], time reversed per phase */
+  float *buf;     /* taps-1 history samples + RS_BLOCK new samples */
+  int pos;        /* buf index of the newest input sample of the next output */
+  int phase;      /* (n*M) mod L of the next output n */
+};
+
+
+static int rs_gcd(int a, int b) {
+  while (b) { int t = a % b; a = b; b = t; }
+  return a;
+}
+
+/* zeroth order modified Bessel function of the first kind */
+static double rs_bessel_i0(double x) {
+  double sum = 1.0, term = 1.0;
+  int k;
+  for (k = 1; k < 32; ++k) {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum += term;
+  }
+  return sum;
+}
+
+trg_resampler *trg_resampler_create(int rate_in, int rate_out) {
+  trg_resampler *rs;
+  int g, N, j;
+  double fc, center;
+
+  if (rate_in < RS_MIN_RATE || rate_in > RS_MAX_RATE || rate_out < RS_MIN_RATE || rate_out > RS_MAX_RATE)
+    return 0;
+
+  g = rs_gcd(rate_in, rate_out);
+  if (rate_out / g > RS_MAX_PHASES) return 0;
+
+  rs = (trg_resampler*)calloc(1, sizeof(trg_resampler));
+  if (!rs) return 0;
+
+  rs->L = rate_out / g;
+  rs->M = rate_in / g;
+  if (rs->L == rs->M) {
+    rs->taps = 1;   /* format conversion only */
+  } else {
+    const int min_rate = (rate_in < rate_out) ? rate_in : rate_out;
+    rs->taps = (int)ceil(RS_TAPS_FACTOR * rate_in / min_rate);
+    rs->taps = (rs->taps + 3) & ~3;
+  }
+
+  rs->coef = (float*)malloc((size_t)rs->L * rs->taps * sizeof(float));
+  rs->buf = (float*)malloc((rs->taps - 1 + RS_BLOCK) * sizeof(float));
+  if (!rs->coef || !rs->buf) {
+    trg_resampler_destroy(rs);
+    return 0;
+  }
+
+  if (rs->taps == 1) {
+    rs->coef[0] = 1.f;
+  } else {
+    /* prototype at L * rate_in, cutoff in cycles per upsampled sample, gain L */
+    N = rs->L * rs->taps;
+    fc = RS_PASS * ((rate_in < rate_out) ? rate_in : rate_out) / ((double)rs->L * rate_in);
+    center = (N - 1) / 2.0;
+    for (j = 0; j < N; ++j) {
+      const double t = j - center;
+      const double r = (j - center) / center;
+      const double sinc = (t == 0.0) ? 1.0 : sin(2.0 * M_PI * fc * t) / (2.0 * M_PI * fc * t);
+      const double w = rs_bessel_i0(RS_KAISER_BETA * sqrt(1.0 - r * r)) / rs_bessel_i0(RS_KAISER_BETA);
+      /* h[p + k*L] -> coef[p][taps-1-k] */
+      const int p = j % rs->L, k = j / rs->L;
+      rs->coef[p * rs->taps + (rs->taps - 1 - k)] = (float)(rs->L * 2.0 * fc * sinc * w);
+    }
+  }
+
+  trg_resampler_reset(rs);
+  return rs;
+}
+
+void trg_resampler_destroy(trg_resampler *rs) {
+  if (!rs) return;
+  free(rs->coef);
+  free(rs->buf);
+  free(rs);
+}
+
+void trg_resampler_reset(trg_resampler *rs) {
+  memset(rs->buf, 0, (rs->taps - 1 + RS_BLOCK) * sizeof(float));
+  rs->pos = rs->taps - 1;
+  rs->phase = 0;
+}
+
+int trg_resampler_max_output(const trg_resampler *rs, int n_in) {
+  return (int)(((long long)n_in * rs->L + rs->M - 1) / rs->M) + 1;
+}
+
+/* center of the L*taps prototype at L * rate_in */
+double trg_resampler_delay(const trg_resampler *rs) {
+  return (rs->L * rs->taps - 1) / (2.0 * rs->L);
+}
+
+/* outputs of the n_new samples appended after the history, then keep the last taps-1 samples */
+static int rs_run(trg_resampler *rs, const int n_new, int16_t *out) {
+  const int taps = rs->taps;
+  const int end = taps - 1 + n_new;
+  int n_out = 0, k;
+
+  while (rs->pos < end) {
+    const float *c = rs->coef + rs->phase * taps;
+    const float *x = rs->buf + rs->pos - (taps - 1);
+    float acc = 0.f;
+    if (taps % SIMD_SZ == 0) {
+      /* taps is a multiple of 4 unless no rate conversion is done */
+      float part[SIMD_SZ];
+      v4sf vacc = VZERO();
+      for (k = 0; k < taps; k += SIMD_SZ)
+        vacc = VADD(vacc, VMUL(VLOADU(c + k), VLOADU(x + k)));
+      VSTOREU(part, vacc);
+      for (k = 0; k < SIMD_SZ; ++k)
+        acc += part[k];
+    } else {
+      for (k = 0; k < taps; ++k)
+        acc += c[k] * x[k];
+    }
+
+    acc += (acc >= 0.f) ? 0.5f : -0.5f;
+    out[n_out++] = (int16_t)((acc > 32767.f) ? 32767 : ((acc < -32768.f) ? -32768 : (int)acc));
+
+    rs->phase += rs->M;
+    rs->pos += rs->phase / rs->L;
+    rs->phase %= rs->L;
+  }
+
+  memmove(rs->buf, rs->buf + n_new, (taps - 1) * sizeof(float));
+  rs->pos -= n_new;
+  return n_out;
+}
+
+int trg_resampler_process_s16(trg_resampler *rs, const int16_t *in, int n_in, int channels, int16_t *out) {
+  int n_out = 0, i;
+
+  while (n_in > 0) {
+    const int n = (n_in < RS_BLOCK) ? n_in : RS_BLOCK;
+    float *dst = rs->buf + rs->taps - 1;
+    if (channels == 2) {
+      for (i = 0; i < n; ++i) dst[i] = 0.5f * ((float)in[2*i] + (float)in[2*i+1]);
+    } else {
+      for (i = 0; i < n; ++i) dst[i] = (float)in[i];
+    }
+    n_out += rs_run(rs, n, out + n_out);
+    in += n * channels;
+    n_in -= n;
+  }
+  return n_out;
+}
+
+int trg_resampler_process_f32(trg_resampler *rs, const float *in, int n_in, int channels, int16_t *out) {
+  int n_out = 0, i;
+
+  while (n_in > 0) {
+    const int n = (n_in < RS_BLOCK) ? n_in : RS_BLOCK;
+    float *dst = rs->buf + rs->taps - 1;
+    if (channels == 2) {
+      for (i = 0; i < n; ++i) dst[i] = 16384.f * (in[2*i] + in[2*i+1]);
+    } else {
+      for (i = 0; i < n; ++i) dst[i] = 32768.f * in[i];
+    }
+    n_out += rs_run(rs, n, out + n_out);
+    in += n * channels;
+    n_in -= n;
+  }
+  return n_out;
+}
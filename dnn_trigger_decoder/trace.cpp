@@ -0,0 +1,183 @@
+// trace.cpp
+// Event trace of the per-frame pipeline, see trace.h
+
+#include "trace.h"
+
+#include <stdio.h>
+
+#include <mutex>
+#include <vector>
+
+#include "base/hci_clock.h"
+
+// __declspec(thread) has no destructor : the ring of a thread is not reused after it exits
+#if defined(_MSC_VER) && _MSC_VER < 1900
+#define TRACE_THREAD_LOCAL	__declspec(thread)
+#define TRACE_THREAD_EXIT	0
+#else
+#define TRACE_THREAD_LOCAL	thread_local
+#define TRACE_THREAD_EXIT	1
+#endif
+
+
+struct TraceEvent
+{
+	const char* name;
+	uint64_t ts_ns;
+	int64_t arg;	// 'X' : duration in ns, 'C' : counter value
+	char ph;
+};
+
+
+// written only by its thread, count is published after the event
+struct TraceThread
+{
+	int tid;
+	size_t capacity;
+	TraceEvent* events;		// ring, event n at n % capacity
+	std::atomic<uint64_t> count;
+	bool exited;			// free for the next new thread, the events are dumped until then
+};
+
+
+std::atomic<bool> CTrace::on(false);
+
+static std::mutex trace_mutex;					// trace_threads, start / dump
+static std::vector<TraceThread*> trace_threads;	// live and exited threads, as many as ran at once
+static size_t trace_capacity = 200000;
+static uint64_t trace_start_ns = 0;
+static int trace_tids = 0;
+
+
+// the ring of an exited thread if there is one, so that threads coming and going don't add rings
+static TraceThread* add_thread()
+{
+	std::lock_guard<std::mutex> lock(trace_mutex);
+
+	TraceThread* t = NULL;
+	for (TraceThread* e : trace_threads)
+		if (e->exited) { t = e; break; }
+	if (!t)
+	{
+		t = new TraceThread;
+		t->capacity = 0;
+		t->events = NULL;
+		trace_threads.push_back(t);
+	}
+	if (t->capacity != trace_capacity)
+	{
+		delete[] t->events;
+		t->capacity = trace_capacity;
+		t->events = new TraceEvent[t->capacity];
+	}
+	t->tid = ++trace_tids;
+	t->count.store(0);
+	t->exited = false;
+
+	return t;
+}
+
+
+#if TRACE_THREAD_EXIT
+static void exit_thread(TraceThread* t)
+{
+	std::lock_guard<std::mutex> lock(trace_mutex);
+	t->exited = true;
+}
+
+
+// ring of this thread, given back when the thread exits
+struct TraceSlot
+{
+	TraceThread* thread;
+
+	TraceSlot() : thread(NULL) {}
+	~TraceSlot() { if (thread) exit_thread(thread); }
+};
+#endif
+
+
+// events_per_thread : ring size of threads that record their first event after this
+bool CTrace::start(const size_t events_per_thread)
+{
+	std::lock_guard<std::mutex> lock(trace_mutex);
+	if (on.load())	return false;
+
+	if (0 < events_per_thread)	trace_capacity = events_per_thread;
+	for (TraceThread* t : trace_threads)
+		t->count.store(0);
+	trace_start_ns = hci_clock_ns();
+
+	on.store(true);
+	return true;
+}
+
+
+void CTrace::stop()
+{
+	on.store(false);
+}
+
+
+void CTrace::record(const char ph, const char* name, const uint64_t ts_ns, const int64_t arg)
+{
+#if TRACE_THREAD_EXIT
+	static TRACE_THREAD_LOCAL TraceSlot slot;
+	if (!slot.thread)	slot.thread = add_thread();
+	TraceThread* self = slot.thread;
+#else
+	static TRACE_THREAD_LOCAL TraceThread* self = NULL;
+	if (!self)	self = add_thread();
+#endif
+
+	const uint64_t n = self->count.load(std::memory_order_relaxed);
+	TraceEvent& e = self->events[n % self->capacity];
+	e.name = name;
+	e.ts_ns = ts_ns;
+	e.arg = arg;
+	e.ph = ph;
+	self->count.store(n + 1, std::memory_order_release);
+}
+
+
+void CTrace::counter(const char* name, const int64_t value)
+{
+	record('C', name, hci_clock_ns(), value);
+}
+
+
+// Chrome trace JSON, timestamps in us from start()
+// a thread recording meanwhile may overwrite its oldest events while they are written
+bool CTrace::dump(const char path[])
+{
+	std::lock_guard<std::mutex> lock(trace_mutex);
+
+	FILE* fp = fopen(path, "w");
+	if (!fp)	return false;
+
+	fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	fprintf(fp, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"DnnTrigger\"}}");
+
+	for (const TraceThread* t : trace_threads)
+	{
+		fprintf(fp, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"trigger %d\"}}", t->tid, t->tid);
+
+		const uint64_t count = t->count.load(std::memory_order_acquire);
+		for (uint64_t n = (t->capacity < count) ? count - t->capacity : 0; n < count; n++)
+		{
+			const TraceEvent& e = t->events[n % t->capacity];
+			if (e.ts_ns < trace_start_ns)	continue;
+
+			const double ts_us = (e.ts_ns - trace_start_ns) / 1000.;
+			if ('X' == e.ph)
+				fprintf(fp, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}", e.name, t->tid, ts_us, e.arg / 1000.);
+			else
+				fprintf(fp, ",\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"args\":{\"value\":%lld}}", e.name, t->tid, ts_us, (long long)e.arg);
+		}
+	}
+
+	fprintf(fp, "\n]}\n");
+	fclose(fp);
+
+	return true;
+}
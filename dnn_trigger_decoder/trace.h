@@ -0,0 +1,37 @@
+// trace.h
+// Event trace of the per-frame pipeline in Chrome trace JSON (chrome://tracing, ui.perfetto.dev)
+// : stage spans (complete events) and queue depths (counters) into a ring buffer per thread,
+// no lock on the recording path, the last events of every thread are written by dump()
+//
+// switched on by "trace" in the [log] section of the config, see CDnnTrigger
+
+
+#ifndef __TRIGGER_TRACE_H__
+#define __TRIGGER_TRACE_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <atomic>
+
+
+class CTrace
+{
+private:
+	static std::atomic<bool> on;
+
+	static void record(const char ph, const char* name, const uint64_t ts_ns, const int64_t arg);
+
+public:
+	static bool start(const size_t events_per_thread);	// false if already on
+	static void stop();
+	static bool dump(const char path[]);	// events of all threads so far, tracing may go on
+
+	static bool enabled() { return on.load(std::memory_order_relaxed); }
+
+	// name : string literal, the pointer is kept
+	static void complete(const char* name, const uint64_t begin_ns, const uint64_t end_ns) { record('X', name, begin_ns, (int64_t)(end_ns - begin_ns)); }
+	static void counter(const char* name, const int64_t value);
+};
+
+#endif	// __TRIGGER_TRACE_H__
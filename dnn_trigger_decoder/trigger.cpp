@@ -0,0 +1,80 @@
+// trigger.cpp
+// input stage shared by the triggers : sample rate / format conversion in front of the front end
+
+#define TRG_DLLEXPORT
+#include "trigger.h"
+
+#include "resampler.h"
+
+
+#define FE_SAMPLE_RATE	16000
+
+
+CTrigger::CTrigger()
+{
+	resampler = NULL;
+	in_rate = FE_SAMPLE_RATE;
+	in_format = TRG_SAMPLE_S16;
+}
+
+
+CTrigger::~CTrigger()
+{
+	trg_resampler_destroy(resampler);
+}
+
+
+// sample_rate : 4000 ~ 192000 Hz, format : TriggerSampleFormat
+// return 0, -1 if not supported
+int CTrigger::initInput(const int sample_rate, const int format)
+{
+	if (format < TRG_SAMPLE_S16 || format > TRG_SAMPLE_F32_STEREO)
+		return -1;
+	in_rate = sample_rate;
+	in_format = format;
+
+	trg_resampler_destroy(resampler);
+	resampler = NULL;
+	if (FE_SAMPLE_RATE == sample_rate && TRG_SAMPLE_S16 == format)
+		return 0;	// detect() as is
+
+	resampler = trg_resampler_create(sample_rate, FE_SAMPLE_RATE);
+	return resampler ? 0 : -1;
+}
+
+
+void CTrigger::resetInput()
+{
+	if (resampler)	trg_resampler_reset(resampler);
+}
+
+
+// offsets of the resampled stream scaled to the input rate, less the filter delay
+int64_t CTrigger::inputSample(const int64_t fe_sample)
+{
+	if (!resampler)
+		return fe_sample;
+
+	const double s = (double)fe_sample * in_rate / FE_SAMPLE_RATE - trg_resampler_delay(resampler);
+	return (s <= 0.) ? 0 : (int64_t)(s + 0.5);
+}
+
+
+int CTrigger::detectAudio(const int len_sample, const void* buf, int* p_st_frame_info)
+{
+	if (!resampler)
+		return detect(len_sample, (const int16_t*)buf, p_st_frame_info);
+
+	const size_t max_out = trg_resampler_max_output(resampler, len_sample);
+	if (in_pcm.size() < max_out)
+		in_pcm.resize(max_out);
+
+	const bool stereo = (TRG_SAMPLE_S16_STEREO == in_format || TRG_SAMPLE_F32_STEREO == in_format);
+	int n_out;
+	if (TRG_SAMPLE_S16 == in_format || TRG_SAMPLE_S16_STEREO == in_format)
+		n_out = trg_resampler_process_s16(resampler, (const int16_t*)buf, len_sample, stereo ? 2 : 1, in_pcm.data());
+	else
+		n_out = trg_resampler_process_f32(resampler, (const float*)buf, len_sample, stereo ? 2 : 1, in_pcm.data());
+
+	return detect(n_out, in_pcm.data(), p_st_frame_info);
+}
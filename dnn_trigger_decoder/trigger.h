@@ -25,6 +25,7 @@
 
 class CFeat2pass;
 class CDnnDecoder;
+typedef struct trg_resampler trg_resampler;
 
 
 class POWER_DEEPNET_API CTrigger : public ITriggerAPI {
@@ -32,18 +33,35 @@ protected:
 	CFeat2pass* feat_extractor;
 	CDnnDecoder* dnn_decoder;
 	float *dnn_prob_output;
-	float feat_buf[40960 + 10];
+	feat_t feat_buf[40960 + 10];	// front end output, Q15 in the fixed-point build
 	int output_frame;
 	int sp_output_frame;
 	int err;
 
+	// input stage of detectAudio() : sample rate / format -> 16 kHz int16 mono, NULL if already so
+	trg_resampler* resampler;
+	int in_rate;
+	int in_format;		// TriggerSampleFormat
+	std::vector<int16_t> in_pcm;
+	int initInput(const int sample_rate, const int format);
+	void resetInput();
+	int64_t inputSample(const int64_t fe_sample);	// 16 kHz front end offset -> input offset (TriggerSpan)
+
 public:
+	CTrigger();
+	virtual ~CTrigger();
+
 	int getError() { return err; }
 	int getOutFrame() { return output_frame; }
     virtual int getOutSPFrame() { return sp_output_frame; }
 
 	virtual int detect(const int len_sample, const int16_t pcm_buf[],int *p_st_frame_info=NULL) = 0;
 	virtual bool reset() = 0;
+	virtual int detectAudio(const int len_sample, const void* buf, int* p_st_frame_info=NULL);
+	// replay : num_frames 51-dim feature frames (feature file rows) instead of audio, -1 if not supported
+	virtual int detectFeatures(const int num_frames, const float feat[], int* p_st_frame_info=NULL) { return -1; }
+	int setNRMode(const int mode) { return feat_extractor->setNRMode(mode); }
+	int setFeatureDump(const char path[]) { return feat_extractor->setDump(path); }
 	static bool setChannel(int ch) { return CFeat2pass::setChannel(ch); }
 };
 
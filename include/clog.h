@@ -237,6 +237,24 @@ int clog_set_date_fmt(int id, const char *fmt);
  */
 int clog_set_fmt(int id, const char *fmt);
 
+/**
+ * Switch a logger to async mode: the log functions only copy the format
+ * string pointer and the arguments into a bounded lock-free queue, a
+ * background thread formats and writes them.  The caller never blocks; a
+ * record is dropped (and counted in the log) when the queue is full.  The
+ * format string must stay valid (a literal), %s arguments are copied.
+ * clog_free() writes the queued records before closing.  Needs C++11,
+ * implemented in clog.cpp.
+ *
+ * @param records
+ * Queue size in records (rounded up to a power of two), 0 to write in the
+ * caller again.
+ *
+ * @return
+ * Zero on success, non-zero on failure.
+ */
+int clog_set_async(int id, int records);
+
 /*
  * No need to read below this point.
  */
@@ -263,9 +281,15 @@ struct clog {
 
     /* Tracks whether the fd needs to be closed eventually. */
     int opened;
+
+    /* Async mode queue and writer thread, NULL when writing in the caller. */
+    void *async;
 };
 
 void _clog_err(const char *fmt, ...);
+void _clog_async_push(struct clog *logger, const char *sfile, int sline,
+                      enum clog_level level, const char *fmt, va_list ap);
+void _clog_async_free(struct clog *logger);
 
 #ifdef CLOG_MAIN
 struct clog *_clog_loggers[CLOG_MAX_LOGGERS] = { 0 };
@@ -317,6 +341,7 @@ clog_init_fd(int id, int fd)
     logger->level = CLOG_DEBUG;
     logger->fd = fd;
     logger->opened = 0;
+    logger->async = NULL;
     strcpy(logger->fmt, CLOG_DEFAULT_FORMAT);
     strcpy(logger->date_fmt, CLOG_DEFAULT_DATE_FORMAT);
     strcpy(logger->time_fmt, CLOG_DEFAULT_TIME_FORMAT);
@@ -329,6 +354,9 @@ void
 clog_free(int id)
 {
     if (_clog_loggers[id]) {
+        if (_clog_loggers[id]->async) {
+            _clog_async_free(_clog_loggers[id]);
+        }
         if (_clog_loggers[id]->opened) {
             close(_clog_loggers[id]->fd);
         }
@@ -542,6 +570,11 @@ _clog_log(const char *sfile, int sline, enum clog_level level,
         return;
     }
 
+    if (logger->async) {
+        _clog_async_push(logger, sfile, sline, level, fmt, ap);
+        return;
+    }
+
     /* Format the message text with the argument list. */
     result = vsnprintf(dynbuf, buf_size, fmt, ap);
     if ((size_t) result >= buf_size) {
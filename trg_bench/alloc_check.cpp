@@ -0,0 +1,223 @@
+// alloc_check.cpp
+// Zero-allocation check of the steady state : an audio file through CDnnTrigger (or CMonoTrigger), the heap
+// allocations of detectAudio() after the warm-up counted per stage (front end, DNN, detector) by CAllocStats
+//
+// usage: TrgAllocCheck root_path audio_file [-mono phone_sequence] [-chunk ms] [-warmup s] [-prob x]
+//   root_path  : directory holding ../conf/diotrg_16k.ini and ../conf/diotrg_mono_16k.ini
+//   audio_file : .raw/.pcm (16k 16bit mono) or .wav, read by CAudioFileReader
+//   -mono      : CMonoTrigger with the phone sequence instead of CDnnTrigger
+//   -chunk     : detectAudio() input length in ms (default 10, one frame), not a multiple of 10 goes
+//                through the input queue
+//   -warmup    : audio before the counting starts in s (default 3)
+//   -prob      : detection threshold instead of [trigger] prob_threshold (CDnnTrigger)
+//
+// with glibc malloc / calloc / realloc are replaced here, every heap allocation of the process is counted
+// (C sources, hci_malloc, new / std containers). Elsewhere operator new is replaced and the hci_malloc
+// functions are counted by the library, plain malloc of the C sources is not
+//
+// the audio has to hold the keyword : without a detection the detector stage (span, verifier) didn't run
+// and the check fails
+//
+// exit code 0 if detectAudio() didn't allocate after the warm-up and detected, 1 if it allocated / didn't
+// detect / errors, 2 usage
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <memory>
+#include <new>
+
+#include "dnn_trigger_decoder/dnn_trigger.h"
+#include "dnn_trigger_decoder/mono_trigger.h"
+#include "dnn_trigger_decoder/alloc_stats.h"
+#include "dnn_trigger_decoder/audio_file.h"
+
+#define CONFIG_PATH			"../conf/diotrg_16k.ini"
+#define MONO_CONFIG_PATH	"../conf/diotrg_mono_16k.ini"
+
+
+#if defined(__GLIBC__)
+#define COUNT_MALLOC	1
+
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t n_elem, size_t elem_size);
+extern "C" void* __libc_realloc(void* p, size_t size);
+
+// no allocation in count(), see alloc_stats.cpp
+extern "C" void* malloc(size_t size) throw()
+{
+	CAllocStats::count(size);
+	return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t n_elem, size_t elem_size) throw()
+{
+	CAllocStats::count(n_elem * elem_size);
+	return __libc_calloc(n_elem, elem_size);
+}
+
+extern "C" void* realloc(void* p, size_t size) throw()
+{
+	CAllocStats::count(size);
+	return __libc_realloc(p, size);
+}
+#else
+#define COUNT_MALLOC	0
+#endif
+
+
+void* operator new(size_t size)
+{
+	if (!COUNT_MALLOC)	CAllocStats::count(size);
+	void* p = malloc(size ? size : 1);
+	if (!p)	throw std::bad_alloc();
+	return p;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) throw()
+{
+	if (!COUNT_MALLOC)	CAllocStats::count(size);
+	return malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) throw()
+{
+	return operator new(size, tag);
+}
+
+void operator delete(void* p) throw() { free(p); }
+void operator delete[](void* p) throw() { free(p); }
+void operator delete(void* p, const std::nothrow_t&) throw() { free(p); }
+void operator delete[](void* p, const std::nothrow_t&) throw() { free(p); }
+
+
+static void print_counts(const char* title, const CAllocStats::Counts& counts)
+{
+	static const char* const stage_name[CAllocStats::STAGES] = { "other", "front end", "dnn", "detector" };
+
+	printf("%s\n", title);
+	for (int s = 0; s < CAllocStats::STAGES; s++)
+		printf("  %-10s %8llu allocations %10llu bytes\n", stage_name[s],
+			(unsigned long long)counts.allocs[s], (unsigned long long)counts.bytes[s]);
+}
+
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		puts("usage: TrgAllocCheck root_path audio_file [-mono phone_sequence] [-chunk ms] [-warmup s] [-prob x]");
+		return 2;
+	}
+	const char* root_path = argv[1];
+	const char* audio_path = argv[2];
+
+	const char* keyword = NULL;
+	int chunk_ms = 10;
+	double warmup_sec = 3.;
+	float prob = -1.f;
+	for (int i = 3; i < argc; i++)
+	{
+		const bool has_value = i + 1 < argc;
+		if (has_value && 0 == strcmp(argv[i], "-mono"))	keyword = argv[++i];
+		else if (has_value && 0 == strcmp(argv[i], "-chunk"))	chunk_ms = std::max(1, atoi(argv[++i]));
+		else if (has_value && 0 == strcmp(argv[i], "-warmup"))	warmup_sec = std::max(0., atof(argv[++i]));
+		else if (has_value && 0 == strcmp(argv[i], "-prob"))	prob = (float)atof(argv[++i]);
+		else { fprintf(stderr, "unknown option %s\n", argv[i]); return 2; }
+	}
+
+	CAudioFileReader reader;
+	if (reader.open(audio_path))
+	{
+		fprintf(stderr, "%s : cannot read audio\n", audio_path);
+		return 1;
+	}
+	const AudioFormat& fmt = reader.getFormat();
+
+	const long chunk = std::max(1L, (long)fmt.sample_rate * chunk_ms / 1000);
+	const long frames = reader.getFrames();
+	const long warmup = (long)(warmup_sec * fmt.sample_rate);
+	if (frames <= warmup)
+	{
+		fprintf(stderr, "%s : shorter than the warm-up (%.1f s)\n", audio_path, warmup_sec);
+		return 1;
+	}
+
+	CAllocStats::Counts counts;
+	CAllocStats::start(!COUNT_MALLOC);
+	std::unique_ptr<CTrigger> trigger;
+	if (keyword)
+	{
+		CMonoTrigger* mono = new CMonoTrigger(root_path, MONO_CONFIG_PATH, fmt.sample_rate, fmt.format);
+		trigger.reset(mono);
+		if (!mono->getError())	mono->addPhonSeq(keyword);
+	}
+	else
+		trigger.reset(new CDnnTrigger(root_path, CONFIG_PATH, fmt.sample_rate, fmt.format));
+	CAllocStats::stop();
+	CAllocStats::get(&counts);
+
+	if (trigger->getError())
+	{
+		fprintf(stderr, "error loading trigger engine (%d)\n", trigger->getError());
+		return 1;
+	}
+	print_counts("startup", counts);
+
+	if (0.f <= prob)
+	{
+		TriggerParam param;
+		if (!trigger->getParam(&param))
+		{
+			fprintf(stderr, "-prob : no parameters of this trigger\n");
+			return 2;
+		}
+		param.prob_threshold = prob;
+		if (!trigger->setParam(&param))
+		{
+			fprintf(stderr, "invalid -prob %g\n", prob);
+			return 2;
+		}
+	}
+
+	long done = 0;
+	int detections = 0;
+	for (bool counting = false; done < frames; )
+	{
+		if (!counting && warmup <= done)
+		{
+			CAllocStats::start(!COUNT_MALLOC);
+			counting = true;
+		}
+
+		const long n = std::min(chunk, frames - done);
+		if (0 < trigger->detectAudio((int)n, reader.frame(done)))
+			detections++;
+		done += n;
+	}
+	CAllocStats::stop();
+	CAllocStats::get(&counts);
+
+	char title[128];
+	snprintf(title, sizeof(title), "after %.1f s warm-up, %.1f s of audio in %d ms chunks, %d detections",
+		warmup_sec, (double)(frames - warmup) / fmt.sample_rate, chunk_ms, detections);
+	print_counts(title, counts);
+
+	uint64_t total = 0;
+	for (int s = 0; s < CAllocStats::STAGES; s++)
+		total += counts.allocs[s];
+	if (total)
+		printf("FAIL : detectAudio() allocates in the steady state\n");
+	else if (!detections)
+		printf("FAIL : no detection, the detector stage didn't run (keyword audio or lower -prob)\n");
+	else
+		printf("OK : no allocation in the steady state\n");
+
+	return total || !detections ? 1 : 0;
+}
@@ -0,0 +1,46 @@
+// bench_audio.cpp
+// Test audio of the trg_bench tools, see bench_audio.h
+
+#include "bench_audio.h"
+
+#include <math.h>
+
+#include "dnn_trigger_decoder/audio_file.h"
+#include "dnn_trigger_decoder/Selvy_Trigger_API.h"
+
+
+void make_synthetic(std::vector<int16_t>& pcm, const int seconds)
+{
+	uint32_t seed = 777;
+	pcm.resize(BENCH_SAMPLE_RATE * seconds);
+
+	for (size_t i = 0; i < pcm.size(); i++)
+	{
+		const double t = (double)i / BENCH_SAMPLE_RATE;
+		seed = seed * 1664525u + 1013904223u;
+		double v = 600.0 * ((seed >> 8) / 16777216.0 - 0.5);
+
+		const double ph = fmod(t, 2.0);
+		if (ph > 0.6 && ph < 1.4)
+		{
+			const double f0 = 180 + 90 * sin(t * 5);
+			v += 5000.0 * sin(2 * M_PI * f0 * t) * (0.6 + 0.4 * sin(t * 13)) + 1500.0 * sin(2 * M_PI * 1200 * t);
+		}
+		pcm[i] = (int16_t)v;
+	}
+}
+
+
+bool read_audio(const char fname[], std::vector<int16_t>& pcm)
+{
+	CAudioFileReader reader;
+	if (reader.open(fname, BENCH_SAMPLE_RATE))	return false;
+
+	const AudioFormat& fmt = reader.getFormat();
+	if (BENCH_SAMPLE_RATE != fmt.sample_rate || TRG_SAMPLE_S16 != fmt.format)	return false;
+
+	const int16_t* samples = (const int16_t*)reader.frame(0);
+	pcm.assign(samples, samples + reader.getFrames());
+
+	return pcm.size() >= BENCH_SAMPLE_RATE / 100;
+}
@@ -0,0 +1,22 @@
+// bench_audio.h
+// Test audio of the trg_bench tools : synthetic noisy speech-like audio and 16k 16bit mono files
+
+
+#ifndef __TRG_BENCH_AUDIO_H__
+#define __TRG_BENCH_AUDIO_H__
+
+#include <stdint.h>
+
+#include <vector>
+
+#define BENCH_SAMPLE_RATE	16000
+
+
+// babble-like bursts (harmonic voice + formant tone) over white noise, 0.8 sec on / 1.2 sec off, 16 kHz
+void make_synthetic(std::vector<int16_t>& pcm, const int seconds);
+
+// .raw/.pcm (16k 16bit mono) or .wav of that format, read by CAudioFileReader
+// false if it can't be read, has another format or is shorter than a 10ms frame
+bool read_audio(const char fname[], std::vector<int16_t>& pcm);
+
+#endif	// __TRG_BENCH_AUDIO_H__
@@ -0,0 +1,206 @@
+// fixed_check.cpp
+// Conformance of the integer DNN (dnn_fixed) against the float DNN on the same features,
+// and end to end against posteriors dumped by another build (float FE + float DNN)
+//
+// usage: TrgFixedCheck [root_path] [16k 16bit mono .raw/.wav file | -] [-dump file] [-ref file] [-tol x] [-prob x]
+//   root_path : directory holding ../conf/diotrg_16k.ini (default ./)
+//   -         : 60 sec of synthetic noisy speech-like audio
+//   -dump     : write the float DNN posteriors of this build, [frame][class] float
+//   -ref      : compare the integer DNN posteriors of this build with a -dump file
+//   -tol      : mean |posterior difference| allowed (default 0.02)
+//   -prob     : detection threshold of the detectors instead of [trigger] prob_threshold
+// exit code 1 when a comparison is out of tolerance, the detections differ or the reference side has
+// no detection (nothing to compare : keyword audio or a lower -prob)
+//
+// the fixed-point build feeds the Q15 features of the front end to the integer DNN as they are, the
+// float DNN takes them converted
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+
+#include "dnn_trigger_decoder/config.h"
+#include "dnn_trigger_decoder/feat_2pass.h"
+#include "dnn_trigger_decoder/dnn_decoder.h"
+#include "dnn_trigger_decoder/detector_word.h"
+#include "bench_audio.h"
+
+
+#define SAMPLE_RATE	16000
+#define FRAME_SHIFT	160
+#define FEAT_DIM	51
+#define DET_SLACK	5		// frames a detection may move
+#define CONFIG_PATH	"../conf/diotrg_16k.ini"
+
+
+// posterior difference and detection agreement of two posterior streams
+struct Compare
+{
+	const char* name;
+	double sum_diff = 0, max_diff = 0;
+	long frames = 0, argmax_agree = 0;
+	std::vector<int> det_a, det_b;
+
+	explicit Compare(const char* name) : name(name) {}
+
+	void add(const float* a, const float* b, const int num_class)
+	{
+		int arg_a = 0, arg_b = 0;
+		for (int k = 0; k < num_class; k++)
+		{
+			const double d = fabs(a[k] - b[k]);
+			sum_diff += d;
+			if (d > max_diff)	max_diff = d;
+			if (a[k] > a[arg_a])	arg_a = k;
+			if (b[k] > b[arg_b])	arg_b = k;
+		}
+		argmax_agree += (arg_a == arg_b);
+		frames++;
+	}
+
+	bool detectionsAgree() const
+	{
+		if (det_a.size() != det_b.size())	return false;
+		for (size_t i = 0; i < det_a.size(); i++)
+			if (abs(det_a[i] - det_b[i]) > DET_SLACK)	return false;
+		return true;
+	}
+
+	bool report(const int num_class, const double tol) const
+	{
+		const double mean_diff = frames ? sum_diff / (frames * num_class) : 0;
+		const bool pass = (mean_diff <= tol) && detectionsAgree() && !det_a.empty();
+
+		printf("%-12s frames %ld  mean|dp| %.5f  max|dp| %.5f  argmax %.2f%%  detections %zu/%zu  %s\n",
+			name, frames, mean_diff, max_diff, frames ? 100.0 * argmax_agree / frames : 0.0,
+			det_a.size(), det_b.size(), pass ? "PASS" : "FAIL");
+		for (size_t i = 0; i < det_a.size() || i < det_b.size(); i++)
+			printf("  detection %zu : %d / %d\n", i,
+				i < det_a.size() ? det_a[i] : -1, i < det_b.size() ? det_b[i] : -1);
+		if (det_a.empty())
+			printf("  no reference detection, the detections are not compared (keyword audio or lower -prob)\n");
+
+		return pass;
+	}
+};
+
+
+int main(int argc, char* argv[])
+{
+	const char* root_path = (argc > 1) ? argv[1] : "./";
+	const char* raw_path = (argc > 2) ? argv[2] : "-";
+	const char* dump_path = NULL;
+	const char* ref_path = NULL;
+	double tol = 0.02;
+	float prob = -1.f;
+
+	for (int i = 3; i + 1 < argc; i += 2)
+	{
+		if (0 == strcmp(argv[i], "-dump"))		dump_path = argv[i+1];
+		else if (0 == strcmp(argv[i], "-ref"))	ref_path = argv[i+1];
+		else if (0 == strcmp(argv[i], "-tol"))	tol = atof(argv[i+1]);
+		else if (0 == strcmp(argv[i], "-prob"))	prob = (float)atof(argv[i+1]);
+		else { fprintf(stderr, "unknown option %s\n", argv[i]); return 2; }
+	}
+
+	std::vector<int16_t> pcm;
+	if (0 != strcmp(raw_path, "-"))
+	{
+		if (!read_audio(raw_path, pcm)) { fprintf(stderr, "cannot read %s\n", raw_path); return 2; }
+	}
+	else
+	{
+		make_synthetic(pcm, 60);
+	}
+
+	const std::shared_ptr<const CConfig> shared_config = CConfig::open(root_path, CONFIG_PATH);	// held while config is used
+	const CConfig& config = *shared_config;
+	char dnn_ini[256];
+	config.gets("trigger", "dnn_ini", "", dnn_ini, sizeof(dnn_ini));
+
+	CFeat2pass fe(root_path);
+	if (fe.getError()) { fprintf(stderr, "front end init error %d\n", fe.getError()); return 2; }
+
+	CDnnDecoder dnn_float(root_path, dnn_ini);
+	CDnnDecoder dnn_fixed(root_path, dnn_ini);
+	if (dnn_float.getError() || dnn_fixed.getError()) { fprintf(stderr, "DNN init error %d\n", dnn_float.getError()); return 2; }
+	if (dnn_fixed.setFixedPoint(true)) { fprintf(stderr, "cannot quantize the DNN\n"); return 2; }
+
+	const int num_class = dnn_float.getNumOutNode();
+	CDetectorWord det_float(num_class - 2, config);
+	CDetectorWord det_fixed(num_class - 2, config);
+	CDetectorWord det_ref(num_class - 2, config);
+	if (det_float.getError()) { fprintf(stderr, "detector init error %d\n", det_float.getError()); return 2; }
+	if (0.f <= prob)
+	{
+		TriggerParam param;
+		det_float.getParam(&param);
+		param.prob_threshold = prob;
+		if (!det_float.setParam(&param) || !det_fixed.setParam(&param) || !det_ref.setParam(&param))
+		{
+			fprintf(stderr, "invalid -prob %g\n", prob);
+			return 2;
+		}
+	}
+
+	FILE* fp_dump = dump_path ? fopen(dump_path, "wb") : NULL;
+	FILE* fp_ref = ref_path ? fopen(ref_path, "rb") : NULL;
+	if (dump_path && !fp_dump) { fprintf(stderr, "cannot write %s\n", dump_path); return 2; }
+	if (ref_path && !fp_ref) { fprintf(stderr, "cannot read %s\n", ref_path); return 2; }
+
+	Compare dnn_cmp("float/fixed");
+	Compare ref_cmp("ref/fixed");
+	std::vector<float> p_float(num_class), p_fixed(num_class), p_ref(num_class);
+	static feat_t feat[40960];
+	std::vector<float> feat_float(FEAT_DIM);
+	bool ref_short = false;
+
+	const int num_frames = (int)(pcm.size() / FRAME_SHIFT);
+	for (int i = 0; i < num_frames; i++)
+	{
+		long len_feat = 0;
+		fe.getFeature(FRAME_SHIFT, &pcm[i * FRAME_SHIFT], &len_feat, feat);
+
+		for (long f = 2; f + FEAT_DIM <= len_feat; f += FEAT_DIM)
+		{
+			for (int k = 0; k < FEAT_DIM; k++)
+				feat_float[k] = FEAT_Q15 ? feat[f + k] * (1.f / 32768.f) : feat[f + k];
+			const int frame = dnn_float.decode(feat_float.data(), p_float.data());
+			dnn_fixed.decode(&feat[f], p_fixed.data());
+			dnn_cmp.add(p_float.data(), p_fixed.data(), num_class);
+
+			if (0 < det_float.detect(p_float.data()))	dnn_cmp.det_a.push_back(frame);
+			if (0 < det_fixed.detect(p_fixed.data()))
+			{
+				dnn_cmp.det_b.push_back(frame);
+				ref_cmp.det_b.push_back(frame);
+			}
+
+			if (fp_dump)
+				fwrite(p_float.data(), sizeof(float), num_class, fp_dump);
+
+			if (fp_ref && !ref_short)
+			{
+				if ((size_t)num_class != fread(p_ref.data(), sizeof(float), num_class, fp_ref)) { ref_short = true; continue; }
+				ref_cmp.add(p_ref.data(), p_fixed.data(), num_class);
+				if (0 < det_ref.detect(p_ref.data()))	ref_cmp.det_a.push_back(frame);
+			}
+		}
+	}
+
+	if (fp_dump)	fclose(fp_dump);
+	if (fp_ref)	fclose(fp_ref);
+
+	printf("audio %.1f sec, %d classes, tolerance %.4f\n", (double)num_frames * FRAME_SHIFT / SAMPLE_RATE, num_class, tol);
+	bool pass = dnn_cmp.report(num_class, tol);
+	if (fp_ref)
+	{
+		if (ref_short)	printf("reference is shorter than the input\n");
+		pass = ref_cmp.report(num_class, tol) && !ref_short && pass;
+	}
+
+	return pass ? 0 : 1;
+}
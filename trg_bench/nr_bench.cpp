@@ -0,0 +1,69 @@
+// nr_bench.cpp
+// CPU cost of the front end (Wiener NR + MFCC + feature) per noise reduction mode
+//
+// usage: TrgNrBench [root_path] [16k 16bit mono .raw/.wav file]
+//   root_path : directory holding ../conf/hci_frontend.ini (default ./)
+//   without an audio file, 60 sec of synthetic noisy speech-like audio is used
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include <vector>
+
+#include "dnn_trigger_decoder/feat_2pass.h"
+#include "wiener/wiener_common.h"
+#include "bench_audio.h"
+
+#define SAMPLE_RATE	16000
+#define FRAME_SHIFT	160
+
+
+int main(int argc, char* argv[])
+{
+	const char* root_path = (argc > 1) ? argv[1] : "./";
+	std::vector<int16_t> pcm;
+
+	if (argc > 2)
+	{
+		if (!read_audio(argv[2], pcm)) { fprintf(stderr, "cannot read %s\n", argv[2]); return 1; }
+	}
+	else
+	{
+		make_synthetic(pcm, 60);
+	}
+
+	const int num_frames = (int)(pcm.size() / FRAME_SHIFT);
+	const double audio_sec = (double)num_frames * FRAME_SHIFT / SAMPLE_RATE;
+	static float feat[40960];
+
+	static const struct { int mode; const char* name; } modes[] = {
+		{ NR_MODE_TWO_STAGE, "two_stage" },
+		{ NR_MODE_SINGLE_STAGE, "single" },
+		{ NR_MODE_OFF, "off" },
+	};
+
+	printf("audio %.1f sec, %d frames\n", audio_sec, num_frames);
+	printf("%-10s %10s %10s %10s\n", "NR_MODE", "cpu sec", "us/frame", "RTF");
+
+	for (const auto& m : modes)
+	{
+		CFeat2pass fe(root_path);
+		if (fe.getError()) { fprintf(stderr, "front end init error %d\n", fe.getError()); return 1; }
+		if (fe.setNRMode(m.mode)) { fprintf(stderr, "cannot set NR mode %s\n", m.name); return 1; }
+
+		long out_frames = 0;
+		const clock_t start = clock();
+		for (int i = 0; i < num_frames; i++)
+		{
+			long len_feat = 0;
+			fe.getFeature(FRAME_SHIFT, &pcm[i * FRAME_SHIFT], &len_feat, feat);
+			out_frames += len_feat;
+		}
+		const double cpu_sec = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+		printf("%-10s %10.3f %10.2f %10.5f\n", m.name, cpu_sec, cpu_sec * 1e6 / num_frames, cpu_sec / audio_sec);
+	}
+
+	return 0;
+}
@@ -0,0 +1,325 @@
+// regress.cpp
+// Accuracy / speed regression run : a fixed list of audio files through CDnnTrigger (or CMonoTrigger), the
+// detections checked against golden files and the speed (RTF, per chunk latency, peak RSS) written to a report
+//
+// usage: TrgRegress root_path list_file [-update] [-tol frames] [-chunk ms] [-report file]
+//   root_path : directory holding ../conf/diotrg_16k.ini and ../conf/diotrg_mono_16k.ini
+//   list_file : "path[<TAB>phone sequence]" per line, paths relative to the list file as trg_file_tester
+//               path : .raw/.pcm (16k 16bit mono) or .wav, read by CAudioFileReader
+//               phone sequence : the file runs through CMonoTrigger with it, else through CDnnTrigger
+//   -update   : write the golden files from this run instead of checking them
+//   -tol      : allowed difference of the detected frame and span in frames (default 0, exact)
+//   -chunk    : detectAudio() input length in ms (default 10, one frame)
+//   -report   : JSON report (default regress.json)
+//
+// golden file <path>.gold, one detection per line : "frame<TAB>span", the return value and spinfo[1] of
+// detectAudio() (span 0 for CMonoTrigger), so the golden files hold for any -chunk
+//
+// exit code 0 if every file matched its golden file, 1 on mismatches / missing golden files / errors, 2 usage
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "dnn_trigger_decoder/dnn_trigger.h"
+#include "dnn_trigger_decoder/mono_trigger.h"
+#include "dnn_trigger_decoder/audio_file.h"
+
+#define CONFIG_PATH			"../conf/diotrg_16k.ini"
+#define MONO_CONFIG_PATH	"../conf/diotrg_mono_16k.ini"
+
+
+typedef std::chrono::steady_clock regress_clock;
+
+
+struct Detection
+{
+	int frame;
+	int span;
+};
+
+
+struct RegressFile
+{
+	std::string path;
+	std::string keyword;		// empty : CDnnTrigger
+
+	const char* status = "error";	// match, mismatch, missing, updated, error
+	std::vector<Detection> dets;
+	double audio_sec = 0.;
+	double proc_sec = 0.;
+	std::vector<uint32_t> chunk_ns;	// detectAudio() time of each chunk
+};
+
+
+// peak resident set of the process in KB
+static long peak_rss_kb()
+{
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS pmc;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))	return 0;
+	return (long)(pmc.PeakWorkingSetSize / 1024);
+#else
+	struct rusage ru;
+	if (getrusage(RUSAGE_SELF, &ru))	return 0;
+#if defined(__APPLE__)
+	return ru.ru_maxrss / 1024;		// bytes
+#else
+	return ru.ru_maxrss;
+#endif
+#endif
+}
+
+
+// q-quantile in us, v is reordered
+static double percentile_us(std::vector<uint32_t>& v, const double q)
+{
+	if (v.empty())	return 0.;
+
+	const size_t k = std::min(v.size() - 1, (size_t)(q * v.size()));
+	std::nth_element(v.begin(), v.begin() + k, v.end());
+	return v[k] / 1000.;
+}
+
+
+static bool read_golden(const std::string& path, std::vector<Detection>& dets)
+{
+	FILE* fp = fopen(path.c_str(), "r");
+	if (!fp)	return false;
+
+	Detection det;
+	while (2 == fscanf(fp, "%d\t%d", &det.frame, &det.span))
+		dets.push_back(det);
+	fclose(fp);
+
+	return true;
+}
+
+
+static bool write_golden(const std::string& path, const std::vector<Detection>& dets)
+{
+	FILE* fp = fopen(path.c_str(), "w");
+	if (!fp)	return false;
+
+	for (const Detection& det : dets)
+		fprintf(fp, "%d\t%d\n", det.frame, det.span);
+	fclose(fp);
+
+	return true;
+}
+
+
+static bool match_golden(const std::vector<Detection>& dets, const std::vector<Detection>& gold, const int tol)
+{
+	if (dets.size() != gold.size())	return false;
+
+	for (size_t i = 0; i < dets.size(); i++)
+	{
+		if (tol < abs(dets[i].frame - gold[i].frame) || tol < abs(dets[i].span - gold[i].span))
+			return false;
+	}
+	return true;
+}
+
+
+// the file in chunk_ms pieces straight from the mapped file, each detectAudio() call timed
+static bool run_file(const char root_path[], RegressFile& rf, const int chunk_ms)
+{
+	CAudioFileReader reader;
+	if (reader.open(rf.path.c_str()))
+	{
+		fprintf(stderr, "%s : cannot read audio\n", rf.path.c_str());
+		return false;
+	}
+	const AudioFormat& fmt = reader.getFormat();
+
+	std::unique_ptr<CTrigger> trigger;
+	if (rf.keyword.empty())
+		trigger.reset(new CDnnTrigger(root_path, CONFIG_PATH, fmt.sample_rate, fmt.format));
+	else
+	{
+		CMonoTrigger* mono = new CMonoTrigger(root_path, MONO_CONFIG_PATH, fmt.sample_rate, fmt.format);
+		trigger.reset(mono);
+		if (!mono->getError())	mono->addPhonSeq(rf.keyword.c_str());
+	}
+	if (trigger->getError())
+	{
+		fprintf(stderr, "%s : error loading trigger engine (%d)\n", rf.path.c_str(), trigger->getError());
+		return false;
+	}
+
+	const long chunk = std::max(1L, (long)fmt.sample_rate * chunk_ms / 1000);
+	const long frames = reader.getFrames();
+	rf.chunk_ns.reserve(frames / chunk + 1);
+
+	const auto file_start = regress_clock::now();
+	for (long done = 0; done < frames; )
+	{
+		const long n = std::min(chunk, frames - done);
+		int spinfo[2] = { 0, 0 };
+
+		const auto start = regress_clock::now();
+		const int ret_dec = trigger->detectAudio((int)n, reader.frame(done), spinfo);
+		rf.chunk_ns.push_back((uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(regress_clock::now() - start).count());
+
+		if (0 < ret_dec)
+		{
+			Detection det = { ret_dec, spinfo[1] };
+			rf.dets.push_back(det);
+		}
+		done += n;
+	}
+	rf.proc_sec = std::chrono::duration<double>(regress_clock::now() - file_start).count();
+	rf.audio_sec = (double)frames / fmt.sample_rate;
+
+	return true;
+}
+
+
+static void json_string(FILE* fp, const std::string& s)
+{
+	fputc('"', fp);
+	for (const char c : s)
+	{
+		if ('"' == c || '\\' == c)	fputc('\\', fp);
+		if ((unsigned char)c < 0x20)	fprintf(fp, "\\u%04x", c);
+		else	fputc(c, fp);
+	}
+	fputc('"', fp);
+}
+
+
+static bool write_report(const char path[], std::vector<RegressFile>& files, const int tol, const int chunk_ms, const int failed)
+{
+	FILE* fp = fopen(path, "w");
+	if (!fp)	return false;
+
+	double audio_sec = 0., proc_sec = 0.;
+	std::vector<uint32_t> all_ns;
+
+	fprintf(fp, "{\n  \"chunk_ms\": %d,\n  \"tol_frames\": %d,\n  \"files\": [\n", chunk_ms, tol);
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		RegressFile& rf = files[i];
+		audio_sec += rf.audio_sec;
+		proc_sec += rf.proc_sec;
+		all_ns.insert(all_ns.end(), rf.chunk_ns.begin(), rf.chunk_ns.end());
+
+		fprintf(fp, "    { \"path\": ");
+		json_string(fp, rf.path);
+		fprintf(fp, ", \"trigger\": \"%s\", \"status\": \"%s\", \"detections\": %d, \"audio_sec\": %.3f, \"proc_sec\": %.4f, \"rtf\": %.5f, "
+			"\"chunks\": %d, \"latency_p50_us\": %.1f, \"latency_p99_us\": %.1f, \"latency_max_us\": %.1f }%s\n",
+			rf.keyword.empty() ? "word" : "mono", rf.status, (int)rf.dets.size(), rf.audio_sec, rf.proc_sec,
+			(0. < rf.audio_sec) ? rf.proc_sec / rf.audio_sec : 0., (int)rf.chunk_ns.size(),
+			percentile_us(rf.chunk_ns, .5), percentile_us(rf.chunk_ns, .99), percentile_us(rf.chunk_ns, 1.),
+			(i + 1 < files.size()) ? "," : "");
+	}
+	fprintf(fp, "  ],\n  \"total\": { \"files\": %d, \"failed\": %d, \"audio_sec\": %.3f, \"proc_sec\": %.4f, \"rtf\": %.5f, "
+		"\"latency_p50_us\": %.1f, \"latency_p99_us\": %.1f, \"latency_max_us\": %.1f, \"peak_rss_kb\": %ld }\n}\n",
+		(int)files.size(), failed, audio_sec, proc_sec, (0. < audio_sec) ? proc_sec / audio_sec : 0.,
+		percentile_us(all_ns, .5), percentile_us(all_ns, .99), percentile_us(all_ns, 1.), peak_rss_kb());
+	fclose(fp);
+
+	return true;
+}
+
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		puts("usage: TrgRegress root_path list_file [-update] [-tol frames] [-chunk ms] [-report file]");
+		return 2;
+	}
+	const char* root_path = argv[1];
+	const char* list_path = argv[2];
+
+	bool update = false;
+	int tol = 0;
+	int chunk_ms = 10;
+	const char* report_path = "regress.json";
+
+	for (int i = 3; i < argc; i++)
+	{
+		const bool has_value = i + 1 < argc;
+		if (0 == strcmp(argv[i], "-update"))	update = true;
+		else if (has_value && 0 == strcmp(argv[i], "-tol"))	tol = std::max(0, atoi(argv[++i]));
+		else if (has_value && 0 == strcmp(argv[i], "-chunk"))	chunk_ms = std::max(1, atoi(argv[++i]));
+		else if (has_value && 0 == strcmp(argv[i], "-report"))	report_path = argv[++i];
+		else { fprintf(stderr, "unknown option %s\n", argv[i]); return 2; }
+	}
+
+	// file list, paths relative to the list file as trg_file_tester
+	std::string list_dir(list_path);
+	list_dir = list_dir.substr(0, list_dir.find_last_of("/\\") + 1);
+
+	std::vector<RegressFile> files;
+	{
+		FILE* fp = fopen(list_path, "r");
+		if (!fp) { fprintf(stderr, "cannot read %s\n", list_path); return 2; }
+
+		char line[1024];
+		while (fgets(line, sizeof(line), fp))
+		{
+			char path[1024] = { 0 }, keyword[256] = { 0 };
+			if (sscanf(line, "%1023[^\t\r\n]\t%255[^\t\r\n]", path, keyword) < 1)	continue;
+
+			std::string file_path(path);
+			FILE* fp_test = fopen(file_path.c_str(), "rb");
+			if (!fp_test)
+			{
+				file_path = list_dir + file_path;
+				fp_test = fopen(file_path.c_str(), "rb");
+			}
+			if (!fp_test) { printf("file not exists:\n%s\n", path); continue; }
+			fclose(fp_test);
+
+			files.emplace_back();
+			files.back().path = file_path;
+			files.back().keyword = keyword;
+		}
+		fclose(fp);
+	}
+	if (files.empty()) { fprintf(stderr, "no files in %s\n", list_path); return 2; }
+
+	int failed = 0;
+	for (RegressFile& rf : files)
+	{
+		const std::string gold_path = rf.path + ".gold";
+		if (!run_file(root_path, rf, chunk_ms))
+			rf.status = "error";
+		else if (update)
+			rf.status = write_golden(gold_path, rf.dets) ? "updated" : "error";
+		else
+		{
+			std::vector<Detection> gold;
+			if (!read_golden(gold_path, gold))
+				rf.status = "missing";
+			else
+				rf.status = match_golden(rf.dets, gold, tol) ? "match" : "mismatch";
+		}
+		if (strcmp(rf.status, "match") && strcmp(rf.status, "updated"))	failed++;
+
+		printf("%s\t%s\t%d\tRTF %.4f\n", rf.path.c_str(), rf.status, (int)rf.dets.size(),
+			(0. < rf.audio_sec) ? rf.proc_sec / rf.audio_sec : 0.);
+	}
+
+	if (!write_report(report_path, files, tol, chunk_ms, failed))
+		fprintf(stderr, "cannot write %s\n", report_path);
+	printf("%d / %d files failed, report %s\n", failed, (int)files.size(), report_path);
+
+	return failed ? 1 : 0;
+}
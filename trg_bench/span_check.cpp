@@ -0,0 +1,150 @@
+// span_check.cpp
+// TriggerSpan at other input rates : keyword audio resampled to -rate goes through CDnnTrigger at that
+// rate, and the same audio resampled back to 16 kHz (what the trigger gets from its input stage) through
+// CDnnTrigger at 16 kHz. Both see the same 16 kHz stream, so the frames have to be the same and the
+// sample offsets the 16 kHz ones at -rate, less the delay of the resampler of the input stage
+//
+// usage: TrgSpanCheck root_path audio_file [-rate hz] [-prob x] [-tol ms]
+//   root_path  : directory holding ../conf/diotrg_16k.ini
+//   audio_file : .raw/.pcm or .wav, 16k 16bit mono with the keyword
+//   -rate      : input rate of the second run (default 48000)
+//   -prob      : detection threshold instead of [trigger] prob_threshold
+//   -tol       : allowed difference of the span offsets in ms (default 0.1)
+//
+// exit code 0 if the spans of both runs match, 1 if they don't / no detection / errors, 2 usage
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+#include "dnn_trigger_decoder/dnn_trigger.h"
+#include "dnn_trigger_decoder/audio_file.h"
+#include "resampler.h"
+
+#define CONFIG_PATH	"../conf/diotrg_16k.ini"
+#define FE_RATE		16000
+
+
+// detections of pcm at rate in 10ms chunks, with their spans
+static bool run(const char root_path[], const int rate, const float prob, const std::vector<int16_t>& pcm, std::vector<TriggerSpan>& spans)
+{
+	srand(1);	// dithering of the NR
+	CDnnTrigger trigger(root_path, CONFIG_PATH, rate, TRG_SAMPLE_S16);
+	if (trigger.getError())
+	{
+		fprintf(stderr, "error loading trigger engine (%d)\n", trigger.getError());
+		return false;
+	}
+
+	if (0.f <= prob)
+	{
+		TriggerParam param;
+		trigger.getParam(&param);
+		param.prob_threshold = prob;
+		if (!trigger.setParam(&param))
+		{
+			fprintf(stderr, "invalid -prob %g\n", prob);
+			return false;
+		}
+	}
+
+	const size_t chunk = rate / 100;
+	for (size_t done = 0; done < pcm.size(); done += chunk)
+	{
+		TriggerSpan span;
+		const int n = (int)std::min(chunk, pcm.size() - done);
+		if (0 < trigger.detectAudio(n, &pcm[done]) && trigger.getTriggerSpan(&span))
+			spans.push_back(span);
+	}
+	return true;
+}
+
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		puts("usage: TrgSpanCheck root_path audio_file [-rate hz] [-prob x] [-tol ms]");
+		return 2;
+	}
+	const char* root_path = argv[1];
+	const char* audio_path = argv[2];
+
+	int rate = 48000;
+	float prob = -1.f;
+	double tol_ms = 0.1;
+	for (int i = 3; i < argc; i++)
+	{
+		const bool has_value = i + 1 < argc;
+		if (has_value && 0 == strcmp(argv[i], "-rate"))	rate = atoi(argv[++i]);
+		else if (has_value && 0 == strcmp(argv[i], "-prob"))	prob = (float)atof(argv[++i]);
+		else if (has_value && 0 == strcmp(argv[i], "-tol"))	tol_ms = std::max(0., atof(argv[++i]));
+		else { fprintf(stderr, "unknown option %s\n", argv[i]); return 2; }
+	}
+
+	CAudioFileReader reader;
+	if (reader.open(audio_path))
+	{
+		fprintf(stderr, "%s : cannot read audio\n", audio_path);
+		return 1;
+	}
+	const AudioFormat& fmt = reader.getFormat();
+	if (FE_RATE != fmt.sample_rate || TRG_SAMPLE_S16 != fmt.format)
+	{
+		fprintf(stderr, "%s : not 16k 16bit mono\n", audio_path);
+		return 1;
+	}
+	const int16_t* samples = (const int16_t*)reader.frame(0);
+	const std::vector<int16_t> pcm(samples, samples + reader.getFrames());
+
+	// input at -rate, and back at 16 kHz through a resampler as the one of the input stage : 16 kHz
+	// sample s of it is at s * rate / 16000 - delay of the input
+	trg_resampler* up = trg_resampler_create(FE_RATE, rate);
+	trg_resampler* down = trg_resampler_create(rate, FE_RATE);
+	if (!up || !down)
+	{
+		fprintf(stderr, "-rate %d not supported\n", rate);
+		return 2;
+	}
+	std::vector<int16_t> pcm_in(trg_resampler_max_output(up, (int)pcm.size()));
+	pcm_in.resize(trg_resampler_process_s16(up, pcm.data(), (int)pcm.size(), 1, pcm_in.data()));
+	std::vector<int16_t> pcm_16k(trg_resampler_max_output(down, (int)pcm_in.size()));
+	pcm_16k.resize(trg_resampler_process_s16(down, pcm_in.data(), (int)pcm_in.size(), 1, pcm_16k.data()));
+	const double delay = trg_resampler_delay(down);
+	trg_resampler_destroy(up);
+	trg_resampler_destroy(down);
+
+	std::vector<TriggerSpan> ref, out;
+	if (!run(root_path, FE_RATE, prob, pcm_16k, ref) || !run(root_path, rate, prob, pcm_in, out))
+		return 1;
+
+	const double tol = tol_ms * rate / 1000.;
+	bool ok = !ref.empty() && ref.size() == out.size();
+	for (size_t i = 0; i < std::max(ref.size(), out.size()); i++)
+	{
+		if (i < ref.size() && i < out.size())
+		{
+			const double begin = std::max(0., (double)ref[i].sample_begin * rate / FE_RATE - delay);
+			const double end = std::max(0., (double)ref[i].sample_end * rate / FE_RATE - delay);
+			const bool match = ref[i].frame_begin == out[i].frame_begin && ref[i].frame_end == out[i].frame_end
+				&& fabs(out[i].sample_begin - begin) <= tol && fabs(out[i].sample_end - end) <= tol;
+			printf("frames %d-%d / %d-%d  samples %.0f-%.0f expected, %lld-%lld  %s\n",
+				ref[i].frame_begin, ref[i].frame_end, out[i].frame_begin, out[i].frame_end, begin, end,
+				(long long)out[i].sample_begin, (long long)out[i].sample_end, match ? "ok" : "MISMATCH");
+			ok = ok && match;
+		}
+		else if (i < ref.size())
+			printf("frames %d-%d at 16 kHz only\n", ref[i].frame_begin, ref[i].frame_end);
+		else
+			printf("frames %d-%d at %d Hz only\n", out[i].frame_begin, out[i].frame_end, rate);
+	}
+
+	if (ref.empty())
+		printf("FAIL : no detection at 16 kHz (keyword audio or lower -prob)\n");
+	else
+		printf("%s : %d detections at 16 kHz, %d at %d Hz\n", ok ? "OK" : "FAIL", (int)ref.size(), (int)out.size(), rate);
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,312 @@
+// thr_sweep.cpp
+// Detector threshold sweep : the DNN runs once per file of a labeled corpus, its posteriors are cached
+// next to the file (<file>.post, feature file layout, one row of classes per frame) and CDetectorWord
+// is replayed on them for every (prob_threshold, w_max, _CM_THRESHOLD2) of a grid
+//
+// usage: TrgThrSweep root_path list_file [-thr a:b:step] [-wmax a:b:step] [-cm2 a:b:step] [-j threads] [-fresh]
+//   root_path : directory holding ../conf/diotrg_16k.ini
+//   list_file : "path<TAB>keyword count" per line, count 0 (or none) for background audio
+//               path : 16k 16bit mono .raw/.wav file, or .trgf feature file (trg_file_tester -dump)
+//   -thr      : prob_threshold grid (default 0.50:0.95:0.05)
+//   -wmax     : w_max grid (default the config value)
+//   -cm2      : _CM_THRESHOLD2 grid (default the config value)
+//   -j        : worker threads (default hardware threads)
+//   -fresh    : ignore the cached posteriors
+//
+// output, one line per parameter set, w_max/cm2 groups sorted by prob_threshold (one DET/ROC curve each):
+//   prob_threshold w_max cm2 hits misses false_accepts miss_rate hit_rate fa_per_hour
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dnn_trigger_decoder/config.h"
+#include "dnn_trigger_decoder/feat_2pass.h"
+#include "dnn_trigger_decoder/feat_file.h"
+#include "dnn_trigger_decoder/dnn_decoder.h"
+#include "dnn_trigger_decoder/detector_word.h"
+#include "bench_audio.h"
+
+
+#define FRAME_SHIFT	160
+#define FEAT_DIM	51
+#define FRAMES_PER_HOUR	360000.0
+#define CONFIG_PATH	"../conf/diotrg_16k.ini"
+
+
+struct CorpusFile
+{
+	std::string path;
+	int keywords;			// labeled keyword count, 0 : background
+	CFeatFileReader post;	// cached posteriors, [frame][class], mapped once the list is complete
+};
+
+
+struct SweepPoint
+{
+	TriggerParam param;
+	long hits = 0, misses = 0, false_accepts = 0;
+	bool valid = false;
+};
+
+
+// a:b:step, or a single value
+static bool parse_range(const char arg[], std::vector<double>& values)
+{
+	double a, b, step;
+	values.clear();
+	const int n = sscanf(arg, "%lf:%lf:%lf", &a, &b, &step);
+	if (1 == n) { values.push_back(a); return true; }
+	if (3 != n || step <= 0 || b < a)	return false;
+
+	for (int i = 0; a + i * step <= b + 1e-9; i++)
+		values.push_back(a + i * step);
+	return true;
+}
+
+
+static bool is_feat_file(const std::string& path)
+{
+	return path.size() > 5 && 0 == path.compare(path.size() - 5, 5, ".trgf");
+}
+
+
+// DNN posteriors of one file to <file>.post
+static bool make_posteriors(const char root_path[], const char dnn_ini[], const std::string& path, const std::string& post_path)
+{
+	CDnnDecoder dnn(root_path, dnn_ini);
+	if (dnn.getError())	return false;
+	const int num_class = dnn.getNumOutNode();
+	std::vector<float> prob(num_class);
+
+	CFeatFileWriter writer;
+	if (writer.open(post_path.c_str(), num_class))	return false;
+
+	if (is_feat_file(path))
+	{
+		CFeatFileReader feat;
+		if (feat.open(path.c_str()) || FEAT_DIM != feat.getDim())	return false;
+
+		for (long f = 0; f < feat.getFrames(); f++)
+		{
+			dnn.decode(feat.row(f), prob.data());
+			if (writer.write(1, prob.data()))	return false;
+		}
+	}
+	else
+	{
+		std::vector<int16_t> pcm;
+		if (!read_audio(path.c_str(), pcm))	return false;
+
+		CFeat2pass fe(root_path);
+		if (fe.getError())	return false;
+
+		static thread_local float feat[40960];
+		for (size_t i = 0; i + FRAME_SHIFT <= pcm.size(); i += FRAME_SHIFT)
+		{
+			long len_feat = 0;
+			fe.getFeature(FRAME_SHIFT, &pcm[i], &len_feat, feat);
+			for (long f = 2; f + FEAT_DIM <= len_feat; f += FEAT_DIM)
+			{
+				dnn.decode(&feat[f], prob.data());
+				if (writer.write(1, prob.data()))	return false;
+			}
+		}
+	}
+
+	return 0 == writer.close();
+}
+
+
+// one detector per parameter set, replayed over the whole corpus
+static void run_point(const char root_path[], const int num_class, std::vector<CorpusFile>& corpus, SweepPoint& point)
+{
+	CDetectorWord det(num_class - 2, *CConfig::open(root_path, CONFIG_PATH));
+	if (det.getError() || !det.setParam(&point.param))
+		return;
+
+	for (auto& file : corpus)
+	{
+		det.reset();
+
+		long detected = 0;
+		for (long f = 0; f < file.post.getFrames(); f++)
+			if (0 < det.detect(file.post.row(f)))
+				detected++;
+
+		const long hits = std::min<long>(detected, file.keywords);
+		point.hits += hits;
+		point.misses += file.keywords - hits;
+		point.false_accepts += detected - hits;
+	}
+	point.valid = true;
+}
+
+
+// work items of a list pulled by 'threads' workers
+template <typename F>
+static void parallel_for(const int count, const int threads, F func)
+{
+	std::atomic<int> next(0);
+	std::vector<std::thread> workers;
+	for (int t = 0; t < threads; t++)
+		workers.emplace_back([&]() {
+			for (int i; (i = next++) < count;)
+				func(i);
+		});
+	for (auto& w : workers)
+		w.join();
+}
+
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		puts("usage: TrgThrSweep root_path list_file [-thr a:b:step] [-wmax a:b:step] [-cm2 a:b:step] [-j threads] [-fresh]");
+		return 2;
+	}
+	const char* root_path = argv[1];
+	const char* list_path = argv[2];
+
+	const std::shared_ptr<const CConfig> shared_config = CConfig::open(root_path, CONFIG_PATH);	// held while config is used
+	const CConfig& config = *shared_config;
+	char dnn_ini[256];
+	config.gets("trigger", "dnn_ini", "", dnn_ini, sizeof(dnn_ini));
+
+	std::vector<double> thr_grid, wmax_grid, cm2_grid;
+	parse_range("0.50:0.95:0.05", thr_grid);
+	wmax_grid.push_back(config.getl("trigger", "w_max", 50));
+	cm2_grid.push_back(config.getl("trigger", "_CM_THRESHOLD2", 10));
+	int threads = std::max(1u, std::thread::hardware_concurrency());
+	bool fresh = false;
+
+	for (int i = 3; i < argc; i++)
+	{
+		const bool has_value = i + 1 < argc;
+		if (0 == strcmp(argv[i], "-fresh"))	fresh = true;
+		else if (has_value && 0 == strcmp(argv[i], "-thr")) { if (!parse_range(argv[++i], thr_grid)) { fprintf(stderr, "bad range %s\n", argv[i]); return 2; } }
+		else if (has_value && 0 == strcmp(argv[i], "-wmax")) { if (!parse_range(argv[++i], wmax_grid)) { fprintf(stderr, "bad range %s\n", argv[i]); return 2; } }
+		else if (has_value && 0 == strcmp(argv[i], "-cm2")) { if (!parse_range(argv[++i], cm2_grid)) { fprintf(stderr, "bad range %s\n", argv[i]); return 2; } }
+		else if (has_value && 0 == strcmp(argv[i], "-j"))	threads = std::max(1, atoi(argv[++i]));
+		else { fprintf(stderr, "unknown option %s\n", argv[i]); return 2; }
+	}
+
+	// corpus list, paths relative to the list file as trg_file_tester
+	std::string list_dir(list_path);
+	list_dir = list_dir.substr(0, list_dir.find_last_of("/\\") + 1);
+
+	std::vector<CorpusFile> corpus;
+	{
+		FILE* fp = fopen(list_path, "r");
+		if (!fp) { fprintf(stderr, "cannot read %s\n", list_path); return 2; }
+
+		char line[1024];
+		while (fgets(line, sizeof(line), fp))
+		{
+			char path[1024] = { 0 };
+			int keywords = 0;
+			if (sscanf(line, "%1023[^\t\r\n]\t%d", path, &keywords) < 1)	continue;
+
+			std::string file_path(path);
+			FILE* fp_test = fopen(file_path.c_str(), "rb");
+			if (!fp_test)
+			{
+				file_path = list_dir + file_path;
+				fp_test = fopen(file_path.c_str(), "rb");
+			}
+			if (!fp_test) { printf("file not exists:\n%s\n", path); continue; }
+			fclose(fp_test);
+
+			corpus.emplace_back();
+			corpus.back().path = file_path;
+			corpus.back().keywords = std::max(0, keywords);
+		}
+		fclose(fp);
+	}
+	if (corpus.empty()) { fprintf(stderr, "empty corpus\n"); return 2; }
+
+	int num_class;
+	{
+		CDnnDecoder dnn(root_path, dnn_ini);
+		if (dnn.getError()) { fprintf(stderr, "DNN init error %d\n", dnn.getError()); return 2; }
+		num_class = dnn.getNumOutNode();
+	}
+
+	// the front end connects once, before the workers open their channels
+	CFeat2pass::setChannel(std::max(16, threads + 1));
+	CFeat2pass fe_connect(root_path);
+	if (fe_connect.getError()) { fprintf(stderr, "front end init error %d\n", fe_connect.getError()); return 2; }
+
+	// posteriors : cached ones of the same class count are used as is
+	std::atomic<int> decoded(0), failed(0);
+	parallel_for((int)corpus.size(), threads, [&](const int i) {
+		CorpusFile& file = corpus[i];
+		const std::string post_path = file.path + ".post";
+
+		if (!fresh && 0 == file.post.open(post_path.c_str()) && num_class == file.post.getDim())
+			return;
+
+		file.post.close();
+		decoded++;
+		if (!make_posteriors(root_path, dnn_ini, file.path, post_path) || file.post.open(post_path.c_str()))
+		{
+			fprintf(stderr, "cannot decode %s\n", file.path.c_str());
+			failed++;
+		}
+	});
+	if (failed) { fprintf(stderr, "%d files failed\n", (int)failed); return 2; }
+
+	long total_frames = 0, background_frames = 0, total_keywords = 0;
+	for (auto& file : corpus)
+	{
+		total_frames += file.post.getFrames();
+		total_keywords += file.keywords;
+		if (0 == file.keywords)
+			background_frames += file.post.getFrames();
+	}
+	// false accepts per hour of background audio, of all audio if the corpus has none
+	const double fa_hours = (background_frames ? background_frames : total_frames) / FRAMES_PER_HOUR;
+
+	std::vector<SweepPoint> points;
+	for (const double wmax : wmax_grid)
+		for (const double cm2 : cm2_grid)
+			for (const double thr : thr_grid)
+			{
+				SweepPoint point;
+				point.param.prob_threshold = (float)thr;
+				point.param.w_max = (int)wmax;
+				point.param.cm_threshold2 = (int)cm2;
+				points.push_back(point);
+			}
+
+	parallel_for((int)points.size(), threads, [&](const int i) {
+		run_point(root_path, num_class, corpus, points[i]);
+	});
+
+	printf("# %zu files, %d decoded, %.2f hours (%.2f background), %ld keywords, %zu parameter sets, %d threads\n",
+		corpus.size(), (int)decoded, total_frames / FRAMES_PER_HOUR, background_frames / FRAMES_PER_HOUR,
+		total_keywords, points.size(), threads);
+	printf("# prob_threshold\tw_max\tcm2\thits\tmisses\tfalse_accepts\tmiss_rate\thit_rate\tfa_per_hour\n");
+	for (auto& point : points)
+	{
+		if (!point.valid)
+		{
+			printf("# %.4f\t%d\t%d\trejected by the detector\n", point.param.prob_threshold, point.param.w_max, point.param.cm_threshold2);
+			continue;
+		}
+
+		const double miss_rate = total_keywords ? (double)point.misses / total_keywords : 0.0;
+		printf("%.4f\t%d\t%d\t%ld\t%ld\t%ld\t%.4f\t%.4f\t%.3f\n",
+			point.param.prob_threshold, point.param.w_max, point.param.cm_threshold2,
+			point.hits, point.misses, point.false_accepts, miss_rate, 1.0 - miss_rate, point.false_accepts / fa_hours);
+	}
+
+	return 0;
+}
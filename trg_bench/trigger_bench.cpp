@@ -0,0 +1,294 @@
+// trigger_bench.cpp
+// Per-stage microbenchmarks of the trigger pipeline : ns per 10 ms frame and real-time factor of each stage
+//
+// usage: TrgBench [root_path] [16k 16bit mono .raw/.wav file ...]
+//   root_path : directory holding ../conf/diotrg_16k.ini and ../conf/diotrg_mono_16k.ini (default ./)
+//   60 sec of synthetic noisy speech-like audio, then each audio file
+//
+// stages, one frame each:
+//   sized_queue     SizedQueue::putItems + getItems of 160 samples
+//   front_end       CFeat2pass::getFeature, the whole front end
+//   nr_wiener       PowerASR_NR_Wiener_procFrameBuffer
+//   wave2mfcc       PowerASR_FX_Wave2Mfcc_convertFrameSample2Mfcc
+//   mfcc2feat       EPD + PowerASR_FX_Mfcc2Feat_convertMfccStream2FeatureVector
+//   dnn layer N     do_forward_prop of layer N of the [trigger] DNN
+//   dnn             do_forward_prop, all layers
+//   detector_word   CDetectorWord::detect on the [trigger] DNN posteriors
+//   detector_mono   CDetectorMono::detect on the [mono] DNN posteriors
+// the front end modules are the stage times the front end channel keeps during the front_end run
+// (CFeat2pass::getStageTime(), not shown with TRG_STATS OFF),
+// per call timings include the clock reads (some 20 ns)
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "dnn_trigger_decoder/SizedQueue.h"
+#include "dnn_trigger_decoder/config.h"
+#include "dnn_trigger_decoder/feat_2pass.h"
+#include "dnn_trigger_decoder/dnn_decoder.h"
+#include "dnn_trigger_decoder/detector_word.h"
+#include "dnn_trigger_decoder/detector_mono.h"
+#include "bp_train.h"
+#include "PowerAI_BaseCommon.h"
+#include "bench_audio.h"
+
+
+#define SAMPLE_RATE	16000
+#define FRAME_SHIFT	160
+#define FEAT_DIM	51
+#define FRAME_NS	1e7		// 10 ms
+#define CONFIG_PATH	"../conf/diotrg_16k.ini"
+#define MONO_CONFIG_PATH	"../conf/diotrg_mono_16k.ini"
+#define MONO_KEYWORD	"\xC7\xCF\xC0\xCC\xBC\xBF\xB9\xD9"	// cp949, see trg_file_tester
+
+
+typedef std::chrono::steady_clock bench_clock;
+
+static inline double elapsed_ns(const bench_clock::time_point start)
+{
+	return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(bench_clock::now() - start).count();
+}
+
+
+struct Stage
+{
+	std::string name;
+	double ns = 0;
+	long frames = 0;
+
+	Stage(const std::string& name) : name(name) {}
+	void report() const
+	{
+		if (!frames)	return;
+		const double ns_frame = ns / frames;
+		printf("%-24s %8ld %12.1f %10.5f\n", name.c_str(), frames, ns_frame, ns_frame / FRAME_NS);
+	}
+};
+
+
+static void bench_queue(const std::vector<int16_t>& pcm, std::vector<Stage>& stages)
+{
+	SizedQueue queue(SAMPLE_RATE);
+	int16_t frame[FRAME_SHIFT];
+	const long num_frames = (long)(pcm.size() / FRAME_SHIFT);
+
+	Stage stage("sized_queue");
+	const auto start = bench_clock::now();
+	for (long i = 0; i < num_frames; i++)
+	{
+		queue.putItems(FRAME_SHIFT, &pcm[i * FRAME_SHIFT]);
+		queue.getItems(FRAME_SHIFT, frame);
+	}
+	stage.ns = elapsed_ns(start);
+	stage.frames = num_frames;
+	stages.push_back(stage);
+}
+
+
+// features of the trigger (front end as a whole)
+static bool bench_front_end(const char root_path[], const std::vector<int16_t>& pcm, std::vector<float>& feats, std::vector<Stage>& stages)
+{
+	CFeat2pass fe(root_path);
+	if (fe.getError()) { fprintf(stderr, "front end init error %d\n", fe.getError()); return false; }
+
+	static float feat_buf[40960];
+	const long num_frames = (long)(pcm.size() / FRAME_SHIFT);
+	feats.clear();
+
+	Stage stage("front_end");
+	fe.clearStageTime();
+	for (long i = 0; i < num_frames; i++)
+	{
+		long len_feat = 0;
+		const auto start = bench_clock::now();
+		fe.getFeature(FRAME_SHIFT, &pcm[i * FRAME_SHIFT], &len_feat, feat_buf);
+		stage.ns += elapsed_ns(start);
+
+		if (len_feat > 2)
+			feats.insert(feats.end(), &feat_buf[2], &feat_buf[len_feat]);
+	}
+	stage.frames = num_frames;
+	stages.push_back(stage);
+
+	// its modules, from the stage times the front end channel keeps (not timed with TRG_STATS OFF)
+	static const char* const fe_stage[3] = { "nr_wiener", "wave2mfcc", "mfcc2feat" };
+	uint64_t fe_ns[3];
+	fe.getStageTime(fe_ns);
+	for (int s = 0; s < 3; s++)
+	{
+		Stage module(fe_stage[s]);
+		module.ns = (double)fe_ns[s];
+		module.frames = fe_ns[s] ? num_frames : 0;
+		stages.push_back(module);
+	}
+
+	return true;
+}
+
+
+// layer by layer through the [trigger] DNN, the posteriors go to the word detector
+static bool bench_dnn(const char root_path[], const std::vector<float>& feats, std::vector<float>& posteriors, int& num_class, std::vector<Stage>& stages)
+{
+	const std::shared_ptr<const CConfig> shared_config = CConfig::open(root_path, CONFIG_PATH);	// held while config is used
+	const CConfig& config = *shared_config;
+	char dnn_ini[256];
+	config.gets("trigger", "dnn_ini", "", dnn_ini, sizeof(dnn_ini));
+
+	DNN_Resource resource;
+	if (SUCCESS != DNN_LoadConfig(&resource, root_path, dnn_ini)) { fprintf(stderr, "cannot read %s\n", dnn_ini); return false; }
+	Deepnet* net = DNN_create(resource.dnnStructParam.numLayer, resource.dnnStructParam.numNodes, resource.dnnStructParam.nonLinearFunc);
+	if (SUCCESS != DNN_load_dnn(net, root_path, resource.szSeedDnnFile)) { fprintf(stderr, "cannot load the DNN\n"); DNN_destroy(net); return false; }
+	DNN_LAYER_UNIT* units = DNN_create_layer_unit(net);
+
+	// input : concatenated window of consecutive feature frames
+	const int n_vis = net->dnnStage[0].nVisNodes;
+	const int window = (n_vis + FEAT_DIM - 1) / FEAT_DIM;
+	std::vector<float> input(n_vis);
+	units->unit[0] = input.data();
+
+	// one stage networks sharing the weights and the layer buffers of the whole one
+	std::vector<Deepnet> layer_net(net->nStage);
+	std::vector<DNN_LAYER_UNIT> layer_units(net->nStage);
+	std::vector<Stage> layer_stages;
+	for (int l = 0; l < net->nStage; l++)
+	{
+		layer_net[l].nStage = 1;
+		layer_net[l].dnnStage[0] = net->dnnStage[l];
+		layer_net[l].nonLinearFunc[0] = net->nonLinearFunc[l];
+		layer_units[l].n_layer = 2;
+		layer_units[l].unit[0] = units->unit[l];
+		layer_units[l].unit[1] = units->unit[l + 1];
+
+		char name[64];
+		snprintf(name, sizeof(name), "dnn layer %d (%dx%d)", l, net->dnnStage[l].nVisNodes, net->dnnStage[l].nHidNodes);
+		layer_stages.push_back(Stage(name));
+	}
+	Stage dnn_stage("dnn");
+
+	const long num_feat = (long)(feats.size() / FEAT_DIM);
+	num_class = net->dnnStage[net->nStage - 1].nHidNodes;
+	posteriors.clear();
+
+	for (long f = 0; f + window <= num_feat; f++)
+	{
+		memcpy(input.data(), &feats[f * FEAT_DIM], sizeof(float) * n_vis);
+
+		for (int l = 0; l < net->nStage; l++)
+		{
+			const auto start = bench_clock::now();
+			do_forward_prop(&layer_net[l], &layer_units[l]);
+			layer_stages[l].ns += elapsed_ns(start);
+			layer_stages[l].frames++;
+		}
+
+		const auto start = bench_clock::now();
+		do_forward_prop(net, units);
+		dnn_stage.ns += elapsed_ns(start);
+		dnn_stage.frames++;
+
+		const float* out = units->unit[net->nStage];
+		posteriors.insert(posteriors.end(), out, out + num_class);
+	}
+
+	stages.insert(stages.end(), layer_stages.begin(), layer_stages.end());
+	stages.push_back(dnn_stage);
+
+	DNN_destroy_layer_unit(units);
+	DNN_destroy(net);
+	return true;
+}
+
+
+static void bench_detector_word(const char root_path[], const std::vector<float>& posteriors, const int num_class, std::vector<Stage>& stages)
+{
+	CDetectorWord det(num_class - 2, *CConfig::open(root_path, CONFIG_PATH));
+	if (det.getError()) { fprintf(stderr, "word detector init error %d\n", det.getError()); return; }
+
+	const long num_frames = (long)(posteriors.size() / num_class);
+	int detected = 0;
+
+	Stage stage("detector_word");
+	const auto start = bench_clock::now();
+	for (long f = 0; f < num_frames; f++)
+		detected += det.detect(&posteriors[f * num_class]);
+	stage.ns = elapsed_ns(start);
+	stage.frames = num_frames;
+	stages.push_back(stage);
+
+	if (detected < 0)	printf("word detector error\n");
+}
+
+
+// posteriors of the [mono] DNN (untimed), then the phone sequence detector
+static void bench_detector_mono(const char root_path[], const std::vector<float>& feats, std::vector<Stage>& stages)
+{
+	const std::shared_ptr<const CConfig> shared_config = CConfig::open(root_path, MONO_CONFIG_PATH);	// held while config is used
+	const CConfig& config = *shared_config;
+	char dnn_ini[256];
+	config.gets("mono", "dnn_ini", "", dnn_ini, sizeof(dnn_ini));
+	if ('\0' == dnn_ini[0]) { printf("no %s, detector_mono skipped\n", MONO_CONFIG_PATH); return; }
+
+	CDnnDecoder dnn(root_path, dnn_ini);
+	if (dnn.getError()) { fprintf(stderr, "mono DNN init error %d\n", dnn.getError()); return; }
+	const int num_phone = dnn.getNumOutNode();
+
+	CDetectorMono det(num_phone, config);
+	if (det.getError() || det.addPhonSeq(MONO_KEYWORD) < 0) { fprintf(stderr, "mono detector init error %d\n", det.getError()); return; }
+
+	const long num_frames = (long)(feats.size() / FEAT_DIM);
+	std::vector<float> posteriors((size_t)num_frames * num_phone);
+	for (long f = 0; f < num_frames; f++)
+		dnn.decode(&feats[f * FEAT_DIM], &posteriors[f * num_phone]);
+
+	Stage stage("detector_mono");
+	const auto start = bench_clock::now();
+	for (long f = 0; f < num_frames; f++)
+		det.detect(&posteriors[f * num_phone]);
+	stage.ns = elapsed_ns(start);
+	stage.frames = num_frames;
+	stages.push_back(stage);
+}
+
+
+static bool run(const char root_path[], const char name[], const std::vector<int16_t>& pcm)
+{
+	std::vector<Stage> stages;
+	std::vector<float> feats, posteriors;
+	int num_class = 0;
+
+	bench_queue(pcm, stages);
+	if (!bench_front_end(root_path, pcm, feats, stages))	return false;
+	if (!bench_dnn(root_path, feats, posteriors, num_class, stages))	return false;
+	bench_detector_word(root_path, posteriors, num_class, stages);
+	bench_detector_mono(root_path, feats, stages);
+
+	printf("\n%s : %.1f sec, %ld frames\n", name, (double)pcm.size() / SAMPLE_RATE, (long)(pcm.size() / FRAME_SHIFT));
+	printf("%-24s %8s %12s %10s\n", "stage", "frames", "ns/frame", "RTF");
+	for (const auto& stage : stages)
+		stage.report();
+
+	return true;
+}
+
+
+int main(int argc, char* argv[])
+{
+	const char* root_path = (argc > 1) ? argv[1] : "./";
+	std::vector<int16_t> pcm;
+
+	make_synthetic(pcm, 60);
+	if (!run(root_path, "synthetic", pcm))	return 1;
+
+	for (int i = 2; i < argc; i++)
+	{
+		if (!read_audio(argv[i], pcm)) { fprintf(stderr, "cannot read %s\n", argv[i]); return 1; }
+		if (!run(root_path, argv[i], pcm))	return 1;
+	}
+
+	return 0;
+}
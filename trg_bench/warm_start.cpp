@@ -0,0 +1,113 @@
+// warm_start.cpp
+// Startup time of CDnnTrigger loaded from the config files (cold) and from a startup snapshot (warm),
+// one start per process as the front end is shared by the process
+//
+// usage: TrgWarmStart save root_path snapshot_file   : cold start, then write the snapshot
+//        TrgWarmStart cold root_path [audio file]     : cold start
+//        TrgWarmStart load snapshot_file [audio file] : warm start from the snapshot
+//   root_path  : directory holding ../conf/diotrg_16k.ini
+//   audio file : .raw/.pcm (16k 16bit mono) or .wav, its detections are printed after the start time
+//                ("frame<TAB>span" per line), the same for cold and load with a snapshot of the same config
+//
+// exit code 0, 1 on errors, 2 usage
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+#include "dnn_trigger_decoder/dnn_trigger.h"
+#include "dnn_trigger_decoder/snapshot.h"
+#include "dnn_trigger_decoder/audio_file.h"
+
+#define CONFIG_PATH	"../conf/diotrg_16k.ini"
+
+
+typedef std::chrono::steady_clock start_clock;
+
+
+static int run_file(CDnnTrigger* trigger, CAudioFileReader& reader)
+{
+	const long chunk = reader.getFormat().sample_rate / 100;
+	const long frames = reader.getFrames();
+	int detections = 0;
+
+	for (long done = 0; done < frames; )
+	{
+		const long n = std::min(chunk, frames - done);
+		int spinfo[2] = { 0, 0 };
+
+		const int ret_dec = trigger->detectAudio((int)n, reader.frame(done), spinfo);
+		if (0 < ret_dec)
+		{
+			printf("%d\t%d\n", ret_dec, spinfo[1]);
+			detections++;
+		}
+		done += n;
+	}
+	return detections;
+}
+
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3 || (strcmp(argv[1], "save") && strcmp(argv[1], "cold") && strcmp(argv[1], "load"))
+		|| (!strcmp(argv[1], "save") && argc < 4))
+	{
+		fprintf(stderr, "usage: %s save root_path snapshot_file | cold root_path [audio file] | load snapshot_file [audio file]\n", argv[0]);
+		return 2;
+	}
+	const bool load = !strcmp(argv[1], "load");
+	const bool save = !strcmp(argv[1], "save");
+	const char* audio_path = (!save && argc > 3) ? argv[3] : NULL;
+
+	CAudioFileReader reader;
+	if (audio_path && reader.open(audio_path))
+	{
+		fprintf(stderr, "%s : cannot read audio\n", audio_path);
+		return 1;
+	}
+	const AudioFormat& fmt = reader.getFormat();
+
+	const auto start = start_clock::now();
+	std::unique_ptr<CDnnTrigger> trigger;
+	if (load)
+	{
+		CSnapshot* snapshot = new CSnapshot;
+		const int ret = snapshot->open(argv[2]);
+		if (ret)
+		{
+			fprintf(stderr, "%s : %s\n", argv[2], (-2 == ret) ? "not a snapshot of this build" : "cannot map");
+			delete snapshot;
+			return 1;
+		}
+		trigger.reset(new CDnnTrigger(snapshot, fmt.sample_rate, fmt.format));
+	}
+	else
+		trigger.reset(new CDnnTrigger(argv[2], CONFIG_PATH, fmt.sample_rate, fmt.format));
+	const double start_ms = std::chrono::duration<double, std::milli>(start_clock::now() - start).count();
+
+	if (trigger->getError())
+	{
+		fprintf(stderr, "error loading trigger engine (%d)\n", trigger->getError());
+		return 1;
+	}
+	printf("%s start %.2f ms\n", load ? "warm" : "cold", start_ms);
+
+	if (save)
+	{
+		const auto save_start = start_clock::now();
+		if (trigger->saveSnapshot(argv[3]))
+		{
+			fprintf(stderr, "%s : cannot write snapshot\n", argv[3]);
+			return 1;
+		}
+		printf("snapshot %s written in %.2f ms\n", argv[3], std::chrono::duration<double, std::milli>(start_clock::now() - save_start).count());
+	}
+
+	if (audio_path)
+		printf("%d detections\n", run_file(trigger.get(), reader));
+
+	return 0;
+}
@@ -1,12 +1,22 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <memory>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include <sndfile.hh>
 #pragma comment(lib, "libsndfile-1")
 
 #include "dnn_trigger_decoder/dnn_trigger.h"
 #include "dnn_trigger_decoder/mono_trigger.h"
+#include "dnn_trigger_decoder/feat_file.h"
+#include "dnn_trigger_decoder/audio_file.h"
 #pragma comment(lib, "dnn_trigger")
 
 #if defined(unix) || defined(__unix__) || defined(__linux__)
@@ -18,6 +28,90 @@
 
 using std::unique_ptr;
 
+static bool g_feat_dump = false;	// -dump : record the features of each sound file to <file>.trgf
+static bool g_stats = false;		// -stats : profiling counters of the CDnnTrigger runs
+static TriggerStats g_stats_sum;
+static int g_jobs = 0;				// -j N : files of a list on N threads, 0 : one by one
+static std::mutex g_mutex;			// g_stats_sum and the output of the -j threads
+
+
+// add the counters of one run to g_stats_sum
+static void addStats(ITriggerAPI& trigger)
+{
+	TriggerStats s;
+	if (!g_stats || !trigger.getStats(&s))	return;
+
+	std::lock_guard<std::mutex> lock(g_mutex);
+
+	g_stats_sum.frames += s.frames;
+	g_stats_sum.dnn_frames += s.dnn_frames;
+	g_stats_sum.fe_ns += s.fe_ns;
+	g_stats_sum.nr_ns += s.nr_ns;
+	g_stats_sum.mfcc_ns += s.mfcc_ns;
+	g_stats_sum.mfcc2feat_ns += s.mfcc2feat_ns;
+	g_stats_sum.dnn_ns += s.dnn_ns;
+	g_stats_sum.dnn_layers = s.dnn_layers;
+	for (int l = 0; l < TRG_STATS_LAYERS; l++)
+		g_stats_sum.dnn_layer_ns[l] += s.dnn_layer_ns[l];
+	g_stats_sum.detector_ns += s.detector_ns;
+	g_stats_sum.queue_overrun += s.queue_overrun;
+	for (int b = 0; b < TRG_STATS_BUCKETS; b++)
+		g_stats_sum.latency[b] += s.latency[b];
+	if (g_stats_sum.latency_max_ns < s.latency_max_ns)
+		g_stats_sum.latency_max_ns = s.latency_max_ns;
+}
+
+
+// lower bound of a latency bucket in ns, TriggerStats::latency
+static uint64_t latencyBucketNs(const int b)
+{
+	return (b < 4) ? b : (uint64_t)(4 + b % 4) << (b / 4 - 1);
+}
+
+
+static uint64_t latencyPercentile(const TriggerStats& s, const double q)
+{
+	uint64_t total = 0, count = 0;
+	for (int b = 0; b < TRG_STATS_BUCKETS; b++)
+		total += s.latency[b];
+	for (int b = 0; b < TRG_STATS_BUCKETS; b++)
+	{
+		count += s.latency[b];
+		if (0 < count && total * q <= count)
+			return latencyBucketNs(b);
+	}
+	return s.latency_max_ns;
+}
+
+
+static void printStats()
+{
+	const TriggerStats& s = g_stats_sum;
+	if (0 == s.frames)	{ puts("no profiling counters"); return; }
+
+	// us per 10ms frame, RTF = time / audio
+	#define STAT_ROW(name, ns)	printf("%-20s %10.2f %10.5f\n", name, (ns) * 1e-3 / s.frames, (ns) * 1e-7 / s.frames)
+	printf("\n%-20s %10s %10s\n", "stage", "us/frame", "RTF");
+	STAT_ROW("front end", s.fe_ns);
+	STAT_ROW("  nr", s.nr_ns);
+	STAT_ROW("  mfcc", s.mfcc_ns);
+	STAT_ROW("  mfcc2feat", s.mfcc2feat_ns);
+	STAT_ROW("dnn", s.dnn_ns);
+	for (int l = 0; l < s.dnn_layers && l < TRG_STATS_LAYERS; l++)
+	{
+		char name[32];
+		sprintf(name, "  layer %d", l);
+		STAT_ROW(name, s.dnn_layer_ns[l]);
+	}
+	STAT_ROW("detector", s.detector_ns);
+	#undef STAT_ROW
+
+	printf("frames %llu, dnn frames %llu, queue overrun %llu samples\n",
+		(unsigned long long)s.frames, (unsigned long long)s.dnn_frames, (unsigned long long)s.queue_overrun);
+	printf("frame latency us : p50 %.1f, p99 %.1f, p99.9 %.1f, max %.1f\n",
+		latencyPercentile(s, 0.5) * 1e-3, latencyPercentile(s, 0.99) * 1e-3, latencyPercentile(s, 0.999) * 1e-3, s.latency_max_ns * 1e-3);
+}
+
 char *trimwhitespace(char *str)
 {
 	// Trim leading space
@@ -64,54 +158,127 @@ static SndfileHandle OpenSoundFile(const char fname[], const int raw_sf = 16000)
 }
 
 
+// detectAudio() input of the mapped / streamed readers : at most one detection per call while
+// the chunk is not longer than the _CM_THRESHOLD2 frames the detector needs after a detection
+#define AUDIO_CHUNK_MS	100
+
+// raw / WAV file mapped in place, or a stream ("-" : stdin), fed in AUDIO_CHUNK_MS chunks without copies
+static int testAudioFile(const char fname[], const CDnnTrigger* model, double* audio_sec)
+{
+	CAudioFileReader file;
+	CAudioStreamReader stream;
+	const bool streamed = !strcmp(fname, "-");
+	const int ret_open = streamed ? stream.open(fname) : file.open(fname);
+	if (ret_open)
+	{
+		printf("%s\n%s\n", fname, (-1 == ret_open) ? "cannot open file" : "unsupported audio format");
+		return -1;
+	}
+	const AudioFormat fmt = streamed ? stream.getFormat() : file.getFormat();
+
+	unique_ptr<CDnnTrigger> trigger(model ? new CDnnTrigger(model, fmt.sample_rate, fmt.format)
+		: new CDnnTrigger("./", "../conf/diotrg_16k.ini", fmt.sample_rate, fmt.format));
+	CDnnTrigger& dnn_trigger = *trigger;
+	if (dnn_trigger.getError())
+	{
+		printf("error loading trigger engine\n");
+		return -5;
+	}
+	if (g_feat_dump && !streamed && dnn_trigger.setFeatureDump((std::string(fname) + ".trgf").c_str()))
+		printf("cannot write %s.trgf\n", fname);
+
+	int kw_detected = 0;
+	const long chunk = (long)fmt.sample_rate * AUDIO_CHUNK_MS / 1000;
+	long done = 0;
+	for (;;)
+	{
+		const void* data;
+		long n;
+		if (streamed)
+			n = stream.read(chunk, &data);
+		else
+		{
+			n = std::min(chunk, file.getFrames() - done);
+			data = file.frame(done);
+		}
+		if (n <= 0)	break;
+		done += n;
+
+		int spinfo[2];
+		auto ret_dec = dnn_trigger.detectAudio((int)n, data, spinfo);
+		if (0 < ret_dec)
+		{
+			if (!g_jobs)	printf("%8d KW detected! -> %8d, %8d\n", kw_detected, dnn_trigger.getOutFrame() - spinfo[1],dnn_trigger.getOutFrame());
+			kw_detected++;
+		}
+	}
+	if (audio_sec)	*audio_sec = (double)done / fmt.sample_rate;
+
+	addStats(dnn_trigger);
+	return kw_detected;
+}
+
+
 // ٺ Ű ׽Ʈ
-int testSndFile(const char fname[])
+// model : session on the DNNs of model instead of loading them, audio_sec : length of the file
+int testSndFile(const char fname[], const CDnnTrigger* model = NULL, double* audio_sec = NULL)
 {
+	if (isAudioFile(fname))
+		return testAudioFile(fname, model, audio_sec);
+
 	SndfileHandle sfh = OpenSoundFile(fname);
 	if (SF_ERR_NO_ERROR  != sfh.error()) {
 		printf("%s\n%s\n", fname, sfh.strError());
 		return -1;
 	}
 
-	if (1 != sfh.channels())
+	if (2 < sfh.channels())
 	{
-		puts("only 1 channel file supported.\n");
+		puts("only 1 or 2 channel file supported.\n");
 		return -2;
 	}
 
-
-	CDnnTrigger dnn_trigger("./", "../conf/diotrg_16k.ini");
+	// any sample rate, the trigger resamples to 16 kHz
+	const int format = (2 == sfh.channels()) ? TRG_SAMPLE_F32_STEREO : TRG_SAMPLE_F32;
+	unique_ptr<CDnnTrigger> trigger(model ? new CDnnTrigger(model, sfh.samplerate(), format)
+		: new CDnnTrigger("./", "../conf/diotrg_16k.ini", sfh.samplerate(), format));
+	CDnnTrigger& dnn_trigger = *trigger;
 	if (dnn_trigger.getError())
 	{
 		printf("error loading trigger engine\n");
 		return -5;
 	}
+	if (g_feat_dump && dnn_trigger.setFeatureDump((std::string(fname) + ".trgf").c_str()))
+		printf("cannot write %s.trgf\n", fname);
 
 	long feat_size = 0;
 	int kw_detected = 0;
 	unique_ptr<float[]> feat_out(new float[40960 + 10]());
-	short pcm_buf[160];
+	const int frame_len = sfh.samplerate() / 100;	// 10ms
+	unique_ptr<float[]> pcm_buf(new float[frame_len * sfh.channels()]);
 	auto samp_len = sfh.frames();
+	if (audio_sec)	*audio_sec = (double)samp_len / sfh.samplerate();
 	//printf("Sound length: %d samples (%d frames)\n", samp_len, samp_len/160);
 
-	for (int f = 0; f < samp_len - 160; f += 160)
+	for (int f = 0; f < samp_len - frame_len; f += frame_len)
 	{
-		sfh.readf(pcm_buf, 160);
+		sfh.readf(pcm_buf.get(), frame_len);
 		int spinfo[2];
-		auto ret_dec = dnn_trigger.detect(160, pcm_buf,spinfo);
+		auto ret_dec = dnn_trigger.detectAudio(frame_len, pcm_buf.get(), spinfo);
 		if (0 < ret_dec)
 		{
 			//printf("KW detected at %d frame \n", dnn_trigger.getOutFrame());
-			printf("%8d KW detected! -> %8d, %8d\n", kw_detected, dnn_trigger.getOutFrame() - spinfo[1],dnn_trigger.getOutFrame());
+			if (!g_jobs)	printf("%8d KW detected! -> %8d, %8d\n", kw_detected, dnn_trigger.getOutFrame() - spinfo[1],dnn_trigger.getOutFrame());
 			kw_detected++;
 		}
 	}
 
+	addStats(dnn_trigger);
 	return kw_detected;
 }
 
 // monophone ׽Ʈ
-int testSndFile(const char fname[], const char keyword[])
+int testSndFile(const char fname[], const char keyword[], double* audio_sec = NULL)
 {
 	SndfileHandle sfh = OpenSoundFile(fname);
 	if (SF_ERR_NO_ERROR  != sfh.error()) {
@@ -139,6 +306,7 @@ int testSndFile(const char fname[], const char keyword[])
 	unique_ptr<float[]> feat_out(new float[40960 + 10]());
 	short pcm_buf[160];
 	auto samp_len = sfh.frames();
+	if (audio_sec)	*audio_sec = samp_len / 16000.;
 	//printf("Sound length: %d samples (%d frames)\n", samp_len, samp_len/160);
 
 	for (int f = 0; f < samp_len - 160; f += 160)
@@ -148,7 +316,7 @@ int testSndFile(const char fname[], const char keyword[])
 		auto ret_dec = dnn_trigger.detect(160, pcm_buf);
 		if (0 < ret_dec)
 		{
-			printf("KW detected at %d frame \n", dnn_trigger.getOutFrame());
+			if (!g_jobs)	printf("KW detected at %d frame \n", dnn_trigger.getOutFrame());
 			kw_detected++;
 		}
 	}
@@ -157,14 +325,128 @@ int testSndFile(const char fname[], const char keyword[])
 }
 
 
+// replay a feature file (-dump output) through the DNN and the detector, no front end
+int testFeatFile(const char fname[], const CDnnTrigger* model = NULL, double* audio_sec = NULL)
+{
+	CFeatFileReader reader;
+	if (reader.open(fname) || 51 != reader.getDim())
+	{
+		printf("%s\nnot a feature file\n", fname);
+		return -1;
+	}
+	if (audio_sec)	*audio_sec = reader.getFrames() / 100.;
+
+	unique_ptr<CDnnTrigger> trigger(model ? new CDnnTrigger(model) : new CDnnTrigger("./", "../conf/diotrg_16k.ini"));
+	CDnnTrigger& dnn_trigger = *trigger;
+	if (dnn_trigger.getError())
+	{
+		printf("error loading trigger engine\n");
+		return -5;
+	}
+
+	int kw_detected = 0;
+	for (long f = 0; f < reader.getFrames(); f++)
+	{
+		int spinfo[2];
+		auto ret_dec = dnn_trigger.detectFeatures(1, reader.row(f), spinfo);
+		if (0 < ret_dec)
+		{
+			if (!g_jobs)	printf("%8d KW detected! -> %8d, %8d\n", kw_detected, dnn_trigger.getOutFrame() - spinfo[1],dnn_trigger.getOutFrame());
+			kw_detected++;
+		}
+	}
+
+	return kw_detected;
+}
+
+
+static bool isFeatFile(const char fname[])
+{
+	return !_strnicmp(get_filename_ext(fname), ".trgf", 6);
+}
+
+
+struct TestJob {
+	std::string path;
+	std::string keyword;	// empty : CDnnTrigger
+	int kw_det;
+	double audio_sec;
+	double proc_sec;
+};
+
+// -j : the files on g_jobs threads, CDnnTrigger files run as sessions of one loaded model
+// return # of files with a critical error
+static int testJobs(std::vector<TestJob>& jobs)
+{
+	CTrigger::setChannel(std::max(16, g_jobs + 1));	// FE channels : model + one session per thread
+	CDnnTrigger model("./", "../conf/diotrg_16k.ini");
+	if (model.getError())
+	{
+		printf("error loading trigger engine\n");
+		return (int)jobs.size();
+	}
+
+	std::atomic<size_t> next(0);
+	std::atomic<int> critical(0);
+	auto worker = [&]() {
+		for (size_t j; (j = next++) < jobs.size(); )
+		{
+			TestJob& job = jobs[j];
+			job.audio_sec = 0.;
+
+			const auto start = std::chrono::steady_clock::now();
+			if (isFeatFile(job.path.c_str()))
+				job.kw_det = testFeatFile(job.path.c_str(), &model, &job.audio_sec);
+			else if (!job.keyword.empty())
+				job.kw_det = testSndFile(job.path.c_str(), job.keyword.c_str(), &job.audio_sec);
+			else
+				job.kw_det = testSndFile(job.path.c_str(), &model, &job.audio_sec);
+			job.proc_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			if (job.kw_det < -2)	critical++;
+
+			std::lock_guard<std::mutex> lock(g_mutex);
+			printf("%s\t%d\tRTF %.4f\n", job.path.c_str(), job.kw_det, (0. < job.audio_sec) ? job.proc_sec / job.audio_sec : 0.);
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < g_jobs; t++)
+		threads.push_back(std::thread(worker));
+	for (auto& t : threads)
+		t.join();
+
+	return critical;
+}
+
 
 int main(int argc, char* argv[])
 {
+	for (; 1 < argc && '-' == argv[1][0]; argc--, argv++)
+	{
+		if (!strcmp(argv[1], "-dump"))
+			g_feat_dump = true;
+		else if (!strcmp(argv[1], "-stats"))
+			g_stats = true;
+		else if (!strcmp(argv[1], "-j") && 2 < argc)
+		{
+			g_jobs = std::max(1, atoi(argv[2]));
+			argc--;
+			argv++;
+		}
+		else
+			break;
+	}
+
 	if (argc < 2)
 	{
 		puts("Usage:\n"
-			"trg_file_tester.exe filepath [keyword]\n"
-			"trg_file.tester.exe listpath");
+			"trg_file_tester.exe [-dump] [-stats] filepath [keyword]\n"
+			"trg_file.tester.exe [-dump] [-stats] [-j N] listpath\n"
+			"  -dump : write the features of each file to <filepath>.trgf\n"
+			"  -stats : print the profiling counters (time per stage, frame latency)\n"
+			"  -j N : test the files of the list on N threads sharing one loaded model\n"
+			"  a .trgf filepath replays the recorded features\n"
+			"  .raw/.pcm/.wav files are memory mapped, filepath - reads raw or WAV from stdin");
 		return -1;
 	}
 	const char* fname = argv[1];
@@ -174,17 +456,23 @@ int main(int argc, char* argv[])
 	if (_strnicmp(ext, ".txt", 5) && _strnicmp(ext, ".list", 6))
 	{
 		int kw_det;
-		if (argc < 3)
+		if (isFeatFile(fname))
+			kw_det = testFeatFile(fname);
+		else if (argc < 3)
 			kw_det = testSndFile(fname);
 		else
 			kw_det = testSndFile(fname, argv[2]);
 		printf("%s\t%d\n", fname, kw_det);
+		if (g_stats)	printStats();
 		return 0;
 	}
 
 	// list file
 	int file_count = 0;
 	int det_file_count = 0;
+	double audio_sec = 0.;
+	std::vector<TestJob> jobs;
+	const auto list_start = std::chrono::steady_clock::now();
 	char sz_line[MAX_PATH] = { 0 };
 	FILE* list_file = fopen(fname, "r");
 	while (NULL != fgets(sz_line, sizeof(sz_line), list_file))
@@ -221,26 +509,53 @@ int main(int argc, char* argv[])
 		fclose(fp_test);
 		file_count++;
 
+		if (g_jobs)
+		{
+			TestJob job = { snd_path, (2 < argc) ? argv[2] : str_trn, 0, 0., 0. };
+			jobs.push_back(job);
+			continue;
+		}
+
 		int kw_det;
-		if (2 < argc)
+		double file_sec = 0.;
+		if (isFeatFile(snd_path.c_str()))
 		{
-			kw_det = testSndFile(snd_path.c_str(), argv[2]);
+			kw_det = testFeatFile(snd_path.c_str(), NULL, &file_sec);
 		}
-		else if (str_trn)
+		else if (2 < argc)
 		{
-			kw_det = testSndFile(snd_path.c_str(), str_trn);
+			kw_det = testSndFile(snd_path.c_str(), argv[2], &file_sec);
+		}
+		else if ('\0' != str_trn[0])
+		{
+			kw_det = testSndFile(snd_path.c_str(), str_trn, &file_sec);
 		}
 		else
 		{
-			kw_det = testSndFile(snd_path.c_str());
+			kw_det = testSndFile(snd_path.c_str(), (const CDnnTrigger*)NULL, &file_sec);
 		}
 		printf("%s\t%d\n\n", snd_path.c_str(), kw_det);
 		if (kw_det < -2) { puts("critical error!"); break; }
 
 		if (0 < kw_det) det_file_count+= kw_det;
+		audio_sec += file_sec;
+	}
+
+	if (g_jobs)
+	{
+		if (testJobs(jobs))	puts("critical error!");
+		for (const TestJob& job : jobs)
+		{
+			if (0 < job.kw_det)	det_file_count += job.kw_det;
+			audio_sec += job.audio_sec;
+		}
 	}
+	const double wall_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - list_start).count();
 
 	printf("kw detected: %d / %d (%f%%)\n", det_file_count, file_count, 100.f*det_file_count/file_count);
+	printf("audio %.3f h, wall %.1f s, %.1fx real time, %.2f detections/hour\n", audio_sec / 3600., wall_sec,
+		(0. < wall_sec) ? audio_sec / wall_sec : 0., (0. < audio_sec) ? det_file_count * 3600. / audio_sec : 0.);
+	if (g_stats)	printStats();
 
 	return 0;
 }
@@ -13,7 +13,7 @@
 
 #include <sndfile.hh>
 
-#include "dnn_trigger_decoder/dnn_trigger.h"
+#include "dnn_trigger_decoder/array_trigger.h"
 #pragma comment(lib, "dnn_trigger")
 
 #ifdef _WIN32
@@ -100,7 +100,7 @@ int main(int argc, char* argv[])
 	micArr.Flush();
 
 
-	CDnnTrigger dnn_trigger("./", "../conf/diotrg_16k.ini");
+	CArrayTrigger dnn_trigger("./", "../conf/diotrg_16k.ini", 8);
 	if (dnn_trigger.getError())
 	{
 		printf("error loading trigger engine\n");
@@ -114,9 +114,9 @@ int main(int argc, char* argv[])
 	char logfilename[32];
 	strftime(logfilename, sizeof(logfilename), "%y%m%d_%H%M%S_0.flac", timeinfo);
 	SndfileHandle sfhf(logfilename, SFM_WRITE, SF_FORMAT_FLAC | SF_FORMAT_PCM_16, 8, D_FX);
+#endif
 
 	unique_ptr<int16_t[]> buf8(new int16_t[8*nSamplesPerFrame]);
-#endif
 
 	bool bSecondBuf = false;
 	int kw_detected = 0;
@@ -132,26 +132,24 @@ int main(int argc, char* argv[])
 
 		micArr.ReadAll(crnt_buf);
 
-#ifdef DD_WRITE_SOUND_FILE		
 		for (int f = 0; f<nSamplesPerFrame; f++)
 		{
 			for (int b = 0; b < 8; b++)	// interleaving
 				buf8[8*f+b] = crnt_sbuf[b][f];
 		}
 
+#ifdef DD_WRITE_SOUND_FILE
 		sfhf.writef(buf8.get(), nSamplesPerFrame);
 #endif
 
 		//printf("%f\n", getRmsEnergy(160, (short*)crnt_buf[0]));
 
-		for (int s = 0; s < nSamplesPerFrame; s += 160)
+		// all 8 microphones, posteriors fused in the engine
+		auto ret_dec = dnn_trigger.detect(nSamplesPerFrame, buf8.get());
+		if (0 < ret_dec)
 		{
-			auto ret_dec = dnn_trigger.detect(160, &crnt_sbuf[0][s]);
-			if (0 < ret_dec)
-			{
-				printf("Keyword detected at %d frame \n", dnn_trigger.getOutFrame());
-				kw_detected++;
-			}
+			printf("Keyword detected at %d frame \n", dnn_trigger.getOutFrame());
+			kw_detected++;
 		}
 	}
 